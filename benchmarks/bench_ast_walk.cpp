@@ -0,0 +1,106 @@
+// Бенчмарк обхода AST: рекурсивный ASTWalker против линейного прохода по
+// FlatBody на большом синтетическом теле функции — визитором по узлам и
+// только по полям FlatNode.
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "AST/ASTContext.h"
+#include "AST/ASTVisitor.h"
+#include "AST/ASTWalker.h"
+#include "AST/FlatAST.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point Start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+// makeBody - Тело из Statements присваиваний "x = (x + i) * (y - 1)", по
+// восемь в каждом вложенном while.
+BraceStmt *makeBody(ASTContext &Ctx, unsigned Statements) {
+    Identifier X = Ctx.getIdentifier("x"), Y = Ctx.getIdentifier("y");
+    Identifier Plus = Ctx.getIdentifier("+"), Minus = Ctx.getIdentifier("-"),
+               Star = Ctx.getIdentifier("*"), Less = Ctx.getIdentifier("<");
+    std::vector<Node *> Elements, Loop;
+    for (unsigned I = 0; I != Statements; ++I) {
+        Expr *Sum = new (Ctx) BinaryExpr(Plus, new (Ctx) DeclRefExpr(X),
+                                         new (Ctx) IntegerLiteralExpr(I));
+        Expr *Diff = new (Ctx) BinaryExpr(Minus, new (Ctx) DeclRefExpr(Y),
+                                          new (Ctx) IntegerLiteralExpr(1));
+        Loop.push_back(new (Ctx) AssignExpr(new (Ctx) DeclRefExpr(X),
+                                            new (Ctx) BinaryExpr(Star, Sum, Diff)));
+        if (Loop.size() == 8) {
+            Expr *Cond = new (Ctx) BinaryExpr(Less, new (Ctx) DeclRefExpr(X),
+                                              new (Ctx) DeclRefExpr(Y));
+            Elements.push_back(new (Ctx) WhileStmt(
+                Cond, new (Ctx) BraceStmt(Ctx.allocateCopy<Node *>(Loop))));
+            Loop.clear();
+        }
+    }
+    return new (Ctx) BraceStmt(Ctx.allocateCopy<Node *>(Elements));
+}
+
+// RefCounter - Считает ссылки на x; один и тот же визитор используется
+// обоими способами обхода.
+class RefCounter : public ASTVisitor<RefCounter> {
+public:
+    Identifier X;
+    uint64_t Count = 0;
+
+    void visitDeclRefExpr(DeclRefExpr *E) { Count += E->getName() == X; }
+};
+
+class RefWalker : public ASTWalker<RefWalker> {
+public:
+    RefCounter Counter;
+
+    bool walkToExprPre(Expr *E) {
+        Counter.visit(E);
+        return true;
+    }
+};
+
+} // namespace
+
+int main() {
+    const unsigned Statements = 200000, Rounds = 5;
+    ASTContext Ctx;
+    BraceStmt *Body = makeBody(Ctx, Statements);
+
+    auto Start = Clock::now();
+    FlatBody Flat = FlatBody::build(Body);
+    double BuildMs = elapsedMs(Start);
+    std::printf("%u nodes, flat layout built in %.2f ms\n", Flat.size(), BuildMs);
+
+    RefWalker Walker;
+    Walker.Counter.X = Ctx.getIdentifier("x");
+    Start = Clock::now();
+    for (unsigned I = 0; I != Rounds; ++I)
+        Walker.walk(Body);
+    double WalkMs = elapsedMs(Start);
+
+    RefCounter Linear;
+    Linear.X = Walker.Counter.X;
+    Start = Clock::now();
+    for (unsigned I = 0; I != Rounds; ++I)
+        Flat.visitPostOrder(Linear);
+    double FlatMs = elapsedMs(Start);
+
+    uint64_t FieldCount = 0;
+    Start = Clock::now();
+    for (unsigned I = 0; I != Rounds; ++I)
+        for (const FlatNode &Entry : Flat)
+            FieldCount += Entry.Kind == NodeKind::DeclRefExpr && Entry.getName() == Linear.X;
+    double FieldsMs = elapsedMs(Start);
+
+    bool Match = Walker.Counter.Count == Linear.Count && Linear.Count == FieldCount;
+    std::printf("walker: %8.2f ms, flat: %8.2f ms, x%.1f\n", WalkMs, FlatMs,
+                WalkMs / (FlatMs > 0 ? FlatMs : 1e-3));
+    std::printf("flat fields only: %8.2f ms, x%.1f%s\n", FieldsMs,
+                WalkMs / (FieldsMs > 0 ? FieldsMs : 1e-3), Match ? "" : "  MISMATCH");
+    return 0;
+}
@@ -0,0 +1,169 @@
+// Бенчмарк JIT: программы с тяжёлыми циклами и вызовами исполняются
+// интерпретатором LIR и машинным кодом, результаты сверяются.
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+
+#include "JIT/JITCompiler.h"
+#include "JIT/LIR.h"
+#include "JIT/LIRInterpreter.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point Start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+const char *const Programs = R"(
+; sum(n) - сумма 0..n-1 в одном цикле.
+func sum(%r0) -> int {
+bb0:
+  %r1 = iconst 0
+  %r2 = iconst 0
+  br bb1
+bb1:
+  %r3 = cmp.lt %r2, %r0
+  condbr %r3, bb2, bb3
+bb2:
+  %r1 = add %r1, %r2
+  %r4 = iconst 1
+  %r2 = add %r2, %r4
+  br bb1
+bb3:
+  ret %r1
+}
+
+; primes(n) - число простых меньше n перебором делителей: вложенные циклы
+; и деление.
+func primes(%r0) -> int {
+bb0:
+  %r1 = iconst 0
+  %r2 = iconst 2
+  %r9 = iconst 1
+  %r10 = iconst 0
+  br bb1
+bb1:
+  %r3 = cmp.lt %r2, %r0
+  condbr %r3, bb2, bb7
+bb2:
+  %r4 = iconst 2
+  br bb3
+bb3:
+  %r5 = mul %r4, %r4
+  %r6 = cmp.le %r5, %r2
+  condbr %r6, bb4, bb6
+bb4:
+  %r7 = rem %r2, %r4
+  %r8 = cmp.eq %r7, %r10
+  condbr %r8, bb5, bb8
+bb8:
+  %r4 = add %r4, %r9
+  br bb3
+bb6:
+  %r1 = add %r1, %r9
+  br bb5
+bb5:
+  %r2 = add %r2, %r9
+  br bb1
+bb7:
+  ret %r1
+}
+
+; leibniz(n) - n членов ряда Лейбница для pi в double.
+func leibniz(%r0) -> float {
+bb0:
+  %f1 = fconst 0
+  %f2 = fconst 1
+  %f3 = fconst 1
+  %f4 = fconst 2
+  %r5 = iconst 0
+  %r6 = iconst 1
+  br bb1
+bb1:
+  %r7 = cmp.lt %r5, %r0
+  condbr %r7, bb2, bb3
+bb2:
+  %f8 = fdiv %f2, %f3
+  %f1 = fadd %f1, %f8
+  %f2 = neg %f2
+  %f3 = fadd %f3, %f4
+  %r5 = add %r5, %r6
+  br bb1
+bb3:
+  %f9 = fconst 4
+  %f10 = fmul %f1, %f9
+  ret %f10
+}
+
+; fib(n) - рекурсивные вызовы.
+func fib(%r0) -> int {
+bb0:
+  %r1 = iconst 2
+  %r2 = cmp.lt %r0, %r1
+  condbr %r2, bb1, bb2
+bb1:
+  ret %r0
+bb2:
+  %r3 = iconst 1
+  %r4 = sub %r0, %r3
+  %r5 = call fib(%r4)
+  %r6 = sub %r0, %r1
+  %r7 = call fib(%r6)
+  %r8 = add %r5, %r7
+  ret %r8
+}
+)";
+
+void run(const char *Name, const LIRModule &M, const JITCompiler &JIT, int64_t Arg) {
+    const LIRFunction *F = M.getFunction(Name);
+    LIRValue Args[] = {makeInt(Arg)};
+
+    LIRInterpreter Interp;
+    auto Start = Clock::now();
+    LIRValue Expected = Interp.run(*F, {Args, 1});
+    double InterpMs = elapsedMs(Start);
+
+    Start = Clock::now();
+    LIRValue Actual = JIT.call(F, {Args, 1});
+    double JITMs = elapsedMs(Start);
+
+    bool IsFloat = F->getReturnType() == LIRType::Float;
+    bool Same = IsFloat ? Expected.F == Actual.F : Expected.I == Actual.I;
+    std::printf("%-8s(%lld): interpreter %9.2f ms (%llu insts), jit %8.2f ms, x%.1f%s\n",
+                Name, static_cast<long long>(Arg), InterpMs,
+                static_cast<unsigned long long>(Interp.getNumInstsExecuted()), JITMs,
+                InterpMs / (JITMs > 0 ? JITMs : 1e-3), Same ? "" : "  MISMATCH");
+}
+
+} // namespace
+
+int main() {
+    LIRModule M;
+    std::string Error;
+    if (!parseLIRModule(Programs, M, Error)) {
+        std::fprintf(stderr, "%s\n", Error.c_str());
+        return 1;
+    }
+    if (!JITCompiler::isHostSupported()) {
+        std::fprintf(stderr, "JIT needs an x86-64 host\n");
+        return 1;
+    }
+
+    JITCompiler JIT;
+    if (!JIT.compile(M, Error)) {
+        std::fprintf(stderr, "%s\n", Error.c_str());
+        return 1;
+    }
+    const JITCompiler::Stats &Stats = JIT.getStats();
+    std::printf("compiled %u functions, %zu bytes of code in %llu us\n", Stats.NumFunctions,
+                Stats.CodeSize, static_cast<unsigned long long>(Stats.CompileMicros));
+
+    run("sum", M, JIT, 20000000);
+    run("primes", M, JIT, 200000);
+    run("leibniz", M, JIT, 10000000);
+    run("fib", M, JIT, 27);
+    return 0;
+}
@@ -0,0 +1,146 @@
+// Бенчмарк оптимизации MIR: конвейер по умолчанию на тысячах функций в
+// одном потоке и на пуле, плюс число исполненных инструкций до и после.
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AST/ASTContext.h"
+#include "AST/Decl.h"
+#include "AST/Expr.h"
+#include "AST/Stmt.h"
+#include "Basic/ThreadPool.h"
+#include "MIR/MIRGen.h"
+#include "MIR/MIRInterpreter.h"
+#include "MIR/PassManager.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point Start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+class ProgramBuilder {
+    ASTContext &Ctx;
+
+    Identifier id(std::string_view Name) { return Ctx.getIdentifier(Name); }
+    Expr *ref(std::string_view Name) { return new (Ctx) DeclRefExpr(id(Name)); }
+    Expr *lit(int64_t Value) { return new (Ctx) IntegerLiteralExpr(Value); }
+    Expr *binary(const char *Op, Expr *LHS, Expr *RHS) {
+        return new (Ctx) BinaryExpr(id(Op), LHS, RHS);
+    }
+    Expr *assign(const char *Name, Expr *Value) {
+        return new (Ctx) AssignExpr(ref(Name), Value);
+    }
+    BraceStmt *brace(std::vector<Node *> Elements) {
+        return new (Ctx) BraceStmt(Ctx.allocateCopy<Node *>(Elements));
+    }
+
+    FuncDecl *func(std::string_view Name, std::vector<const char *> ParamNames, BraceStmt *Body) {
+        std::vector<ParamDecl *> Params;
+        std::vector<TypeBase *> ParamTypes;
+        for (const char *P : ParamNames) {
+            Params.push_back(new (Ctx) ParamDecl(id(P), Ctx.getIntType()));
+            ParamTypes.push_back(Ctx.getIntType());
+        }
+        return new (Ctx) FuncDecl(id(Name), Ctx.allocateCopy<ParamDecl *>(Params), Body,
+                                  Ctx.getFunctionType(ParamTypes, Ctx.getIntType()));
+    }
+
+public:
+    explicit ProgramBuilder(ASTContext &ctx) : Ctx(ctx) {}
+
+    // build - Функция scale(x, y) = x * 3 + y и Count функций вида
+    //   fN(n, k) { var s = N; var i = 0
+    //              while i < n { s = s + scale(k * (2 + N), i) % 7; i = i + 1 }
+    //              return s }
+    // В цикле есть инвариант, вызов для встраивания и константы для свёртки.
+    std::vector<FuncDecl *> build(unsigned Count) {
+        std::vector<FuncDecl *> Funcs;
+        Funcs.push_back(func("scale", {"x", "y"},
+                             brace({new (Ctx) ReturnStmt(
+                                 binary("+", binary("*", ref("x"), lit(3)), ref("y")))})));
+        for (unsigned N = 0; N != Count; ++N) {
+            std::vector<Expr *> Args = {binary("*", ref("k"), binary("+", lit(2), lit(N))),
+                                        ref("i")};
+            Expr *Call = new (Ctx) CallExpr(ref("scale"), Ctx.allocateCopy<Expr *>(Args));
+            auto *Loop = new (Ctx) WhileStmt(
+                binary("<", ref("i"), ref("n")),
+                brace({assign("s", binary("+", ref("s"), binary("%", Call, lit(7)))),
+                       assign("i", binary("+", ref("i"), lit(1)))}));
+            Funcs.push_back(func(
+                "f" + std::to_string(N), {"n", "k"},
+                brace({new (Ctx) VarDecl(id("s"), false, nullptr, lit(N)),
+                       new (Ctx) VarDecl(id("i"), false, nullptr, lit(0)), Loop,
+                       new (Ctx) ReturnStmt(ref("s"))})));
+        }
+        return Funcs;
+    }
+};
+
+uint64_t countExecuted(const MIRModule &M, int64_t &Result) {
+    MIRInterpreter Interp;
+    Result = Interp.run(*M.getFunction("f1"), {makeMIRInt(1000), makeMIRInt(5)}).I;
+    return Interp.getNumInstsExecuted();
+}
+
+} // namespace
+
+int main() {
+    const unsigned Functions = 4000;
+    ASTContext Ctx;
+    std::vector<FuncDecl *> Funcs = ProgramBuilder(Ctx).build(Functions);
+
+    std::string Error;
+    MIRModule Serial, Parallel;
+    auto Start = Clock::now();
+    if (!lowerToMIR(Funcs, Serial, Error) || !lowerToMIR(Funcs, Parallel, Error)) {
+        std::fprintf(stderr, "lowering failed: %s\n", Error.c_str());
+        return 1;
+    }
+    std::printf("%u functions lowered twice in %.2f ms, %u instructions each\n",
+                Functions + 1, elapsedMs(Start), Serial.getNumInsts());
+
+    int64_t Before, After;
+    uint64_t ExecutedBefore = countExecuted(Serial, Before);
+
+    MIRPassManager SerialPM;
+    SerialPM.addDefaultPipeline();
+    Start = Clock::now();
+    if (!SerialPM.run(Serial, Error)) {
+        std::fprintf(stderr, "%s\n", Error.c_str());
+        return 1;
+    }
+    double SerialMs = elapsedMs(Start);
+
+    ThreadPool Pool;
+    MIRPassManager ParallelPM;
+    ParallelPM.addDefaultPipeline();
+    ParallelPM.setThreadPool(&Pool);
+    Start = Clock::now();
+    if (!ParallelPM.run(Parallel, Error)) {
+        std::fprintf(stderr, "%s\n", Error.c_str());
+        return 1;
+    }
+    double ParallelMs = elapsedMs(Start);
+
+    uint64_t ExecutedAfter = countExecuted(Parallel, After);
+    if (Before != After || !Parallel.verify(Error)) {
+        std::fprintf(stderr, "optimised module is wrong: %s\n", Error.c_str());
+        return 1;
+    }
+
+    std::printf("pipeline, 1 thread:   %8.2f ms\n", SerialMs);
+    std::printf("pipeline, %u threads: %8.2f ms (x%.2f)\n", Pool.getNumThreads(), ParallelMs,
+                SerialMs / ParallelMs);
+    std::printf("%u instructions after optimisation\n", Parallel.getNumInsts());
+    std::printf("f1(1000, 5): %llu -> %llu instructions executed\n",
+                static_cast<unsigned long long>(ExecutedBefore),
+                static_cast<unsigned long long>(ExecutedAfter));
+    ParallelPM.printStats(std::cout);
+    return 0;
+}
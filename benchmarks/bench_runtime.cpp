@@ -0,0 +1,233 @@
+// Бенчмарк объектной модели: структуры на месте против объектов в куче,
+// пул против malloc и число retain/release на итерацию цикла MIR до и
+// после снятия парных операций.
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "AST/ASTContext.h"
+#include "AST/Decl.h"
+#include "MIR/MIRInterpreter.h"
+#include "MIR/PassManager.h"
+#include "Runtime/Layout.h"
+#include "Runtime/Runtime.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point Start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+// Sink - Не даёт компилятору выбросить результаты.
+volatile int64_t Sink;
+
+// benchStorage - Count значений Point { x: Int; y: Int; z: Double }: одним
+// буфером по раскладке структуры и отдельными объектами класса с тем же
+// набором полей.
+void benchStorage(LayoutContext &Layouts, ASTContext &Ctx, unsigned Count) {
+    std::string Error;
+    const TypeLayout *Point = Layouts.getLayout(Ctx.getStructType(Ctx.getIdentifier("Point")), Error);
+    const ClassMetadata *Boxed = Layouts.getClassMetadata(Ctx.getIdentifier("BoxedPoint"), Error);
+    if (!Point || !Boxed) {
+        std::fprintf(stderr, "layout failed: %s\n", Error.c_str());
+        std::exit(1);
+    }
+
+    auto Start = Clock::now();
+    std::vector<char> Inline(size_t(Count) * Point->getStride());
+    for (unsigned I = 0; I != Count; ++I) {
+        int64_t X = I;
+        std::memcpy(&Inline[size_t(I) * Point->getStride()], &X, sizeof(X));
+    }
+    int64_t Sum = 0;
+    for (unsigned I = 0; I != Count; ++I) {
+        int64_t X;
+        std::memcpy(&X, &Inline[size_t(I) * Point->getStride()], sizeof(X));
+        Sum += X;
+    }
+    Sink = Sum;
+    double InlineMs = elapsedMs(Start);
+
+    Runtime RT;
+    Start = Clock::now();
+    std::vector<HeapObject *> Objects(Count);
+    for (unsigned I = 0; I != Count; ++I) {
+        Objects[I] = RT.allocObject(*Boxed);
+        *reinterpret_cast<int64_t *>(Objects[I]->getField(HeapObjectHeaderSize)) = I;
+    }
+    Sum = 0;
+    for (HeapObject *O : Objects)
+        Sum += *reinterpret_cast<int64_t *>(O->getField(HeapObjectHeaderSize));
+    for (HeapObject *O : Objects)
+        RT.release(O);
+    Sink = Sum;
+    double BoxedMs = elapsedMs(Start);
+
+    std::printf("%u points as struct: %8.2f ms, 1 buffer of %u-byte elements, 0 refcount ops\n",
+                Count, InlineMs, Point->getStride());
+    std::printf("%u points as class:  %8.2f ms, %.2f allocs/op, %.2f releases/op\n", Count,
+                BoxedMs, double(RT.getStats().NumAllocs) / Count,
+                double(RT.getStats().NumReleases) / Count);
+}
+
+// benchChurn - Создание и освобождение короткоживущих объектов: пул
+// против malloc/free того же размера.
+void benchChurn(const ClassMetadata &Meta, unsigned Count) {
+    Runtime RT;
+    const unsigned Live = 64;
+    std::vector<HeapObject *> Window(Live, nullptr);
+    auto Start = Clock::now();
+    for (unsigned I = 0; I != Count; ++I) {
+        HeapObject *&Slot = Window[I % Live];
+        RT.release(Slot);
+        Slot = RT.allocObject(Meta);
+    }
+    for (HeapObject *O : Window)
+        RT.release(O);
+    double PoolMs = elapsedMs(Start);
+
+    std::vector<void *> MallocWindow(Live, nullptr);
+    Start = Clock::now();
+    for (unsigned I = 0; I != Count; ++I) {
+        void *&Slot = MallocWindow[I % Live];
+        std::free(Slot);
+        Slot = std::malloc(Meta.InstanceSize);
+        std::memset(Slot, 0, Meta.InstanceSize);
+    }
+    for (void *P : MallocWindow)
+        std::free(P);
+    double MallocMs = elapsedMs(Start);
+
+    const ObjectAllocator::Stats &S = RT.getAllocator().getStats();
+    std::printf("alloc+free churn: pool %6.1f ns/op (%.1f%% reused, %llu slabs), "
+                "malloc %6.1f ns/op\n",
+                PoolMs * 1e6 / Count, 100.0 * double(S.NumReused) / double(S.NumAllocs),
+                static_cast<unsigned long long>(S.NumSlabs), MallocMs * 1e6 / Count);
+}
+
+// buildAccumulate - accumulate(o, n): цикл из n итераций, в каждой
+//   retain o; v = get(o); retain o; set(o, v + i); release o; release o
+// — такие пары ставит вызывающий, продлевая жизнь аргумента на время
+// вызова.
+MIRFunction *buildAccumulate(MIRModule &M) {
+    const uint32_t Value = HeapObjectHeaderSize;
+    MIRFunction *Get = M.createFunction("get", {MIRType::Ref}, MIRType::Int);
+    MIRBuilder GB(*Get);
+    GB.setInsertPoint(Get->getEntryBlock());
+    GB.createRet(GB.createLoadField(MIRType::Int, GB.createParam(0), Value));
+
+    MIRFunction *Set = M.createFunction("set", {MIRType::Ref, MIRType::Int}, MIRType::Void);
+    MIRBuilder SB(*Set);
+    SB.setInsertPoint(Set->getEntryBlock());
+    SB.createStoreField(SB.createParam(0), Value, SB.createParam(1));
+    SB.createRet(nullptr);
+
+    MIRFunction *F =
+        M.createFunction("accumulate", {MIRType::Ref, MIRType::Int}, MIRType::Int);
+    MIRBuilder B(*F);
+    MIRBlock *Entry = F->getEntryBlock();
+    B.setInsertPoint(Entry);
+    MIRInst *Object = B.createParam(0);
+    MIRInst *N = B.createParam(1);
+    MIRInst *Zero = B.iconst(0);
+    MIRBlock *Header = B.createBlock(), *Body = B.createBlock(), *Exit = B.createBlock();
+    B.createBr(Header);
+
+    MIRInst *I = B.createPhi(MIRType::Int, Header);
+    MIRInst *Sum = B.createPhi(MIRType::Int, Header);
+    B.setInsertPoint(Header);
+    B.createCondBr(B.createCmpLt(I, N), Body, Exit);
+
+    B.setInsertPoint(Body);
+    B.createRetain(Object);
+    MIRInst *V = B.createCall(Get, {Object});
+    B.createRetain(Object);
+    B.createCall(Set, {Object, B.createAdd(V, I)});
+    B.createRelease(Object);
+    B.createRelease(Object);
+    MIRInst *NextSum = B.createAdd(Sum, V);
+    MIRInst *NextI = B.createAdd(I, B.iconst(1));
+    B.createBr(Header);
+    F->setOperands(I, {Zero, NextI});
+    F->setOperands(Sum, {Zero, NextSum});
+
+    B.setInsertPoint(Exit);
+    B.createRet(Sum);
+    return F;
+}
+
+struct Traffic {
+    int64_t Result;
+    Runtime::Stats Stats;
+    uint64_t Insts;
+    double Ms;
+};
+
+Traffic runAccumulate(const MIRFunction &F, const ClassMetadata &Meta, int64_t Iterations) {
+    Runtime RT;
+    HeapObject *O = RT.allocObject(Meta);
+    MIRInterpreter Interp(&RT);
+    auto Start = Clock::now();
+    int64_t Result = Interp.run(F, {makeMIRPointer(O), makeMIRInt(Iterations)}).I;
+    double Ms = elapsedMs(Start);
+    RT.release(O);
+    return {Result, RT.getStats(), Interp.getNumInstsExecuted(), Ms};
+}
+
+void printTraffic(const char *Label, const Traffic &T, int64_t Iterations) {
+    std::printf("%-10s %6.2f retains/op, %6.2f releases/op, %6.2f insts/op, %8.2f ms\n", Label,
+                double(T.Stats.NumRetains) / Iterations, double(T.Stats.NumReleases) / Iterations,
+                double(T.Insts) / Iterations, T.Ms);
+}
+
+} // namespace
+
+int main() {
+    ASTContext Ctx;
+    auto field = [&](const char *Name, TypeBase *Ty) -> Decl * {
+        return new (Ctx) VarDecl(Ctx.getIdentifier(Name), false, Ty);
+    };
+    std::vector<Decl *> Fields = {field("x", Ctx.getIntType()), field("y", Ctx.getIntType()),
+                                  field("z", Ctx.getDoubleType())};
+    ArrayRef<Decl *> Members = Ctx.allocateCopy<Decl *>(Fields);
+
+    LayoutContext Layouts;
+    Layouts.addStruct(new (Ctx) StructDecl(Ctx.getIdentifier("Point"), Members));
+    Layouts.addClass(Ctx.getIdentifier("BoxedPoint"), Members);
+    std::string Error;
+    const ClassMetadata *Boxed =
+        Layouts.getClassMetadata(Ctx.getIdentifier("BoxedPoint"), Error);
+
+    benchStorage(Layouts, Ctx, 2000000);
+    benchChurn(*Boxed, 10000000);
+
+    MIRModule M;
+    MIRFunction *F = buildAccumulate(M);
+    const int64_t Iterations = 1000000;
+    Traffic Before = runAccumulate(*F, *Boxed, Iterations);
+
+    MIRPassManager PM;
+    PM.addDefaultPipeline();
+    if (!PM.run(M, Error)) {
+        std::fprintf(stderr, "%s\n", Error.c_str());
+        return 1;
+    }
+    Traffic After = runAccumulate(*F, *Boxed, Iterations);
+    if (Before.Result != After.Result || !M.verify(Error)) {
+        std::fprintf(stderr, "optimised module is wrong: %s\n", Error.c_str());
+        return 1;
+    }
+
+    std::printf("accumulate(o, %lld):\n", static_cast<long long>(Iterations));
+    printTraffic("  before", Before, Iterations);
+    printTraffic("  after", After, Iterations);
+    PM.printStats(std::cout);
+    return 0;
+}
@@ -0,0 +1,103 @@
+// Микробенчмарк ScopedSymbolTable: глубокая вложенность и широкие области.
+// Сравнивается с наивным вариантом "std::unordered_map на каждую область".
+
+#include <chrono>
+#include <cstdio>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Sema/SymbolTable.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point Start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+// MapPerScope - Базовая реализация для сравнения: стек map, lookup идёт
+// от внутренней области к внешней.
+class MapPerScope {
+    std::vector<std::unordered_map<const char *, int>> Scopes;
+
+public:
+    MapPerScope() { Scopes.emplace_back(); }
+    void pushScope() { Scopes.emplace_back(); }
+    void popScope() { Scopes.pop_back(); }
+    void insert(Identifier Name, int Value) { Scopes.back()[Name.get()] = Value; }
+    const int *lookup(Identifier Name) const {
+        for (auto It = Scopes.rbegin(); It != Scopes.rend(); ++It) {
+            auto Found = It->find(Name.get());
+            if (Found != It->end())
+                return &Found->second;
+        }
+        return nullptr;
+    }
+};
+
+// Глубокая вложенность: Depth областей, в каждой одно объявление, на каждом
+// уровне ищется имя, объявленное в глобальной области.
+template <typename TableT>
+double runDeepNesting(const std::vector<Identifier> &Names, unsigned Depth,
+                      unsigned Rounds, long &Checksum) {
+    auto Start = Clock::now();
+    for (unsigned R = 0; R < Rounds; ++R) {
+        TableT Table;
+        Table.insert(Names[0], 1);
+        for (unsigned D = 0; D < Depth; ++D) {
+            Table.pushScope();
+            Table.insert(Names[1 + D % (Names.size() - 1)], static_cast<int>(D));
+            if (const int *V = Table.lookup(Names[0]))
+                Checksum += *V;
+        }
+        for (unsigned D = 0; D < Depth; ++D)
+            Table.popScope();
+    }
+    return elapsedMs(Start);
+}
+
+// Широкая область: Width объявлений в одной области, затем поиск каждого.
+template <typename TableT>
+double runWideScope(const std::vector<Identifier> &Names, unsigned Width,
+                    unsigned Rounds, long &Checksum) {
+    auto Start = Clock::now();
+    for (unsigned R = 0; R < Rounds; ++R) {
+        TableT Table;
+        Table.pushScope();
+        for (unsigned I = 0; I < Width; ++I)
+            Table.insert(Names[I], static_cast<int>(I));
+        for (unsigned I = 0; I < Width; ++I)
+            if (const int *V = Table.lookup(Names[I]))
+                Checksum += *V;
+        Table.popScope();
+    }
+    return elapsedMs(Start);
+}
+
+} // namespace
+
+int main() {
+    IdentifierTable Idents;
+    std::vector<Identifier> Names;
+    for (unsigned I = 0; I < 100000; ++I)
+        Names.push_back(Idents.get("name" + std::to_string(I)));
+
+    long Checksum = 0;
+
+    const unsigned Depth = 1000, DeepRounds = 50;
+    double DeepFlat = runDeepNesting<ScopedSymbolTable<int>>(Names, Depth, DeepRounds, Checksum);
+    double DeepMaps = runDeepNesting<MapPerScope>(Names, Depth, DeepRounds, Checksum);
+    std::printf("deep nesting (depth %u x %u):  flat %.2f ms, map-per-scope %.2f ms\n",
+                Depth, DeepRounds, DeepFlat, DeepMaps);
+
+    const unsigned Width = 100000, WideRounds = 20;
+    double WideFlat = runWideScope<ScopedSymbolTable<int>>(Names, Width, WideRounds, Checksum);
+    double WideMaps = runWideScope<MapPerScope>(Names, Width, WideRounds, Checksum);
+    std::printf("wide scope (width %u x %u):   flat %.2f ms, map-per-scope %.2f ms\n",
+                Width, WideRounds, WideFlat, WideMaps);
+
+    std::printf("checksum %ld\n", Checksum);
+    return 0;
+}
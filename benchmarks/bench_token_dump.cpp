@@ -0,0 +1,90 @@
+// Бенчмарк вывода токенов: прежний цикл с std::endl на каждый токен против
+// TokenDumper в трёх форматах через BufferedWriter. Вывод идёт в /dev/null,
+// так что меряется только форматирование и число системных вызовов.
+
+#include <chrono>
+#include <cstdio>
+#include <fcntl.h>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+
+#include "Basic/BufferedWriter.h"
+#include "Driver/TokenDumper.h"
+#include "Parse/Lexer.h"
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double elapsedMs(Clock::time_point Start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - Start).count();
+}
+
+std::string makeSource(size_t TargetBytes) {
+    static const char Chunk[] = "func compute(value: Int, scale: Double) {\n"
+                                "    let name = \"item\\tvalue\"\n"
+                                "    var total = 42\n"
+                                "    if flag { return total }\n"
+                                "}\n";
+    std::string Source;
+    Source.reserve(TargetBytes + sizeof(Chunk));
+    while (Source.size() < TargetBytes)
+        Source += Chunk;
+    return Source;
+}
+
+void report(const char *Label, double Ms, size_t SourceBytes, uint64_t OutBytes,
+            uint64_t Syscalls) {
+    std::printf("%-14s %8.2f ms %8.1f MB/s in, %8.1f MB out, %llu write() calls\n", Label, Ms,
+                SourceBytes / 1e6 / (Ms / 1e3), OutBytes / 1e6,
+                static_cast<unsigned long long>(Syscalls));
+}
+
+} // namespace
+
+int main() {
+    const std::string Source = makeSource(64u << 20);
+
+    auto Start = Clock::now();
+    uint64_t NumTokens = 0;
+    Lexer L(Source);
+    for (Token Tok = L.lex(); !Tok.isEOF(); Tok = L.lex())
+        ++NumTokens;
+    double LexMs = elapsedMs(Start);
+    std::printf("%zu MB source, %llu tokens\n", Source.size() >> 20,
+                static_cast<unsigned long long>(NumTokens));
+    report("lex only", LexMs, Source.size(), 0, 0);
+
+    {
+        // std::endl сбрасывает поток, т.е. один write() на токен.
+        std::ofstream Null("/dev/null");
+        Start = Clock::now();
+        Lexer Legacy(Source);
+        uint64_t Lines = 0;
+        for (Token Tok = Legacy.lex(); !Tok.isEOF(); Tok = Legacy.lex(), ++Lines)
+            Null << Tok.getTokenName() << Tok.getText() << std::endl;
+        report("legacy endl", elapsedMs(Start), Source.size(), 0, Lines);
+    }
+
+    int FD = ::open("/dev/null", O_WRONLY | O_CLOEXEC);
+    if (FD < 0) {
+        std::perror("/dev/null");
+        return 1;
+    }
+    const std::pair<const char *, TokenDumpFormat> Formats[] = {
+        {"text", TokenDumpFormat::Text},
+        {"json", TokenDumpFormat::JSONLines},
+        {"binary", TokenDumpFormat::Binary},
+    };
+    for (const auto &[Label, Format] : Formats) {
+        BufferedWriter OS(FD);
+        Start = Clock::now();
+        TokenDumper(OS, Format).dumpFile("bench.swift", Source);
+        OS.flush();
+        report(Label, elapsedMs(Start), Source.size(), OS.getBytesWritten(),
+               OS.getNumSyscalls());
+    }
+    ::close(FD);
+    return 0;
+}
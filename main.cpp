@@ -1,17 +1,271 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include <string_view>
 #include <sstream>
+#include <vector>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 #include "Parse/Token.h"
 #include "Parse/Lexer.h"
+#include "Parse/StreamingLexer.h"
+#include "Driver/BatchLoader.h"
+#include "Driver/CompileServer.h"
+#include "Driver/DependencyGraph.h"
+#include "Driver/TokenDumper.h"
+#include "JIT/JITCompiler.h"
+#include "JIT/LIR.h"
 
-int main() {
-    std::ifstream file("/Users/kamil/Developer/SwiftMini/test.swiftMini");
+static void printUsage() {
+    std::cerr << "usage: SwiftMini <file>\n"
+              << "       SwiftMini --stream [<file>]\n"
+              << "       SwiftMini --server [--socket <path>]\n"
+              << "       SwiftMini --incremental <deps-file> <file>...\n"
+              << "       SwiftMini --jit <file.lir> [<int-arg>...]\n"
+              << "       SwiftMini -dump-tokens [-format=text|json|binary] [-o <out>] <file>...\n";
+}
+
+// runStreaming - Лексит вход кусками фиксированного размера, не загружая его
+// целиком; без имени файла читает stdin.
+static int runStreaming(int argc, char **argv) {
+    if (argc > 3) {
+        printUsage();
+        return 1;
+    }
+    int FD = STDIN_FILENO;
+    if (argc == 3 && std::string_view(argv[2]) != "-") {
+        FD = ::open(argv[2], O_RDONLY);
+        if (FD < 0) {
+            std::cerr << "Can not open file" << std::endl;
+            return 1;
+        }
+    }
+
+    StreamingLexer lexer(StreamingLexer::readFromFD(FD));
+    while (true) {
+        Token result = lexer.lex();
+        std::cout << result.getTokenName() << result.getText() << '\n';
+        if (result.isEOF()) {
+            break;
+        }
+    }
+    std::cout.flush();
+    if (FD != STDIN_FILENO)
+        ::close(FD);
+    return 0;
+}
+
+static int runServer(int argc, char **argv) {
+    // Клиент может уйти, не дочитав ответ: это конец его соединения
+    // (EPIPE), а не всего сервера.
+    std::signal(SIGPIPE, SIG_IGN);
+    CompileServer Server;
+    if (argc == 4 && std::string_view(argv[2]) == "--socket") {
+        if (!Server.serveUnixSocket(argv[3])) {
+            std::cerr << "Can not listen on " << argv[3] << std::endl;
+            return 1;
+        }
+        return 0;
+    }
+    if (argc != 2) {
+        printUsage();
+        return 1;
+    }
+    Server.serve(STDIN_FILENO, STDOUT_FILENO);
+    return 0;
+}
+
+// runIncremental - Пересобирает (лексит) только файлы, затронутые изменениями
+// с прошлого запуска, и сохраняет новый граф зависимостей в <deps-file>.
+static int runIncremental(int argc, char **argv) {
+    if (argc < 4) {
+        printUsage();
+        return 1;
+    }
+    std::string DepsPath = argv[2];
+    std::vector<std::string> Inputs(argv + 3, argv + argc);
+
+    // Отсутствующий граф — первая сборка, пересобирается всё.
+    DependencyGraph OldGraph;
+    std::string Error;
+    if (::access(DepsPath.c_str(), F_OK) == 0 && !OldGraph.load(DepsPath, Error)) {
+        std::cerr << Error << std::endl;
+        return 1;
+    }
+
+    DependencyGraph NewGraph;
+    std::vector<RebuildDecision> Decisions;
+    if (!planIncrementalBuild(OldGraph, Inputs, NewGraph, Decisions, Error)) {
+        std::cerr << Error << std::endl;
+        return 1;
+    }
+
+    // Файлы уже пролексированы при планировании, из тех же байтов, что
+    // попали в граф.
+    unsigned NumRebuilt = 0;
+    for (const RebuildDecision &Decision : Decisions) {
+        if (!Decision.NeedsRebuild) {
+            std::cout << "up-to-date " << Decision.Path << '\n';
+            continue;
+        }
+        std::cout << "rebuild " << Decision.Path << " (" << Decision.Reason << "), "
+                  << Decision.NumTokens << " tokens\n";
+        ++NumRebuilt;
+    }
+    std::cout << NumRebuilt << " of " << Decisions.size() << " files rebuilt" << std::endl;
+
+    if (!NewGraph.save(DepsPath)) {
+        std::cerr << "Can not write " << DepsPath << std::endl;
+        return 1;
+    }
+    return 0;
+}
+
+// runJIT - Компилирует LIR-модуль в машинный код и вызывает его функцию
+// main с целыми аргументами из командной строки.
+static int runJIT(int argc, char **argv) {
+    if (argc < 3) {
+        printUsage();
+        return 1;
+    }
+    std::ifstream file(argv[2]);
     if (!file.is_open()) {
         std::cerr << "Can not open file" << std::endl;
         return 1;
     }
-    
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    LIRModule Module;
+    std::string Error;
+    if (!parseLIRModule(buffer.str(), Module, Error)) {
+        std::cerr << argv[2] << ":" << Error << std::endl;
+        return 1;
+    }
+
+    const LIRFunction *Main = Module.getFunction("main");
+    if (!Main) {
+        std::cerr << "no function 'main'" << std::endl;
+        return 1;
+    }
+    std::vector<LIRValue> Args;
+    for (int I = 3; I < argc; ++I)
+        Args.push_back(makeInt(std::strtoll(argv[I], nullptr, 10)));
+    if (Args.size() != Main->Params.size()) {
+        std::cerr << "'main' expects " << Main->Params.size() << " arguments" << std::endl;
+        return 1;
+    }
+    for (VReg Param : Main->Params) {
+        if (Main->getRegType(Param) != LIRType::Int) {
+            std::cerr << "'main' parameters must be int" << std::endl;
+            return 1;
+        }
+    }
+
+    JITCompiler JIT;
+    if (!JIT.compile(Module, Error)) {
+        std::cerr << Error << std::endl;
+        return 1;
+    }
+    LIRValue Result = JIT.call(Main, Args);
+    if (Main->getReturnType() == LIRType::Int)
+        std::cout << Result.I << std::endl;
+    else
+        std::cout << Result.F << std::endl;
+    return 0;
+}
+
+// runDumpTokens - Выводит токены файлов в выбранном формате через один
+// большой буфер. Файлы читаются пакетом, а выводятся в порядке аргументов:
+// файл, прочитанный раньше своей очереди, ждёт в Pending.
+static int runDumpTokens(int argc, char **argv) {
+    TokenDumpFormat Format = TokenDumpFormat::Text;
+    const char *OutputPath = nullptr;
+    std::vector<std::string> Inputs;
+    for (int I = 2; I < argc; ++I) {
+        std::string_view Arg = argv[I];
+        if (Arg.substr(0, 8) == "-format=") {
+            if (!parseTokenDumpFormat(Arg.substr(8), Format)) {
+                std::cerr << "unknown token dump format '" << Arg.substr(8) << "'" << std::endl;
+                return 1;
+            }
+        } else if (Arg == "-o" && I + 1 < argc) {
+            OutputPath = argv[++I];
+        } else {
+            Inputs.push_back(argv[I]);
+        }
+    }
+    if (Inputs.empty()) {
+        printUsage();
+        return 1;
+    }
+
+    int OutFD = STDOUT_FILENO;
+    if (OutputPath) {
+        OutFD = ::open(OutputPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (OutFD < 0) {
+            std::cerr << "Can not write " << OutputPath << std::endl;
+            return 1;
+        }
+    }
+
+    BufferedWriter OS(OutFD);
+    TokenDumper Dumper(OS, Format);
+    bool Failed = false;
+    std::vector<LoadedFile> Pending(Inputs.size());
+    std::vector<bool> Ready(Inputs.size(), false);
+    unsigned NextIndex = 0;
+    BatchLoader Loader;
+    Loader.load(Inputs, [&](LoadedFile &File) {
+        Ready[File.Index] = true;
+        Pending[File.Index] = std::move(File);
+        for (; NextIndex != Inputs.size() && Ready[NextIndex]; ++NextIndex) {
+            LoadedFile &Next = Pending[NextIndex];
+            if (Next.Errno) {
+                std::cerr << Inputs[NextIndex] << ": " << std::strerror(Next.Errno) << std::endl;
+                Failed = true;
+            } else {
+                Dumper.dumpFile(Inputs[NextIndex], Next.getContents());
+            }
+            Next.Data.reset();
+        }
+    });
+
+    if (!OS.flush()) {
+        std::cerr << "Can not write " << (OutputPath ? OutputPath : "<stdout>") << std::endl;
+        Failed = true;
+    }
+    if (OutFD != STDOUT_FILENO)
+        ::close(OutFD);
+    return Failed ? 1 : 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc >= 2 && std::string_view(argv[1]) == "--server")
+        return runServer(argc, argv);
+    if (argc >= 2 && std::string_view(argv[1]) == "--stream")
+        return runStreaming(argc, argv);
+    if (argc >= 2 && std::string_view(argv[1]) == "--incremental")
+        return runIncremental(argc, argv);
+    if (argc >= 2 && std::string_view(argv[1]) == "--jit")
+        return runJIT(argc, argv);
+    if (argc >= 2 && std::string_view(argv[1]) == "-dump-tokens")
+        return runDumpTokens(argc, argv);
+
+    if (argc != 2) {
+        printUsage();
+        return 1;
+    }
+
+    std::ifstream file(argv[1]);
+    if (!file.is_open()) {
+        std::cerr << "Can not open file" << std::endl;
+        return 1;
+    }
+
     std::stringstream buffer;
     buffer << file.rdbuf();
     std::string content = buffer.str();
@@ -20,11 +274,11 @@ int main() {
     Lexer lexer(content);
     while(true) {
         Token result = lexer.lex();
-        std::cout << result.getTokenName() << result.getText() << std::endl;
+        std::cout << result.getTokenName() << result.getText() << '\n';
         if (result.isEOF()) {
             break;
         }
     }
+    std::cout.flush();
     return 0;
 }
-
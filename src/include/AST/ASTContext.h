@@ -0,0 +1,118 @@
+#ifndef ASTContext_h
+#define ASTContext_h
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string_view>
+#include <vector>
+
+#include "AST/Identifier.h"
+#include "AST/Types.h"
+#include "Basic/Allocator.h"
+#include "Basic/ArrayRef.h"
+
+// ASTContext - Владеет памятью AST и типов одной единицы компиляции.
+//
+// Все типы уникализируются здесь: get*Type() возвращает существующий объект,
+// если структурно такой тип уже создавался, иначе размещает новый в арене.
+// Объекты живут до уничтожения контекста.
+class ASTContext {
+public:
+    // TypeStats - Статистика таблицы типов для -print-stats.
+    struct TypeStats {
+        // NumTypesByKind - Число уникальных типов каждого вида.
+        unsigned NumTypesByKind[NumTypeKinds] = {};
+        unsigned NumUniqueTypes = 0;
+
+        // NumLookups - Все вызовы get*Type(); NumHits - из них найдено
+        // в таблице без создания нового типа.
+        uint64_t NumLookups = 0;
+        uint64_t NumHits = 0;
+        // NumProbes - Суммарное число просмотренных слотов таблицы.
+        uint64_t NumProbes = 0;
+
+        size_t TableCapacity = 0;
+        // BytesInTypes - Память, занятая объектами типов в арене.
+        size_t BytesInTypes = 0;
+    };
+
+private:
+    BumpPtrAllocator Allocator;
+
+    IdentifierTable Identifiers;
+
+    // UniqueTypes - Хеш-таблица с открытой адресацией; nullptr — пустой слот.
+    std::vector<TypeBase *> UniqueTypes;
+    unsigned NumUniqueTypes = 0;
+
+    TypeBase *BuiltinTypes[NumTypeKinds] = {};
+
+    mutable TypeStats Stats;
+
+public:
+    ASTContext();
+    ASTContext(const ASTContext &) = delete;
+    ASTContext &operator=(const ASTContext &) = delete;
+
+    void *allocate(size_t Size, size_t Alignment) {
+        return Allocator.allocate(Size, Alignment);
+    }
+
+    template <typename T>
+    T *allocate(size_t Num = 1) { return Allocator.allocate<T>(Num); }
+
+    // allocateCopy - Копирует массив в арену; результат живёт вместе с AST.
+    template <typename T>
+    ArrayRef<T> allocateCopy(ArrayRef<T> Array) {
+        if (Array.empty())
+            return {};
+        T *Data = allocate<T>(Array.size());
+        std::uninitialized_copy(Array.begin(), Array.end(), Data);
+        return {Data, Array.size()};
+    }
+
+    Identifier getIdentifier(std::string_view Str) { return Identifiers.get(Str); }
+
+    const IdentifierTable &getIdentifierTable() const { return Identifiers; }
+
+    // Встроенные типы создаются вместе с контекстом.
+    #define BUILTIN_TYPE(Id, Name)                                            \
+    BuiltinType *get##Id##Type() const {                                      \
+        return static_cast<BuiltinType *>(                                    \
+            BuiltinTypes[static_cast<unsigned>(TypeKind::Id)]);               \
+    }
+    #include "TypeNodes.def"
+
+    StructType *getStructType(Identifier Name);
+    ClassType *getClassType(Identifier Name);
+    EnumType *getEnumType(Identifier Name);
+
+    FunctionType *getFunctionType(ArrayRef<TypeBase *> Params, TypeBase *Result);
+
+    TupleType *getTupleType(ArrayRef<TypeBase *> Elements);
+
+    TupleType *getVoidType() { return getTupleType({}); }
+
+    InOutType *getInOutType(TypeBase *ObjectType);
+
+    const TypeStats &getTypeStats() const;
+
+    // getTotalMemory - Вся память арены (AST, типы, служебные массивы).
+    size_t getTotalMemory() const {
+        return Allocator.getTotalMemory() + Identifiers.getMemoryUsage() +
+               UniqueTypes.capacity() * sizeof(TypeBase *);
+    }
+
+    void printStats(std::ostream &OS) const;
+
+private:
+    // getUniqueType - Ищет тип (Kind, Operands) в таблице и создаёт его,
+    // если такого ещё нет.
+    TypeBase *getUniqueType(TypeKind Kind, ArrayRef<void *> Operands);
+
+    void growTypeTable();
+};
+
+#endif
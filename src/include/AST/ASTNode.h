@@ -0,0 +1,90 @@
+#ifndef ASTNode_h
+#define ASTNode_h
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+#include "AST/ASTContext.h"
+#include "Basic/Casting.h"
+
+enum class NodeKind : uint8_t {
+  #define NODE(Class, Parent) Class,
+  #include "ASTNodes.def"
+};
+
+constexpr unsigned NumNodeKinds = 0
+  #define NODE(Class, Parent) + 1
+  #include "ASTNodes.def"
+  ;
+
+// Node - Базовый класс объявлений, операторов и выражений.
+//
+// Виртуальных функций нет: вид узла хранится в Kind, обход и диспетчеризация
+// идут через ASTVisitor/ASTWalker, которые разворачиваются в switch по
+// списку из ASTNodes.def. Узлы размещаются в арене ASTContext и не
+// удаляются по одному.
+class Node {
+    NodeKind Kind;
+
+protected:
+    explicit Node(NodeKind kind) : Kind(kind) {}
+
+public:
+    Node(const Node &) = delete;
+    Node &operator=(const Node &) = delete;
+
+    NodeKind getKind() const { return Kind; }
+
+    static const char *getKindName(NodeKind Kind);
+
+    // dump - Печатает поддерево в виде S-выражения с отступами.
+    void dump(std::ostream &OS) const;
+
+    void *operator new(size_t Size, ASTContext &Ctx, size_t Alignment = alignof(void *)) {
+        return Ctx.allocate(Size, Alignment);
+    }
+    void operator delete(void *, ASTContext &, size_t) {}
+    void *operator new(size_t) = delete;
+    void operator delete(void *) = delete;
+};
+
+#define NODE_RANGE(Class, First, Last)                                        \
+  inline bool is##Class##Kind(NodeKind K) {                                   \
+      return K >= NodeKind::First && K <= NodeKind::Last;                     \
+  }
+#include "ASTNodes.def"
+
+// Decl - Объявление.
+class Decl : public Node {
+protected:
+    using Node::Node;
+
+public:
+    static bool classof(const Node *N) { return isDeclKind(N->getKind()); }
+};
+
+// Stmt - Оператор.
+class Stmt : public Node {
+protected:
+    using Node::Node;
+
+public:
+    static bool classof(const Node *N) { return isStmtKind(N->getKind()); }
+};
+
+// Expr - Выражение. Тип проставляет семантический анализ.
+class Expr : public Node {
+    TypeBase *Ty = nullptr;
+
+protected:
+    using Node::Node;
+
+public:
+    TypeBase *getType() const { return Ty; }
+    void setType(TypeBase *T) { Ty = T; }
+
+    static bool classof(const Node *N) { return isExprKind(N->getKind()); }
+};
+
+#endif
@@ -0,0 +1,116 @@
+#ifndef ASTVisitor_h
+#define ASTVisitor_h
+
+#include <cassert>
+
+#include "AST/Decl.h"
+#include "AST/Expr.h"
+#include "AST/Stmt.h"
+
+// ASTVisitor - Статическая диспетчеризация по виду узла (CRTP).
+//
+// visit() разворачивается в один switch по NodeKind из ASTNodes.def и
+// вызывает visit##Class() наследника без виртуальных вызовов. Если
+// наследник не определил visit##Class(), вызов поднимается к родителю по
+// иерархии: visitVarDecl -> visitValueDecl -> visitDecl -> visitNode.
+// visitNode по умолчанию возвращает RetTy().
+template <typename ImplClass, typename RetTy = void, typename... ArgTys>
+class ASTVisitor {
+    ImplClass &impl() { return static_cast<ImplClass &>(*this); }
+
+public:
+    RetTy visit(Node *N, ArgTys... Args) {
+        switch (N->getKind()) {
+        #define NODE(Class, Parent)                                           \
+        case NodeKind::Class:                                                 \
+            return impl().visit##Class(static_cast<Class *>(N), Args...);
+        #include "AST/ASTNodes.def"
+        }
+        assert(false && "Unknown node kind");
+        return RetTy();
+    }
+
+    RetTy visitNode(Node *, ArgTys...) { return RetTy(); }
+
+    #define NODE(Class, Parent)                                               \
+    RetTy visit##Class(Class *N, ArgTys... Args) {                            \
+        return impl().visit##Parent(N, Args...);                              \
+    }
+    #define ABSTRACT_NODE(Class, Parent) NODE(Class, Parent)
+    #include "AST/ASTNodes.def"
+};
+
+namespace detail {
+
+// ChildEnumerator - Перечисляет непосредственных детей узла в порядке
+// исходного текста; отсутствующие (nullptr) пропускаются. Листья попадают
+// в visitNode и детей не имеют.
+template <typename Fn>
+class ChildEnumerator : public ASTVisitor<ChildEnumerator<Fn>> {
+    Fn &Callback;
+
+    void child(Node *N) {
+        if (N)
+            Callback(N);
+    }
+    template <typename T>
+    void children(ArrayRef<T *> Nodes) {
+        for (T *N : Nodes)
+            child(N);
+    }
+
+public:
+    explicit ChildEnumerator(Fn &callback) : Callback(callback) {}
+
+    void visitVarDecl(VarDecl *D) { child(D->getInit()); }
+    void visitFuncDecl(FuncDecl *D) {
+        children(D->getParams());
+        child(D->getBody());
+    }
+    void visitStructDecl(StructDecl *D) { children(D->getMembers()); }
+
+    void visitBraceStmt(BraceStmt *S) { children(S->getElements()); }
+    void visitReturnStmt(ReturnStmt *S) { child(S->getResult()); }
+    void visitIfStmt(IfStmt *S) {
+        child(S->getCond());
+        child(S->getThen());
+        child(S->getElse());
+    }
+    void visitWhileStmt(WhileStmt *S) {
+        child(S->getCond());
+        child(S->getBody());
+    }
+    void visitForInStmt(ForInStmt *S) {
+        child(S->getVar());
+        child(S->getSequence());
+        child(S->getBody());
+    }
+
+    void visitMemberRefExpr(MemberRefExpr *E) { child(E->getBase()); }
+    void visitUnaryExpr(UnaryExpr *E) { child(E->getOperand()); }
+    void visitBinaryExpr(BinaryExpr *E) {
+        child(E->getLHS());
+        child(E->getRHS());
+    }
+    void visitAssignExpr(AssignExpr *E) {
+        child(E->getDest());
+        child(E->getSource());
+    }
+    void visitCallExpr(CallExpr *E) {
+        child(E->getCallee());
+        children(E->getArgs());
+    }
+    void visitTupleExpr(TupleExpr *E) { children(E->getElements()); }
+    void visitInOutExpr(InOutExpr *E) { child(E->getSubExpr()); }
+};
+
+} // namespace detail
+
+// forEachChild - Вызывает Callback(Node *) для каждого непосредственного
+// ребёнка N.
+template <typename Fn>
+void forEachChild(Node *N, Fn Callback) {
+    detail::ChildEnumerator<Fn>(Callback).visit(N);
+}
+
+#endif
@@ -0,0 +1,50 @@
+#ifndef ASTWalker_h
+#define ASTWalker_h
+
+#include "AST/ASTVisitor.h"
+
+// ASTWalker - Обход поддерева в глубину с хуками до и после детей (CRTP).
+//
+// walkTo*Pre() вызывается перед детьми узла; false — не спускаться в них
+// (post-хук тогда тоже не вызывается). walkTo*Post() вызывается после
+// детей. Хуки выбираются по категории узла статически, наследник
+// переопределяет только нужные.
+template <typename ImplClass>
+class ASTWalker {
+    ImplClass &impl() { return static_cast<ImplClass &>(*this); }
+
+public:
+    bool walkToDeclPre(Decl *) { return true; }
+    void walkToDeclPost(Decl *) {}
+    bool walkToStmtPre(Stmt *) { return true; }
+    void walkToStmtPost(Stmt *) {}
+    bool walkToExprPre(Expr *) { return true; }
+    void walkToExprPost(Expr *) {}
+
+    void walk(Node *N) {
+        if (!pre(N))
+            return;
+        forEachChild(N, [this](Node *Child) { walk(Child); });
+        post(N);
+    }
+
+private:
+    bool pre(Node *N) {
+        if (isDeclKind(N->getKind()))
+            return impl().walkToDeclPre(static_cast<Decl *>(N));
+        if (isStmtKind(N->getKind()))
+            return impl().walkToStmtPre(static_cast<Stmt *>(N));
+        return impl().walkToExprPre(static_cast<Expr *>(N));
+    }
+
+    void post(Node *N) {
+        if (isDeclKind(N->getKind()))
+            impl().walkToDeclPost(static_cast<Decl *>(N));
+        else if (isStmtKind(N->getKind()))
+            impl().walkToStmtPost(static_cast<Stmt *>(N));
+        else
+            impl().walkToExprPost(static_cast<Expr *>(N));
+    }
+};
+
+#endif
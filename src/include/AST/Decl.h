@@ -0,0 +1,89 @@
+#ifndef Decl_h
+#define Decl_h
+
+#include "AST/ASTNode.h"
+#include "AST/Identifier.h"
+#include "Basic/ArrayRef.h"
+
+class BraceStmt;
+
+// ValueDecl - Именованное объявление, у которого есть тип.
+class ValueDecl : public Decl {
+    Identifier Name;
+    TypeBase *Ty;
+
+protected:
+    ValueDecl(NodeKind kind, Identifier name, TypeBase *ty)
+        : Decl(kind), Name(name), Ty(ty) {}
+
+public:
+    Identifier getName() const { return Name; }
+
+    TypeBase *getType() const { return Ty; }
+    void setType(TypeBase *T) { Ty = T; }
+
+    static bool classof(const Node *N) { return isValueDeclKind(N->getKind()); }
+};
+
+// VarDecl - "var x: T = init" или "let x = init".
+class VarDecl : public ValueDecl {
+    bool IsLet;
+    Expr *Init;
+
+public:
+    VarDecl(Identifier name, bool isLet, TypeBase *ty = nullptr, Expr *init = nullptr)
+        : ValueDecl(NodeKind::VarDecl, name, ty), IsLet(isLet), Init(init) {}
+
+    bool isLet() const { return IsLet; }
+
+    Expr *getInit() const { return Init; }
+    void setInit(Expr *E) { Init = E; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::VarDecl; }
+};
+
+// ParamDecl - Параметр функции.
+class ParamDecl : public ValueDecl {
+    bool IsInOut;
+
+public:
+    ParamDecl(Identifier name, TypeBase *ty, bool isInOut = false)
+        : ValueDecl(NodeKind::ParamDecl, name, ty), IsInOut(isInOut) {}
+
+    bool isInOut() const { return IsInOut; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::ParamDecl; }
+};
+
+// FuncDecl - Функция. Параметры лежат в арене ASTContext.
+class FuncDecl : public ValueDecl {
+    ArrayRef<ParamDecl *> Params;
+    BraceStmt *Body;
+
+public:
+    FuncDecl(Identifier name, ArrayRef<ParamDecl *> params, BraceStmt *body,
+             TypeBase *ty = nullptr)
+        : ValueDecl(NodeKind::FuncDecl, name, ty), Params(params), Body(body) {}
+
+    ArrayRef<ParamDecl *> getParams() const { return Params; }
+
+    BraceStmt *getBody() const { return Body; }
+    void setBody(BraceStmt *S) { Body = S; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::FuncDecl; }
+};
+
+// StructDecl - Структура: поля и методы.
+class StructDecl : public ValueDecl {
+    ArrayRef<Decl *> Members;
+
+public:
+    StructDecl(Identifier name, ArrayRef<Decl *> members, TypeBase *ty = nullptr)
+        : ValueDecl(NodeKind::StructDecl, name, ty), Members(members) {}
+
+    ArrayRef<Decl *> getMembers() const { return Members; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::StructDecl; }
+};
+
+#endif
@@ -0,0 +1,198 @@
+#ifndef Expr_h
+#define Expr_h
+
+#include <cstdint>
+#include <string_view>
+
+#include "AST/ASTNode.h"
+#include "AST/Identifier.h"
+#include "Basic/ArrayRef.h"
+
+class ValueDecl;
+
+// LiteralExpr - Литерал.
+class LiteralExpr : public Expr {
+protected:
+    using Expr::Expr;
+
+public:
+    static bool classof(const Node *N) { return isLiteralExprKind(N->getKind()); }
+};
+
+class IntegerLiteralExpr : public LiteralExpr {
+    int64_t Value;
+
+public:
+    explicit IntegerLiteralExpr(int64_t value)
+        : LiteralExpr(NodeKind::IntegerLiteralExpr), Value(value) {}
+
+    int64_t getValue() const { return Value; }
+
+    static bool classof(const Node *N) {
+        return N->getKind() == NodeKind::IntegerLiteralExpr;
+    }
+};
+
+class FloatLiteralExpr : public LiteralExpr {
+    double Value;
+
+public:
+    explicit FloatLiteralExpr(double value)
+        : LiteralExpr(NodeKind::FloatLiteralExpr), Value(value) {}
+
+    double getValue() const { return Value; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::FloatLiteralExpr; }
+};
+
+class BooleanLiteralExpr : public LiteralExpr {
+    bool Value;
+
+public:
+    explicit BooleanLiteralExpr(bool value)
+        : LiteralExpr(NodeKind::BooleanLiteralExpr), Value(value) {}
+
+    bool getValue() const { return Value; }
+
+    static bool classof(const Node *N) {
+        return N->getKind() == NodeKind::BooleanLiteralExpr;
+    }
+};
+
+// StringLiteralExpr - Строковый литерал; текст должен жить в арене
+// ASTContext или в буфере исходника.
+class StringLiteralExpr : public LiteralExpr {
+    std::string_view Value;
+
+public:
+    explicit StringLiteralExpr(std::string_view value)
+        : LiteralExpr(NodeKind::StringLiteralExpr), Value(value) {}
+
+    std::string_view getValue() const { return Value; }
+
+    static bool classof(const Node *N) {
+        return N->getKind() == NodeKind::StringLiteralExpr;
+    }
+};
+
+// DeclRefExpr - Ссылка на объявление по имени. Decl проставляет Sema.
+class DeclRefExpr : public Expr {
+    Identifier Name;
+    ValueDecl *D;
+
+public:
+    explicit DeclRefExpr(Identifier name, ValueDecl *d = nullptr)
+        : Expr(NodeKind::DeclRefExpr), Name(name), D(d) {}
+
+    Identifier getName() const { return Name; }
+
+    ValueDecl *getDecl() const { return D; }
+    void setDecl(ValueDecl *VD) { D = VD; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::DeclRefExpr; }
+};
+
+// MemberRefExpr - "base.member".
+class MemberRefExpr : public Expr {
+    Expr *Base;
+    Identifier Member;
+
+public:
+    MemberRefExpr(Expr *base, Identifier member)
+        : Expr(NodeKind::MemberRefExpr), Base(base), Member(member) {}
+
+    Expr *getBase() const { return Base; }
+    Identifier getMember() const { return Member; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::MemberRefExpr; }
+};
+
+// UnaryExpr - Префиксный оператор. Оператор хранится по имени, как функция
+// в Swift: "-", "!".
+class UnaryExpr : public Expr {
+    Identifier Op;
+    Expr *Operand;
+
+public:
+    UnaryExpr(Identifier op, Expr *operand)
+        : Expr(NodeKind::UnaryExpr), Op(op), Operand(operand) {}
+
+    Identifier getOperator() const { return Op; }
+    Expr *getOperand() const { return Operand; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::UnaryExpr; }
+};
+
+// BinaryExpr - Инфиксный оператор "lhs op rhs".
+class BinaryExpr : public Expr {
+    Identifier Op;
+    Expr *LHS;
+    Expr *RHS;
+
+public:
+    BinaryExpr(Identifier op, Expr *lhs, Expr *rhs)
+        : Expr(NodeKind::BinaryExpr), Op(op), LHS(lhs), RHS(rhs) {}
+
+    Identifier getOperator() const { return Op; }
+    Expr *getLHS() const { return LHS; }
+    Expr *getRHS() const { return RHS; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::BinaryExpr; }
+};
+
+// AssignExpr - "dest = source".
+class AssignExpr : public Expr {
+    Expr *Dest;
+    Expr *Source;
+
+public:
+    AssignExpr(Expr *dest, Expr *source)
+        : Expr(NodeKind::AssignExpr), Dest(dest), Source(source) {}
+
+    Expr *getDest() const { return Dest; }
+    Expr *getSource() const { return Source; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::AssignExpr; }
+};
+
+// CallExpr - "callee(args)". Аргументы лежат в арене ASTContext.
+class CallExpr : public Expr {
+    Expr *Callee;
+    ArrayRef<Expr *> Args;
+
+public:
+    CallExpr(Expr *callee, ArrayRef<Expr *> args)
+        : Expr(NodeKind::CallExpr), Callee(callee), Args(args) {}
+
+    Expr *getCallee() const { return Callee; }
+    ArrayRef<Expr *> getArgs() const { return Args; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::CallExpr; }
+};
+
+// TupleExpr - "(a, b, c)".
+class TupleExpr : public Expr {
+    ArrayRef<Expr *> Elements;
+
+public:
+    explicit TupleExpr(ArrayRef<Expr *> elements)
+        : Expr(NodeKind::TupleExpr), Elements(elements) {}
+
+    ArrayRef<Expr *> getElements() const { return Elements; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::TupleExpr; }
+};
+
+// InOutExpr - "&x" в аргументе inout-параметра.
+class InOutExpr : public Expr {
+    Expr *SubExpr;
+
+public:
+    explicit InOutExpr(Expr *subExpr) : Expr(NodeKind::InOutExpr), SubExpr(subExpr) {}
+
+    Expr *getSubExpr() const { return SubExpr; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::InOutExpr; }
+};
+
+#endif
@@ -0,0 +1,77 @@
+#ifndef FlatAST_h
+#define FlatAST_h
+
+#include <cstdint>
+#include <vector>
+
+#include "AST/ASTNode.h"
+#include "AST/Identifier.h"
+
+// FlatNode - Узел в плоской раскладке. SubtreeSize включает сам узел.
+//
+// Вид узла и его главный операнд лежат прямо в записи, поэтому проходу,
+// которому их хватает (поиск ссылок на имя, подсчёт операторов и
+// литералов), не нужно читать сам узел из кучи. За остальным — через N.
+struct FlatNode {
+    Node *N;
+    union {
+        // Name - Имя у DeclRefExpr и объявлений, оператор у UnaryExpr и
+        // BinaryExpr, член у MemberRefExpr; у прочих узлов nullptr.
+        const void *Name;
+        // IntValue - Значение IntegerLiteralExpr, 0/1 у BooleanLiteralExpr.
+        int64_t IntValue;
+    };
+    NodeKind Kind;
+    uint32_t SubtreeSize;
+    // Parent - Индекс родителя; у корня NoParent.
+    uint32_t Parent;
+
+    Identifier getName() const { return Identifier::getFromOpaquePointer(Name); }
+};
+
+static_assert(sizeof(void *) != 8 || sizeof(FlatNode) == 32, "FlatNode grew");
+
+// FlatBody - Поддерево (обычно тело функции), разложенное в массив в
+// post-order: дети идут раньше родителя, поддерево узла I занимает
+// отрезок [I - SubtreeSize + 1, I].
+//
+// Проходы, которым не важна вложенность (сбор статистики, поиск ссылок,
+// проверки по всем выражениям), идут по массиву линейно, без рекурсии и
+// без переходов по указателям детей; если им хватает полей FlatNode, то и
+// без обращений к узлам. Раскладка — снимок: после изменения дерева её
+// нужно построить заново.
+class FlatBody {
+    std::vector<FlatNode> Nodes;
+
+public:
+    static constexpr uint32_t NoParent = ~0u;
+
+    static FlatBody build(Node *Root);
+
+    using iterator = std::vector<FlatNode>::const_iterator;
+    iterator begin() const { return Nodes.begin(); }
+    iterator end() const { return Nodes.end(); }
+
+    uint32_t size() const { return static_cast<uint32_t>(Nodes.size()); }
+    bool empty() const { return Nodes.empty(); }
+
+    const FlatNode &operator[](uint32_t Index) const { return Nodes[Index]; }
+
+    // getRootIndex - Корень лежит последним.
+    uint32_t getRootIndex() const { return size() - 1; }
+
+    // getChildren - Индексы непосредственных детей в порядке исходного текста.
+    std::vector<uint32_t> getChildren(uint32_t Index) const;
+
+    // visitPostOrder - Вызывает V.visit(Node *) для всех узлов в post-order;
+    // V — ASTVisitor или любой объект с таким методом. Визитор получает
+    // сам узел и читает его из кучи; линейный проход по полям FlatNode
+    // этого не делает.
+    template <typename VisitorT>
+    void visitPostOrder(VisitorT &V) const {
+        for (const FlatNode &Entry : Nodes)
+            V.visit(Entry.N);
+    }
+};
+
+#endif
@@ -0,0 +1,78 @@
+#ifndef Identifier_h
+#define Identifier_h
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <unordered_set>
+
+#include "Basic/Allocator.h"
+
+// Identifier - Интернированное имя. Каждая уникальная строка хранится в
+// IdentifierTable ровно один раз, поэтому сравнение двух Identifier — это
+// сравнение указателей, а хеш — хеш указателя.
+class Identifier {
+    friend class IdentifierTable;
+
+    // Pointer - NUL-terminated строка в арене IdentifierTable.
+    // Перед строкой лежит её длина (uint32_t).
+    const char *Pointer = nullptr;
+
+    explicit Identifier(const char *Ptr) : Pointer(Ptr) {}
+
+public:
+    Identifier() = default;
+
+    const char *get() const { return Pointer; }
+
+    std::string_view str() const {
+        if (!Pointer)
+            return {};
+        uint32_t Length;
+        std::memcpy(&Length, Pointer - sizeof(uint32_t), sizeof(uint32_t));
+        return {Pointer, Length};
+    }
+
+    bool empty() const { return Pointer == nullptr; }
+
+    bool operator==(Identifier RHS) const { return Pointer == RHS.Pointer; }
+    bool operator!=(Identifier RHS) const { return Pointer != RHS.Pointer; }
+
+    const void *getAsOpaquePointer() const { return Pointer; }
+
+    static Identifier getFromOpaquePointer(const void *Ptr) {
+        return Identifier(static_cast<const char *>(Ptr));
+    }
+};
+
+namespace std {
+template <> struct hash<Identifier> {
+    size_t operator()(Identifier Id) const {
+        return hash<const void *>()(Id.getAsOpaquePointer());
+    }
+};
+} // namespace std
+
+// IdentifierTable - Владеет памятью всех интернированных имён.
+class IdentifierTable {
+    BumpPtrAllocator Allocator;
+
+    // Ключи указывают на строки внутри Allocator.
+    std::unordered_set<std::string_view> Table;
+
+public:
+    IdentifierTable() = default;
+    IdentifierTable(const IdentifierTable &) = delete;
+    IdentifierTable &operator=(const IdentifierTable &) = delete;
+
+    // get - Возвращает Identifier для строки, интернируя её при первом
+    // обращении. Пустая строка даёт пустой Identifier.
+    Identifier get(std::string_view Str);
+
+    size_t size() const { return Table.size(); }
+
+    size_t getMemoryUsage() const { return Allocator.getTotalMemory(); }
+};
+
+#endif
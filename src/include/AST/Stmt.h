@@ -0,0 +1,101 @@
+#ifndef Stmt_h
+#define Stmt_h
+
+#include "AST/ASTNode.h"
+#include "Basic/ArrayRef.h"
+
+class VarDecl;
+
+// BraceStmt - Блок "{ ... }". Элементы — объявления, операторы и
+// выражения вперемешку, как в исходном тексте.
+class BraceStmt : public Stmt {
+    ArrayRef<Node *> Elements;
+
+public:
+    explicit BraceStmt(ArrayRef<Node *> elements)
+        : Stmt(NodeKind::BraceStmt), Elements(elements) {}
+
+    ArrayRef<Node *> getElements() const { return Elements; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::BraceStmt; }
+};
+
+// ReturnStmt - "return" с необязательным результатом.
+class ReturnStmt : public Stmt {
+    Expr *Result;
+
+public:
+    explicit ReturnStmt(Expr *result = nullptr)
+        : Stmt(NodeKind::ReturnStmt), Result(result) {}
+
+    Expr *getResult() const { return Result; }
+    bool hasResult() const { return Result != nullptr; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::ReturnStmt; }
+};
+
+// IfStmt - "if cond { ... } else ...". Else — BraceStmt, IfStmt или nullptr.
+class IfStmt : public Stmt {
+    Expr *Cond;
+    Stmt *Then;
+    Stmt *Else;
+
+public:
+    IfStmt(Expr *cond, Stmt *then, Stmt *elseStmt = nullptr)
+        : Stmt(NodeKind::IfStmt), Cond(cond), Then(then), Else(elseStmt) {}
+
+    Expr *getCond() const { return Cond; }
+    Stmt *getThen() const { return Then; }
+    Stmt *getElse() const { return Else; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::IfStmt; }
+};
+
+// WhileStmt - "while cond { ... }".
+class WhileStmt : public Stmt {
+    Expr *Cond;
+    Stmt *Body;
+
+public:
+    WhileStmt(Expr *cond, Stmt *body) : Stmt(NodeKind::WhileStmt), Cond(cond), Body(body) {}
+
+    Expr *getCond() const { return Cond; }
+    Stmt *getBody() const { return Body; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::WhileStmt; }
+};
+
+// ForInStmt - "for x in sequence { ... }".
+class ForInStmt : public Stmt {
+    VarDecl *Var;
+    Expr *Sequence;
+    Stmt *Body;
+
+public:
+    ForInStmt(VarDecl *var, Expr *sequence, Stmt *body)
+        : Stmt(NodeKind::ForInStmt), Var(var), Sequence(sequence), Body(body) {}
+
+    VarDecl *getVar() const { return Var; }
+    Expr *getSequence() const { return Sequence; }
+    Stmt *getBody() const { return Body; }
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::ForInStmt; }
+};
+
+// BreakStmt - "break".
+class BreakStmt : public Stmt {
+public:
+    BreakStmt() : Stmt(NodeKind::BreakStmt) {}
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::BreakStmt; }
+};
+
+// ContinueStmt - "continue".
+class ContinueStmt : public Stmt {
+public:
+    ContinueStmt() : Stmt(NodeKind::ContinueStmt) {}
+
+    static bool classof(const Node *N) { return N->getKind() == NodeKind::ContinueStmt; }
+};
+
+#endif
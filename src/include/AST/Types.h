@@ -0,0 +1,176 @@
+#ifndef Types_h
+#define Types_h
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+
+#include "AST/Identifier.h"
+#include "Basic/ArrayRef.h"
+#include "Basic/Casting.h"
+
+class ASTContext;
+
+enum class TypeKind : uint8_t {
+  #define TYPE(Id, Parent) Id,
+  #include "TypeNodes.def"
+};
+
+constexpr unsigned NumTypeKinds = 0
+  #define TYPE(Id, Parent) + 1
+  #include "TypeNodes.def"
+  ;
+
+// TypeBase - Базовый класс всех типов.
+//
+// Типы хеш-консятся в ASTContext: структурно одинаковые типы — это один и тот
+// же объект, поэтому равенство типов — сравнение указателей, а TypeBase*
+// можно использовать как ключ в хеш-таблицах.
+//
+// Структура типа целиком описывается видом и массивом операндов, который
+// лежит сразу за объектом в арене ASTContext (имя для nominal-типов,
+// элементы кортежа, параметры и результат функции). Подклассы не добавляют
+// полей, а только интерпретируют операнды.
+class TypeBase {
+    friend class ASTContext;
+
+    TypeKind Kind;
+    uint32_t NumOperands;
+    // Hash - Структурный хеш, посчитанный при создании; нужен только
+    // таблице уникализации в ASTContext.
+    size_t Hash;
+
+protected:
+    TypeBase(TypeKind kind, uint32_t numOperands, size_t hash)
+        : Kind(kind), NumOperands(numOperands), Hash(hash) {}
+
+    void *const *getOperandStorage() const {
+        return reinterpret_cast<void *const *>(
+            reinterpret_cast<const char *>(this) + sizeof(TypeBase));
+    }
+
+    ArrayRef<void *> getOperands() const {
+        return {getOperandStorage(), NumOperands};
+    }
+
+public:
+    TypeBase(const TypeBase &) = delete;
+    TypeBase &operator=(const TypeBase &) = delete;
+
+    TypeKind getKind() const { return Kind; }
+
+    size_t getHash() const { return Hash; }
+
+    void print(std::ostream &OS) const;
+
+    std::string getString() const;
+};
+
+// BuiltinType - Int, Double, Bool, String.
+class BuiltinType : public TypeBase {
+    friend class ASTContext;
+    using TypeBase::TypeBase;
+
+public:
+    std::string_view getName() const;
+
+    static bool classof(const TypeBase *T) {
+        switch (T->getKind()) {
+          #define BUILTIN_TYPE(Id, Name) case TypeKind::Id: return true;
+          #include "TypeNodes.def"
+        default:
+          return false;
+        }
+    }
+};
+
+// NominalType - Тип, объявленный через struct/class/enum.
+class NominalType : public TypeBase {
+    friend class ASTContext;
+
+protected:
+    using TypeBase::TypeBase;
+
+public:
+    Identifier getName() const {
+        return Identifier::getFromOpaquePointer(getOperandStorage()[0]);
+    }
+
+    static bool classof(const TypeBase *T) {
+        switch (T->getKind()) {
+          #define NOMINAL_TYPE(Id, Parent) case TypeKind::Id: return true;
+          #include "TypeNodes.def"
+        default:
+          return false;
+        }
+    }
+};
+
+#define NOMINAL_TYPE(Id, Parent)                                              \
+  class Id##Type : public Parent {                                            \
+      friend class ASTContext;                                                \
+      using Parent::Parent;                                                   \
+                                                                              \
+  public:                                                                     \
+      static bool classof(const TypeBase *T) {                                \
+          return T->getKind() == TypeKind::Id;                                \
+      }                                                                       \
+  };
+#include "TypeNodes.def"
+
+// FunctionType - (Params...) -> Result. Параметры inout представлены
+// InOutType.
+class FunctionType : public TypeBase {
+    friend class ASTContext;
+    using TypeBase::TypeBase;
+
+public:
+    TypeBase *getResult() const {
+        return static_cast<TypeBase *>(getOperandStorage()[0]);
+    }
+
+    ArrayRef<TypeBase *> getParams() const {
+        return {reinterpret_cast<TypeBase *const *>(getOperandStorage() + 1),
+                getOperands().size() - 1};
+    }
+
+    static bool classof(const TypeBase *T) {
+        return T->getKind() == TypeKind::Function;
+    }
+};
+
+// TupleType - (A, B, ...). Пустой кортеж — это Void.
+class TupleType : public TypeBase {
+    friend class ASTContext;
+    using TypeBase::TypeBase;
+
+public:
+    ArrayRef<TypeBase *> getElements() const {
+        return {reinterpret_cast<TypeBase *const *>(getOperandStorage()),
+                getOperands().size()};
+    }
+
+    bool isVoid() const { return getOperands().empty(); }
+
+    static bool classof(const TypeBase *T) {
+        return T->getKind() == TypeKind::Tuple;
+    }
+};
+
+// InOutType - Тип параметра `inout T`.
+class InOutType : public TypeBase {
+    friend class ASTContext;
+    using TypeBase::TypeBase;
+
+public:
+    TypeBase *getObjectType() const {
+        return static_cast<TypeBase *>(getOperandStorage()[0]);
+    }
+
+    static bool classof(const TypeBase *T) {
+        return T->getKind() == TypeKind::InOut;
+    }
+};
+
+#endif
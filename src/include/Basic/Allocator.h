@@ -0,0 +1,108 @@
+#ifndef Allocator_h
+#define Allocator_h
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+// BumpPtrAllocator - Арена: память выделяется последовательно из крупных
+// слэбов и освобождается целиком вместе с аллокатором.
+// Деструкторы размещённых объектов не вызываются.
+class BumpPtrAllocator {
+    static constexpr size_t DefaultSlabSize = 4096 * 4;
+
+    std::vector<void *> Slabs;
+    std::vector<void *> CustomSizedSlabs;
+
+    char *CurPtr = nullptr;
+    char *End = nullptr;
+
+    size_t SlabSize;
+
+    // BytesAllocated - Сумма размеров всех запросов (без учёта выравнивания).
+    size_t BytesAllocated = 0;
+
+    size_t CustomSizedBytes = 0;
+
+public:
+    explicit BumpPtrAllocator(size_t slabSize = DefaultSlabSize)
+        : SlabSize(slabSize) {}
+
+    BumpPtrAllocator(const BumpPtrAllocator &) = delete;
+    BumpPtrAllocator &operator=(const BumpPtrAllocator &) = delete;
+
+    ~BumpPtrAllocator() { reset(); }
+
+    void *allocate(size_t Size, size_t Alignment) {
+        assert(Alignment && (Alignment & (Alignment - 1)) == 0 &&
+               "Alignment is not a power of two");
+        BytesAllocated += Size;
+
+        uintptr_t Aligned = alignAddr(CurPtr, Alignment);
+        if (CurPtr && Aligned + Size <= reinterpret_cast<uintptr_t>(End)) {
+            CurPtr = reinterpret_cast<char *>(Aligned + Size);
+            return reinterpret_cast<void *>(Aligned);
+        }
+
+        // Большие запросы получают собственный слэб, чтобы не тратить
+        // остаток текущего.
+        size_t PaddedSize = Size + Alignment - 1;
+        if (PaddedSize > SlabSize) {
+            void *Slab = std::malloc(PaddedSize);
+            if (!Slab)
+                throw std::bad_alloc();
+            CustomSizedSlabs.push_back(Slab);
+            CustomSizedBytes += PaddedSize;
+            return reinterpret_cast<void *>(alignAddr(Slab, Alignment));
+        }
+
+        startNewSlab();
+        Aligned = alignAddr(CurPtr, Alignment);
+        CurPtr = reinterpret_cast<char *>(Aligned + Size);
+        return reinterpret_cast<void *>(Aligned);
+    }
+
+    template <typename T>
+    T *allocate(size_t Num = 1) {
+        return static_cast<T *>(allocate(Num * sizeof(T), alignof(T)));
+    }
+
+    void reset() {
+        for (void *Slab : Slabs)
+            std::free(Slab);
+        for (void *Slab : CustomSizedSlabs)
+            std::free(Slab);
+        Slabs.clear();
+        CustomSizedSlabs.clear();
+        CurPtr = End = nullptr;
+        BytesAllocated = 0;
+        CustomSizedBytes = 0;
+    }
+
+    size_t getBytesAllocated() const { return BytesAllocated; }
+
+    // getTotalMemory - Память, реально запрошенная у системы.
+    size_t getTotalMemory() const {
+        return Slabs.size() * SlabSize + CustomSizedBytes;
+    }
+
+private:
+    static uintptr_t alignAddr(const void *Ptr, size_t Alignment) {
+        uintptr_t Addr = reinterpret_cast<uintptr_t>(Ptr);
+        return (Addr + Alignment - 1) & ~uintptr_t(Alignment - 1);
+    }
+
+    void startNewSlab() {
+        void *Slab = std::malloc(SlabSize);
+        if (!Slab)
+            throw std::bad_alloc();
+        Slabs.push_back(Slab);
+        CurPtr = static_cast<char *>(Slab);
+        End = CurPtr + SlabSize;
+    }
+};
+
+#endif
@@ -0,0 +1,68 @@
+#ifndef ArrayRef_h
+#define ArrayRef_h
+
+#include <cassert>
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+// ArrayRef - Невладеющая ссылка на непрерывный массив элементов.
+// Данные должны жить дольше самой ArrayRef.
+template <typename T>
+class ArrayRef {
+    const T *Data = nullptr;
+    size_t Length = 0;
+
+public:
+    using iterator = const T *;
+
+    ArrayRef() = default;
+    ArrayRef(const T *data, size_t length) : Data(data), Length(length) {}
+    ArrayRef(const T &OneElt) : Data(&OneElt), Length(1) {}
+    ArrayRef(const std::vector<T> &Vec) : Data(Vec.data()), Length(Vec.size()) {}
+    // Список инициализации живёт до конца полного выражения, поэтому такая
+    // ArrayRef годится только как аргумент вызова.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Winit-list-lifetime"
+#endif
+    ArrayRef(std::initializer_list<T> List)
+        : Data(List.begin() == List.end() ? nullptr : List.begin()),
+          Length(List.size()) {}
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+    iterator begin() const { return Data; }
+    iterator end() const { return Data + Length; }
+
+    const T *data() const { return Data; }
+    size_t size() const { return Length; }
+    bool empty() const { return Length == 0; }
+
+    const T &operator[](size_t Index) const {
+        assert(Index < Length && "Invalid index!");
+        return Data[Index];
+    }
+
+    const T &front() const { return (*this)[0]; }
+    const T &back() const { return (*this)[Length - 1]; }
+
+    ArrayRef slice(size_t Start) const {
+        assert(Start <= Length && "Invalid slice!");
+        return ArrayRef(Data + Start, Length - Start);
+    }
+
+    bool equals(ArrayRef RHS) const {
+        if (Length != RHS.Length)
+            return false;
+        for (size_t I = 0; I != Length; ++I)
+            if (!(Data[I] == RHS.Data[I]))
+                return false;
+        return true;
+    }
+
+    std::vector<T> vec() const { return std::vector<T>(begin(), end()); }
+};
+
+#endif
@@ -0,0 +1,131 @@
+#ifndef BufferedWriter_h
+#define BufferedWriter_h
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string_view>
+#include <unistd.h>
+
+// BufferedWriter - Запись в файловый дескриптор через большой буфер.
+//
+// Системный вызов делается, только когда буфер заполнен, при flush() и при
+// смене дескриптора; куски длиннее буфера уходят в write() напрямую, без
+// копирования. Один писатель можно переиспользовать для нескольких
+// выходов через setFD(), буфер при этом не перевыделяется. Ошибка записи
+// запоминается, дальнейший вывод отбрасывается.
+class BufferedWriter {
+    int FD;
+    std::unique_ptr<char[]> Buffer;
+    size_t Capacity;
+    size_t Size = 0;
+    bool HasError = false;
+    uint64_t BytesWritten = 0;
+    uint64_t NumSyscalls = 0;
+
+    void writeToFD(const char *Data, size_t Length) {
+        while (Length && !HasError) {
+            ssize_t Written = ::write(FD, Data, Length);
+            ++NumSyscalls;
+            if (Written < 0) {
+                if (errno == EINTR)
+                    continue;
+                HasError = true;
+                return;
+            }
+            Data += Written;
+            Length -= static_cast<size_t>(Written);
+            BytesWritten += static_cast<uint64_t>(Written);
+        }
+    }
+
+    void flushBuffer() {
+        writeToFD(Buffer.get(), Size);
+        Size = 0;
+    }
+
+public:
+    static constexpr size_t DefaultBufferSize = 1 << 20;
+
+    explicit BufferedWriter(int fd, size_t bufferSize = DefaultBufferSize)
+        : FD(fd), Buffer(new char[bufferSize]), Capacity(bufferSize) {}
+
+    ~BufferedWriter() { flush(); }
+
+    BufferedWriter(const BufferedWriter &) = delete;
+    BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+    // setFD - Сбрасывает накопленное в старый дескриптор и пишет дальше в
+    // новый; состояние ошибки обнуляется.
+    void setFD(int fd) {
+        flush();
+        FD = fd;
+        HasError = false;
+    }
+
+    void write(std::string_view S) {
+        if (S.size() <= Capacity - Size) {
+            std::memcpy(Buffer.get() + Size, S.data(), S.size());
+            Size += S.size();
+            return;
+        }
+        flushBuffer();
+        if (S.size() >= Capacity) {
+            writeToFD(S.data(), S.size());
+            return;
+        }
+        std::memcpy(Buffer.get(), S.data(), S.size());
+        Size = S.size();
+    }
+
+    void write(char C) {
+        if (Size == Capacity)
+            flushBuffer();
+        Buffer[Size++] = C;
+    }
+
+    // writeDecimal - Число без знака в десятичной записи.
+    void writeDecimal(uint64_t V) {
+        char Digits[20];
+        char *End = Digits + sizeof(Digits), *Ptr = End;
+        do {
+            *--Ptr = static_cast<char>('0' + V % 10);
+            V /= 10;
+        } while (V);
+        write(std::string_view(Ptr, static_cast<size_t>(End - Ptr)));
+    }
+
+    // writeULEB128 - Число без знака по 7 бит в байте, младшие первыми;
+    // старший бит байта означает, что за ним есть продолжение.
+    void writeULEB128(uint64_t V) {
+        char Bytes[10];
+        size_t N = 0;
+        do {
+            uint8_t Byte = V & 0x7f;
+            V >>= 7;
+            Bytes[N++] = static_cast<char>(V ? Byte | 0x80 : Byte);
+        } while (V);
+        write(std::string_view(Bytes, N));
+    }
+
+    // writeLE32 - Четыре байта, младший первым, независимо от платформы.
+    void writeLE32(uint32_t V) {
+        char Bytes[4] = {static_cast<char>(V), static_cast<char>(V >> 8),
+                         static_cast<char>(V >> 16), static_cast<char>(V >> 24)};
+        write(std::string_view(Bytes, 4));
+    }
+
+    // flush - Отдаёт буфер ядру; false, если какая-то запись не удалась.
+    bool flush() {
+        if (Size)
+            flushBuffer();
+        return !HasError;
+    }
+
+    bool hasError() const { return HasError; }
+    uint64_t getBytesWritten() const { return BytesWritten; }
+    uint64_t getNumSyscalls() const { return NumSyscalls; }
+};
+
+#endif
@@ -0,0 +1,42 @@
+#ifndef Casting_h
+#define Casting_h
+
+#include <cassert>
+
+// isa/cast/dyn_cast - LLVM-подобный RTTI без виртуальных таблиц.
+// Класс To должен объявить `static bool classof(const From *)`.
+
+template <typename To, typename From>
+inline bool isa(const From *Val) {
+    assert(Val && "isa<> used on a null pointer");
+    return To::classof(Val);
+}
+
+template <typename To, typename From>
+inline To *cast(From *Val) {
+    assert(isa<To>(Val) && "cast<Ty>() argument of incompatible type!");
+    return static_cast<To *>(Val);
+}
+
+template <typename To, typename From>
+inline const To *cast(const From *Val) {
+    assert(isa<To>(Val) && "cast<Ty>() argument of incompatible type!");
+    return static_cast<const To *>(Val);
+}
+
+template <typename To, typename From>
+inline To *dyn_cast(From *Val) {
+    return isa<To>(Val) ? static_cast<To *>(Val) : nullptr;
+}
+
+template <typename To, typename From>
+inline const To *dyn_cast(const From *Val) {
+    return isa<To>(Val) ? static_cast<const To *>(Val) : nullptr;
+}
+
+template <typename To, typename From>
+inline To *dyn_cast_or_null(From *Val) {
+    return Val && isa<To>(Val) ? static_cast<To *>(Val) : nullptr;
+}
+
+#endif
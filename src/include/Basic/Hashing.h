@@ -0,0 +1,23 @@
+#ifndef Hashing_h
+#define Hashing_h
+
+#include <cstdint>
+#include <string_view>
+
+// hashBytes - 64-битный FNV-1a. Используется для хешей содержимого файлов:
+// быстрый, детерминированный между запусками и платформами.
+inline uint64_t hashBytes(std::string_view Bytes, uint64_t Seed = 0xcbf29ce484222325ull) {
+    uint64_t Hash = Seed;
+    for (unsigned char C : Bytes) {
+        Hash ^= C;
+        Hash *= 0x100000001b3ull;
+    }
+    return Hash;
+}
+
+// hashCombine - Добавляет значение Value к уже посчитанному хешу Seed.
+inline uint64_t hashCombine(uint64_t Seed, uint64_t Value) {
+    return Seed ^ (Value + 0x9E3779B97F4A7C15ull + (Seed << 6) + (Seed >> 2));
+}
+
+#endif
@@ -0,0 +1,95 @@
+#ifndef ThreadPool_h
+#define ThreadPool_h
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ThreadPool - Фиксированный набор рабочих потоков с общей очередью задач.
+//
+// async() ставит задачу в очередь, wait() блокирует, пока очередь не
+// опустеет и все начатые задачи не завершатся. Задачи не должны бросать
+// исключения.
+class ThreadPool {
+    std::vector<std::thread> Workers;
+    std::deque<std::function<void()>> Tasks;
+
+    std::mutex Mutex;
+    // QueueCondition - Появилась задача или пул останавливается.
+    std::condition_variable QueueCondition;
+    // DoneCondition - Очередь пуста и ни одна задача не выполняется.
+    std::condition_variable DoneCondition;
+
+    unsigned ActiveTasks = 0;
+    bool Stopping = false;
+
+public:
+    // ThreadPool - NumThreads == 0 означает число аппаратных потоков.
+    explicit ThreadPool(unsigned NumThreads = 0) {
+        if (NumThreads == 0)
+            NumThreads = getDefaultConcurrency();
+        for (unsigned I = 0; I != NumThreads; ++I)
+            Workers.emplace_back([this] { workerLoop(); });
+    }
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Stopping = true;
+        }
+        QueueCondition.notify_all();
+        for (std::thread &Worker : Workers)
+            Worker.join();
+    }
+
+    static unsigned getDefaultConcurrency() {
+        unsigned N = std::thread::hardware_concurrency();
+        return N ? N : 1;
+    }
+
+    unsigned getNumThreads() const { return static_cast<unsigned>(Workers.size()); }
+
+    void async(std::function<void()> Task) {
+        {
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Tasks.push_back(std::move(Task));
+        }
+        QueueCondition.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> Lock(Mutex);
+        DoneCondition.wait(Lock, [this] { return Tasks.empty() && ActiveTasks == 0; });
+    }
+
+private:
+    void workerLoop() {
+        while (true) {
+            std::function<void()> Task;
+            {
+                std::unique_lock<std::mutex> Lock(Mutex);
+                QueueCondition.wait(Lock, [this] { return Stopping || !Tasks.empty(); });
+                if (Tasks.empty())
+                    return;
+                Task = std::move(Tasks.front());
+                Tasks.pop_front();
+                ++ActiveTasks;
+            }
+            Task();
+            {
+                std::lock_guard<std::mutex> Lock(Mutex);
+                --ActiveTasks;
+                if (Tasks.empty() && ActiveTasks == 0)
+                    DoneCondition.notify_all();
+            }
+        }
+    }
+};
+
+#endif
@@ -0,0 +1,96 @@
+#ifndef BatchLoader_h
+#define BatchLoader_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// LoadedFile - Содержимое одного файла из пакета.
+//
+// Буфер на байт длиннее содержимого и заканчивается NUL, поэтому его можно
+// сразу отдавать Lexer без копирования.
+struct LoadedFile {
+    // Index - Номер файла во входном списке BatchLoader::load.
+    unsigned Index = 0;
+    std::string_view Path;
+    std::unique_ptr<char[]> Data;
+    size_t Size = 0;
+    // Errno - 0, если файл прочитан; иначе код ошибки открытия или чтения.
+    int Errno = 0;
+
+    std::string_view getContents() const { return {Data.get(), Size}; }
+};
+
+// BatchLoader - Читает большие наборы файлов, держа диск загруженным.
+//
+// Основной путь — io_uring: open и statx для окна файлов уходят в ядро одним
+// io_uring_enter, read ставится, как только известен размер, close — без
+// ожидания результата. Если ядро не поддерживает io_uring или нужные
+// операции (до 5.6, или io_uring запрещён seccomp), файлы читает пул потоков
+// обычными open/fstat/read.
+//
+// Обычный файл читается до размера из statx/fstat. Каналы, FIFO, /dev/stdin
+// и файлы с нулевым размером (как в /proc) читаются до EOF в растущий буфер.
+//
+// Обработчик вызывается в потоке, вызвавшем load(), в порядке завершения
+// чтения, а не в порядке Paths: пока он лексит один файл, остальные
+// продолжают читаться.
+class BatchLoader {
+public:
+    enum class Backend { IOUring, ThreadPool };
+
+    struct Options {
+        // QueueDepth - Сколько файлов читается одновременно.
+        unsigned QueueDepth = 64;
+        // NumThreads - Размер пула для запасного пути; 0 — число ядер.
+        unsigned NumThreads = 0;
+        bool ForceThreadPool = false;
+    };
+
+    struct Stats {
+        uint64_t NumFiles = 0;
+        uint64_t NumFailed = 0;
+        uint64_t NumBytes = 0;
+        // NumSyscalls - io_uring_enter, либо open/fstat/read/close пула.
+        uint64_t NumSyscalls = 0;
+        uint64_t LoadMicros = 0;
+    };
+
+    using Handler = std::function<void(LoadedFile &)>;
+
+private:
+    class Ring;
+
+    Options Opts;
+    std::unique_ptr<Ring> IOUring;
+    Stats LoadStats;
+
+    void loadWithRing(const std::vector<std::string> &Paths, const Handler &OnLoaded);
+    void loadWithThreadPool(const std::vector<std::string> &Paths, const Handler &OnLoaded);
+
+public:
+    explicit BatchLoader(Options opts);
+    BatchLoader() : BatchLoader(Options()) {}
+    ~BatchLoader();
+
+    BatchLoader(const BatchLoader &) = delete;
+    BatchLoader &operator=(const BatchLoader &) = delete;
+
+    Backend getBackend() const { return IOUring ? Backend::IOUring : Backend::ThreadPool; }
+    static const char *getBackendName(Backend B);
+
+    // load - Читает все Paths и вызывает OnLoaded ровно один раз для каждого,
+    // в том числе для файлов, которые не удалось прочитать (Errno != 0).
+    // Буфер можно забрать из LoadedFile; иначе он освобождается сразу после
+    // возврата из обработчика.
+    void load(const std::vector<std::string> &Paths, const Handler &OnLoaded);
+
+    // getStats - Статистика последнего вызова load().
+    const Stats &getStats() const { return LoadStats; }
+};
+
+#endif
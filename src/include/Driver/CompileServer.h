@@ -0,0 +1,133 @@
+#ifndef CompileServer_h
+#define CompileServer_h
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "AST/Identifier.h"
+#include "Parse/Token.h"
+
+// CompileServer - Долгоживущий режим `SwiftMini --server`.
+//
+// Между запросами сервер держит в памяти исходные буферы, потоки токенов и
+// интернированные идентификаторы каждого открытого файла, поэтому повторные
+// запросы не читают и не лексят файл заново. Идентификаторы живут в таблице
+// своего файла: `change` и `close` освобождают имена старой версии, и память
+// долгоживущего сервера не растёт с каждой правкой. Уведомление `change` пересобирает
+// только изменившийся файл, и только если его содержимое действительно
+// поменялось (сравнение по хешу).
+//
+// Протокол — рамки с префиксом длины в обе стороны:
+//
+//   <длина payload в байтах, десятичная>\n<payload>
+//
+// Первая строка payload — команда, остальное — тело:
+//
+//   open <path>             загрузить файл с диска (если ещё не загружен)
+//   change <path>\n<text>   новое содержимое файла (например, из редактора);
+//                           без тела файл перечитывается с диска
+//   tokens <path>           поток токенов: "<kind> <offset> <length> <text>"
+//   close <path>            выбросить файл из кеша
+//   stats                   счётчики кеша и времени
+//   shutdown                завершить сервер
+//
+// Ответ начинается с "ok" или "error: <сообщение>".
+class CompileServer {
+public:
+    struct Stats {
+        uint64_t NumRequests = 0;
+        // NumLexes - Сколько раз файл действительно лексился.
+        uint64_t NumLexes = 0;
+        // NumReuses - Запросы, обслуженные из кеша без повторного лексинга.
+        uint64_t NumReuses = 0;
+        uint64_t TotalRequestMicros = 0;
+        uint64_t LastRequestMicros = 0;
+    };
+
+private:
+    // SourceFile - Закешированное состояние одного файла. Токены ссылаются на
+    // Buffer, поэтому объект не перемещается (unique_ptr).
+    struct SourceFile {
+        std::string Path;
+        std::string Buffer;
+        uint64_t ContentHash = 0;
+        unsigned Version = 0;
+        std::vector<Token> Tokens;
+        // Identifiers - Таблица имён текущей версии; пересоздаётся при
+        // каждом лексинге, поэтому имена прошлых версий не копятся.
+        std::unique_ptr<IdentifierTable> Identifiers;
+        // Names - Интернированные имена идентификаторов в порядке появления.
+        std::vector<Identifier> Names;
+    };
+
+    std::unordered_map<std::string, std::unique_ptr<SourceFile>> Files;
+
+    Stats Counters;
+    bool ShutdownRequested = false;
+
+public:
+    CompileServer() = default;
+
+    // handleRequest - Обрабатывает один запрос (payload без рамки).
+    std::string handleRequest(std::string_view Request);
+
+    // serve - Читает рамки из InFD и отвечает в OutFD, пока не придёт
+    // shutdown, вход не закончится или клиент не перестанет принимать ответы.
+    // Обрыв соединения завершает только его, не сервер.
+    void serve(int InFD, int OutFD);
+
+    // serveUnixSocket - Принимает соединения на Unix-сокете SocketPath и
+    // обслуживает их по очереди. Возвращает false при ошибке сокета.
+    bool serveUnixSocket(const std::string &SocketPath);
+
+    bool isShutdownRequested() const { return ShutdownRequested; }
+
+    const Stats &getStats() const { return Counters; }
+
+    // getNumIdentifiers - Уникальные имена во всех открытых файлах (имя,
+    // встреченное в двух файлах, считается дважды).
+    size_t getNumIdentifiers() const;
+
+    // getIdentifierMemory - Байты, занятые таблицами имён открытых файлов.
+    size_t getIdentifierMemory() const;
+
+private:
+    std::string handleOpen(const std::string &Path);
+    std::string handleChange(const std::string &Path, std::string_view Body,
+                             bool HasBody);
+    std::string handleTokens(const std::string &Path);
+    std::string handleStats() const;
+
+    // updateFile - Кладёт новое содержимое в кеш и лексит файл, если хеш
+    // содержимого изменился. Возвращает true, если файл перелексирован.
+    bool updateFile(const std::string &Path, std::string Contents);
+
+    void lexFile(SourceFile &File);
+};
+
+// FrameReader - Читает рамки протокола из дескриптора через собственный
+// буфер, чтобы не делать системный вызов на каждый байт заголовка.
+class FrameReader {
+    int FD;
+    std::string Buffer;
+    size_t Pos = 0;
+
+public:
+    explicit FrameReader(int fd) : FD(fd) {}
+
+    // read - false на EOF или повреждённой рамке.
+    bool read(std::string &Payload);
+
+private:
+    bool fill();
+};
+
+// writeFrame - Пишет одну рамку. false, если собеседник ушёл (EPIPE,
+// ECONNRESET) или запись не удалась; сигнала SIGPIPE на сокете не бывает.
+bool writeFrame(int FD, std::string_view Payload);
+
+#endif
@@ -0,0 +1,92 @@
+#ifndef DependencyGraph_h
+#define DependencyGraph_h
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Parse/Token.h"
+
+// FileDependencies - Что файл предоставляет другим и что использует сам.
+//
+// Каждый файл — отдельный модуль с именем, равным имени файла без
+// расширения. Интерфейс файла — его объявления верхнего уровня; у каждого
+// свой хеш, так что изменение тела функции или одного объявления не задевает
+// файлы, которые это объявление не используют.
+struct FileDependencies {
+    std::string Path;
+    uint64_t ContentHash = 0;
+
+    // Imports - Имена модулей из `import X`.
+    std::vector<std::string> Imports;
+
+    // Provides - Имя объявления верхнего уровня -> хеш его интерфейса
+    // (для func — сигнатура без тела, для остального — объявление целиком).
+    std::map<std::string, uint64_t> Provides;
+
+    // Uses - Все идентификаторы, на которые ссылается файл (без повторов).
+    std::vector<std::string> Uses;
+};
+
+// DependencyGraph - Граф зависимостей между файлами, сохраняемый между
+// запусками драйвера.
+class DependencyGraph {
+    std::map<std::string, FileDependencies> Files;
+
+    // Modules - Имя модуля -> путь файла, который его предоставляет.
+    std::map<std::string, std::string, std::less<>> Modules;
+
+public:
+    // scanFile - Извлекает зависимости файла из его токенов.
+    static FileDependencies scanFile(const std::string &Path, std::string_view Contents);
+
+    // scanFile - То же, но оставляет в Tokens поток токенов файла (без
+    // START_OF_FILE и eof), чтобы вызывающему не лексить файл ещё раз.
+    static FileDependencies scanFile(const std::string &Path, std::string_view Contents,
+                                     std::vector<Token> &Tokens);
+
+    static std::string getModuleName(std::string_view Path);
+
+    void addFile(FileDependencies Deps) {
+        std::string Path = Deps.Path;
+        Modules[getModuleName(Path)] = Path;
+        Files[Path] = std::move(Deps);
+    }
+
+    const FileDependencies *getFile(const std::string &Path) const;
+
+    // getModule - Файл, который предоставляет модуль ModuleName.
+    const FileDependencies *getModule(std::string_view ModuleName) const;
+
+    size_t size() const { return Files.size(); }
+
+    bool load(const std::string &Path, std::string &Error);
+    bool save(const std::string &Path) const;
+};
+
+// RebuildDecision - Почему файл нужно (или не нужно) пересобрать.
+struct RebuildDecision {
+    std::string Path;
+    bool NeedsRebuild = false;
+    std::string Reason;
+    // NumTokens - Для пересобираемого файла — число его токенов (пересборка
+    // в драйвере — это лексинг), без START_OF_FILE и eof.
+    unsigned NumTokens = 0;
+};
+
+// planIncrementalBuild - Сравнивает входные файлы с графом прошлой сборки.
+// Файл пересобирается, если изменилось его содержимое или интерфейс
+// объявления, которое он использует из импортированного модуля. NewGraph
+// получает граф для текущей сборки; неизменённые файлы не перелексируются.
+// Пересобираемые файлы лексятся из тех же байтов, что хешировались в
+// NewGraph, так что читать их второй раз не нужно. Возвращает false, если
+// какой-то файл не удалось прочитать.
+bool planIncrementalBuild(const DependencyGraph &OldGraph,
+                          const std::vector<std::string> &Inputs,
+                          DependencyGraph &NewGraph,
+                          std::vector<RebuildDecision> &Decisions,
+                          std::string &Error);
+
+#endif
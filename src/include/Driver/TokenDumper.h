@@ -0,0 +1,89 @@
+#ifndef TokenDumper_h
+#define TokenDumper_h
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+
+#include "Basic/BufferedWriter.h"
+#include "Parse/Token.h"
+
+// TokenDumpFormat - Формат вывода -dump-tokens.
+//
+// Text - "файл:строка:столбец: <вид> 'текст'", спецсимволы текста
+//   экранированы в стиле C.
+// JSONLines - Один JSON-объект на строку:
+//   {"file":..,"line":..,"col":..,"offset":..,"kind":"kw_let","text":..}
+// Binary - Поток записей, см. TokenDumper.
+enum class TokenDumpFormat { Text, JSONLines, Binary };
+
+// parseTokenDumpFormat - "text", "json" или "binary".
+bool parseTokenDumpFormat(std::string_view Name, TokenDumpFormat &Format);
+
+// getTokenKindSpelling - Имя вида токена как в Tokens.def: "kw_let", "eof".
+std::string_view getTokenKindSpelling(tok K);
+
+// TokenDumper - Выводит токены файлов в одном из форматов.
+//
+// Строки и столбцы считаются с 1, столбец — в байтах от начала строки.
+// START_OF_FILE не выводится, eof выводится последним токеном каждого файла.
+//
+// Двоичный поток начинается с заголовка: "SMTK", LE32 версия (1),
+// LE32 число видов токенов и для каждого вида — ULEB128 длина и имя.
+// Дальше идут записи, первый байт которых — тег:
+//   FileRecordTag: ULEB128 длина пути, путь, ULEB128 размер файла;
+//   вид токена:    ULEB128 смещение от начала предыдущего токена файла,
+//                  ULEB128 длина, ULEB128 прирост номера строки,
+//                  ULEB128 столбец.
+// Текст токена не пишется: он восстанавливается по смещению и длине.
+class TokenDumper {
+public:
+    static constexpr uint8_t FileRecordTag = 0xff;
+    static constexpr uint32_t BinaryVersion = 1;
+
+private:
+    BufferedWriter &OS;
+    TokenDumpFormat Format;
+    uint64_t NumTokens = 0;
+
+    // Состояние текущего файла.
+    std::string_view Path;
+    std::string_view Buffer;
+    uint64_t ScannedTo = 0;
+    uint64_t LineStart = 0;
+    uint32_t Line = 1;
+    uint64_t PrevOffset = 0;
+    uint32_t PrevLine = 1;
+
+    void advanceTo(uint64_t Offset);
+    void dumpToken(const Token &Tok);
+
+public:
+    // TokenDumper - Для Binary сразу пишет заголовок потока.
+    TokenDumper(BufferedWriter &os, TokenDumpFormat format);
+
+    // dumpFile - Лексит Contents и выводит все его токены.
+    void dumpFile(std::string_view FilePath, std::string_view Contents);
+
+    uint64_t getNumTokens() const { return NumTokens; }
+};
+
+// TokenRecord - Токен, прочитанный из двоичного потока.
+struct TokenRecord {
+    tok Kind;
+    uint64_t Offset;
+    uint64_t Length;
+    uint32_t Line;
+    uint32_t Column;
+};
+
+// readTokenStream - Разбирает двоичный поток TokenDumper. OnFile вызывается
+// перед токенами каждого файла. При повреждённом потоке возвращает false
+// и описание в Error.
+bool readTokenStream(std::string_view Data,
+                     const std::function<void(std::string_view Path, uint64_t Size)> &OnFile,
+                     const std::function<void(const TokenRecord &)> &OnToken,
+                     std::string &Error);
+
+#endif
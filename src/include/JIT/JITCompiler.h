@@ -0,0 +1,84 @@
+#ifndef JITCompiler_h
+#define JITCompiler_h
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Basic/ArrayRef.h"
+#include "JIT/LIR.h"
+
+// ExecutableMemory - Анонимное отображение с машинным кодом. Пишется, пока
+// открыто на запись, и переключается в read+exec в makeExecutable().
+class ExecutableMemory {
+    void *Base = nullptr;
+    size_t Size = 0;
+
+public:
+    ExecutableMemory() = default;
+    ExecutableMemory(const ExecutableMemory &) = delete;
+    ExecutableMemory &operator=(const ExecutableMemory &) = delete;
+    ~ExecutableMemory() { release(); }
+
+    // allocate - Выделяет не меньше Size байт (с округлением до страницы).
+    bool allocate(size_t Size);
+    bool makeExecutable();
+    void release();
+
+    uint8_t *data() const { return static_cast<uint8_t *>(Base); }
+    size_t size() const { return Size; }
+};
+
+// JITCompiler - Компилирует все функции LIR-модуля в машинный код x86-64
+// (System V ABI) в одном исполняемом отображении.
+//
+// Значения распределяются по регистрам линейным сканированием: целые — по
+// rbx, r12-r15 (переживают вызовы) и rsi, rdi, r8-r10, double — по
+// xmm8-xmm15; остальные уходят в кадр стека. rax, rcx, rdx, r11, xmm0 и
+// xmm1 зарезервированы под временные значения.
+class JITCompiler {
+public:
+    struct Stats {
+        unsigned NumFunctions = 0;
+        size_t CodeSize = 0;
+        // NumSpilledValues - Виртуальные регистры, оставшиеся в памяти.
+        unsigned NumSpilledValues = 0;
+        uint64_t CompileMicros = 0;
+    };
+
+private:
+    ExecutableMemory Memory;
+    const LIRModule *Module = nullptr;
+    // EntryOffsets/ThunkOffsets - Смещения входов функций и их переходников
+    // вызова из C++ (по номеру функции в модуле).
+    std::vector<size_t> EntryOffsets;
+    std::vector<size_t> ThunkOffsets;
+    Stats CompileStats;
+
+public:
+    // isHostSupported - JIT работает только на x86-64.
+    static bool isHostSupported();
+
+    // compile - Проверяет и компилирует модуль. Модуль должен жить, пока
+    // используется скомпилированный код.
+    bool compile(const LIRModule &M, std::string &Error);
+
+    // getPointerToFunction - Адрес функции с обычным соглашением о вызовах;
+    // приводится к указателю на функцию с типами int64_t/double.
+    void *getPointerToFunction(const LIRFunction *F) const;
+
+    template <typename FnT>
+    FnT getFunction(std::string_view Name) const {
+        const LIRFunction *F = Module ? Module->getFunction(Name) : nullptr;
+        return F ? reinterpret_cast<FnT>(getPointerToFunction(F)) : nullptr;
+    }
+
+    // call - Вызов с произвольными аргументами через переходник.
+    LIRValue call(const LIRFunction *F, ArrayRef<LIRValue> Args) const;
+
+    const Stats &getStats() const { return CompileStats; }
+};
+
+#endif
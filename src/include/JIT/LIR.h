@@ -0,0 +1,177 @@
+#ifndef LIR_h
+#define LIR_h
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Basic/ArrayRef.h"
+
+// LIR - Низкоуровневое представление для JIT и интерпретатора.
+//
+// Функция — список базовых блоков над виртуальными регистрами двух типов:
+// Int (int64_t) и Float (double). Представление не SSA: регистр можно
+// переопределять, так переменные (`var`) и счётчики циклов живут в одном
+// регистре. Значения регистров на входе в функцию, кроме параметров, равны
+// нулю. Деление на ноль и INT64_MIN / -1 не определены.
+//
+// LIR получают из оптимизированного MIR через lowerToLIR (MIR/LIRGen.h)
+// или из текстового вида (parseLIRModule). Оптимизаций на уровне LIR нет:
+// они делаются на MIR, где есть SSA и типы.
+
+enum class LIROpcode : uint8_t {
+    #define LIR_OP(Id, Name) Id,
+    #include "JIT/LIROps.def"
+};
+
+const char *getOpcodeName(LIROpcode Op);
+bool isTerminator(LIROpcode Op);
+
+enum class LIRType : uint8_t { Int, Float };
+
+// VReg - Номер виртуального регистра внутри функции.
+using VReg = uint32_t;
+constexpr VReg NoVReg = ~0u;
+
+using BlockID = uint32_t;
+
+class LIRFunction;
+
+// LIRValue - Значение регистра в интерпретаторе и на границе с JIT-кодом.
+union LIRValue {
+    int64_t I;
+    double F;
+};
+
+inline LIRValue makeInt(int64_t V) { LIRValue R; R.I = V; return R; }
+inline LIRValue makeFloat(double V) { LIRValue R; R.F = V; return R; }
+
+struct LIRInst {
+    LIROpcode Op;
+    VReg Dest = NoVReg;
+    // A, B - Операнды; у ret — A, у condbr — условие в A.
+    VReg A = NoVReg;
+    VReg B = NoVReg;
+    // Imm - Значение iconst, биты double для fconst.
+    int64_t Imm = 0;
+    // Targets - Блоки-преемники br/condbr (для condbr: [истина, ложь]).
+    BlockID Targets[2] = {0, 0};
+    LIRFunction *Callee = nullptr;
+    std::vector<VReg> Args;
+
+    double getFloatImm() const;
+};
+
+struct LIRBlock {
+    std::vector<LIRInst> Insts;
+};
+
+class LIRFunction {
+    std::string Name;
+    LIRType ReturnType;
+    unsigned Index;
+
+public:
+    // RegTypes - Тип каждого виртуального регистра.
+    std::vector<LIRType> RegTypes;
+    // Params - Регистры параметров, по порядку.
+    std::vector<VReg> Params;
+    // Blocks - Блок 0 — вход.
+    std::vector<LIRBlock> Blocks;
+
+    LIRFunction(std::string name, LIRType returnType, unsigned index)
+        : Name(std::move(name)), ReturnType(returnType), Index(index) {}
+
+    const std::string &getName() const { return Name; }
+    LIRType getReturnType() const { return ReturnType; }
+    // getIndex - Номер функции в модуле.
+    unsigned getIndex() const { return Index; }
+
+    unsigned getNumRegs() const { return static_cast<unsigned>(RegTypes.size()); }
+    LIRType getRegType(VReg R) const { return RegTypes[R]; }
+
+    VReg createReg(LIRType Type) {
+        RegTypes.push_back(Type);
+        return static_cast<VReg>(RegTypes.size() - 1);
+    }
+
+    void print(std::ostream &OS) const;
+};
+
+class LIRModule {
+    std::vector<std::unique_ptr<LIRFunction>> Functions;
+
+public:
+    LIRFunction *createFunction(std::string Name, ArrayRef<LIRType> ParamTypes,
+                                LIRType ReturnType);
+    LIRFunction *getFunction(std::string_view Name) const;
+
+    const std::vector<std::unique_ptr<LIRFunction>> &getFunctions() const {
+        return Functions;
+    }
+
+    // verify - Проверяет типы операндов, терминаторы и переходы; при
+    // ошибке возвращает false и описание в Error.
+    bool verify(std::string &Error) const;
+
+    void print(std::ostream &OS) const;
+};
+
+// parseLIRModule - Читает модуль из текстового вида, который печатает
+// LIRModule::print(). Регистры параметров должны идти первыми по порядку.
+// Проверку типов оставляет verify().
+bool parseLIRModule(std::string_view Text, LIRModule &M, std::string &Error);
+
+// LIRBuilder - Добавляет инструкции в конец текущего блока функции.
+class LIRBuilder {
+    LIRFunction &F;
+    BlockID Current = 0;
+
+    LIRInst &append(LIROpcode Op);
+    VReg emitBinary(LIROpcode Op, LIRType ResultType, VReg A, VReg B);
+
+public:
+    explicit LIRBuilder(LIRFunction &f) : F(f) {}
+
+    BlockID createBlock();
+    void setInsertPoint(BlockID Block) { Current = Block; }
+    BlockID getInsertBlock() const { return Current; }
+
+    VReg getParam(unsigned I) const { return F.Params[I]; }
+
+    // createVar - Регистр под изменяемую переменную; присваивание — copy().
+    VReg createVar(LIRType Type) { return F.createReg(Type); }
+
+    VReg iconst(int64_t Value);
+    VReg fconst(double Value);
+    void copy(VReg Dest, VReg Src);
+
+    #define LIR_INT_BINARY(Id, Name)                                          \
+    VReg create##Id(VReg A, VReg B) {                                         \
+        return emitBinary(LIROpcode::Id, LIRType::Int, A, B);                 \
+    }
+    #define LIR_FLOAT_BINARY(Id, Name)                                        \
+    VReg create##Id(VReg A, VReg B) {                                         \
+        return emitBinary(LIROpcode::Id, LIRType::Float, A, B);               \
+    }
+    #define LIR_INT_COMPARE(Id, Name)                                         \
+    VReg create##Id(VReg A, VReg B) {                                         \
+        return emitBinary(LIROpcode::Id, LIRType::Int, A, B);                 \
+    }
+    #define LIR_FLOAT_COMPARE(Id, Name) LIR_INT_COMPARE(Id, Name)
+    #include "JIT/LIROps.def"
+
+    VReg createNeg(VReg A);
+    VReg createIntToFloat(VReg A);
+    VReg createFloatToInt(VReg A);
+    VReg createCall(LIRFunction *Callee, ArrayRef<VReg> Args);
+
+    void createBr(BlockID Target);
+    void createCondBr(VReg Cond, BlockID IfTrue, BlockID IfFalse);
+    void createRet(VReg Value);
+};
+
+#endif
@@ -0,0 +1,24 @@
+#ifndef LIRInterpreter_h
+#define LIRInterpreter_h
+
+#include <cstdint>
+#include <vector>
+
+#include "Basic/ArrayRef.h"
+#include "JIT/LIR.h"
+
+// LIRInterpreter - Исполняет LIR без компиляции. Эталон для проверки JIT и
+// базовая линия в бенчмарках.
+class LIRInterpreter {
+    // Frames - Регистры всех активных вызовов подряд; кадр функции занимает
+    // getNumRegs() ячеек.
+    std::vector<LIRValue> Frames;
+    uint64_t NumInstsExecuted = 0;
+
+public:
+    LIRValue run(const LIRFunction &F, ArrayRef<LIRValue> Args);
+
+    uint64_t getNumInstsExecuted() const { return NumInstsExecuted; }
+};
+
+#endif
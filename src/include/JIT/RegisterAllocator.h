@@ -0,0 +1,72 @@
+#ifndef RegisterAllocator_h
+#define RegisterAllocator_h
+
+#include <cstdint>
+#include <vector>
+
+#include "JIT/LIR.h"
+
+// RegisterClass - Физические регистры, доступные для значений одного типа.
+// Номера регистров — номера кодировки целевой машины.
+struct RegisterClass {
+    // CallerSaved - Не сохраняются при вызове; годятся только для значений,
+    // не живых через call.
+    std::vector<uint8_t> CallerSaved;
+    // CalleeSaved - Сохраняются вызываемой функцией; их использование
+    // стоит сохранения в прологе.
+    std::vector<uint8_t> CalleeSaved;
+};
+
+// LiveInterval - Отрезок линейного порядка инструкций, на котором регистр
+// жив. Инструкция с номером N читает операнды в позиции 2N и пишет
+// результат в позиции 2N+1. Дыры во времени жизни не учитываются.
+struct LiveInterval {
+    VReg Reg;
+    uint32_t Start;
+    uint32_t End;
+    // CrossesCall - Значение живо через какой-то call.
+    bool CrossesCall;
+};
+
+// ValueLocation - Где живёт виртуальный регистр во время всей функции.
+struct ValueLocation {
+    enum Kind : uint8_t { Unused, Register, Stack };
+    Kind K = Unused;
+    uint8_t PhysReg = 0;
+    uint32_t Slot = 0;
+
+    bool isRegister() const { return K == Register; }
+    bool isStack() const { return K == Stack; }
+};
+
+struct RegisterAssignment {
+    std::vector<ValueLocation> Locations;
+    unsigned NumSpillSlots = 0;
+    // UsedCalleeSaved - Сохраняемые регистры, которые нужно сохранить
+    // в прологе (для обоих типов, в порядке первого использования).
+    std::vector<uint8_t> UsedCalleeSaved;
+    // ZeroOnEntry - Регистры, читаемые до первой записи: на входе в функцию
+    // они должны быть равны нулю.
+    std::vector<VReg> ZeroOnEntry;
+};
+
+// LinearScanAllocator - Распределение регистров линейным сканированием
+// (Poletto & Sarkar). Интервалы обходятся по возрастанию начала; когда
+// свободных регистров нет, в память уходит интервал, кончающийся позже всех.
+class LinearScanAllocator {
+    RegisterClass Classes[2];
+
+    void allocateClass(const LIRFunction &F, const std::vector<LiveInterval> &Intervals,
+                       LIRType Type, RegisterAssignment &Result) const;
+
+public:
+    LinearScanAllocator(RegisterClass IntRegs, RegisterClass FloatRegs);
+
+    RegisterAssignment allocate(const LIRFunction &F) const;
+
+    // computeLiveIntervals - Интервалы всех используемых регистров,
+    // упорядоченные по началу.
+    static std::vector<LiveInterval> computeLiveIntervals(const LIRFunction &F);
+};
+
+#endif
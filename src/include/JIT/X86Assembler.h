@@ -0,0 +1,120 @@
+#ifndef X86Assembler_h
+#define X86Assembler_h
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace x86 {
+
+// Номера совпадают с кодировкой в ModRM/REX.
+enum GPR : uint8_t {
+    RAX, RCX, RDX, RBX, RSP, RBP, RSI, RDI,
+    R8, R9, R10, R11, R12, R13, R14, R15,
+};
+
+enum XMM : uint8_t {
+    XMM0, XMM1, XMM2, XMM3, XMM4, XMM5, XMM6, XMM7,
+    XMM8, XMM9, XMM10, XMM11, XMM12, XMM13, XMM14, XMM15,
+};
+
+// Cond - Условие jcc/setcc (младшие 4 бита опкода).
+enum Cond : uint8_t {
+    O, NO, B, AE, E, NE, BE, A, S, NS, P, NP, L, GE, LE, G,
+};
+
+// Mem - Операнд [Base + Disp]. Base не может быть RSP или R12: для них
+// нужен SIB-байт, который ассемблер не кодирует.
+struct Mem {
+    GPR Base;
+    int32_t Disp;
+};
+
+} // namespace x86
+
+// X86Assembler - Кодирует подмножество x86-64, нужное JIT, в буфер байт.
+// Переходы на метки пишутся с rel32 и дозаполняются в finalize().
+class X86Assembler {
+public:
+    using Label = uint32_t;
+
+private:
+    std::vector<uint8_t> Code;
+    // LabelOffsets - Смещение привязанной метки; -1 — ещё не привязана.
+    std::vector<int64_t> LabelOffsets;
+
+    struct Fixup {
+        size_t Offset;
+        Label Target;
+    };
+    std::vector<Fixup> Fixups;
+
+    void emit8(uint8_t Byte) { Code.push_back(Byte); }
+    void emit32(uint32_t Value);
+    void emit64(uint64_t Value);
+    void emitRex(bool W, uint8_t Reg, uint8_t RM, bool Force = false);
+    void emitModRMReg(uint8_t Reg, uint8_t RM);
+    void emitModRMMem(uint8_t Reg, x86::Mem M);
+    void emitRel32(Label Target);
+
+    // emitRR/emitRM - Общий вид "[префикс] [REX] опкод ModRM".
+    void emitRR(uint8_t Prefix, bool W, uint8_t Op1, uint8_t Op2, uint8_t Reg, uint8_t RM);
+    void emitRM(uint8_t Prefix, bool W, uint8_t Op1, uint8_t Op2, uint8_t Reg, x86::Mem M);
+
+public:
+    Label createLabel();
+    void bind(Label L);
+    bool isBound(Label L) const { return LabelOffsets[L] >= 0; }
+    size_t getLabelOffset(Label L) const { return static_cast<size_t>(LabelOffsets[L]); }
+
+    size_t size() const { return Code.size(); }
+    const std::vector<uint8_t> &getCode() const { return Code; }
+
+    // finalize - Дозаполняет переходы; false, если есть непривязанная метка.
+    bool finalize();
+
+    // Целочисленные.
+    void mov(x86::GPR Dst, x86::GPR Src);
+    void mov(x86::GPR Dst, x86::Mem Src);
+    void mov(x86::Mem Dst, x86::GPR Src);
+    void movImm(x86::GPR Dst, int64_t Imm);
+    void add(x86::GPR Dst, x86::GPR Src);
+    void sub(x86::GPR Dst, x86::GPR Src);
+    void and_(x86::GPR Dst, x86::GPR Src);
+    void or_(x86::GPR Dst, x86::GPR Src);
+    void xor_(x86::GPR Dst, x86::GPR Src);
+    void cmp(x86::GPR A, x86::GPR B);
+    void test(x86::GPR A, x86::GPR B);
+    void imul(x86::GPR Dst, x86::GPR Src);
+    void neg(x86::GPR Dst);
+    void cqo();
+    void idiv(x86::GPR Divisor);
+    // setcc - Пишет 0/1 в младший байт Dst и расширяет нулями до 64 бит.
+    void setcc(x86::Cond C, x86::GPR Dst);
+    void subImm(x86::GPR Dst, int32_t Imm);
+
+    // SSE2, скалярный double.
+    void movsd(x86::XMM Dst, x86::XMM Src);
+    void movsd(x86::XMM Dst, x86::Mem Src);
+    void movsd(x86::Mem Dst, x86::XMM Src);
+    void addsd(x86::XMM Dst, x86::XMM Src);
+    void subsd(x86::XMM Dst, x86::XMM Src);
+    void mulsd(x86::XMM Dst, x86::XMM Src);
+    void divsd(x86::XMM Dst, x86::XMM Src);
+    void xorpd(x86::XMM Dst, x86::XMM Src);
+    void ucomisd(x86::XMM A, x86::XMM B);
+    void cvtsi2sd(x86::XMM Dst, x86::GPR Src);
+    void cvttsd2si(x86::GPR Dst, x86::XMM Src);
+    void movq(x86::XMM Dst, x86::GPR Src);
+    void movq(x86::GPR Dst, x86::XMM Src);
+
+    // Управление.
+    void push(x86::GPR Reg);
+    void pop(x86::GPR Reg);
+    void jmp(Label Target);
+    void jcc(x86::Cond C, Label Target);
+    void call(Label Target);
+    void ret();
+};
+
+#endif
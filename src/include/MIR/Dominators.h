@@ -0,0 +1,39 @@
+#ifndef Dominators_h
+#define Dominators_h
+
+#include <vector>
+
+#include "MIR/MIR.h"
+
+// DominatorTree - Непосредственные доминаторы блоков функции.
+//
+// Строится итеративным алгоритмом Cooper–Harvey–Kennedy над обратным
+// post-order. Недостижимые из входа блоки в дерево не входят. Дерево —
+// снимок: после изменения CFG его нужно построить заново.
+class DominatorTree {
+    // RPO - Достижимые блоки в обратном post-order; RPO[0] — вход.
+    std::vector<MIRBlock *> RPO;
+    // RPONumber - Позиция блока в RPO по ID; ~0u у недостижимых.
+    std::vector<unsigned> RPONumber;
+    // IDom - Номер в RPO непосредственного доминатора; у входа — он сам.
+    std::vector<unsigned> IDom;
+
+public:
+    explicit DominatorTree(const MIRFunction &F);
+
+    const std::vector<MIRBlock *> &getReversePostOrder() const { return RPO; }
+
+    bool isReachable(const MIRBlock *B) const { return RPONumber[B->getID()] != ~0u; }
+
+    // getRPONumber - Позиция блока в getReversePostOrder(); ~0u у недостижимых.
+    unsigned getRPONumber(const MIRBlock *B) const { return RPONumber[B->getID()]; }
+
+    // getIDom - nullptr у входа и недостижимых блоков.
+    MIRBlock *getIDom(const MIRBlock *B) const;
+
+    // dominates - A доминирует над B (в том числе A == B). Для
+    // недостижимого B всегда true.
+    bool dominates(const MIRBlock *A, const MIRBlock *B) const;
+};
+
+#endif
@@ -0,0 +1,22 @@
+#ifndef LIRGen_h
+#define LIRGen_h
+
+#include <string>
+
+#include "JIT/LIR.h"
+#include "MIR/MIR.h"
+
+// lowerToLIR - Переводит функции MIR-модуля M в LIR-модуль Out для JIT и
+// LIR-интерпретатора; функции получают те же имена и номера.
+//
+// Bool становится Int (0/1), Void-функция возвращает Int 0. Каждое
+// значение MIR получает свой регистр, phi — тоже: её операнды копируются
+// в регистр phi на дугах из предшественников. Если у дуги condbr есть
+// такие копии, для неё заводится отдельный блок, иначе копии испортили бы
+// регистр phi на пути во второй преемник. Недостижимые блоки пропускаются.
+//
+// В LIR нет памяти, поэтому функции с ref и addr (классы, inout) не
+// переводятся: возвращается false и описание в Error.
+bool lowerToLIR(const MIRModule &M, LIRModule &Out, std::string &Error);
+
+#endif
@@ -0,0 +1,323 @@
+#ifndef MIR_h
+#define MIR_h
+
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Basic/Allocator.h"
+#include "Basic/ArrayRef.h"
+
+// MIR - Типизированное SSA-представление среднего уровня.
+//
+// Функция — список базовых блоков; каждая инструкция определяет не больше
+// одного значения и сама является этим значением. Значения, приходящие из
+// разных предшественников, сливаются phi в начале блока: I-й операнд phi
+// соответствует Preds[I] блока. Инструкции и массивы операндов живут в
+// арене своей функции, поэтому функции можно оптимизировать независимо
+// в разных потоках. Деление на ноль и INT64_MIN / -1 не определены.
+//
+// Память видна только через ref и addr. ref — ссылка на объект класса
+// (HeapObject): alloc_ref возвращает её со счётчиком 1, retain и release
+// меняют счётчик явно, load_field/store_field обращаются к полю по
+// смещению от начала объекта и счётчик не трогают. addr — адрес ячейки
+// в кадре от alloca; через него inout-аргументы передаются по адресу.
+//
+// MIR и LIR (JIT/LIR.h) — два уровня одного конвейера, а не две
+// независимые реализации. MIR хранит то, что нужно оптимизациям: SSA с
+// phi, типы Bool/Ref/Addr и явные retain/release, на которых работают
+// встраивание, LICM и снятие пар счётчиков. LIR — вход JIT: регистры не в
+// SSA, только Int и Float, без памяти, как удобно распределителю регистров.
+// Мост — lowerToLIR (MIR/LIRGen.h); MIRInterpreter остаётся эталоном для
+// проверки проходов и исполняет то, что в LIR пока не переводится (ref и
+// addr).
+
+enum class MIROpcode : uint8_t {
+    #define MIR_OP(Id, Name) Id,
+    #include "MIR/MIROps.def"
+};
+
+const char *getOpcodeName(MIROpcode Op);
+bool isTerminator(MIROpcode Op);
+
+// hasSideEffects - Инструкцию нельзя удалить, даже если её значение не
+// используется. Вызовы считаются побочными: анализа чистоты функций нет.
+bool hasSideEffects(MIROpcode Op);
+
+// accessesMemory - Инструкция читает или пишет память либо счётчик
+// ссылок: переставлять её через другие такие инструкции и выносить из
+// цикла нельзя.
+bool accessesMemory(MIROpcode Op);
+
+enum class MIRType : uint8_t { Void, Int, Float, Bool, Ref, Addr };
+
+const char *getTypeName(MIRType Type);
+
+class MIRBlock;
+class MIRFunction;
+struct ClassMetadata;
+
+// MIRInst - Инструкция в компактной записи: 40 байт на 64-битной
+// платформе, операнды — отдельный массив в арене функции.
+class MIRInst {
+    friend class MIRBlock;
+    friend class MIRFunction;
+
+    MIROpcode Op;
+    MIRType Ty;
+    uint16_t NumOperands;
+    // ID - Номер значения, уникальный в функции; индекс в таблицах проходов.
+    uint32_t ID;
+    MIRBlock *Parent = nullptr;
+    MIRInst **Operands;
+    // Данные, которые не являются значениями: константа, номер параметра
+    // или смещение поля, вызываемая функция, класс alloc_ref,
+    // блоки-преемники br/condbr (для condbr: [истина, ложь]).
+    union {
+        int64_t IntValue;
+        double FloatValue;
+        MIRFunction *Callee;
+        const ClassMetadata *Class;
+        MIRBlock *Targets[2];
+    };
+
+    MIRInst(MIROpcode op, MIRType ty, uint32_t id, MIRInst **operands, unsigned numOperands)
+        : Op(op), Ty(ty), NumOperands(static_cast<uint16_t>(numOperands)), ID(id),
+          Operands(operands), Targets{nullptr, nullptr} {}
+
+public:
+    MIROpcode getOpcode() const { return Op; }
+    MIRType getType() const { return Ty; }
+    uint32_t getID() const { return ID; }
+
+    MIRBlock *getParent() const { return Parent; }
+    void setParent(MIRBlock *B) { Parent = B; }
+
+    unsigned getNumOperands() const { return NumOperands; }
+    MIRInst *getOperand(unsigned I) const { return Operands[I]; }
+    void setOperand(unsigned I, MIRInst *V) { Operands[I] = V; }
+    ArrayRef<MIRInst *> getOperands() const { return {Operands, NumOperands}; }
+
+    bool isTerminator() const { return ::isTerminator(Op); }
+    bool isPhi() const { return Op == MIROpcode::Phi; }
+    bool isConstant() const {
+        return Op == MIROpcode::IConst || Op == MIROpcode::FConst || Op == MIROpcode::BConst;
+    }
+
+    // IConst, BConst (0/1), номер параметра у Param и смещение поля у
+    // LoadField/StoreField.
+    int64_t getIntValue() const { return IntValue; }
+    void setIntValue(int64_t V) { IntValue = V; }
+    double getFloatValue() const { return FloatValue; }
+    void setFloatValue(double V) { FloatValue = V; }
+    bool getBoolValue() const { return IntValue != 0; }
+
+    MIRFunction *getCallee() const { return Callee; }
+    void setCallee(MIRFunction *F) { Callee = F; }
+
+    const ClassMetadata *getClass() const { return Class; }
+    void setClass(const ClassMetadata *C) { Class = C; }
+
+    unsigned getNumSuccessors() const {
+        return Op == MIROpcode::Br ? 1 : Op == MIROpcode::CondBr ? 2 : 0;
+    }
+    MIRBlock *getSuccessor(unsigned I) const { return Targets[I]; }
+    void setSuccessor(unsigned I, MIRBlock *B) { Targets[I] = B; }
+};
+
+static_assert(sizeof(void *) != 8 || sizeof(MIRInst) == 40, "MIRInst grew");
+
+class MIRBlock {
+    friend class MIRFunction;
+
+    uint32_t ID;
+
+    explicit MIRBlock(uint32_t id) : ID(id) {}
+
+public:
+    // Insts - Сначала phi, последним — терминатор.
+    std::vector<MIRInst *> Insts;
+    // Preds - Входящие дуги; блок с condbr на один и тот же блок дважды
+    // встречается дважды.
+    std::vector<MIRBlock *> Preds;
+
+    // getID - Индекс блока в MIRFunction::Blocks.
+    uint32_t getID() const { return ID; }
+
+    MIRInst *getTerminator() const {
+        return !Insts.empty() && Insts.back()->isTerminator() ? Insts.back() : nullptr;
+    }
+
+    unsigned getNumSuccessors() const {
+        MIRInst *T = getTerminator();
+        return T ? T->getNumSuccessors() : 0;
+    }
+    MIRBlock *getSuccessor(unsigned I) const { return getTerminator()->getSuccessor(I); }
+
+    unsigned getNumPhis() const;
+
+    // getPredIndex - Индекс первой дуги из Pred; ~0u, если её нет.
+    unsigned getPredIndex(const MIRBlock *Pred) const;
+
+    // removePredecessor - Убирает дугу Preds[Index] вместе с операндами phi.
+    void removePredecessor(unsigned Index);
+};
+
+class MIRFunction {
+    std::string Name;
+    std::vector<MIRType> ParamTypes;
+    MIRType ReturnType;
+    unsigned Index;
+
+    BumpPtrAllocator Arena;
+    uint32_t NumValues = 0;
+
+public:
+    // Blocks - Blocks[0] — вход; у него нет предшественников.
+    std::vector<std::unique_ptr<MIRBlock>> Blocks;
+
+    MIRFunction(std::string name, std::vector<MIRType> paramTypes, MIRType returnType,
+                unsigned index)
+        : Name(std::move(name)), ParamTypes(std::move(paramTypes)), ReturnType(returnType),
+          Index(index) {}
+
+    const std::string &getName() const { return Name; }
+    ArrayRef<MIRType> getParamTypes() const { return ParamTypes; }
+    MIRType getReturnType() const { return ReturnType; }
+    // getIndex - Номер функции в модуле.
+    unsigned getIndex() const { return Index; }
+
+    MIRBlock *getEntryBlock() const { return Blocks.front().get(); }
+
+    MIRBlock *createBlock();
+
+    // createInst - Размещает инструкцию в арене, в блок не вставляет.
+    MIRInst *createInst(MIROpcode Op, MIRType Ty, ArrayRef<MIRInst *> Operands);
+
+    // setOperands - Заменяет весь список операндов (нужно phi, у которых
+    // число операндов меняется вместе с Preds).
+    void setOperands(MIRInst *I, ArrayRef<MIRInst *> Operands);
+
+    // getNumValues - Верхняя граница ID всех когда-либо созданных
+    // инструкций; удалённые номера не переиспользуются.
+    uint32_t getNumValues() const { return NumValues; }
+
+    unsigned getNumInsts() const;
+
+    size_t getArenaBytes() const { return Arena.getTotalMemory(); }
+
+    // replaceAllUses - Заменяет каждый операнд V на Replacement[V->ID],
+    // если тот задан; цепочки замен разворачиваются до конца.
+    void replaceAllUses(std::vector<MIRInst *> &Replacement);
+
+    // eraseBlocks - Удаляет блоки с Dead[ID], убирает ведущие из них дуги
+    // у оставшихся блоков и перенумеровывает блоки.
+    void eraseBlocks(const std::vector<bool> &Dead);
+
+    void print(std::ostream &OS) const;
+};
+
+// resolveReplacement - Конец цепочки замен для V (см. replaceAllUses).
+MIRInst *resolveReplacement(std::vector<MIRInst *> &Replacement, MIRInst *V);
+
+class MIRModule {
+    std::vector<std::unique_ptr<MIRFunction>> Functions;
+
+public:
+    MIRFunction *createFunction(std::string Name, ArrayRef<MIRType> ParamTypes,
+                                MIRType ReturnType);
+    MIRFunction *getFunction(std::string_view Name) const;
+
+    const std::vector<std::unique_ptr<MIRFunction>> &getFunctions() const {
+        return Functions;
+    }
+
+    unsigned getNumInsts() const;
+
+    // verify - Проверяет структуру блоков, дуги, phi, типы и то, что каждое
+    // определение доминирует над использованиями; при ошибке возвращает
+    // false и описание в Error.
+    bool verify(std::string &Error) const;
+
+    void print(std::ostream &OS) const;
+};
+
+bool verifyFunction(const MIRFunction &F, std::string &Error);
+
+// MIRBuilder - Добавляет инструкции в конец текущего блока функции и
+// поддерживает Preds при создании переходов.
+class MIRBuilder {
+    MIRFunction &F;
+    MIRBlock *Current = nullptr;
+
+    MIRInst *append(MIROpcode Op, MIRType Ty, ArrayRef<MIRInst *> Operands);
+
+public:
+    explicit MIRBuilder(MIRFunction &f) : F(f) {}
+
+    MIRFunction &getFunction() const { return F; }
+
+    MIRBlock *createBlock() { return F.createBlock(); }
+    void setInsertPoint(MIRBlock *B) { Current = B; }
+    MIRBlock *getInsertBlock() const { return Current; }
+
+    // isTerminated - Текущий блок уже завершён переходом или ret.
+    bool isTerminated() const { return Current->getTerminator() != nullptr; }
+
+    MIRInst *createParam(unsigned Index);
+    MIRInst *iconst(int64_t Value);
+    MIRInst *fconst(double Value);
+    MIRInst *bconst(bool Value);
+    MIRInst *createCopy(MIRInst *V);
+
+    // createPhi - Пустая phi в начале блока B, после уже существующих;
+    // операнды задаёт MIRFunction::setOperands.
+    MIRInst *createPhi(MIRType Ty, MIRBlock *B);
+
+    #define MIR_INT_BINARY(Id, Name)                                          \
+    MIRInst *create##Id(MIRInst *A, MIRInst *B) {                             \
+        return append(MIROpcode::Id, MIRType::Int, {A, B});                   \
+    }
+    #define MIR_FLOAT_BINARY(Id, Name)                                        \
+    MIRInst *create##Id(MIRInst *A, MIRInst *B) {                             \
+        return append(MIROpcode::Id, MIRType::Float, {A, B});                 \
+    }
+    #define MIR_BOOL_BINARY(Id, Name)                                         \
+    MIRInst *create##Id(MIRInst *A, MIRInst *B) {                             \
+        return append(MIROpcode::Id, MIRType::Bool, {A, B});                  \
+    }
+    #define MIR_INT_COMPARE(Id, Name) MIR_BOOL_BINARY(Id, Name)
+    #define MIR_FLOAT_COMPARE(Id, Name) MIR_BOOL_BINARY(Id, Name)
+    #include "MIR/MIROps.def"
+
+    MIRInst *createNeg(MIRInst *A) { return append(MIROpcode::Neg, MIRType::Int, {A}); }
+    MIRInst *createFNeg(MIRInst *A) { return append(MIROpcode::FNeg, MIRType::Float, {A}); }
+    MIRInst *createNot(MIRInst *A) { return append(MIROpcode::Not, MIRType::Bool, {A}); }
+    MIRInst *createCall(MIRFunction *Callee, ArrayRef<MIRInst *> Args);
+
+    // createNull - Нулевая ссылка (Ref) или адрес (Addr).
+    MIRInst *createNull(MIRType Ty) { return append(MIROpcode::Null, Ty, {}); }
+    MIRInst *createAllocRef(const ClassMetadata *Class);
+    void createRetain(MIRInst *Object) { append(MIROpcode::Retain, MIRType::Void, {Object}); }
+    void createRelease(MIRInst *Object) { append(MIROpcode::Release, MIRType::Void, {Object}); }
+    MIRInst *createLoadField(MIRType Ty, MIRInst *Object, uint32_t Offset);
+    void createStoreField(MIRInst *Object, uint32_t Offset, MIRInst *Value);
+    // createAlloca - Слот в начале входного блока, где бы ни стояла точка
+    // вставки: alloca выполняется один раз за вызов функции, а не на каждой
+    // итерации цикла, в котором слот нужен.
+    MIRInst *createAlloca();
+    MIRInst *createLoad(MIRType Ty, MIRInst *Addr) { return append(MIROpcode::Load, Ty, {Addr}); }
+    void createStore(MIRInst *Addr, MIRInst *Value) {
+        append(MIROpcode::Store, MIRType::Void, {Addr, Value});
+    }
+
+    void createBr(MIRBlock *Target);
+    void createCondBr(MIRInst *Cond, MIRBlock *IfTrue, MIRBlock *IfFalse);
+    // createRet - Value == nullptr для функций, возвращающих Void.
+    void createRet(MIRInst *Value);
+};
+
+#endif
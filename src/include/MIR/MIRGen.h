@@ -0,0 +1,21 @@
+#ifndef MIRGen_h
+#define MIRGen_h
+
+#include <string>
+
+#include "AST/Decl.h"
+#include "Basic/ArrayRef.h"
+#include "MIR/MIR.h"
+
+// lowerToMIR - Строит MIR для функций Funcs в модуле M.
+//
+// Ожидается проверенное AST: у параметров заданы типы, у функций —
+// FunctionType (без него функция возвращает Void). Поддерживаются Int,
+// Double и Bool; имена в выражениях разрешаются по областям видимости,
+// если DeclRefExpr ещё не связан с объявлением. SSA строится сразу при
+// обходе (Braun et al., "Simple and Efficient Construction of SSA Form"):
+// переменные становятся значениями, phi ставятся по мере чтения.
+// При ошибке возвращает false и описание в Error.
+bool lowerToMIR(ArrayRef<FuncDecl *> Funcs, MIRModule &M, std::string &Error);
+
+#endif
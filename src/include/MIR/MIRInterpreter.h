@@ -0,0 +1,48 @@
+#ifndef MIRInterpreter_h
+#define MIRInterpreter_h
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include "Basic/ArrayRef.h"
+#include "MIR/MIR.h"
+
+class Runtime;
+
+// MIRValue - Значение в интерпретаторе MIR; Bool хранится в I как 0/1,
+// ref и addr — в P.
+union MIRValue {
+    int64_t I;
+    double F;
+    void *P;
+};
+
+inline MIRValue makeMIRInt(int64_t V) { MIRValue R; R.I = V; return R; }
+inline MIRValue makeMIRFloat(double V) { MIRValue R; R.F = V; return R; }
+inline MIRValue makeMIRPointer(void *V) { MIRValue R; R.P = V; return R; }
+
+// MIRInterpreter - Исполняет MIR напрямую. Эталон для проверки проходов:
+// функция до и после оптимизации должна давать один результат.
+//
+// Объекты классов создаёт и освобождает Runtime; без него инструкции
+// над ref выполнять нельзя.
+class MIRInterpreter {
+    Runtime *RT;
+    // Frames - Значения всех активных вызовов подряд; кадр функции
+    // занимает getNumValues() ячеек и адресуется ID инструкции.
+    std::vector<MIRValue> Frames;
+    // Slots - Ячейки alloca всех активных вызовов. Адрес ячейки уходит в
+    // вызываемые функции, поэтому контейнер не должен её перемещать.
+    std::deque<MIRValue> Slots;
+    uint64_t NumInstsExecuted = 0;
+
+public:
+    explicit MIRInterpreter(Runtime *rt = nullptr) : RT(rt) {}
+
+    MIRValue run(const MIRFunction &F, ArrayRef<MIRValue> Args);
+
+    uint64_t getNumInstsExecuted() const { return NumInstsExecuted; }
+};
+
+#endif
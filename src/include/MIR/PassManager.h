@@ -0,0 +1,76 @@
+#ifndef MIRPassManager_h
+#define MIRPassManager_h
+
+#include <cstdint>
+#include <iosfwd>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Basic/ThreadPool.h"
+#include "MIR/MIR.h"
+
+enum class MIRPassID : uint8_t {
+    #define MIR_PASS(Id, Name) Id,
+    #include "MIR/MIRPasses.def"
+};
+
+const char *getPassName(MIRPassID ID);
+bool isFunctionPass(MIRPassID ID);
+
+// MIRPassManager - Выполняет конвейер проходов над модулем.
+//
+// Подряд идущие проходы над функциями образуют группу: каждая функция
+// проходит всю группу целиком в отдельной задаче пула, без синхронизации
+// между проходами. Проходы над модулем (встраивание) — точки
+// синхронизации: выполняются в вызывающем потоке, когда группа перед ними
+// закончилась для всех функций. Без пула всё выполняется последовательно.
+class MIRPassManager {
+public:
+    // PassStats - Суммарная статистика одного места в конвейере.
+    struct PassStats {
+        const char *Name = nullptr;
+        unsigned NumRuns = 0;
+        unsigned NumChanges = 0;
+        // InstsRemoved - Убыль числа инструкций; отрицательна, если проход
+        // код добавил (встраивание).
+        int64_t InstsRemoved = 0;
+        // Nanos - Сумма по функциям: при параллельном запуске больше
+        // реального времени.
+        uint64_t Nanos = 0;
+    };
+
+private:
+    std::vector<MIRPassID> Pipeline;
+    std::vector<PassStats> Stats;
+    std::mutex StatsMutex;
+    ThreadPool *Pool = nullptr;
+    bool VerifyEach = false;
+
+    bool runFunctionGroup(MIRModule &M, size_t Begin, size_t End, std::string &Error);
+
+public:
+    void addPass(MIRPassID ID) { Pipeline.push_back(ID); }
+    // addPass - По имени из MIRPasses.def; false, если прохода нет.
+    bool addPass(std::string_view Name);
+
+    // addDefaultPipeline - Чистка, встраивание, затем повторная чистка,
+    // снятие пар retain/release, которые встраивание свело в один блок, и
+    // вынос инвариантов из циклов уже встроенного кода.
+    void addDefaultPipeline();
+
+    const std::vector<MIRPassID> &getPipeline() const { return Pipeline; }
+
+    void setThreadPool(ThreadPool *P) { Pool = P; }
+    // setVerifyEach - Проверять MIR после каждого прохода; ошибка
+    // называет проход, который её внёс.
+    void setVerifyEach(bool V) { VerifyEach = V; }
+
+    bool run(MIRModule &M, std::string &Error);
+
+    const std::vector<PassStats> &getStats() const { return Stats; }
+    void printStats(std::ostream &OS) const;
+};
+
+#endif
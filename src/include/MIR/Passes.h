@@ -0,0 +1,18 @@
+#ifndef MIRPasses_h
+#define MIRPasses_h
+
+#include "MIR/MIR.h"
+
+// Каждый проход возвращает число сделанных изменений (свёрнутых,
+// удалённых, перенесённых или встроенных инструкций); 0 — функция не
+// изменилась.
+
+#define MIR_FUNCTION_PASS(Id, Name) unsigned run##Id(MIRFunction &F);
+#define MIR_MODULE_PASS(Id, Name) unsigned run##Id(MIRModule &M);
+#include "MIR/MIRPasses.def"
+
+// InlineThreshold - Функции не длиннее стольких инструкций встраиваются
+// в места вызова.
+constexpr unsigned InlineThreshold = 40;
+
+#endif
@@ -19,9 +19,17 @@ class Lexer {
     // Указатель на следующий не обработанный символ.
     const char *CurPtr;
 
+    // IsContinuation - Буфер — продолжение файла, а не его начало
+    // (см. StreamingLexer). В таком буфере нет hashbang.
+    bool IsContinuation = false;
+
 public:
     explicit Lexer(std::string_view input);
 
+    // Lexer - Продолжает лексинг с начала input так, будто предыдущим
+    // токеном был Resume. Первый вызов lex() вернёт сам Resume.
+    Lexer(std::string_view input, const Token &Resume);
+
     Token lex() {
         Token result = NextToken;
         if (result.isNot(tok::eof))
@@ -30,6 +38,10 @@ public:
         return result;
     }
 
+    // getBufferPtr - Позиция сразу за токеном, который вернёт следующий
+    // вызов lex().
+    const char *getBufferPtr() const { return CurPtr; }
+
 private:
     
     void initialize(std::string_view input);
@@ -0,0 +1,95 @@
+#ifndef StreamingLexer_h
+#define StreamingLexer_h
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Lexer.h"
+#include "Token.h"
+
+// StreamingLexer - Лексер для входа, который нельзя целиком держать в памяти
+// или перематывать (pipe, stdin).
+//
+// Вход читается кусками по ChunkSize байт в окно. Внутри окна работает
+// обычный Lexer, поэтому токены совпадают с буферизованным режимом. Токен,
+// который может продолжаться за границей окна, не выдаётся: хвост окна,
+// начиная с конца последнего выданного токена, переносится в начало
+// следующего окна и лексится заново.
+//
+// Комментарии и пробелы между токенами пропускаются отдельным автоматом,
+// который помнит состояние (вложенность `/* */`, незакрытый `//`) между
+// окнами, так что даже гигантский комментарий не копится в памяти. Память
+// ограничена ChunkSize плюс длина самого длинного токена.
+//
+// Текст токена, возвращённого lex(), действителен до следующего вызова lex().
+class StreamingLexer {
+public:
+    // ReadFn - Читает до Size байт в Buffer; 0 означает конец входа.
+    using ReadFn = std::function<size_t(char *Buffer, size_t Size)>;
+
+    static constexpr size_t DefaultChunkSize = 64 * 1024;
+
+private:
+    ReadFn Read;
+    size_t ChunkSize;
+
+    // Window - Текущее окно входа; за последним байтом всегда лежит NUL.
+    std::vector<char> Window;
+    size_t WindowSize = 0;
+    // ResumeOffset - Смещение в окне сразу за последним выданным токеном.
+    size_t ResumeOffset = 0;
+    bool StreamEnded = false;
+
+    // AtStreamStart - Окно начинается с первого байта входа (для hashbang).
+    bool AtStreamStart = true;
+
+    std::optional<Lexer> WindowLexer;
+
+    // Prev - Последний выданный токен. При смене окна его текст копируется в
+    // PrevText: Lexer может вернуть его повторно.
+    Token Prev;
+    std::string PrevText;
+
+    enum class TriviaState : uint8_t { Normal, LineComment, BlockComment };
+    TriviaState State = TriviaState::Normal;
+    unsigned CommentDepth = 0;
+    // CommentPending - '*' или '/', которым закончилось окно внутри
+    // блочного комментария; 0, если такого нет.
+    char CommentPending = 0;
+
+    bool EmittedStart = false;
+    bool Finished = false;
+
+public:
+    explicit StreamingLexer(ReadFn read, size_t chunkSize = DefaultChunkSize);
+
+    // readFromFD - ReadFn поверх файлового дескриптора.
+    static ReadFn readFromFD(int FD);
+
+    Token lex();
+
+    // getWindowCapacity - Сколько памяти сейчас занимает окно.
+    size_t getWindowCapacity() const { return Window.capacity(); }
+
+private:
+    // refill - Переносит хвост окна с ResumeOffset в начало, дочитывает вход,
+    // пропускает пробелы и комментарии и создаёт Lexer над новым окном.
+    void refill();
+
+    // readAtLeast - Читает, пока в окне не станет Target байт или вход
+    // не закончится.
+    void readAtLeast(size_t Target);
+
+    // skipTrivia - Пропускает пробелы и комментарии в начале окна.
+    // Возвращает число пропущенных байт; NeedMore — окно кончилось раньше,
+    // чем стало ясно, где начинается следующий токен.
+    size_t skipTrivia(bool &NeedMore);
+
+    void dropPrefix(size_t Count);
+};
+
+#endif
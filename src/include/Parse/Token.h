@@ -1,29 +1,167 @@
 #ifndef Token_h
 #define Token_h
 
+#include <cstdint>
+#include <initializer_list>
 #include <string_view>
 
-enum class tok {
-  unknown = 0,
-  eof,
-  identifier,
-  oper_binary,
-  oper_postfix,
-  oper_prefix,
-  dollarident,
-  integer_literal,
-  floating_literal,
-  string_literal,
-  character_literal,
-  comment,
-  
-  #define KEYWORD(X) kw_ ## X,
-  #define PUNCTUATOR(X, Y) X,
+enum class tok : uint8_t {
+  #define TOKEN(X) X,
   #include "Tokens.def"
-  
-  START_OF_FILE
 };
 
+constexpr unsigned NumTokenKinds = 0
+  #define TOKEN(X) + 1
+  #include "Tokens.def"
+  ;
+static_assert(NumTokenKinds <= 256, "tok must fit in uint8_t");
+
+// TokenCategory - Биты категорий в TokenInfo::Categories.
+enum TokenCategory : uint8_t {
+  TC_Keyword     = 1 << 0,
+  TC_DeclKeyword = 1 << 1,
+  TC_StmtKeyword = 1 << 2,
+  TC_Punctuation = 1 << 3,
+  TC_Literal     = 1 << 4,
+  TC_Operator    = 1 << 5,
+};
+
+// Associativity - Ассоциативность инфиксного оператора.
+enum class Associativity : uint8_t { None, Left, Right };
+
+// TokenInfo - Метаданные вида токена, генерируются из Tokens.def.
+struct TokenInfo {
+    // Name - Имя для дампа токенов, например "<kw_func>".
+    std::string_view Name;
+    // Spelling - Написание ключевого слова или знака; пусто у токенов,
+    // текст которых задаёт исходник.
+    std::string_view Spelling;
+    uint8_t Categories;
+    // Precedence - Приоритет инфиксного оператора; 0 — не инфиксный.
+    uint8_t Precedence;
+    Associativity Assoc;
+};
+
+// TokenInfos - Таблица метаданных, индекс — значение tok.
+inline constexpr TokenInfo TokenInfos[NumTokenKinds] = {
+  // eof в дампе токенов исторически называется "<EOF>".
+  #define MISC(X)                                                             \
+    {tok::X == tok::eof ? "<EOF>" : "<" #X ">", {}, 0, 0, Associativity::None},
+  #define LITERAL(X) {"<" #X ">", {}, TC_Literal, 0, Associativity::None},
+  #define OPERATOR_TOKEN(X) {"<" #X ">", {}, TC_Operator, 0, Associativity::None},
+  #define KEYWORD(X) {"<kw_" #X ">", #X, TC_Keyword, 0, Associativity::None},
+  #define DECL_KEYWORD(X)                                                     \
+    {"<kw_" #X ">", #X, TC_Keyword | TC_DeclKeyword, 0, Associativity::None},
+  #define STMT_KEYWORD(X)                                                     \
+    {"<kw_" #X ">", #X, TC_Keyword | TC_StmtKeyword, 0, Associativity::None},
+  #define PUNCTUATOR(X, Y) {"<" #X ">", Y, TC_Punctuation, 0, Associativity::None},
+  #define PUNCTUATOR_OPERATOR(X, Y)                                           \
+    {"<" #X ">", Y, TC_Punctuation | TC_Operator, 0, Associativity::None},
+  #define BINARY_OPERATOR(X, Y, Prec, Assoc)                                  \
+    {"<" #X ">", Y, TC_Punctuation | TC_Operator, Prec, Associativity::Assoc},
+  #include "Tokens.def"
+};
+
+constexpr const TokenInfo &getTokenInfo(tok K) {
+    return TokenInfos[static_cast<uint8_t>(K)];
+}
+
+// TokenSet - Множество видов токенов в виде битовой маски. Проверка —
+// один сдвиг и маска, без сравнения с каждым видом по очереди:
+//
+//   static constexpr TokenSet StmtStart = TokenSet::withCategory(TC_StmtKeyword);
+//   if (StmtStart.contains(Tok.getKind())) ...
+class TokenSet {
+    static constexpr unsigned NumWords = (NumTokenKinds + 63) / 64;
+    uint64_t Words[NumWords] = {};
+
+public:
+    constexpr TokenSet() = default;
+    constexpr TokenSet(std::initializer_list<tok> Kinds) {
+        for (tok K : Kinds)
+            insert(K);
+    }
+
+    // withCategory - Все виды, у которых есть хотя бы один бит из Mask.
+    static constexpr TokenSet withCategory(uint8_t Mask) {
+        TokenSet Set;
+        for (unsigned I = 0; I != NumTokenKinds; ++I)
+            if (TokenInfos[I].Categories & Mask)
+                Set.insert(static_cast<tok>(I));
+        return Set;
+    }
+
+    constexpr void insert(tok K) {
+        unsigned Index = static_cast<uint8_t>(K);
+        Words[Index / 64] |= uint64_t(1) << (Index % 64);
+    }
+
+    constexpr bool contains(tok K) const {
+        unsigned Index = static_cast<uint8_t>(K);
+        return (Words[Index / 64] >> (Index % 64)) & 1;
+    }
+
+    constexpr TokenSet operator|(const TokenSet &RHS) const {
+        TokenSet Result = *this;
+        for (unsigned I = 0; I != NumWords; ++I)
+            Result.Words[I] |= RHS.Words[I];
+        return Result;
+    }
+};
+
+// KeywordTable - Хеш-таблица ключевых слов с линейным пробированием,
+// строится из TokenInfos при компиляции. Хеш берёт только длину, первый и
+// последний символ, так что поиск идентификатора — несколько обращений к
+// таблице и не больше одного сравнения строк на пробу.
+class KeywordTable {
+    static constexpr unsigned Size = 256;
+    // Пустой слот — tok::unknown (нулевой вид).
+    tok Slots[Size] = {};
+    unsigned NumKeywords = 0;
+
+    static constexpr unsigned hash(std::string_view Text) {
+        uint32_t H = 2166136261u;
+        for (uint32_t V : {uint32_t(Text.size()), uint32_t(uint8_t(Text.front())),
+                           uint32_t(uint8_t(Text.back()))})
+            H = (H ^ V) * 16777619u;
+        return H % Size;
+    }
+
+public:
+    constexpr KeywordTable() {
+        for (unsigned I = 0; I != NumTokenKinds; ++I) {
+            if (!(TokenInfos[I].Categories & TC_Keyword))
+                continue;
+            unsigned Slot = hash(TokenInfos[I].Spelling);
+            while (Slots[Slot] != tok::unknown)
+                Slot = (Slot + 1) % Size;
+            Slots[Slot] = static_cast<tok>(I);
+            ++NumKeywords;
+        }
+    }
+
+    constexpr unsigned getNumKeywords() const { return NumKeywords; }
+    static constexpr unsigned getCapacity() { return Size; }
+
+    // lookup - Вид ключевого слова или tok::identifier.
+    constexpr tok lookup(std::string_view Text) const {
+        if (Text.empty())
+            return tok::identifier;
+        for (unsigned Slot = hash(Text);; Slot = (Slot + 1) % Size) {
+            tok K = Slots[Slot];
+            if (K == tok::unknown)
+                return tok::identifier;
+            if (getTokenInfo(K).Spelling == Text)
+                return K;
+        }
+    }
+};
+
+inline constexpr KeywordTable Keywords;
+// Заполненность не выше половины держит цепочки проб короткими.
+static_assert(Keywords.getNumKeywords() * 2 <= KeywordTable::getCapacity(),
+              "grow KeywordTable::Size");
+
 class Token {
 private:
     tok Kind;
@@ -50,40 +188,30 @@ public:
 
     bool isNot(tok K) const { return Kind != K; }
     
+    // isAny - Вид токена входит в множество, как в
+    // "if (Tok.isAny(DeclStart)) {...}".
+    bool isAny(const TokenSet &Set) const { return Set.contains(Kind); }
+
+    const TokenInfo &getInfo() const { return getTokenInfo(Kind); }
+
+    // isAnyOperator - Оператор, написание которого задал пользователь
+    // (oper_binary/oper_postfix/oper_prefix), а не знак пунктуации.
     bool isAnyOperator() const {
-      return Kind == tok::oper_binary || Kind == tok::oper_postfix ||
-             Kind == tok::oper_prefix;
+        return (getInfo().Categories & (TC_Operator | TC_Punctuation)) == TC_Operator;
     }
 
-    bool isKeyword() const {
-      switch (Kind) {
-        #define KEYWORD(X) case tok::kw_##X: return true;
-        #include "Tokens.def"
-      default: 
-        return false;
-      }
-    }
-    
-    bool isPunctuation() const {
-        switch (Kind) {
-          #define PUNCTUATOR(X, Y) case tok::X: return true;
-          #include "Tokens.def"
-        default:
-          return false;
-        }
-    }
+    // isOperator - Любой оператор, включая "+", "=", "&" и т. п.
+    bool isOperator() const { return getInfo().Categories & TC_Operator; }
 
-    bool isLiteral() const {
-        switch (Kind) {
-            case tok::integer_literal:
-            case tok::floating_literal:
-            case tok::string_literal:
-            case tok::character_literal:
-                return true;
-            default:
-                return false;
-        }
-    }
+    bool isKeyword() const { return getInfo().Categories & TC_Keyword; }
+
+    bool isDeclKeyword() const { return getInfo().Categories & TC_DeclKeyword; }
+
+    bool isStmtKeyword() const { return getInfo().Categories & TC_StmtKeyword; }
+
+    bool isPunctuation() const { return getInfo().Categories & TC_Punctuation; }
+
+    bool isLiteral() const { return getInfo().Categories & TC_Literal; }
 
     bool isIdentifier() const {
         return Kind == tok::identifier;
@@ -96,53 +224,22 @@ public:
     bool isEOF() const {
         return Kind == tok::eof;
     }
-    
-    std::string_view getTokenName() {
-        switch (Kind) {
-            case tok::unknown: return "<unknown>";
-            case tok::eof: return "<EOF>";
-            case tok::identifier: return "<identifier>";
-            case tok::oper_binary: return "<oper_binary>";
-            case tok::oper_postfix: return "<oper_postfix>";
-            case tok::oper_prefix: return "<oper_prefix>";
-            case tok::dollarident: return "<dollarident>";
-            case tok::integer_literal: return "<integer_literal>";
-            case tok::floating_literal: return "<floating_literal>";
-            case tok::string_literal: return "<string_literal>";
-            case tok::character_literal: return "<character_literal>";
-            case tok::comment: return "<comment>";
-            case tok::START_OF_FILE: return "<START_OF_FILE>";
-            #define KEYWORD(X) case tok::kw_ ## X: return "<kw_" #X ">";
-            #define PUNCTUATOR(X, Y) case tok::X: return "<" #X ">";
-            #include "Tokens.def"
-            
-            default: return "<INVALID_TOKEN>";
-        }
+
+    // getPrecedence - Приоритет инфиксного оператора, 0 — не инфиксный.
+    unsigned getPrecedence() const { return getInfo().Precedence; }
+
+    Associativity getAssociativity() const { return getInfo().Assoc; }
+
+    static std::string_view getTokenName(tok K) {
+        if (static_cast<uint8_t>(K) >= NumTokenKinds)
+            return "<INVALID_TOKEN>";
+        return getTokenInfo(K).Name;
     }
+
+    std::string_view getTokenName() const { return getTokenName(Kind); }
     
     static tok kindOfIdentifier(const char* start, const char* end) {
-        std::string_view text(start, end - start);
-
-        switch (text.size()) {
-        case 2:
-            if (text == "if") return tok::kw_if;
-            break;
-        case 3:
-            if (text == "let") return tok::kw_let;
-            if (text == "var") return tok::kw_var;
-            break;
-
-        case 4:
-            if (text == "else") return tok::kw_else;
-            if (text == "func") return tok::kw_func;
-            break;
-
-        case 6:
-            if (text == "return") return tok::kw_return;
-            break;
-        }
-
-        return tok::identifier;
+        return Keywords.lookup(std::string_view(start, end - start));
     }
 };
 
@@ -0,0 +1,43 @@
+#ifndef HeapObject_h
+#define HeapObject_h
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct HeapObject;
+
+// ClassMetadata - Описание экземпляров класса, общее для всех объектов.
+struct ClassMetadata {
+    std::string Name;
+    // InstanceSize - Размер объекта вместе с заголовком HeapObject.
+    uint32_t InstanceSize = 0;
+    uint32_t InstanceAlignment = 1;
+    // RefOffsets - Смещения от начала объекта до полей-ссылок, в том числе
+    // внутри хранимых на месте структур. При уничтожении объекта для
+    // каждого делается release.
+    std::vector<uint32_t> RefOffsets;
+    // Deinit - Вызывается, когда счётчик падает до нуля, до освобождения
+    // полей; nullptr — deinit нет.
+    void (*Deinit)(HeapObject *Object) = nullptr;
+};
+
+// HeapObject - Заголовок каждого экземпляра класса; поля лежат сразу за ним.
+//
+// Счётчик ссылок интрузивный и неатомарный: объекты одного Runtime не
+// разделяются между потоками. Только что созданный объект имеет счётчик 1.
+struct HeapObject {
+    const ClassMetadata *Metadata;
+    uint32_t RefCount;
+    uint32_t Reserved;
+
+    // getField - Адрес поля по смещению от начала объекта.
+    char *getField(uint32_t Offset) { return reinterpret_cast<char *>(this) + Offset; }
+};
+
+static_assert(sizeof(HeapObject) == 16, "HeapObject header grew");
+
+// HeapObjectHeaderSize - Смещение первого поля объекта.
+constexpr uint32_t HeapObjectHeaderSize = sizeof(HeapObject);
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef Layout_h
+#define Layout_h
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "AST/Identifier.h"
+#include "Basic/ArrayRef.h"
+#include "Runtime/HeapObject.h"
+
+class Decl;
+class StructDecl;
+class TypeBase;
+
+// TypeLayout - Как значение типа лежит в памяти кадра, поля или элемента
+// массива.
+struct TypeLayout {
+    uint32_t Size = 0;
+    uint32_t Alignment = 1;
+    // RefOffsets - Смещения ссылок на объекты классов внутри значения.
+    // Копия значения делает retain по каждому, уничтожение — release;
+    // значения без ссылок копируются memcpy.
+    std::vector<uint32_t> RefOffsets;
+
+    // getStride - Шаг между соседними элементами массива.
+    uint32_t getStride() const {
+        uint32_t Stride = (Size + Alignment - 1) / Alignment * Alignment;
+        return Stride ? Stride : 1;
+    }
+    bool isTrivial() const { return RefOffsets.empty(); }
+};
+
+// FieldLayout - Хранимое свойство struct или class.
+struct FieldLayout {
+    Identifier Name;
+    TypeBase *Type;
+    // Offset - От начала значения структуры или от начала объекта класса
+    // (то есть с учётом заголовка HeapObject).
+    uint32_t Offset;
+    const TypeLayout *Layout;
+};
+
+// NominalLayout - Раскладка struct или class.
+//
+// Значение struct — его поля подряд, на месте: в кадре, в поле другой
+// структуры или объекта, без выделения памяти. Значение class — одна
+// ссылка на HeapObject; поля лежат в объекте после заголовка.
+struct NominalLayout {
+    Identifier Name;
+    bool IsClass = false;
+    // Value - Раскладка значения этого типа; у класса это ссылка.
+    TypeLayout Value;
+    std::vector<FieldLayout> Fields;
+    // Metadata - Только у классов; InstanceSize включает заголовок.
+    std::unique_ptr<ClassMetadata> Metadata;
+
+    const FieldLayout *getField(Identifier FieldName) const;
+};
+
+// LayoutContext - Считает и кеширует раскладки типов программы.
+//
+// Объявления регистрируются заранее, раскладка считается при первом
+// запросе. Хранимые свойства — VarDecl среди членов с явным типом; прочие
+// члены пропускаются. Структура, содержащая себя на месте, — ошибка:
+// у неё бесконечный размер. Класс может ссылаться на себя, потому что
+// его значение — ссылка.
+class LayoutContext {
+    std::unordered_map<Identifier, const StructDecl *> Structs;
+    std::unordered_map<Identifier, ArrayRef<Decl *>> Classes;
+    std::unordered_map<Identifier, std::unique_ptr<NominalLayout>> Layouts;
+    // InProgress - Структуры, раскладка которых сейчас считается.
+    std::vector<Identifier> InProgress;
+
+    TypeLayout IntLayout, DoubleLayout, BoolLayout, RefLayout;
+
+    NominalLayout *computeLayout(Identifier Name, bool IsClass, ArrayRef<Decl *> Members,
+                                 std::string &Error);
+
+public:
+    LayoutContext();
+
+    LayoutContext(const LayoutContext &) = delete;
+    LayoutContext &operator=(const LayoutContext &) = delete;
+
+    void addStruct(const StructDecl *D);
+
+    // addClass - В AST пока нет ClassDecl, поэтому класс задаётся именем
+    // и списком членов.
+    void addClass(Identifier Name, ArrayRef<Decl *> Members);
+
+    // getLayout - Раскладка значения типа T; nullptr и описание в Error,
+    // если тип неизвестен или не может храниться (функции, inout, String).
+    const TypeLayout *getLayout(TypeBase *T, std::string &Error);
+
+    // getNominalLayout - Раскладка struct или class по имени.
+    const NominalLayout *getNominalLayout(Identifier Name, std::string &Error);
+
+    // getClassMetadata - Метаданные для Runtime::allocObject.
+    const ClassMetadata *getClassMetadata(Identifier Name, std::string &Error);
+};
+
+#endif
@@ -0,0 +1,66 @@
+#ifndef ObjectAllocator_h
+#define ObjectAllocator_h
+
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+// ObjectAllocator - Пул для экземпляров классов.
+//
+// Запросы до MaxPooledSize округляются до класса размера, кратного
+// SizeClassGranule, и берутся из слэбов; освобождённый блок попадает в
+// список свободных своего класса и отдаётся следующему объекту того же
+// размера. Большие объекты идут в malloc. Слэбы возвращаются системе
+// только вместе с аллокатором.
+class ObjectAllocator {
+public:
+    static constexpr size_t SizeClassGranule = 16;
+    static constexpr size_t MaxPooledSize = 512;
+    static constexpr size_t NumSizeClasses = MaxPooledSize / SizeClassGranule;
+    static constexpr size_t SlabSize = 64 * 1024;
+
+    struct Stats {
+        uint64_t NumAllocs = 0;
+        uint64_t NumFrees = 0;
+        // NumReused - Выделения, обслуженные из списка свободных.
+        uint64_t NumReused = 0;
+        uint64_t NumLarge = 0;
+        uint64_t NumSlabs = 0;
+    };
+
+private:
+    struct FreeBlock {
+        FreeBlock *Next;
+    };
+
+    FreeBlock *FreeLists[NumSizeClasses] = {};
+    std::vector<void *> Slabs;
+    char *CurPtr = nullptr;
+    char *End = nullptr;
+    Stats AllocStats;
+
+    static size_t getSizeClass(size_t Size) {
+        return (Size + SizeClassGranule - 1) / SizeClassGranule - 1;
+    }
+
+    void *allocateFromSlab(size_t BlockSize);
+
+public:
+    ObjectAllocator() = default;
+    ~ObjectAllocator();
+
+    ObjectAllocator(const ObjectAllocator &) = delete;
+    ObjectAllocator &operator=(const ObjectAllocator &) = delete;
+
+    // allocate - Блок не меньше Size байт, выровненный на SizeClassGranule.
+    void *allocate(size_t Size);
+
+    // deallocate - Size должен совпадать с переданным в allocate.
+    void deallocate(void *Ptr, size_t Size);
+
+    const Stats &getStats() const { return AllocStats; }
+    void printStats(std::ostream &OS) const;
+};
+
+#endif
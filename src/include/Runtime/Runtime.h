@@ -0,0 +1,75 @@
+#ifndef Runtime_h
+#define Runtime_h
+
+#include <cstdint>
+#include <iosfwd>
+#include <vector>
+
+#include "Runtime/HeapObject.h"
+#include "Runtime/Layout.h"
+#include "Runtime/ObjectAllocator.h"
+
+// Runtime - Объектная модель времени выполнения.
+//
+// Значения struct живут на месте и копируются побайтно; retain и release
+// нужны только ссылкам внутри них (TypeLayout::RefOffsets). Экземпляры
+// классов берутся из ObjectAllocator и освобождаются, когда счётчик ссылок
+// падает до нуля. Счётчики операций позволяют сравнивать объём работы с
+// памятью до и после оптимизаций.
+class Runtime {
+public:
+    struct Stats {
+        uint64_t NumAllocs = 0;
+        uint64_t NumDeallocs = 0;
+        uint64_t NumRetains = 0;
+        uint64_t NumReleases = 0;
+    };
+
+private:
+    ObjectAllocator Allocator;
+    Stats RuntimeStats;
+    // DestroyWorklist - Объекты, счётчик которых упал до нуля. Длинная
+    // цепочка ссылок освобождается в цикле, а не рекурсией.
+    std::vector<HeapObject *> DestroyWorklist;
+    // Destroying - Идёт цикл по DestroyWorklist: release из deinit только
+    // добавляет объект в очередь.
+    bool Destroying = false;
+
+    void destroy(HeapObject *Object);
+
+public:
+    Runtime() = default;
+
+    Runtime(const Runtime &) = delete;
+    Runtime &operator=(const Runtime &) = delete;
+
+    // allocObject - Новый объект со счётчиком 1 и обнулёнными полями.
+    HeapObject *allocObject(const ClassMetadata &Metadata);
+
+    // retain, release - nullptr пропускается.
+    void retain(HeapObject *Object) {
+        if (!Object)
+            return;
+        ++RuntimeStats.NumRetains;
+        ++Object->RefCount;
+    }
+    void release(HeapObject *Object);
+
+    // copyValue - Копирует значение с раскладкой L из Src в Dest (память
+    // не пересекается) и делает retain для каждой ссылки копии.
+    void copyValue(void *Dest, const void *Src, const TypeLayout &L);
+
+    // destroyValue - release для каждой ссылки внутри значения.
+    void destroyValue(void *Value, const TypeLayout &L);
+
+    // getNumLiveObjects - Выделено и ещё не освобождено.
+    uint64_t getNumLiveObjects() const {
+        return RuntimeStats.NumAllocs - RuntimeStats.NumDeallocs;
+    }
+
+    const Stats &getStats() const { return RuntimeStats; }
+    const ObjectAllocator &getAllocator() const { return Allocator; }
+    void printStats(std::ostream &OS) const;
+};
+
+#endif
@@ -0,0 +1,197 @@
+#ifndef SymbolTable_h
+#define SymbolTable_h
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+#include "AST/Identifier.h"
+
+// ScopedSymbolTable - Таблица имён для вложенных областей видимости `{}`.
+//
+// Все области хранятся в одной плоской хеш-таблице с открытой адресацией
+// (линейное пробирование), ключ — указатель интернированного Identifier.
+// В таблице всегда лежит только самое внутреннее видимое объявление имени,
+// поэтому lookup стоит O(1) независимо от глубины вложенности.
+//
+// Вход и выход из области обслуживает журнал отмены (UndoLog): каждое
+// объявление добавляет запись — либо "имя новое", либо "имя затенило
+// предыдущее значение". popScope() проигрывает записи текущей области в
+// обратном порядке, так что его стоимость — O(число объявлений в области),
+// и никаких отдельных map на каждую область не выделяется.
+template <typename ValueT>
+class ScopedSymbolTable {
+    struct Bucket {
+        // Key - Identifier::get(); nullptr означает пустой слот.
+        const char *Key = nullptr;
+        // Depth - Глубина области, в которой объявлено текущее значение.
+        unsigned Depth = 0;
+        ValueT Value{};
+    };
+
+    struct UndoEntry {
+        Identifier Name;
+        // Shadowed - true, если объявление затенило имя из внешней области;
+        // тогда OldValue/OldDepth нужно вернуть при выходе из области.
+        bool Shadowed;
+        unsigned OldDepth;
+        ValueT OldValue;
+    };
+
+    std::vector<Bucket> Buckets;
+    unsigned Log2Capacity = 0;
+    unsigned NumEntries = 0;
+
+    std::vector<UndoEntry> UndoLog;
+
+    // ScopeMarks - Размер UndoLog в момент входа в каждую открытую область.
+    std::vector<size_t> ScopeMarks;
+
+public:
+    explicit ScopedSymbolTable(unsigned InitialLog2Capacity = 6) {
+        assert(InitialLog2Capacity > 0 && InitialLog2Capacity < 64);
+        Log2Capacity = InitialLog2Capacity;
+        Buckets.resize(size_t(1) << Log2Capacity);
+    }
+
+    // getDepth - 0 для глобальной области.
+    unsigned getDepth() const { return static_cast<unsigned>(ScopeMarks.size()); }
+
+    void pushScope() { ScopeMarks.push_back(UndoLog.size()); }
+
+    void popScope() {
+        assert(!ScopeMarks.empty() && "Popping the global scope");
+        size_t Mark = ScopeMarks.back();
+        ScopeMarks.pop_back();
+
+        while (UndoLog.size() > Mark) {
+            UndoEntry &Entry = UndoLog.back();
+            Bucket &B = Buckets[findBucket(Entry.Name.get())];
+            assert(B.Key == Entry.Name.get() && "Undo log out of sync");
+            if (Entry.Shadowed) {
+                B.Value = Entry.OldValue;
+                B.Depth = Entry.OldDepth;
+            } else {
+                // Области закрываются строго в обратном порядке, поэтому
+                // любой ключ, который при вставке мог пройти через этот слот,
+                // уже удалён. Надгробия (tombstones) не нужны.
+                B = Bucket();
+                --NumEntries;
+            }
+            UndoLog.pop_back();
+        }
+    }
+
+    // insert - Объявляет Name в текущей области. Возвращает false, если имя
+    // уже объявлено в этой же области (повторное объявление); таблица при
+    // этом не меняется.
+    bool insert(Identifier Name, const ValueT &Value) {
+        assert(!Name.empty() && "Declaring an empty identifier");
+        unsigned Depth = getDepth();
+
+        size_t Index = findBucket(Name.get());
+        Bucket *B = &Buckets[Index];
+        if (B->Key) {
+            if (B->Depth == Depth)
+                return false;
+            UndoLog.push_back({Name, true, B->Depth, B->Value});
+            B->Depth = Depth;
+            B->Value = Value;
+            return true;
+        }
+
+        if ((NumEntries + 1) * 2 > Buckets.size()) {
+            grow();
+            B = &Buckets[findBucket(Name.get())];
+        }
+
+        B->Key = Name.get();
+        B->Depth = Depth;
+        B->Value = Value;
+        ++NumEntries;
+        UndoLog.push_back({Name, false, 0, ValueT{}});
+        return true;
+    }
+
+    // lookup - Самое внутреннее видимое объявление или nullptr.
+    const ValueT *lookup(Identifier Name) const {
+        if (Name.empty())
+            return nullptr;
+        const Bucket &B = Buckets[findBucket(Name.get())];
+        return B.Key ? &B.Value : nullptr;
+    }
+
+    ValueT *lookup(Identifier Name) {
+        return const_cast<ValueT *>(
+            static_cast<const ScopedSymbolTable *>(this)->lookup(Name));
+    }
+
+    bool isDeclaredInCurrentScope(Identifier Name) const {
+        const Bucket &B = Buckets[findBucket(Name.get())];
+        return B.Key && B.Depth == getDepth();
+    }
+
+    // getNumEntries - Число различных видимых имён.
+    unsigned getNumEntries() const { return NumEntries; }
+
+    size_t getCapacity() const { return Buckets.size(); }
+
+    size_t getUndoLogSize() const { return UndoLog.size(); }
+
+    // Scope - RAII-обёртка для pushScope()/popScope().
+    class Scope {
+        ScopedSymbolTable &Table;
+
+    public:
+        explicit Scope(ScopedSymbolTable &T) : Table(T) { Table.pushScope(); }
+        ~Scope() { Table.popScope(); }
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+    };
+
+private:
+    static size_t hash(const char *Key, unsigned Log2) {
+        // Фибоначчиево хеширование: старшие биты произведения хорошо
+        // перемешаны даже для выровненных указателей.
+        uint64_t H = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(Key)) *
+                     0x9E3779B97F4A7C15ull;
+        return static_cast<size_t>(H >> (64 - Log2));
+    }
+
+    // findBucketIn - Слот с ключом Key либо первый пустой слот на его пути.
+    static size_t findBucketIn(const std::vector<Bucket> &Table, unsigned Log2,
+                               const char *Key) {
+        size_t Mask = Table.size() - 1;
+        size_t Index = hash(Key, Log2);
+        while (true) {
+            const Bucket &B = Table[Index];
+            if (B.Key == Key || !B.Key)
+                return Index;
+            Index = (Index + 1) & Mask;
+        }
+    }
+
+    size_t findBucket(const char *Key) const {
+        return findBucketIn(Buckets, Log2Capacity, Key);
+    }
+
+    void grow() {
+        std::vector<Bucket> OldBuckets;
+        OldBuckets.swap(Buckets);
+        unsigned OldLog2 = Log2Capacity++;
+        Buckets.assign(size_t(1) << Log2Capacity, Bucket());
+
+        // Переносим ключи в порядке их первого объявления: тогда новая
+        // таблица выглядит так, будто ключи вставлялись в неё изначально, и
+        // удаление без надгробий в popScope() остаётся корректным.
+        for (const UndoEntry &Entry : UndoLog) {
+            if (Entry.Shadowed)
+                continue;
+            const char *Key = Entry.Name.get();
+            Buckets[findBucket(Key)] = OldBuckets[findBucketIn(OldBuckets, OldLog2, Key)];
+        }
+    }
+};
+
+#endif
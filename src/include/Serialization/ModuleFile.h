@@ -0,0 +1,73 @@
+#ifndef ModuleFile_h
+#define ModuleFile_h
+
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "AST/ASTContext.h"
+#include "Serialization/ModuleFormat.h"
+
+// ModuleFile - Модуль, загруженный через mmap.
+//
+// Открытие проверяет только заголовок; имена и типы читаются из файла по
+// требованию и кешируются в ASTContext, так что импорт большого модуля
+// стоит столько страниц, сколько объявлений реально использовано.
+class ModuleFile {
+public:
+    struct Decl {
+        module_format::DeclKind Kind;
+        Identifier Name;
+        TypeBase *Type;
+    };
+
+private:
+    const char *Data;
+    size_t Size;
+    ASTContext &Ctx;
+    const module_format::Header *Hdr;
+
+    // Кеши номер -> объект; пустой Identifier / nullptr — ещё не загружен.
+    std::vector<Identifier> Identifiers;
+    std::vector<TypeBase *> Types;
+    unsigned NumLoadedTypes = 0;
+
+    ModuleFile(const char *data, size_t size, ASTContext &ctx);
+
+public:
+    ~ModuleFile();
+    ModuleFile(const ModuleFile &) = delete;
+    ModuleFile &operator=(const ModuleFile &) = delete;
+
+    // open - nullptr и текст ошибки в Error, если файл не открылся или
+    // повреждён.
+    static std::unique_ptr<ModuleFile> open(const std::string &Path, ASTContext &Ctx,
+                                            std::string &Error);
+
+    Identifier getModuleName();
+
+    unsigned getNumDecls() const { return Hdr->NumDecls; }
+
+    // lookup - Ищет экспортированное объявление по имени через хеш-таблицу
+    // в файле.
+    std::optional<Decl> lookup(std::string_view Name);
+
+    Decl getDecl(unsigned Index);
+
+    // getNumLoadedTypes - Сколько записей типов уже прочитано из файла.
+    unsigned getNumLoadedTypes() const { return NumLoadedTypes; }
+
+private:
+    bool validateHeader(std::string &Error) const;
+
+    uint32_t readU32(uint32_t Offset) const;
+
+    std::string_view getIdentifierText(module_format::IdentifierID ID) const;
+    Identifier getIdentifier(module_format::IdentifierID ID);
+    TypeBase *getType(module_format::TypeID ID);
+};
+
+#endif
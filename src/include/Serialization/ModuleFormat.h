@@ -0,0 +1,89 @@
+#ifndef ModuleFormat_h
+#define ModuleFormat_h
+
+#include <cstdint>
+
+// Формат бинарного модуля (.swiftminimodule).
+//
+// Файл рассчитан на mmap: в нём нет указателей, только смещения от начала
+// файла (uint32_t), и ничего не нужно разворачивать при загрузке. Читатель
+// трогает лишь те страницы, к которым реально обращается: заголовок,
+// хеш-таблицу имён, записи найденных объявлений и их типов.
+//
+//   Header
+//   Identifier data   [uint32 length][bytes][NUL] ...
+//   IdentifierOffsets uint32[NumIdentifiers]
+//   Type records      TypeRecord + uint32 operands[NumOperands] ...
+//   TypeOffsets       uint32[NumTypes]
+//   DeclRecords       DeclRecord[NumDecls]
+//   DeclHashTable     uint32[NumBuckets]  (индекс объявления + 1, 0 — пусто)
+//
+// Все числа little-endian, записи выровнены на 4 байта.
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "The module format is only implemented for little-endian hosts"
+#endif
+
+namespace module_format {
+
+constexpr char Magic[8] = {'S', 'W', 'M', 'M', 'O', 'D', '\0', '\0'};
+constexpr uint32_t Version = 1;
+
+// Операнды типов ссылаются на другие типы и имена по номеру.
+using IdentifierID = uint32_t;
+using TypeID = uint32_t;
+
+struct Header {
+    char Magic[8];
+    uint32_t Version;
+    uint32_t FileSize;
+
+    IdentifierID ModuleName;
+
+    uint32_t NumIdentifiers;
+    uint32_t IdentifierOffsets;
+
+    uint32_t NumTypes;
+    uint32_t TypeOffsets;
+
+    uint32_t NumDecls;
+    uint32_t DeclRecords;
+
+    uint32_t NumBuckets;
+    uint32_t DeclHashTable;
+};
+
+// TypeRecord - Вид типа (TypeKind) и число операндов; операнды идут следом.
+// Для nominal-типов операнд — IdentifierID имени, для остальных — TypeID
+// (у функции первым идёт результат, затем параметры).
+struct TypeRecord {
+    uint8_t Kind;
+    uint8_t Reserved[3];
+    uint32_t NumOperands;
+};
+
+// DeclKind - Виды экспортируемых объявлений.
+enum class DeclKind : uint8_t {
+    Let,
+    Var,
+    Func,
+    Struct,
+    Class,
+    Enum,
+    TypeAlias,
+};
+
+struct DeclRecord {
+    IdentifierID Name;
+    TypeID Type;
+    uint8_t Kind;
+    uint8_t Reserved[3];
+};
+
+static_assert(sizeof(Header) == 52, "Header layout changed");
+static_assert(sizeof(TypeRecord) == 8, "TypeRecord layout changed");
+static_assert(sizeof(DeclRecord) == 12, "DeclRecord layout changed");
+
+} // namespace module_format
+
+#endif
@@ -0,0 +1,36 @@
+#ifndef ModuleWriter_h
+#define ModuleWriter_h
+
+#include <string>
+#include <vector>
+
+#include "AST/Identifier.h"
+#include "AST/Types.h"
+#include "Serialization/ModuleFormat.h"
+
+// ModuleWriter - Собирает экспортируемые объявления проверенного модуля и
+// сериализует их вместе с нужными типами и именами в формат ModuleFormat.h.
+class ModuleWriter {
+    struct PendingDecl {
+        module_format::DeclKind Kind;
+        Identifier Name;
+        TypeBase *Type;
+    };
+
+    Identifier ModuleName;
+    std::vector<PendingDecl> Decls;
+
+public:
+    explicit ModuleWriter(Identifier moduleName) : ModuleName(moduleName) {}
+
+    void addDecl(module_format::DeclKind Kind, Identifier Name, TypeBase *Type) {
+        Decls.push_back({Kind, Name, Type});
+    }
+
+    // serialize - Образ файла модуля целиком.
+    std::string serialize() const;
+
+    bool writeToFile(const std::string &Path) const;
+};
+
+#endif
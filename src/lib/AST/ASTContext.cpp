@@ -0,0 +1,163 @@
+#include <cassert>
+#include <new>
+#include <ostream>
+#include "AST/ASTContext.h"
+
+static size_t hashTypeOperands(TypeKind Kind, ArrayRef<void *> Operands) {
+    uint64_t Hash = static_cast<uint64_t>(Kind) + 1;
+    for (void *Op : Operands) {
+        Hash ^= reinterpret_cast<uintptr_t>(Op) + 0x9E3779B97F4A7C15ull +
+                (Hash << 6) + (Hash >> 2);
+    }
+    return static_cast<size_t>(Hash * 0x9E3779B97F4A7C15ull);
+}
+
+ASTContext::ASTContext() {
+    UniqueTypes.assign(256, nullptr);
+
+    #define BUILTIN_TYPE(Id, Name)                                            \
+    BuiltinTypes[static_cast<unsigned>(TypeKind::Id)] =                       \
+        getUniqueType(TypeKind::Id, {});
+    #include "AST/TypeNodes.def"
+
+    // Создание встроенных типов не считается обращением к таблице.
+    Stats.NumLookups = Stats.NumHits = Stats.NumProbes = 0;
+}
+
+TypeBase *ASTContext::getUniqueType(TypeKind Kind, ArrayRef<void *> Operands) {
+    size_t Hash = hashTypeOperands(Kind, Operands);
+    ++Stats.NumLookups;
+
+    size_t Mask = UniqueTypes.size() - 1;
+    size_t Index = Hash & Mask;
+    while (TypeBase *T = UniqueTypes[Index]) {
+        ++Stats.NumProbes;
+        if (T->Hash == Hash && T->Kind == Kind && T->getOperands().equals(Operands)) {
+            ++Stats.NumHits;
+            return T;
+        }
+        Index = (Index + 1) & Mask;
+    }
+
+    size_t Size = sizeof(TypeBase) + Operands.size() * sizeof(void *);
+    void *Mem = Allocator.allocate(Size, alignof(TypeBase));
+    Stats.BytesInTypes += Size;
+    ++Stats.NumTypesByKind[static_cast<unsigned>(Kind)];
+
+    uint32_t NumOperands = static_cast<uint32_t>(Operands.size());
+    TypeBase *Result = nullptr;
+    switch (Kind) {
+      #define TYPE(Id, Parent)                                                \
+      case TypeKind::Id:                                                      \
+        static_assert(sizeof(Id##Type) == sizeof(TypeBase),                   \
+                      "Types must not add fields");                           \
+        Result = new (Mem) Id##Type(Kind, NumOperands, Hash);                 \
+        break;
+      #define BUILTIN_TYPE(Id, Name)                                          \
+      case TypeKind::Id:                                                      \
+        Result = new (Mem) BuiltinType(Kind, NumOperands, Hash);              \
+        break;
+      #include "AST/TypeNodes.def"
+    }
+
+    void **Storage = reinterpret_cast<void **>(
+        static_cast<char *>(Mem) + sizeof(TypeBase));
+    for (size_t I = 0; I != Operands.size(); ++I)
+        Storage[I] = Operands[I];
+
+    UniqueTypes[Index] = Result;
+    if (++NumUniqueTypes * 4 > UniqueTypes.size() * 3)
+        growTypeTable();
+    return Result;
+}
+
+void ASTContext::growTypeTable() {
+    std::vector<TypeBase *> Old;
+    Old.swap(UniqueTypes);
+    UniqueTypes.assign(Old.size() * 2, nullptr);
+
+    size_t Mask = UniqueTypes.size() - 1;
+    for (TypeBase *T : Old) {
+        if (!T)
+            continue;
+        size_t Index = T->Hash & Mask;
+        while (UniqueTypes[Index])
+            Index = (Index + 1) & Mask;
+        UniqueTypes[Index] = T;
+    }
+}
+
+StructType *ASTContext::getStructType(Identifier Name) {
+    assert(!Name.empty() && "Nominal type without a name");
+    void *Ops[] = {const_cast<void *>(Name.getAsOpaquePointer())};
+    return static_cast<StructType *>(getUniqueType(TypeKind::Struct, {Ops, 1}));
+}
+
+ClassType *ASTContext::getClassType(Identifier Name) {
+    assert(!Name.empty() && "Nominal type without a name");
+    void *Ops[] = {const_cast<void *>(Name.getAsOpaquePointer())};
+    return static_cast<ClassType *>(getUniqueType(TypeKind::Class, {Ops, 1}));
+}
+
+EnumType *ASTContext::getEnumType(Identifier Name) {
+    assert(!Name.empty() && "Nominal type without a name");
+    void *Ops[] = {const_cast<void *>(Name.getAsOpaquePointer())};
+    return static_cast<EnumType *>(getUniqueType(TypeKind::Enum, {Ops, 1}));
+}
+
+FunctionType *ASTContext::getFunctionType(ArrayRef<TypeBase *> Params,
+                                          TypeBase *Result) {
+    assert(Result && "Function type without a result");
+    // Небольшой буфер на стеке покрывает почти все сигнатуры.
+    void *SmallOps[8];
+    std::vector<void *> LargeOps;
+    void **Ops = SmallOps;
+    if (Params.size() + 1 > 8) {
+        LargeOps.resize(Params.size() + 1);
+        Ops = LargeOps.data();
+    }
+    Ops[0] = Result;
+    for (size_t I = 0; I != Params.size(); ++I)
+        Ops[I + 1] = Params[I];
+    return static_cast<FunctionType *>(
+        getUniqueType(TypeKind::Function, {Ops, Params.size() + 1}));
+}
+
+TupleType *ASTContext::getTupleType(ArrayRef<TypeBase *> Elements) {
+    static_assert(sizeof(TypeBase *) == sizeof(void *));
+    return static_cast<TupleType *>(getUniqueType(
+        TypeKind::Tuple,
+        {reinterpret_cast<void *const *>(Elements.data()), Elements.size()}));
+}
+
+InOutType *ASTContext::getInOutType(TypeBase *ObjectType) {
+    assert(ObjectType && !isa<InOutType>(ObjectType) && "Invalid inout object type");
+    void *Ops[] = {ObjectType};
+    return static_cast<InOutType *>(getUniqueType(TypeKind::InOut, {Ops, 1}));
+}
+
+const ASTContext::TypeStats &ASTContext::getTypeStats() const {
+    Stats.NumUniqueTypes = NumUniqueTypes;
+    Stats.TableCapacity = UniqueTypes.size();
+    return Stats;
+}
+
+void ASTContext::printStats(std::ostream &OS) const {
+    const TypeStats &S = getTypeStats();
+    OS << "*** AST Context Stats:\n";
+    OS << "  " << Identifiers.size() << " identifiers\n";
+    OS << "  " << S.NumUniqueTypes << " unique types\n";
+    #define TYPE(Id, Parent)                                                  \
+    OS << "    " << S.NumTypesByKind[static_cast<unsigned>(TypeKind::Id)]     \
+       << " " #Id " types\n";
+    #include "AST/TypeNodes.def"
+    OS << "  " << S.NumLookups << " type lookups, " << S.NumHits << " hits";
+    if (S.NumLookups)
+        OS << ", " << double(S.NumProbes) / double(S.NumLookups)
+           << " probes/lookup";
+    OS << "\n";
+    OS << "  " << S.TableCapacity << " type table slots ("
+       << S.TableCapacity * sizeof(TypeBase *) << " bytes)\n";
+    OS << "  " << S.BytesInTypes << " bytes in types\n";
+    OS << "  " << getTotalMemory() << " bytes total\n";
+}
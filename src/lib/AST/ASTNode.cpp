@@ -0,0 +1,93 @@
+#include <ostream>
+#include "AST/ASTNode.h"
+#include "AST/ASTVisitor.h"
+
+const char *Node::getKindName(NodeKind Kind) {
+    switch (Kind) {
+    #define NODE(Class, Parent)                                               \
+    case NodeKind::Class:                                                     \
+        return #Class;
+    #include "AST/ASTNodes.def"
+    }
+    return "<invalid>";
+}
+
+namespace {
+
+// AttributePrinter - Печатает собственные поля узла (не детей) после
+// имени вида.
+class AttributePrinter : public ASTVisitor<AttributePrinter, void, std::ostream &> {
+    static void printType(std::ostream &OS, TypeBase *Ty) {
+        if (!Ty)
+            return;
+        OS << " : ";
+        Ty->print(OS);
+    }
+
+public:
+    void visitValueDecl(ValueDecl *D, std::ostream &OS) {
+        OS << ' ' << D->getName().str();
+        printType(OS, D->getType());
+    }
+    void visitVarDecl(VarDecl *D, std::ostream &OS) {
+        OS << (D->isLet() ? " let" : " var");
+        visitValueDecl(D, OS);
+    }
+    void visitParamDecl(ParamDecl *D, std::ostream &OS) {
+        if (D->isInOut())
+            OS << " inout";
+        visitValueDecl(D, OS);
+    }
+
+    void visitExpr(Expr *E, std::ostream &OS) { printType(OS, E->getType()); }
+    void visitIntegerLiteralExpr(IntegerLiteralExpr *E, std::ostream &OS) {
+        OS << ' ' << E->getValue();
+        visitExpr(E, OS);
+    }
+    void visitFloatLiteralExpr(FloatLiteralExpr *E, std::ostream &OS) {
+        OS << ' ' << E->getValue();
+        visitExpr(E, OS);
+    }
+    void visitBooleanLiteralExpr(BooleanLiteralExpr *E, std::ostream &OS) {
+        OS << (E->getValue() ? " true" : " false");
+        visitExpr(E, OS);
+    }
+    void visitStringLiteralExpr(StringLiteralExpr *E, std::ostream &OS) {
+        OS << " \"" << E->getValue() << '"';
+        visitExpr(E, OS);
+    }
+    void visitDeclRefExpr(DeclRefExpr *E, std::ostream &OS) {
+        OS << ' ' << E->getName().str();
+        visitExpr(E, OS);
+    }
+    void visitMemberRefExpr(MemberRefExpr *E, std::ostream &OS) {
+        OS << " ." << E->getMember().str();
+        visitExpr(E, OS);
+    }
+    void visitUnaryExpr(UnaryExpr *E, std::ostream &OS) {
+        OS << ' ' << E->getOperator().str();
+        visitExpr(E, OS);
+    }
+    void visitBinaryExpr(BinaryExpr *E, std::ostream &OS) {
+        OS << ' ' << E->getOperator().str();
+        visitExpr(E, OS);
+    }
+};
+
+void dumpNode(Node *N, std::ostream &OS, unsigned Indent) {
+    OS << std::string(Indent, ' ') << '(' << Node::getKindName(N->getKind());
+    AttributePrinter().visit(N, OS);
+    forEachChild(N, [&](Node *Child) {
+        OS << '\n';
+        dumpNode(Child, OS, Indent + 2);
+    });
+    OS << ')';
+}
+
+} // namespace
+
+void Node::dump(std::ostream &OS) const {
+    // Обход не меняет узлы, но визиторы работают с неконстантными указателями.
+    dumpNode(const_cast<Node *>(this), OS, 0);
+    OS << '\n';
+}
@@ -0,0 +1,71 @@
+#include <algorithm>
+#include "AST/FlatAST.h"
+#include "AST/ASTVisitor.h"
+#include "AST/Decl.h"
+#include "AST/Expr.h"
+
+namespace {
+
+// makeFlatNode - Запись для N вместе с полями, которые проходы читают
+// без обращения к узлу.
+FlatNode makeFlatNode(Node *N, uint32_t SubtreeSize) {
+    FlatNode Entry;
+    Entry.N = N;
+    Entry.Name = nullptr;
+    Entry.Kind = N->getKind();
+    Entry.SubtreeSize = SubtreeSize;
+    Entry.Parent = FlatBody::NoParent;
+    if (auto *Ref = dyn_cast<DeclRefExpr>(N))
+        Entry.Name = Ref->getName().getAsOpaquePointer();
+    else if (auto *D = dyn_cast<ValueDecl>(N))
+        Entry.Name = D->getName().getAsOpaquePointer();
+    else if (auto *U = dyn_cast<UnaryExpr>(N))
+        Entry.Name = U->getOperator().getAsOpaquePointer();
+    else if (auto *B = dyn_cast<BinaryExpr>(N))
+        Entry.Name = B->getOperator().getAsOpaquePointer();
+    else if (auto *M = dyn_cast<MemberRefExpr>(N))
+        Entry.Name = M->getMember().getAsOpaquePointer();
+    else if (auto *I = dyn_cast<IntegerLiteralExpr>(N))
+        Entry.IntValue = I->getValue();
+    else if (auto *L = dyn_cast<BooleanLiteralExpr>(N))
+        Entry.IntValue = L->getValue();
+    return Entry;
+}
+
+// appendPostOrder - Добавляет поддерево N и возвращает индекс N. Детей
+// связываем с родителем уже после того, как он занял свой слот.
+uint32_t appendPostOrder(std::vector<FlatNode> &Nodes, Node *N) {
+    uint32_t First = static_cast<uint32_t>(Nodes.size());
+    std::vector<uint32_t> Children;
+    forEachChild(N, [&](Node *Child) { Children.push_back(appendPostOrder(Nodes, Child)); });
+
+    uint32_t Index = static_cast<uint32_t>(Nodes.size());
+    Nodes.push_back(makeFlatNode(N, Index - First + 1));
+    for (uint32_t Child : Children)
+        Nodes[Child].Parent = Index;
+    return Index;
+}
+
+} // namespace
+
+FlatBody FlatBody::build(Node *Root) {
+    FlatBody Body;
+    if (Root)
+        appendPostOrder(Body.Nodes, Root);
+    return Body;
+}
+
+std::vector<uint32_t> FlatBody::getChildren(uint32_t Index) const {
+    // Последний ребёнок стоит прямо перед родителем, каждый предыдущий —
+    // перед поддеревом следующего.
+    std::vector<uint32_t> Children;
+    uint32_t First = Index + 1 - Nodes[Index].SubtreeSize;
+    uint32_t Child = Index;
+    while (Child > First) {
+        --Child;
+        Children.push_back(Child);
+        Child = Child + 1 - Nodes[Child].SubtreeSize;
+    }
+    std::reverse(Children.begin(), Children.end());
+    return Children;
+}
@@ -0,0 +1,21 @@
+#include "AST/Identifier.h"
+
+Identifier IdentifierTable::get(std::string_view Str) {
+    if (Str.empty())
+        return Identifier();
+
+    auto It = Table.find(Str);
+    if (It != Table.end())
+        return Identifier(It->data());
+
+    uint32_t Length = static_cast<uint32_t>(Str.size());
+    char *Mem = static_cast<char *>(
+        Allocator.allocate(sizeof(uint32_t) + Str.size() + 1, alignof(uint32_t)));
+    std::memcpy(Mem, &Length, sizeof(uint32_t));
+    char *Chars = Mem + sizeof(uint32_t);
+    std::memcpy(Chars, Str.data(), Str.size());
+    Chars[Str.size()] = '\0';
+
+    Table.insert(std::string_view(Chars, Str.size()));
+    return Identifier(Chars);
+}
@@ -0,0 +1,53 @@
+#include <ostream>
+#include <sstream>
+#include "AST/Types.h"
+
+std::string_view BuiltinType::getName() const {
+    switch (getKind()) {
+      #define BUILTIN_TYPE(Id, Name) case TypeKind::Id: return Name;
+      #include "AST/TypeNodes.def"
+    default:
+      return "<invalid builtin>";
+    }
+}
+
+void TypeBase::print(std::ostream &OS) const {
+    if (auto *Builtin = dyn_cast<BuiltinType>(this)) {
+        OS << Builtin->getName();
+        return;
+    }
+    if (auto *Nominal = dyn_cast<NominalType>(this)) {
+        OS << Nominal->getName().str();
+        return;
+    }
+    if (auto *InOut = dyn_cast<InOutType>(this)) {
+        OS << "inout ";
+        InOut->getObjectType()->print(OS);
+        return;
+    }
+
+    auto printList = [&OS](ArrayRef<TypeBase *> Types) {
+        OS << '(';
+        for (size_t I = 0; I != Types.size(); ++I) {
+            if (I)
+                OS << ", ";
+            Types[I]->print(OS);
+        }
+        OS << ')';
+    };
+
+    if (auto *Tuple = dyn_cast<TupleType>(this)) {
+        printList(Tuple->getElements());
+        return;
+    }
+    auto *Fn = cast<FunctionType>(this);
+    printList(Fn->getParams());
+    OS << " -> ";
+    Fn->getResult()->print(OS);
+}
+
+std::string TypeBase::getString() const {
+    std::ostringstream OS;
+    print(OS);
+    return OS.str();
+}
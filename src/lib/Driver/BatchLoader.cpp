@@ -0,0 +1,571 @@
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "Basic/ThreadPool.h"
+#include "Driver/BatchLoader.h"
+
+//===----------------------------------------------------------------------===//
+// BatchLoader::Ring
+//===----------------------------------------------------------------------===//
+
+// Ring - Минимальная обёртка над io_uring на сырых системных вызовах: одна
+// очередь отправки, одна очередь завершений, без SQPOLL.
+class BatchLoader::Ring {
+    int FD = -1;
+    unsigned Entries = 0;
+
+    void *SQRing = MAP_FAILED;
+    void *CQRing = MAP_FAILED;
+    size_t SQRingSize = 0, CQRingSize = 0;
+    io_uring_sqe *SQEs = static_cast<io_uring_sqe *>(MAP_FAILED);
+    size_t SQEsSize = 0;
+
+    unsigned *SQHead = nullptr, *SQTail = nullptr, *SQMask = nullptr, *SQArray = nullptr;
+    unsigned *CQHead = nullptr, *CQTail = nullptr, *CQMask = nullptr;
+    io_uring_cqe *CQEs = nullptr;
+
+    // LocalTail - Хвост с подготовленными, но ещё не опубликованными SQE.
+    unsigned LocalTail = 0;
+
+    template <typename T> static T *at(void *Base, unsigned Offset) {
+        return reinterpret_cast<T *>(static_cast<char *>(Base) + Offset);
+    }
+
+    bool supportsOps(std::initializer_list<unsigned> Ops);
+
+public:
+    Ring() = default;
+    Ring(const Ring &) = delete;
+    Ring &operator=(const Ring &) = delete;
+    ~Ring();
+
+    // create - nullptr, если io_uring недоступен или не умеет нужных
+    // операций.
+    static std::unique_ptr<Ring> create(unsigned Entries);
+
+    unsigned getEntries() const { return Entries; }
+
+    // getSQE - Обнулённый SQE в конце очереди; nullptr, если очередь полна.
+    io_uring_sqe *getSQE();
+
+    // hasUnsubmitted - Есть SQE, которые ядро ещё не забрало: новые или
+    // не принятые прошлым submit.
+    bool hasUnsubmitted() const { return LocalTail != __atomic_load_n(SQHead, __ATOMIC_ACQUIRE); }
+
+    // submit - Публикует подготовленные SQE, отдаёт ядру все ещё не
+    // забранные и ждёт не меньше WaitFor завершений. Возвращает число
+    // принятых SQE или -errno.
+    int submit(unsigned WaitFor);
+
+    // discardUnsubmitted - Вызывает Fn(user_data) для SQE, которые ядро ещё
+    // не забрало, и убирает их из очереди. Без SQPOLL ядро читает очередь
+    // только внутри io_uring_enter, поэтому хвост можно откатить.
+    template <typename Fn> void discardUnsubmitted(Fn &&Callback) {
+        unsigned Head = __atomic_load_n(SQHead, __ATOMIC_ACQUIRE);
+        for (unsigned I = Head; I != LocalTail; ++I)
+            Callback(SQEs[SQArray[I & *SQMask]].user_data);
+        LocalTail = Head;
+        __atomic_store_n(SQTail, Head, __ATOMIC_RELEASE);
+    }
+
+    // drain - Вызывает Fn(user_data, res) для всех готовых CQE.
+    template <typename Fn> void drain(Fn &&Callback) {
+        unsigned Head = *CQHead;
+        unsigned Tail = __atomic_load_n(CQTail, __ATOMIC_ACQUIRE);
+        for (; Head != Tail; ++Head) {
+            const io_uring_cqe &CQE = CQEs[Head & *CQMask];
+            Callback(CQE.user_data, CQE.res);
+        }
+        __atomic_store_n(CQHead, Head, __ATOMIC_RELEASE);
+    }
+};
+
+BatchLoader::Ring::~Ring() {
+    if (SQEs != MAP_FAILED)
+        ::munmap(SQEs, SQEsSize);
+    if (CQRing != MAP_FAILED && CQRing != SQRing)
+        ::munmap(CQRing, CQRingSize);
+    if (SQRing != MAP_FAILED)
+        ::munmap(SQRing, SQRingSize);
+    if (FD >= 0)
+        ::close(FD);
+}
+
+bool BatchLoader::Ring::supportsOps(std::initializer_list<unsigned> Ops) {
+    // Операции open/statx/read появились в 5.6, вместе с IORING_REGISTER_PROBE:
+    // если проба не поддерживается, ядро слишком старое.
+    const unsigned MaxOps = 256;
+    size_t Size = sizeof(io_uring_probe) + MaxOps * sizeof(io_uring_probe_op);
+    std::unique_ptr<void, decltype(&std::free)> Memory(std::calloc(1, Size), &std::free);
+    if (!Memory)
+        return false;
+    auto *Probe = static_cast<io_uring_probe *>(Memory.get());
+    if (::syscall(__NR_io_uring_register, FD, IORING_REGISTER_PROBE, Probe, MaxOps) < 0)
+        return false;
+    for (unsigned Op : Ops)
+        if (Op > Probe->last_op || !(Probe->ops[Op].flags & IO_URING_OP_SUPPORTED))
+            return false;
+    return true;
+}
+
+std::unique_ptr<BatchLoader::Ring> BatchLoader::Ring::create(unsigned Entries) {
+    io_uring_params Params;
+    std::memset(&Params, 0, sizeof(Params));
+    auto R = std::make_unique<Ring>();
+    R->FD = static_cast<int>(::syscall(__NR_io_uring_setup, Entries, &Params));
+    if (R->FD < 0)
+        return nullptr;
+    R->Entries = Params.sq_entries;
+
+    R->SQRingSize = Params.sq_off.array + Params.sq_entries * sizeof(unsigned);
+    R->CQRingSize = Params.cq_off.cqes + Params.cq_entries * sizeof(io_uring_cqe);
+    bool SingleMap = Params.features & IORING_FEAT_SINGLE_MMAP;
+    if (SingleMap)
+        R->SQRingSize = R->CQRingSize = std::max(R->SQRingSize, R->CQRingSize);
+
+    R->SQRing = ::mmap(nullptr, R->SQRingSize, PROT_READ | PROT_WRITE,
+                       MAP_SHARED | MAP_POPULATE, R->FD, IORING_OFF_SQ_RING);
+    if (R->SQRing == MAP_FAILED)
+        return nullptr;
+    R->CQRing = SingleMap ? R->SQRing
+                          : ::mmap(nullptr, R->CQRingSize, PROT_READ | PROT_WRITE,
+                                   MAP_SHARED | MAP_POPULATE, R->FD, IORING_OFF_CQ_RING);
+    if (R->CQRing == MAP_FAILED)
+        return nullptr;
+    R->SQEsSize = Params.sq_entries * sizeof(io_uring_sqe);
+    R->SQEs = static_cast<io_uring_sqe *>(::mmap(nullptr, R->SQEsSize, PROT_READ | PROT_WRITE,
+                                                 MAP_SHARED | MAP_POPULATE, R->FD,
+                                                 IORING_OFF_SQES));
+    if (R->SQEs == MAP_FAILED)
+        return nullptr;
+
+    R->SQHead = at<unsigned>(R->SQRing, Params.sq_off.head);
+    R->SQTail = at<unsigned>(R->SQRing, Params.sq_off.tail);
+    R->SQMask = at<unsigned>(R->SQRing, Params.sq_off.ring_mask);
+    R->SQArray = at<unsigned>(R->SQRing, Params.sq_off.array);
+    R->CQHead = at<unsigned>(R->CQRing, Params.cq_off.head);
+    R->CQTail = at<unsigned>(R->CQRing, Params.cq_off.tail);
+    R->CQMask = at<unsigned>(R->CQRing, Params.cq_off.ring_mask);
+    R->CQEs = at<io_uring_cqe>(R->CQRing, Params.cq_off.cqes);
+    R->LocalTail = *R->SQTail;
+
+    if (!R->supportsOps({IORING_OP_OPENAT, IORING_OP_STATX, IORING_OP_READ, IORING_OP_CLOSE}))
+        return nullptr;
+    return R;
+}
+
+io_uring_sqe *BatchLoader::Ring::getSQE() {
+    unsigned Head = __atomic_load_n(SQHead, __ATOMIC_ACQUIRE);
+    if (LocalTail - Head >= Entries)
+        return nullptr;
+    unsigned Index = LocalTail & *SQMask;
+    io_uring_sqe *SQE = &SQEs[Index];
+    std::memset(SQE, 0, sizeof(*SQE));
+    SQArray[Index] = Index;
+    ++LocalTail;
+    return SQE;
+}
+
+int BatchLoader::Ring::submit(unsigned WaitFor) {
+    __atomic_store_n(SQTail, LocalTail, __ATOMIC_RELEASE);
+    unsigned Flags = WaitFor ? IORING_ENTER_GETEVENTS : 0;
+    long Result;
+    do {
+        // Считаем от головы, а не от прошлого хвоста: SQE, которые прошлый
+        // вызов не принял, отправляются снова.
+        unsigned ToSubmit = LocalTail - __atomic_load_n(SQHead, __ATOMIC_ACQUIRE);
+        Result = ::syscall(__NR_io_uring_enter, FD, ToSubmit, WaitFor, Flags, nullptr, 0);
+    } while (Result < 0 && errno == EINTR);
+    return Result < 0 ? -errno : static_cast<int>(Result);
+}
+
+//===----------------------------------------------------------------------===//
+// BatchLoader
+//===----------------------------------------------------------------------===//
+
+BatchLoader::BatchLoader(Options opts) : Opts(opts) {
+    Opts.QueueDepth = std::max(Opts.QueueDepth, 1u);
+    // На файл в полёте не больше двух операций (open + statx), плюс запас
+    // под close, которые не ждём.
+    if (!Opts.ForceThreadPool)
+        IOUring = Ring::create(Opts.QueueDepth * 4);
+}
+
+BatchLoader::~BatchLoader() = default;
+
+const char *BatchLoader::getBackendName(Backend B) {
+    switch (B) {
+    case Backend::IOUring: return "io_uring";
+    case Backend::ThreadPool: return "thread-pool";
+    }
+    return "<invalid>";
+}
+
+void BatchLoader::load(const std::vector<std::string> &Paths, const Handler &OnLoaded) {
+    LoadStats = Stats();
+    auto Start = std::chrono::steady_clock::now();
+    if (IOUring)
+        loadWithRing(Paths, OnLoaded);
+    else
+        loadWithThreadPool(Paths, OnLoaded);
+    LoadStats.LoadMicros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - Start)
+            .count());
+}
+
+namespace {
+
+// InitialStreamCapacity - Начальный буфер для файлов, размер которых заранее
+// неизвестен: каналы, FIFO, /dev/stdin, файлы /proc с нулевым st_size.
+constexpr size_t InitialStreamCapacity = 64 * 1024;
+
+// isStream - Читать ли файл до EOF, а не до размера из stat.
+bool isStream(bool IsRegular, uint64_t Size) { return !IsRegular || Size == 0; }
+
+// growBuffer - Удваивает буфер, сохраняя первые Used байт; место под
+// завершающий NUL остаётся всегда.
+void growBuffer(std::unique_ptr<char[]> &Data, size_t Used, uint64_t &Capacity) {
+    Capacity *= 2;
+    std::unique_ptr<char[]> Grown(new char[Capacity + 1]);
+    std::memcpy(Grown.get(), Data.get(), Used);
+    Data = std::move(Grown);
+}
+
+enum RingOp : uint64_t { OpOpen, OpStatx, OpRead, OpClose };
+
+// RingSlot - Файл, который сейчас читается через кольцо. Адрес Statx
+// передаётся ядру, поэтому слоты не перемещаются.
+struct RingSlot {
+    unsigned Index = 0;
+    int FD = -1;
+    int Errno = 0;
+    // Pending - Сколько из open/statx ещё не завершилось.
+    unsigned Pending = 0;
+    // Stream - Файл читается до EOF с текущей позиции, Size — ёмкость
+    // буфера; иначе Size — размер из statx.
+    bool Stream = false;
+    uint64_t Size = 0;
+    uint64_t Done = 0;
+    std::unique_ptr<char[]> Data;
+    struct statx Statx;
+};
+
+// makeUserData - У close вместо номера слота — сам дескриптор: слот к
+// моменту завершения close может уже читать другой файл.
+uint64_t makeUserData(unsigned Slot, RingOp Op) { return uint64_t(Slot) << 2 | Op; }
+
+// Одно чтение io_uring ограничено 32-битной длиной.
+constexpr uint64_t MaxReadChunk = 1u << 30;
+
+} // namespace
+
+void BatchLoader::loadWithRing(const std::vector<std::string> &Paths, const Handler &OnLoaded) {
+    Ring &R = *IOUring;
+    std::vector<RingSlot> Slots(std::min<size_t>(Opts.QueueDepth, Paths.size()));
+    std::vector<unsigned> FreeSlots;
+    for (unsigned S = static_cast<unsigned>(Slots.size()); S-- != 0;)
+        FreeSlots.push_back(S);
+    std::vector<LoadedFile> Ready;
+    size_t Next = 0, NumHandled = 0;
+    // InFlight - Операции без завершения (в очереди, в ядре или брошенные);
+    // не больше Entries, поэтому очередь завершений (2 * Entries) не
+    // переполняется, а в очереди отправки всегда есть место.
+    unsigned InFlight = 0;
+    // RingErrno - Ошибка io_uring_enter. После неё кольцо больше не
+    // используется: брошенные операции завершаются с этой ошибкой, новые
+    // файлы не начинаются, а уже принятые ядром операции дожидаемся.
+    int RingErrno = 0;
+    // Abandoned - user_data операций, которые ядро так и не приняло.
+    std::vector<uint64_t> Abandoned;
+    // Scratch - Сюда заполняется операция, для которой нет места в
+    // кольце после его отказа; она сразу попадает в Abandoned.
+    io_uring_sqe Scratch;
+
+    auto abandonRing = [&](int Errno) {
+        RingErrno = Errno;
+        R.discardUnsubmitted([&](uint64_t UserData) { Abandoned.push_back(UserData); });
+    };
+    auto enter = [&](unsigned WaitFor) {
+        int Result = R.submit(WaitFor);
+        ++LoadStats.NumSyscalls;
+        // EBUSY — переполнена очередь завершений: после drain неотправленные
+        // SQE уйдут следующим вызовом.
+        if (Result < 0 && Result != -EBUSY && !RingErrno)
+            abandonRing(-Result);
+        return Result;
+    };
+    auto sqe = [&](uint64_t UserData) {
+        ++InFlight;
+        io_uring_sqe *SQE = RingErrno ? nullptr : R.getSQE();
+        if (!SQE && !RingErrno) {
+            int Result = enter(0);
+            SQE = RingErrno ? nullptr : R.getSQE();
+            // Места так и не стало: ядро не приняло ни одного SQE.
+            if (!SQE && !RingErrno)
+                abandonRing(Result < 0 ? -Result : EBUSY);
+        }
+        if (!SQE) {
+            Abandoned.push_back(UserData);
+            SQE = &Scratch;
+        }
+        SQE->user_data = UserData;
+        return SQE;
+    };
+    auto queueRead = [&](unsigned S) {
+        RingSlot &Slot = Slots[S];
+        if (Slot.Stream && Slot.Done == Slot.Size)
+            growBuffer(Slot.Data, Slot.Done, Slot.Size);
+        io_uring_sqe *SQE = sqe(makeUserData(S, OpRead));
+        SQE->opcode = IORING_OP_READ;
+        SQE->fd = Slot.FD;
+        SQE->addr = reinterpret_cast<uint64_t>(Slot.Data.get() + Slot.Done);
+        SQE->len = static_cast<uint32_t>(std::min(Slot.Size - Slot.Done, MaxReadChunk));
+        // -1 — читать с текущей позиции: у канала смещения нет.
+        SQE->off = Slot.Stream ? uint64_t(-1) : Slot.Done;
+    };
+    auto finish = [&](unsigned S) {
+        RingSlot &Slot = Slots[S];
+        if (Slot.FD >= 0 && RingErrno) {
+            ::close(Slot.FD);
+        } else if (Slot.FD >= 0) {
+            io_uring_sqe *SQE = sqe(makeUserData(static_cast<unsigned>(Slot.FD), OpClose));
+            SQE->opcode = IORING_OP_CLOSE;
+            SQE->fd = Slot.FD;
+        }
+        LoadedFile File;
+        File.Index = Slot.Index;
+        File.Path = Paths[Slot.Index];
+        File.Errno = Slot.Errno;
+        if (!Slot.Errno) {
+            Slot.Data[Slot.Done] = '\0';
+            File.Data = std::move(Slot.Data);
+            File.Size = Slot.Done;
+        }
+        Ready.push_back(std::move(File));
+        FreeSlots.push_back(S);
+    };
+    auto startFiles = [&]() {
+        for (; RingErrno && Next != Paths.size(); ++Next) {
+            LoadedFile File;
+            File.Index = static_cast<unsigned>(Next);
+            File.Path = Paths[Next];
+            File.Errno = RingErrno;
+            Ready.push_back(std::move(File));
+        }
+        while (Next != Paths.size() && !FreeSlots.empty() && InFlight + 2 <= R.getEntries()) {
+            unsigned S = FreeSlots.back();
+            FreeSlots.pop_back();
+            RingSlot &Slot = Slots[S];
+            Slot.Index = static_cast<unsigned>(Next);
+            Slot.FD = -1;
+            Slot.Errno = 0;
+            Slot.Pending = 2;
+            Slot.Stream = false;
+            Slot.Size = Slot.Done = 0;
+            // open и statx по пути независимы и уходят в ядро вместе.
+            const char *Path = Paths[Next++].c_str();
+            io_uring_sqe *Open = sqe(makeUserData(S, OpOpen));
+            Open->opcode = IORING_OP_OPENAT;
+            Open->fd = AT_FDCWD;
+            Open->addr = reinterpret_cast<uint64_t>(Path);
+            Open->open_flags = O_RDONLY | O_CLOEXEC;
+            io_uring_sqe *Stat = sqe(makeUserData(S, OpStatx));
+            Stat->opcode = IORING_OP_STATX;
+            Stat->fd = AT_FDCWD;
+            Stat->addr = reinterpret_cast<uint64_t>(Path);
+            Stat->len = STATX_TYPE | STATX_SIZE;
+            Stat->off = reinterpret_cast<uint64_t>(&Slot.Statx);
+        }
+    };
+    auto complete = [&](uint64_t UserData, int Result) {
+        --InFlight;
+        auto Op = static_cast<RingOp>(UserData & 3);
+        unsigned S = static_cast<unsigned>(UserData >> 2);
+        if (Op == OpClose)
+            return;
+        RingSlot &Slot = Slots[S];
+        if (Op == OpRead) {
+            if ((Result == -EAGAIN || Result == -EINTR) && !RingErrno) {
+                queueRead(S);
+                return;
+            }
+            if (Result < 0)
+                Slot.Errno = -Result;
+            else
+                Slot.Done += static_cast<uint64_t>(Result);
+            // Поток читается до нулевого read; обычный файл — до размера из
+            // statx, а короткое чтение до конца значит, что файл укоротился.
+            if (Result > 0 && (Slot.Stream || Slot.Done != Slot.Size))
+                queueRead(S);
+            else
+                finish(S);
+            return;
+        }
+
+        if (Result < 0 && !Slot.Errno)
+            Slot.Errno = -Result;
+        else if (Op == OpOpen && Result >= 0)
+            Slot.FD = Result;
+        else if (Op == OpStatx && Result >= 0) {
+            bool IsRegular = !(Slot.Statx.stx_mask & STATX_TYPE) || S_ISREG(Slot.Statx.stx_mode);
+            Slot.Stream = isStream(IsRegular, Slot.Statx.stx_size);
+            Slot.Size = Slot.Stream ? InitialStreamCapacity : Slot.Statx.stx_size;
+        }
+        if (--Slot.Pending)
+            return;
+        if (Slot.Errno) {
+            finish(S);
+            return;
+        }
+        Slot.Data.reset(new char[Slot.Size + 1]);
+        if (Slot.Size)
+            queueRead(S);
+        else
+            finish(S);
+    };
+    // failAbandoned - Завершает брошенные операции ошибкой кольца; их
+    // завершение может бросить ещё (close после read), поэтому до пустой
+    // очереди. Брошенный close закрывает дескриптор сам.
+    auto failAbandoned = [&]() {
+        while (!Abandoned.empty()) {
+            uint64_t UserData = Abandoned.back();
+            Abandoned.pop_back();
+            if ((UserData & 3) == OpClose)
+                ::close(static_cast<int>(UserData >> 2));
+            complete(UserData, -RingErrno);
+        }
+    };
+
+    while (NumHandled != Paths.size()) {
+        startFiles();
+        if (InFlight)
+            enter(1);
+        R.drain(complete);
+        failAbandoned();
+
+        // Новые чтения отправляем до обработки готовых файлов, чтобы диск
+        // работал, пока их лексят.
+        startFiles();
+        if (!RingErrno && R.hasUnsubmitted())
+            enter(0);
+        failAbandoned();
+        for (LoadedFile &File : Ready) {
+            ++LoadStats.NumFiles;
+            LoadStats.NumFailed += File.Errno != 0;
+            LoadStats.NumBytes += File.Size;
+            OnLoaded(File);
+            ++NumHandled;
+        }
+        Ready.clear();
+    }
+
+    // Дожидаемся оставшихся close: их CQE не должны достаться следующему load.
+    while (InFlight) {
+        enter(1);
+        R.drain(complete);
+        failAbandoned();
+    }
+}
+
+namespace {
+
+// readFile - Запасной путь: обычные блокирующие вызовы в рабочем потоке.
+LoadedFile readFile(unsigned Index, const std::string &Path, std::atomic<uint64_t> &Syscalls) {
+    LoadedFile File;
+    File.Index = Index;
+    File.Path = Path;
+    int FD = ::open(Path.c_str(), O_RDONLY | O_CLOEXEC);
+    ++Syscalls;
+    if (FD < 0) {
+        File.Errno = errno;
+        return File;
+    }
+    struct stat Stat;
+    ++Syscalls;
+    if (::fstat(FD, &Stat) < 0) {
+        File.Errno = errno;
+        ::close(FD);
+        return File;
+    }
+    bool Stream = isStream(S_ISREG(Stat.st_mode), static_cast<uint64_t>(Stat.st_size));
+    uint64_t Size = Stream ? InitialStreamCapacity : static_cast<uint64_t>(Stat.st_size);
+    File.Data.reset(new char[Size + 1]);
+    while (Stream || File.Size != Size) {
+        if (File.Size == Size)
+            growBuffer(File.Data, File.Size, Size);
+        ssize_t N = ::read(FD, File.Data.get() + File.Size, Size - File.Size);
+        ++Syscalls;
+        if (N < 0 && errno == EINTR)
+            continue;
+        if (N < 0)
+            File.Errno = errno;
+        if (N <= 0)
+            break;
+        File.Size += static_cast<size_t>(N);
+    }
+    ::close(FD);
+    ++Syscalls;
+    if (File.Errno) {
+        File.Data.reset();
+        File.Size = 0;
+    } else {
+        File.Data[File.Size] = '\0';
+    }
+    return File;
+}
+
+} // namespace
+
+void BatchLoader::loadWithThreadPool(const std::vector<std::string> &Paths,
+                                     const Handler &OnLoaded) {
+    std::mutex Mutex;
+    std::condition_variable ReadyCondition;
+    std::deque<LoadedFile> Ready;
+    std::atomic<uint64_t> Syscalls{0};
+
+    // Пул объявлен последним: его деструктор дожидается рабочих потоков до
+    // того, как исчезнут очередь и мьютекс, которыми они пользуются.
+    ThreadPool Pool(Opts.NumThreads);
+    size_t Next = 0;
+    auto submitNext = [&]() {
+        unsigned Index = static_cast<unsigned>(Next++);
+        Pool.async([&, Index] {
+            LoadedFile File = readFile(Index, Paths[Index], Syscalls);
+            std::lock_guard<std::mutex> Lock(Mutex);
+            Ready.push_back(std::move(File));
+            ReadyCondition.notify_one();
+        });
+    };
+    while (Next != Paths.size() && Next != Opts.QueueDepth)
+        submitNext();
+
+    for (size_t NumHandled = 0; NumHandled != Paths.size(); ++NumHandled) {
+        LoadedFile File;
+        {
+            std::unique_lock<std::mutex> Lock(Mutex);
+            ReadyCondition.wait(Lock, [&] { return !Ready.empty(); });
+            File = std::move(Ready.front());
+            Ready.pop_front();
+        }
+        if (Next != Paths.size())
+            submitNext();
+        ++LoadStats.NumFiles;
+        LoadStats.NumFailed += File.Errno != 0;
+        LoadStats.NumBytes += File.Size;
+        OnLoaded(File);
+    }
+    LoadStats.NumSyscalls = Syscalls;
+}
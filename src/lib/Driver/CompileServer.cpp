@@ -0,0 +1,310 @@
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "Basic/Hashing.h"
+#include "Driver/CompileServer.h"
+#include "Parse/Lexer.h"
+
+static bool readWholeFile(const std::string &Path, std::string &Contents) {
+    std::ifstream File(Path, std::ios::binary);
+    if (!File.is_open())
+        return false;
+    std::stringstream Buffer;
+    Buffer << File.rdbuf();
+    Contents = Buffer.str();
+    return true;
+}
+
+static std::string makeError(std::string_view Message) {
+    return "error: " + std::string(Message);
+}
+
+std::string CompileServer::handleRequest(std::string_view Request) {
+    auto Start = std::chrono::steady_clock::now();
+    ++Counters.NumRequests;
+
+    std::string_view Line = Request;
+    std::string_view Body;
+    bool HasBody = false;
+    size_t NewLine = Request.find('\n');
+    if (NewLine != std::string_view::npos) {
+        Line = Request.substr(0, NewLine);
+        Body = Request.substr(NewLine + 1);
+        HasBody = true;
+    }
+
+    std::string_view Command = Line;
+    std::string Path;
+    size_t Space = Line.find(' ');
+    if (Space != std::string_view::npos) {
+        Command = Line.substr(0, Space);
+        Path = std::string(Line.substr(Space + 1));
+    }
+
+    std::string Response;
+    if (Command == "open" && !Path.empty()) {
+        Response = handleOpen(Path);
+    } else if (Command == "change" && !Path.empty()) {
+        Response = handleChange(Path, Body, HasBody);
+    } else if (Command == "tokens" && !Path.empty()) {
+        Response = handleTokens(Path);
+    } else if (Command == "close" && !Path.empty()) {
+        Response = Files.erase(Path) ? "ok" : makeError("file is not open: " + Path);
+    } else if (Command == "stats") {
+        Response = handleStats();
+    } else if (Command == "shutdown") {
+        ShutdownRequested = true;
+        Response = "ok";
+    } else {
+        Response = makeError("unknown request: " + std::string(Line));
+    }
+
+    auto Micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - Start).count();
+    Counters.LastRequestMicros = static_cast<uint64_t>(Micros);
+    Counters.TotalRequestMicros += static_cast<uint64_t>(Micros);
+    return Response;
+}
+
+std::string CompileServer::handleOpen(const std::string &Path) {
+    auto It = Files.find(Path);
+    if (It != Files.end()) {
+        ++Counters.NumReuses;
+        return "ok " + std::to_string(It->second->Tokens.size()) + " tokens (cached)";
+    }
+
+    std::string Contents;
+    if (!readWholeFile(Path, Contents))
+        return makeError("can not open file: " + Path);
+    updateFile(Path, std::move(Contents));
+    return "ok " + std::to_string(Files[Path]->Tokens.size()) + " tokens";
+}
+
+std::string CompileServer::handleChange(const std::string &Path,
+                                        std::string_view Body, bool HasBody) {
+    std::string Contents;
+    if (HasBody)
+        Contents = std::string(Body);
+    else if (!readWholeFile(Path, Contents))
+        return makeError("can not open file: " + Path);
+
+    bool Relexed = updateFile(Path, std::move(Contents));
+    const SourceFile &File = *Files[Path];
+    return "ok " + std::to_string(File.Tokens.size()) + " tokens" +
+           (Relexed ? "" : " (unchanged)");
+}
+
+std::string CompileServer::handleTokens(const std::string &Path) {
+    auto It = Files.find(Path);
+    if (It == Files.end())
+        return makeError("file is not open: " + Path);
+    ++Counters.NumReuses;
+
+    const SourceFile &File = *It->second;
+    std::string Response = "ok " + std::to_string(File.Tokens.size()) + "\n";
+    for (Token Tok : File.Tokens) {
+        Response += Tok.getTokenName();
+        Response += ' ';
+        Response += std::to_string(Tok.getText().data() - File.Buffer.data());
+        Response += ' ';
+        Response += std::to_string(Tok.getText().size());
+        Response += ' ';
+        Response += Tok.getText();
+        Response += '\n';
+    }
+    return Response;
+}
+
+std::string CompileServer::handleStats() const {
+    size_t NumTokens = 0, BufferBytes = 0;
+    for (const auto &Entry : Files) {
+        NumTokens += Entry.second->Tokens.size();
+        BufferBytes += Entry.second->Buffer.size();
+    }
+
+    std::string Response = "ok\n";
+    Response += "files " + std::to_string(Files.size()) + "\n";
+    Response += "tokens " + std::to_string(NumTokens) + "\n";
+    Response += "buffer-bytes " + std::to_string(BufferBytes) + "\n";
+    Response += "identifiers " + std::to_string(getNumIdentifiers()) + "\n";
+    Response += "identifier-bytes " + std::to_string(getIdentifierMemory()) + "\n";
+    Response += "requests " + std::to_string(Counters.NumRequests) + "\n";
+    Response += "lexes " + std::to_string(Counters.NumLexes) + "\n";
+    Response += "reuses " + std::to_string(Counters.NumReuses) + "\n";
+    Response += "total-us " + std::to_string(Counters.TotalRequestMicros) + "\n";
+    return Response;
+}
+
+size_t CompileServer::getNumIdentifiers() const {
+    size_t NumIdentifiers = 0;
+    for (const auto &Entry : Files)
+        NumIdentifiers += Entry.second->Identifiers->size();
+    return NumIdentifiers;
+}
+
+size_t CompileServer::getIdentifierMemory() const {
+    size_t Bytes = 0;
+    for (const auto &Entry : Files)
+        Bytes += Entry.second->Identifiers->getMemoryUsage();
+    return Bytes;
+}
+
+bool CompileServer::updateFile(const std::string &Path, std::string Contents) {
+    uint64_t Hash = hashBytes(Contents);
+
+    std::unique_ptr<SourceFile> &Slot = Files[Path];
+    if (Slot && Slot->ContentHash == Hash && Slot->Buffer == Contents) {
+        ++Counters.NumReuses;
+        return false;
+    }
+
+    if (!Slot) {
+        Slot = std::make_unique<SourceFile>();
+        Slot->Path = Path;
+    }
+    Slot->Buffer = std::move(Contents);
+    Slot->ContentHash = Hash;
+    ++Slot->Version;
+    lexFile(*Slot);
+    return true;
+}
+
+void CompileServer::lexFile(SourceFile &File) {
+    ++Counters.NumLexes;
+    File.Tokens.clear();
+    File.Names.clear();
+    // Старая таблица уходит вместе с именами прошлой версии файла.
+    File.Identifiers = std::make_unique<IdentifierTable>();
+
+    Lexer L(File.Buffer);
+    // Первый токен — START_OF_FILE, в кеш его не кладём.
+    L.lex();
+    while (true) {
+        Token Tok = L.lex();
+        File.Tokens.push_back(Tok);
+        if (Tok.isIdentifier())
+            File.Names.push_back(File.Identifiers->get(Tok.getText()));
+        if (Tok.isEOF())
+            break;
+    }
+}
+
+void CompileServer::serve(int InFD, int OutFD) {
+    FrameReader Reader(InFD);
+    std::string Request;
+    while (!ShutdownRequested && Reader.read(Request)) {
+        if (!writeFrame(OutFD, handleRequest(Request)))
+            return;
+    }
+}
+
+bool CompileServer::serveUnixSocket(const std::string &SocketPath) {
+    sockaddr_un Addr{};
+    Addr.sun_family = AF_UNIX;
+    if (SocketPath.size() >= sizeof(Addr.sun_path))
+        return false;
+    std::memcpy(Addr.sun_path, SocketPath.c_str(), SocketPath.size() + 1);
+
+    int ListenFD = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    if (ListenFD < 0)
+        return false;
+    ::unlink(SocketPath.c_str());
+    if (::bind(ListenFD, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)) < 0 ||
+        ::listen(ListenFD, 8) < 0) {
+        ::close(ListenFD);
+        return false;
+    }
+
+    while (!ShutdownRequested) {
+        int ConnFD = ::accept(ListenFD, nullptr, nullptr);
+        if (ConnFD < 0) {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+        serve(ConnFD, ConnFD);
+        ::close(ConnFD);
+    }
+
+    ::close(ListenFD);
+    ::unlink(SocketPath.c_str());
+    return true;
+}
+
+bool FrameReader::fill() {
+    if (Pos == Buffer.size()) {
+        Buffer.clear();
+        Pos = 0;
+    } else if (Pos > Buffer.size() / 2) {
+        Buffer.erase(0, Pos);
+        Pos = 0;
+    }
+    char Chunk[64 * 1024];
+    while (true) {
+        ssize_t N = ::read(FD, Chunk, sizeof(Chunk));
+        if (N < 0 && errno == EINTR)
+            continue;
+        if (N <= 0)
+            return false;
+        Buffer.append(Chunk, static_cast<size_t>(N));
+        return true;
+    }
+}
+
+bool FrameReader::read(std::string &Payload) {
+    // Заголовок: десятичная длина и '\n'.
+    size_t Length = 0;
+    size_t NumDigits = 0;
+    while (true) {
+        if (Pos == Buffer.size() && !fill())
+            return false;
+        char C = Buffer[Pos++];
+        if (C == '\n')
+            break;
+        if (C < '0' || C > '9' || ++NumDigits > 18)
+            return false;
+        Length = Length * 10 + static_cast<size_t>(C - '0');
+    }
+    if (NumDigits == 0)
+        return false;
+
+    while (Buffer.size() - Pos < Length) {
+        if (!fill())
+            return false;
+    }
+    Payload.assign(Buffer, Pos, Length);
+    Pos += Length;
+    return true;
+}
+
+bool writeFrame(int FD, std::string_view Payload) {
+    std::string Frame = std::to_string(Payload.size());
+    Frame += '\n';
+    Frame += Payload;
+
+    // В сокет пишем через send(MSG_NOSIGNAL): клиент, закрывший соединение
+    // до ответа, даёт EPIPE, а не SIGPIPE, который убил бы весь сервер.
+    const char *Ptr = Frame.data();
+    size_t Remaining = Frame.size();
+    bool IsSocket = true;
+    while (Remaining) {
+        ssize_t N = IsSocket ? ::send(FD, Ptr, Remaining, MSG_NOSIGNAL)
+                             : ::write(FD, Ptr, Remaining);
+        if (N < 0 && errno == ENOTSOCK) {
+            IsSocket = false;
+            continue;
+        }
+        if (N < 0 && errno == EINTR)
+            continue;
+        if (N <= 0)
+            return false;
+        Ptr += N;
+        Remaining -= static_cast<size_t>(N);
+    }
+    return true;
+}
@@ -0,0 +1,348 @@
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <fstream>
+#include <set>
+#include "Basic/Hashing.h"
+#include "Driver/BatchLoader.h"
+#include "Driver/DependencyGraph.h"
+#include "Parse/Lexer.h"
+
+static const char *const DepsFileMagic = "swiftmini-deps 1";
+
+static bool isDeclStart(const Token &Tok) {
+    switch (Tok.getKind()) {
+    case tok::kw_func:
+    case tok::kw_let:
+    case tok::kw_var:
+    case tok::kw_struct:
+    case tok::kw_class:
+    case tok::kw_enum:
+    case tok::kw_protocol:
+    case tok::kw_typealias:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// hashInterface - Хеш токенов объявления, начинающегося с Tokens[Start].
+// У func в интерфейс входит только сигнатура, у остальных объявлений —
+// всё до следующего объявления верхнего уровня.
+static uint64_t hashInterface(const std::vector<Token> &Tokens, size_t Start) {
+    bool IsFunc = Tokens[Start].is(tok::kw_func);
+    uint64_t Hash = 0;
+    unsigned Depth = 0;
+    for (size_t I = Start; I < Tokens.size(); ++I) {
+        const Token &Tok = Tokens[I];
+        if (Depth == 0 && I != Start) {
+            if (IsFunc && Tok.is(tok::l_brace))
+                break;
+            if (isDeclStart(Tok) || Tok.is(tok::kw_import))
+                break;
+        }
+        if (Tok.is(tok::l_brace))
+            ++Depth;
+        else if (Tok.is(tok::r_brace) && Depth > 0 && --Depth == 0 && !IsFunc) {
+            Hash = hashCombine(Hash, hashBytes(Tok.getText()));
+            break;
+        }
+        Hash = hashCombine(Hash, static_cast<uint64_t>(Tok.getKind()));
+        Hash = hashCombine(Hash, hashBytes(Tok.getText()));
+    }
+    return Hash;
+}
+
+FileDependencies DependencyGraph::scanFile(const std::string &Path,
+                                           std::string_view Contents) {
+    std::vector<Token> Tokens;
+    return scanFile(Path, Contents, Tokens);
+}
+
+FileDependencies DependencyGraph::scanFile(const std::string &Path,
+                                           std::string_view Contents,
+                                           std::vector<Token> &Tokens) {
+    FileDependencies Deps;
+    Deps.Path = Path;
+    Deps.ContentHash = hashBytes(Contents);
+
+    Tokens.clear();
+    Lexer L(Contents);
+    L.lex(); // START_OF_FILE
+    for (Token Tok = L.lex(); !Tok.isEOF(); Tok = L.lex())
+        Tokens.push_back(Tok);
+
+    std::set<std::string_view> Uses;
+    unsigned Depth = 0;
+    for (size_t I = 0; I < Tokens.size(); ++I) {
+        const Token &Tok = Tokens[I];
+        if (Tok.is(tok::l_brace)) {
+            ++Depth;
+            continue;
+        }
+        if (Tok.is(tok::r_brace)) {
+            if (Depth > 0)
+                --Depth;
+            continue;
+        }
+        if (Tok.isIdentifier()) {
+            Uses.insert(Tok.getText());
+            continue;
+        }
+
+        bool HasName = I + 1 < Tokens.size() && Tokens[I + 1].isIdentifier();
+        if (Depth != 0 || !HasName)
+            continue;
+        if (Tok.is(tok::kw_import))
+            Deps.Imports.emplace_back(Tokens[I + 1].getText());
+        else if (isDeclStart(Tok))
+            Deps.Provides[std::string(Tokens[I + 1].getText())] = hashInterface(Tokens, I);
+    }
+
+    Deps.Uses.assign(Uses.begin(), Uses.end());
+    return Deps;
+}
+
+std::string DependencyGraph::getModuleName(std::string_view Path) {
+    size_t Slash = Path.find_last_of('/');
+    if (Slash != std::string_view::npos)
+        Path.remove_prefix(Slash + 1);
+    size_t Dot = Path.find('.');
+    if (Dot != std::string_view::npos)
+        Path = Path.substr(0, Dot);
+    return std::string(Path);
+}
+
+const FileDependencies *DependencyGraph::getFile(const std::string &Path) const {
+    auto It = Files.find(Path);
+    return It == Files.end() ? nullptr : &It->second;
+}
+
+const FileDependencies *DependencyGraph::getModule(std::string_view ModuleName) const {
+    auto It = Modules.find(ModuleName);
+    return It == Modules.end() ? nullptr : getFile(It->second);
+}
+
+// Формат файла графа — строки "<ключ> <значение>":
+//
+//   swiftmini-deps 1
+//   file <path>
+//   hash <hex>
+//   import <module>
+//   provides <hex> <name>
+//   uses <name>
+//   end
+bool DependencyGraph::save(const std::string &Path) const {
+    std::ofstream OS(Path, std::ios::trunc);
+    if (!OS.is_open())
+        return false;
+
+    char Hex[17];
+    OS << DepsFileMagic << '\n';
+    for (const auto &Entry : Files) {
+        const FileDependencies &Deps = Entry.second;
+        OS << "file " << Deps.Path << '\n';
+        std::snprintf(Hex, sizeof(Hex), "%016" PRIx64, Deps.ContentHash);
+        OS << "hash " << Hex << '\n';
+        for (const std::string &Import : Deps.Imports)
+            OS << "import " << Import << '\n';
+        for (const auto &Provided : Deps.Provides) {
+            std::snprintf(Hex, sizeof(Hex), "%016" PRIx64, Provided.second);
+            OS << "provides " << Hex << ' ' << Provided.first << '\n';
+        }
+        for (const std::string &Use : Deps.Uses)
+            OS << "uses " << Use << '\n';
+        OS << "end\n";
+    }
+    return static_cast<bool>(OS);
+}
+
+static bool parseHex(std::string_view Text, uint64_t &Value) {
+    if (Text.empty() || Text.size() > 16)
+        return false;
+    Value = 0;
+    for (char C : Text) {
+        unsigned Digit;
+        if (C >= '0' && C <= '9')
+            Digit = static_cast<unsigned>(C - '0');
+        else if (C >= 'a' && C <= 'f')
+            Digit = static_cast<unsigned>(C - 'a' + 10);
+        else
+            return false;
+        Value = (Value << 4) | Digit;
+    }
+    return true;
+}
+
+bool DependencyGraph::load(const std::string &Path, std::string &Error) {
+    std::ifstream IS(Path);
+    if (!IS.is_open()) {
+        Error = "can not open dependency file: " + Path;
+        return false;
+    }
+
+    std::string Line;
+    if (!std::getline(IS, Line) || Line != DepsFileMagic) {
+        Error = "not a dependency file: " + Path;
+        return false;
+    }
+
+    DependencyGraph Result;
+    FileDependencies Current;
+    bool InFile = false;
+    unsigned LineNo = 1;
+    auto fail = [&]() {
+        Error = Path + ":" + std::to_string(LineNo) + ": malformed dependency file";
+        return false;
+    };
+
+    while (std::getline(IS, Line)) {
+        ++LineNo;
+        std::string_view View = Line;
+        size_t Space = View.find(' ');
+        std::string_view Key = View.substr(0, Space);
+        std::string_view Value =
+            Space == std::string_view::npos ? std::string_view() : View.substr(Space + 1);
+
+        if (Key == "file") {
+            if (InFile || Value.empty())
+                return fail();
+            Current = FileDependencies();
+            Current.Path = std::string(Value);
+            InFile = true;
+        } else if (!InFile) {
+            return fail();
+        } else if (Key == "hash") {
+            if (!parseHex(Value, Current.ContentHash))
+                return fail();
+        } else if (Key == "import") {
+            Current.Imports.emplace_back(Value);
+        } else if (Key == "provides") {
+            size_t NameStart = Value.find(' ');
+            uint64_t Hash;
+            if (NameStart == std::string_view::npos ||
+                !parseHex(Value.substr(0, NameStart), Hash))
+                return fail();
+            Current.Provides[std::string(Value.substr(NameStart + 1))] = Hash;
+        } else if (Key == "uses") {
+            Current.Uses.emplace_back(Value);
+        } else if (Key == "end") {
+            Result.addFile(std::move(Current));
+            InFile = false;
+        } else {
+            return fail();
+        }
+    }
+    if (InFile)
+        return fail();
+
+    *this = std::move(Result);
+    return true;
+}
+
+// findUsedInterfaceChange - Первое имя из Uses, интерфейс которого в модуле
+// изменился между OldModule и NewModule.
+static const std::string *findUsedInterfaceChange(const FileDependencies &User,
+                                                  const FileDependencies &OldModule,
+                                                  const FileDependencies &NewModule) {
+    for (const std::string &Name : User.Uses) {
+        auto Old = OldModule.Provides.find(Name);
+        auto New = NewModule.Provides.find(Name);
+        bool HadOld = Old != OldModule.Provides.end();
+        bool HasNew = New != NewModule.Provides.end();
+        if (HadOld != HasNew || (HadOld && Old->second != New->second))
+            return &Name;
+    }
+    return nullptr;
+}
+
+// countTokens - Пересборка файла, который в этом запуске ещё не лексился.
+static unsigned countTokens(std::string_view Contents) {
+    Lexer L(Contents);
+    L.lex(); // START_OF_FILE
+    unsigned NumTokens = 0;
+    while (!L.lex().isEOF())
+        ++NumTokens;
+    return NumTokens;
+}
+
+bool planIncrementalBuild(const DependencyGraph &OldGraph,
+                          const std::vector<std::string> &Inputs,
+                          DependencyGraph &NewGraph,
+                          std::vector<RebuildDecision> &Decisions,
+                          std::string &Error) {
+    NewGraph = DependencyGraph();
+    Decisions.clear();
+
+    // Сначала содержимое: неизменённые файлы берут зависимости из старого
+    // графа, изменённые сканируются заново. Файлы читаются пакетом и
+    // сканируются по мере готовности, в порядке завершения чтения. Буферы
+    // неизменённых файлов держим до конца: их может пересобрать изменение
+    // интерфейса.
+    Decisions.resize(Inputs.size());
+    std::vector<FileDependencies> Deps(Inputs.size());
+    std::vector<LoadedFile> Unchanged(Inputs.size());
+    size_t FirstFailed = Inputs.size();
+    std::vector<Token> Tokens;
+    BatchLoader Loader;
+    Loader.load(Inputs, [&](LoadedFile &File) {
+        const std::string &Path = Inputs[File.Index];
+        RebuildDecision &Decision = Decisions[File.Index];
+        Decision.Path = Path;
+        if (File.Errno) {
+            FirstFailed = std::min<size_t>(FirstFailed, File.Index);
+            return;
+        }
+        const FileDependencies *Old = OldGraph.getFile(Path);
+        if (Old && Old->ContentHash == hashBytes(File.getContents())) {
+            Deps[File.Index] = *Old;
+            Unchanged[File.Index] = std::move(File);
+        } else {
+            // Токены сканирования и есть пересборка: второй раз не лексим.
+            Deps[File.Index] = DependencyGraph::scanFile(Path, File.getContents(), Tokens);
+            Decision.NeedsRebuild = true;
+            Decision.Reason = Old ? "content changed" : "new file";
+            Decision.NumTokens = static_cast<unsigned>(Tokens.size());
+        }
+    });
+    if (FirstFailed != Inputs.size()) {
+        Error = "can not open file: " + Inputs[FirstFailed];
+        Decisions.clear();
+        return false;
+    }
+    // Граф заполняется в порядке Inputs: при совпадении имён модулей
+    // побеждает последний файл, как и раньше.
+    for (FileDependencies &D : Deps)
+        NewGraph.addFile(std::move(D));
+
+    // Затем интерфейсы: файл с прежним содержимым пересобирается, только если
+    // поменялось объявление, которое он использует из импортированного
+    // модуля. Пересборка сама по себе дальше не распространяется.
+    for (RebuildDecision &Decision : Decisions) {
+        if (Decision.NeedsRebuild)
+            continue;
+        const FileDependencies &File = *NewGraph.getFile(Decision.Path);
+        for (const std::string &Import : File.Imports) {
+            const FileDependencies *OldModule = OldGraph.getModule(Import);
+            const FileDependencies *NewModule = NewGraph.getModule(Import);
+            if (!OldModule != !NewModule) {
+                Decision.NeedsRebuild = true;
+                Decision.Reason = "module '" + Import + "' " +
+                                  (NewModule ? "appeared" : "disappeared");
+                break;
+            }
+            if (!NewModule)
+                continue;
+            if (const std::string *Name = findUsedInterfaceChange(File, *OldModule, *NewModule)) {
+                Decision.NeedsRebuild = true;
+                Decision.Reason = "uses changed declaration '" + *Name + "' from '" +
+                                  Import + "'";
+                break;
+            }
+        }
+    }
+    for (size_t I = 0; I != Decisions.size(); ++I)
+        if (Decisions[I].NeedsRebuild && Unchanged[I].Data)
+            Decisions[I].NumTokens = countTokens(Unchanged[I].getContents());
+    return true;
+}
@@ -0,0 +1,317 @@
+#include <cstring>
+#include <vector>
+#include "Driver/TokenDumper.h"
+#include "Parse/Lexer.h"
+
+static_assert(NumTokenKinds <= TokenDumper::FileRecordTag,
+              "token kinds collide with the file record tag");
+
+namespace {
+
+constexpr std::string_view KindSpellings[NumTokenKinds] = {
+  #define TOKEN(X) #X,
+  #include "Parse/Tokens.def"
+};
+
+// writeEscapedC - Текст в одинарных кавычках; \, ' и управляющие символы
+// экранируются, остальные байты (в том числе UTF-8) пишутся как есть.
+void writeEscapedC(BufferedWriter &OS, std::string_view Text) {
+    static const char Hex[] = "0123456789abcdef";
+    OS.write('\'');
+    size_t Begin = 0;
+    for (size_t I = 0; I != Text.size(); ++I) {
+        unsigned char C = static_cast<unsigned char>(Text[I]);
+        if (C >= 0x20 && C != '\\' && C != '\'' && C != 0x7f)
+            continue;
+        OS.write(Text.substr(Begin, I - Begin));
+        Begin = I + 1;
+        switch (C) {
+        case '\n': OS.write("\\n"); break;
+        case '\t': OS.write("\\t"); break;
+        case '\r': OS.write("\\r"); break;
+        case '\\': OS.write("\\\\"); break;
+        case '\'': OS.write("\\'"); break;
+        default:
+            OS.write("\\x");
+            OS.write(Hex[C >> 4]);
+            OS.write(Hex[C & 15]);
+            break;
+        }
+    }
+    OS.write(Text.substr(Begin));
+    OS.write('\'');
+}
+
+// writeJSONString - Строка JSON; управляющие символы — \uXXXX или краткие
+// escape-последовательности.
+void writeJSONString(BufferedWriter &OS, std::string_view Text) {
+    static const char Hex[] = "0123456789abcdef";
+    OS.write('"');
+    size_t Begin = 0;
+    for (size_t I = 0; I != Text.size(); ++I) {
+        unsigned char C = static_cast<unsigned char>(Text[I]);
+        if (C >= 0x20 && C != '\\' && C != '"')
+            continue;
+        OS.write(Text.substr(Begin, I - Begin));
+        Begin = I + 1;
+        switch (C) {
+        case '\n': OS.write("\\n"); break;
+        case '\t': OS.write("\\t"); break;
+        case '\r': OS.write("\\r"); break;
+        case '\\': OS.write("\\\\"); break;
+        case '"': OS.write("\\\""); break;
+        default:
+            OS.write("\\u00");
+            OS.write(Hex[C >> 4]);
+            OS.write(Hex[C & 15]);
+            break;
+        }
+    }
+    OS.write(Text.substr(Begin));
+    OS.write('"');
+}
+
+// Reader - Курсор по двоичному потоку с проверкой границ.
+class Reader {
+    const char *Ptr;
+    const char *End;
+
+public:
+    explicit Reader(std::string_view Data) : Ptr(Data.data()), End(Data.data() + Data.size()) {}
+
+    bool atEnd() const { return Ptr == End; }
+
+    bool readByte(uint8_t &V) {
+        if (Ptr == End)
+            return false;
+        V = static_cast<uint8_t>(*Ptr++);
+        return true;
+    }
+
+    bool readLE32(uint32_t &V) {
+        if (End - Ptr < 4)
+            return false;
+        V = 0;
+        for (unsigned I = 0; I != 4; ++I)
+            V |= uint32_t(static_cast<uint8_t>(Ptr[I])) << (8 * I);
+        Ptr += 4;
+        return true;
+    }
+
+    bool readULEB128(uint64_t &V) {
+        V = 0;
+        for (unsigned Shift = 0; Shift < 64; Shift += 7) {
+            uint8_t Byte;
+            if (!readByte(Byte))
+                return false;
+            V |= uint64_t(Byte & 0x7f) << Shift;
+            if (!(Byte & 0x80))
+                return true;
+        }
+        return false;
+    }
+
+    bool readBytes(uint64_t Length, std::string_view &S) {
+        if (static_cast<uint64_t>(End - Ptr) < Length)
+            return false;
+        S = std::string_view(Ptr, static_cast<size_t>(Length));
+        Ptr += Length;
+        return true;
+    }
+};
+
+} // namespace
+
+bool parseTokenDumpFormat(std::string_view Name, TokenDumpFormat &Format) {
+    if (Name == "text")
+        Format = TokenDumpFormat::Text;
+    else if (Name == "json")
+        Format = TokenDumpFormat::JSONLines;
+    else if (Name == "binary")
+        Format = TokenDumpFormat::Binary;
+    else
+        return false;
+    return true;
+}
+
+std::string_view getTokenKindSpelling(tok K) {
+    if (static_cast<uint8_t>(K) >= NumTokenKinds)
+        return "INVALID_TOKEN";
+    return KindSpellings[static_cast<uint8_t>(K)];
+}
+
+TokenDumper::TokenDumper(BufferedWriter &os, TokenDumpFormat format) : OS(os), Format(format) {
+    if (Format != TokenDumpFormat::Binary)
+        return;
+    OS.write("SMTK");
+    OS.writeLE32(BinaryVersion);
+    OS.writeLE32(NumTokenKinds);
+    for (std::string_view Spelling : KindSpellings) {
+        OS.writeULEB128(Spelling.size());
+        OS.write(Spelling);
+    }
+}
+
+void TokenDumper::advanceTo(uint64_t Offset) {
+    // Токены идут по возрастанию смещений, поэтому каждый байт файла
+    // просматривается в поисках перевода строки один раз.
+    const char *Data = Buffer.data();
+    while (ScannedTo < Offset) {
+        const void *NL = std::memchr(Data + ScannedTo, '\n', Offset - ScannedTo);
+        if (!NL) {
+            ScannedTo = Offset;
+            break;
+        }
+        ScannedTo = static_cast<uint64_t>(static_cast<const char *>(NL) - Data) + 1;
+        LineStart = ScannedTo;
+        ++Line;
+    }
+}
+
+void TokenDumper::dumpFile(std::string_view FilePath, std::string_view Contents) {
+    Path = FilePath;
+    Buffer = Contents;
+    ScannedTo = LineStart = PrevOffset = 0;
+    Line = PrevLine = 1;
+
+    if (Format == TokenDumpFormat::Binary) {
+        OS.write(static_cast<char>(FileRecordTag));
+        OS.writeULEB128(Path.size());
+        OS.write(Path);
+        OS.writeULEB128(Buffer.size());
+    }
+
+    Lexer L(Contents);
+    while (true) {
+        Token Tok = L.lex();
+        if (Tok.isNot(tok::START_OF_FILE))
+            dumpToken(Tok);
+        if (Tok.isEOF())
+            break;
+    }
+}
+
+void TokenDumper::dumpToken(const Token &Tok) {
+    ++NumTokens;
+    std::string_view Text = Tok.getText();
+    uint64_t Offset = static_cast<uint64_t>(Text.data() - Buffer.data());
+    advanceTo(Offset);
+    uint64_t Column = Offset - LineStart + 1;
+
+    switch (Format) {
+    case TokenDumpFormat::Text:
+        OS.write(Path);
+        OS.write(':');
+        OS.writeDecimal(Line);
+        OS.write(':');
+        OS.writeDecimal(Column);
+        OS.write(": ");
+        OS.write(Tok.getTokenName());
+        OS.write(' ');
+        writeEscapedC(OS, Text);
+        OS.write('\n');
+        break;
+    case TokenDumpFormat::JSONLines:
+        OS.write("{\"file\":");
+        writeJSONString(OS, Path);
+        OS.write(",\"line\":");
+        OS.writeDecimal(Line);
+        OS.write(",\"col\":");
+        OS.writeDecimal(Column);
+        OS.write(",\"offset\":");
+        OS.writeDecimal(Offset);
+        OS.write(",\"kind\":\"");
+        OS.write(getTokenKindSpelling(Tok.getKind()));
+        OS.write("\",\"text\":");
+        writeJSONString(OS, Text);
+        OS.write("}\n");
+        break;
+    case TokenDumpFormat::Binary:
+        OS.write(static_cast<char>(Tok.getKind()));
+        OS.writeULEB128(Offset - PrevOffset);
+        OS.writeULEB128(Text.size());
+        OS.writeULEB128(Line - PrevLine);
+        OS.writeULEB128(Column);
+        PrevOffset = Offset;
+        PrevLine = Line;
+        break;
+    }
+}
+
+bool readTokenStream(std::string_view Data,
+                     const std::function<void(std::string_view Path, uint64_t Size)> &OnFile,
+                     const std::function<void(const TokenRecord &)> &OnToken,
+                     std::string &Error) {
+    Reader R(Data);
+    std::string_view Magic;
+    uint32_t Version, NumKinds;
+    if (!R.readBytes(4, Magic) || Magic != "SMTK") {
+        Error = "not a token stream";
+        return false;
+    }
+    if (!R.readLE32(Version) || Version != TokenDumper::BinaryVersion) {
+        Error = "unsupported token stream version";
+        return false;
+    }
+    if (!R.readLE32(NumKinds) || NumKinds > TokenDumper::FileRecordTag) {
+        Error = "corrupted token kind table";
+        return false;
+    }
+
+    // Виды сопоставляются по имени: поток, записанный другой версией
+    // Tokens.def, читается, пока в нём нет незнакомых видов.
+    std::vector<tok> KindMap;
+    for (uint32_t I = 0; I != NumKinds; ++I) {
+        uint64_t Length;
+        std::string_view Spelling;
+        if (!R.readULEB128(Length) || !R.readBytes(Length, Spelling)) {
+            Error = "corrupted token kind table";
+            return false;
+        }
+        unsigned K = 0;
+        while (K != NumTokenKinds && KindSpellings[K] != Spelling)
+            ++K;
+        if (K == NumTokenKinds) {
+            Error = "unknown token kind '" + std::string(Spelling) + "'";
+            return false;
+        }
+        KindMap.push_back(static_cast<tok>(K));
+    }
+
+    bool InFile = false;
+    TokenRecord Record = {};
+    while (!R.atEnd()) {
+        uint8_t Tag;
+        R.readByte(Tag);
+        if (Tag == TokenDumper::FileRecordTag) {
+            uint64_t Length, Size;
+            std::string_view Path;
+            if (!R.readULEB128(Length) || !R.readBytes(Length, Path) || !R.readULEB128(Size)) {
+                Error = "truncated file record";
+                return false;
+            }
+            InFile = true;
+            Record.Offset = 0;
+            Record.Line = 1;
+            OnFile(Path, Size);
+            continue;
+        }
+        if (Tag >= KindMap.size() || !InFile) {
+            Error = "invalid record tag " + std::to_string(Tag);
+            return false;
+        }
+        uint64_t Delta, Length, LineDelta, Column;
+        if (!R.readULEB128(Delta) || !R.readULEB128(Length) || !R.readULEB128(LineDelta) ||
+            !R.readULEB128(Column)) {
+            Error = "truncated token record";
+            return false;
+        }
+        Record.Kind = KindMap[Tag];
+        Record.Offset += Delta;
+        Record.Length = Length;
+        Record.Line += static_cast<uint32_t>(LineDelta);
+        Record.Column = static_cast<uint32_t>(Column);
+        OnToken(Record);
+    }
+    return true;
+}
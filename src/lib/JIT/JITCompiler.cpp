@@ -0,0 +1,620 @@
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "JIT/JITCompiler.h"
+#include "JIT/RegisterAllocator.h"
+#include "JIT/X86Assembler.h"
+
+using namespace x86;
+
+//===----------------------------------------------------------------------===//
+// ExecutableMemory
+//===----------------------------------------------------------------------===//
+
+bool ExecutableMemory::allocate(size_t Bytes) {
+    release();
+    size_t PageSize = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t Rounded = (Bytes + PageSize - 1) / PageSize * PageSize;
+    if (Rounded == 0)
+        Rounded = PageSize;
+    void *Mem = ::mmap(nullptr, Rounded, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                       -1, 0);
+    if (Mem == MAP_FAILED)
+        return false;
+    Base = Mem;
+    Size = Rounded;
+    return true;
+}
+
+bool ExecutableMemory::makeExecutable() {
+    return Base && ::mprotect(Base, Size, PROT_READ | PROT_EXEC) == 0;
+}
+
+void ExecutableMemory::release() {
+    if (Base)
+        ::munmap(Base, Size);
+    Base = nullptr;
+    Size = 0;
+}
+
+//===----------------------------------------------------------------------===//
+// Генерация кода
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+const GPR IntArgRegs[] = {RDI, RSI, RDX, RCX, R8, R9};
+const XMM FloatArgRegs[] = {XMM0, XMM1, XMM2, XMM3, XMM4, XMM5, XMM6, XMM7};
+constexpr unsigned NumIntArgRegs = 6;
+constexpr unsigned NumFloatArgRegs = 8;
+
+const LinearScanAllocator &getAllocator() {
+    static const LinearScanAllocator Allocator(
+        RegisterClass{{RSI, RDI, R8, R9, R10}, {RBX, R12, R13, R14, R15}},
+        RegisterClass{{XMM8, XMM9, XMM10, XMM11, XMM12, XMM13, XMM14, XMM15}, {}});
+    return Allocator;
+}
+
+bool fitsCallingConvention(ArrayRef<LIRType> Types) {
+    unsigned NumInts = 0, NumFloats = 0;
+    for (LIRType Type : Types)
+        ++(Type == LIRType::Int ? NumInts : NumFloats);
+    return NumInts <= NumIntArgRegs && NumFloats <= NumFloatArgRegs;
+}
+
+bool isCommutative(LIROpcode Op) {
+    switch (Op) {
+    case LIROpcode::Add:
+    case LIROpcode::Mul:
+    case LIROpcode::And:
+    case LIROpcode::Or:
+    case LIROpcode::Xor:
+    case LIROpcode::FAdd:
+    case LIROpcode::FMul:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// FunctionCodegen - Переводит одну функцию в машинный код.
+//
+// Кадр: [rbp-8 ...] сначала сохранённые callee-saved регистры, затем слоты
+// вытесненных значений, затем область аргументов, через которую
+// перекладываются параметры и аргументы вызовов (так не нужно решать
+// задачу параллельного перемещения между регистрами).
+class FunctionCodegen {
+    X86Assembler &Asm;
+    const LIRFunction &F;
+    const RegisterAssignment &Alloc;
+    const std::vector<X86Assembler::Label> &FunctionLabels;
+    std::vector<X86Assembler::Label> BlockLabels;
+    unsigned FrameSize = 0;
+    unsigned SpillBase = 0;
+    unsigned ArgBase = 0;
+
+    // CompareResult/CompareCond - Последнее сравнение в блоке, флаги
+    // которого ещё актуальны: condbr по нему обходится без test.
+    VReg CompareResult = NoVReg;
+    Cond CompareCond = E;
+
+    static Mem frameSlot(unsigned Index) {
+        return {RBP, -8 * static_cast<int32_t>(Index + 1)};
+    }
+    Mem argSlot(unsigned I) const { return frameSlot(ArgBase + I); }
+
+    const ValueLocation &loc(VReg R) const { return Alloc.Locations[R]; }
+    Mem spillSlot(VReg R) const { return frameSlot(SpillBase + loc(R).Slot); }
+    bool inReg(VReg R, uint8_t Reg) const {
+        return loc(R).isRegister() && loc(R).PhysReg == Reg;
+    }
+
+    void loadGPR(GPR Dst, VReg R) {
+        if (loc(R).isRegister())
+            Asm.mov(Dst, static_cast<GPR>(loc(R).PhysReg));
+        else if (loc(R).isStack())
+            Asm.mov(Dst, spillSlot(R));
+    }
+    // useGPR - Регистр со значением R; из памяти грузится в Scratch.
+    GPR useGPR(VReg R, GPR Scratch) {
+        if (loc(R).isRegister())
+            return static_cast<GPR>(loc(R).PhysReg);
+        loadGPR(Scratch, R);
+        return Scratch;
+    }
+    GPR destGPR(VReg R) const {
+        return loc(R).isRegister() ? static_cast<GPR>(loc(R).PhysReg) : RAX;
+    }
+    void storeGPR(VReg R, GPR Src) {
+        if (loc(R).isRegister())
+            Asm.mov(static_cast<GPR>(loc(R).PhysReg), Src);
+        else if (loc(R).isStack())
+            Asm.mov(spillSlot(R), Src);
+    }
+
+    void loadXMM(XMM Dst, VReg R) {
+        if (loc(R).isRegister())
+            Asm.movsd(Dst, static_cast<XMM>(loc(R).PhysReg));
+        else if (loc(R).isStack())
+            Asm.movsd(Dst, spillSlot(R));
+    }
+    XMM useXMM(VReg R, XMM Scratch) {
+        if (loc(R).isRegister())
+            return static_cast<XMM>(loc(R).PhysReg);
+        loadXMM(Scratch, R);
+        return Scratch;
+    }
+    XMM destXMM(VReg R) const {
+        return loc(R).isRegister() ? static_cast<XMM>(loc(R).PhysReg) : XMM0;
+    }
+    void storeXMM(VReg R, XMM Src) {
+        if (loc(R).isRegister())
+            Asm.movsd(static_cast<XMM>(loc(R).PhysReg), Src);
+        else if (loc(R).isStack())
+            Asm.movsd(spillSlot(R), Src);
+    }
+
+    void emitPrologue();
+    void emitEpilogue();
+    void emitInst(const LIRInst &Inst, BlockID Block);
+    void emitIntBinary(const LIRInst &Inst);
+    void emitFloatBinary(const LIRInst &Inst);
+    void emitIntCompare(const LIRInst &Inst);
+    void emitFloatCompare(const LIRInst &Inst);
+    void emitCall(const LIRInst &Inst);
+    void emitCondBr(const LIRInst &Inst, BlockID Block);
+
+public:
+    FunctionCodegen(X86Assembler &assembler, const LIRFunction &f,
+                    const RegisterAssignment &alloc,
+                    const std::vector<X86Assembler::Label> &functionLabels)
+        : Asm(assembler), F(f), Alloc(alloc), FunctionLabels(functionLabels) {}
+
+    void emit();
+};
+
+void FunctionCodegen::emit() {
+    unsigned MaxArgs = static_cast<unsigned>(F.Params.size());
+    for (const LIRBlock &Block : F.Blocks)
+        for (const LIRInst &Inst : Block.Insts)
+            if (Inst.Op == LIROpcode::Call)
+                MaxArgs = std::max(MaxArgs, static_cast<unsigned>(Inst.Args.size()));
+
+    SpillBase = static_cast<unsigned>(Alloc.UsedCalleeSaved.size());
+    ArgBase = SpillBase + Alloc.NumSpillSlots;
+    // После push rbp стек выровнен на 16; кадр сохраняет выравнивание для
+    // вызовов.
+    FrameSize = (8 * (ArgBase + MaxArgs) + 15) / 16 * 16;
+
+    for (size_t B = 0; B != F.Blocks.size(); ++B)
+        BlockLabels.push_back(Asm.createLabel());
+
+    Asm.bind(FunctionLabels[F.getIndex()]);
+    emitPrologue();
+    for (BlockID B = 0; B != F.Blocks.size(); ++B) {
+        Asm.bind(BlockLabels[B]);
+        CompareResult = NoVReg;
+        for (const LIRInst &Inst : F.Blocks[B].Insts)
+            emitInst(Inst, B);
+    }
+}
+
+void FunctionCodegen::emitPrologue() {
+    Asm.push(RBP);
+    Asm.mov(RBP, RSP);
+    if (FrameSize)
+        Asm.subImm(RSP, static_cast<int32_t>(FrameSize));
+    for (unsigned I = 0; I != Alloc.UsedCalleeSaved.size(); ++I)
+        Asm.mov(frameSlot(I), static_cast<GPR>(Alloc.UsedCalleeSaved[I]));
+
+    unsigned NumInts = 0, NumFloats = 0;
+    for (unsigned I = 0; I != F.Params.size(); ++I) {
+        if (F.getRegType(F.Params[I]) == LIRType::Int)
+            Asm.mov(argSlot(I), IntArgRegs[NumInts++]);
+        else
+            Asm.movsd(argSlot(I), FloatArgRegs[NumFloats++]);
+    }
+    for (unsigned I = 0; I != F.Params.size(); ++I) {
+        VReg Param = F.Params[I];
+        if (F.getRegType(Param) == LIRType::Int) {
+            GPR D = destGPR(Param);
+            Asm.mov(D, argSlot(I));
+            storeGPR(Param, D);
+        } else {
+            XMM D = destXMM(Param);
+            Asm.movsd(D, argSlot(I));
+            storeXMM(Param, D);
+        }
+    }
+
+    for (VReg R : Alloc.ZeroOnEntry) {
+        if (F.getRegType(R) == LIRType::Int) {
+            GPR D = destGPR(R);
+            Asm.movImm(D, 0);
+            storeGPR(R, D);
+        } else {
+            XMM D = destXMM(R);
+            Asm.xorpd(D, D);
+            storeXMM(R, D);
+        }
+    }
+}
+
+void FunctionCodegen::emitEpilogue() {
+    for (unsigned I = 0; I != Alloc.UsedCalleeSaved.size(); ++I)
+        Asm.mov(static_cast<GPR>(Alloc.UsedCalleeSaved[I]), frameSlot(I));
+    Asm.mov(RSP, RBP);
+    Asm.pop(RBP);
+    Asm.ret();
+}
+
+void FunctionCodegen::emitIntBinary(const LIRInst &Inst) {
+    if (Inst.Op == LIROpcode::Div || Inst.Op == LIROpcode::Rem) {
+        loadGPR(RAX, Inst.A);
+        loadGPR(RCX, Inst.B);
+        Asm.cqo();
+        Asm.idiv(RCX);
+        storeGPR(Inst.Dest, Inst.Op == LIROpcode::Div ? RAX : RDX);
+        return;
+    }
+
+    VReg A = Inst.A, B = Inst.B;
+    GPR D = destGPR(Inst.Dest);
+    // Двухадресная форма: D = A; D op= B. Если B уже лежит в D, A его затрёт.
+    if (inReg(B, D) && !inReg(A, D)) {
+        if (isCommutative(Inst.Op))
+            std::swap(A, B);
+        else
+            D = RAX;
+    }
+    loadGPR(D, A);
+    GPR Rb = useGPR(B, RCX);
+    switch (Inst.Op) {
+    case LIROpcode::Add: Asm.add(D, Rb); break;
+    case LIROpcode::Sub: Asm.sub(D, Rb); break;
+    case LIROpcode::Mul: Asm.imul(D, Rb); break;
+    case LIROpcode::And: Asm.and_(D, Rb); break;
+    case LIROpcode::Or:  Asm.or_(D, Rb); break;
+    case LIROpcode::Xor: Asm.xor_(D, Rb); break;
+    default: break;
+    }
+    storeGPR(Inst.Dest, D);
+}
+
+void FunctionCodegen::emitFloatBinary(const LIRInst &Inst) {
+    VReg A = Inst.A, B = Inst.B;
+    XMM D = destXMM(Inst.Dest);
+    if (inReg(B, D) && !inReg(A, D)) {
+        if (isCommutative(Inst.Op))
+            std::swap(A, B);
+        else
+            D = XMM0;
+    }
+    loadXMM(D, A);
+    XMM Rb = useXMM(B, XMM1);
+    switch (Inst.Op) {
+    case LIROpcode::FAdd: Asm.addsd(D, Rb); break;
+    case LIROpcode::FSub: Asm.subsd(D, Rb); break;
+    case LIROpcode::FMul: Asm.mulsd(D, Rb); break;
+    case LIROpcode::FDiv: Asm.divsd(D, Rb); break;
+    default: break;
+    }
+    storeXMM(Inst.Dest, D);
+}
+
+void FunctionCodegen::emitIntCompare(const LIRInst &Inst) {
+    Cond C = E;
+    switch (Inst.Op) {
+    case LIROpcode::CmpEq: C = E; break;
+    case LIROpcode::CmpNe: C = NE; break;
+    case LIROpcode::CmpLt: C = L; break;
+    case LIROpcode::CmpLe: C = LE; break;
+    case LIROpcode::CmpGt: C = G; break;
+    case LIROpcode::CmpGe: C = GE; break;
+    default: break;
+    }
+    GPR Ra = useGPR(Inst.A, RAX);
+    GPR Rb = useGPR(Inst.B, RCX);
+    Asm.cmp(Ra, Rb);
+    GPR D = destGPR(Inst.Dest);
+    Asm.setcc(C, D);
+    storeGPR(Inst.Dest, D);
+    CompareResult = Inst.Dest;
+    CompareCond = C;
+}
+
+void FunctionCodegen::emitFloatCompare(const LIRInst &Inst) {
+    XMM Xa = useXMM(Inst.A, XMM0);
+    XMM Xb = useXMM(Inst.B, XMM1);
+    GPR D = destGPR(Inst.Dest);
+
+    // ucomisd выставляет флаги как беззнаковое сравнение, а неупорядоченный
+    // результат (NaN) — как ZF=PF=CF=1. "Больше" не срабатывает на NaN,
+    // поэтому "меньше" получается перестановкой операндов.
+    Cond C = A;
+    switch (Inst.Op) {
+    case LIROpcode::FCmpLt: Asm.ucomisd(Xb, Xa); C = A; break;
+    case LIROpcode::FCmpLe: Asm.ucomisd(Xb, Xa); C = AE; break;
+    case LIROpcode::FCmpGt: Asm.ucomisd(Xa, Xb); C = A; break;
+    case LIROpcode::FCmpGe: Asm.ucomisd(Xa, Xb); C = AE; break;
+    case LIROpcode::FCmpEq:
+    case LIROpcode::FCmpNe: {
+        bool IsEq = Inst.Op == LIROpcode::FCmpEq;
+        Asm.ucomisd(Xa, Xb);
+        Asm.setcc(IsEq ? E : NE, RAX);
+        Asm.setcc(IsEq ? NP : P, RCX);
+        if (IsEq)
+            Asm.and_(RAX, RCX);
+        else
+            Asm.or_(RAX, RCX);
+        storeGPR(Inst.Dest, RAX);
+        // and/or оставили ZF = (результат == 0).
+        CompareResult = Inst.Dest;
+        CompareCond = NE;
+        return;
+    }
+    default:
+        break;
+    }
+    Asm.setcc(C, D);
+    storeGPR(Inst.Dest, D);
+    CompareResult = Inst.Dest;
+    CompareCond = C;
+}
+
+void FunctionCodegen::emitCall(const LIRInst &Inst) {
+    const LIRFunction &Callee = *Inst.Callee;
+    for (unsigned I = 0; I != Inst.Args.size(); ++I) {
+        VReg Arg = Inst.Args[I];
+        if (F.getRegType(Arg) == LIRType::Int)
+            Asm.mov(argSlot(I), useGPR(Arg, RAX));
+        else
+            Asm.movsd(argSlot(I), useXMM(Arg, XMM0));
+    }
+    unsigned NumInts = 0, NumFloats = 0;
+    for (unsigned I = 0; I != Inst.Args.size(); ++I) {
+        if (F.getRegType(Inst.Args[I]) == LIRType::Int)
+            Asm.mov(IntArgRegs[NumInts++], argSlot(I));
+        else
+            Asm.movsd(FloatArgRegs[NumFloats++], argSlot(I));
+    }
+    Asm.call(FunctionLabels[Callee.getIndex()]);
+    if (Callee.getReturnType() == LIRType::Int)
+        storeGPR(Inst.Dest, RAX);
+    else
+        storeXMM(Inst.Dest, XMM0);
+}
+
+void FunctionCodegen::emitCondBr(const LIRInst &Inst, BlockID Block) {
+    Cond C = NE;
+    if (CompareResult != Inst.A) {
+        GPR R = useGPR(Inst.A, RAX);
+        Asm.test(R, R);
+    } else {
+        C = CompareCond;
+    }
+
+    BlockID Next = Block + 1;
+    BlockID IfTrue = Inst.Targets[0], IfFalse = Inst.Targets[1];
+    if (IfTrue == Next) {
+        // Инверсия условия x86 — смена младшего бита.
+        Asm.jcc(static_cast<Cond>(C ^ 1), BlockLabels[IfFalse]);
+        return;
+    }
+    Asm.jcc(C, BlockLabels[IfTrue]);
+    if (IfFalse != Next)
+        Asm.jmp(BlockLabels[IfFalse]);
+}
+
+void FunctionCodegen::emitInst(const LIRInst &Inst, BlockID Block) {
+    switch (Inst.Op) {
+    case LIROpcode::IConst: {
+        GPR D = destGPR(Inst.Dest);
+        Asm.movImm(D, Inst.Imm);
+        storeGPR(Inst.Dest, D);
+        break;
+    }
+    case LIROpcode::FConst: {
+        XMM D = destXMM(Inst.Dest);
+        if (Inst.Imm == 0) {
+            Asm.xorpd(D, D);
+        } else {
+            Asm.movImm(RAX, Inst.Imm);
+            Asm.movq(D, RAX);
+        }
+        storeXMM(Inst.Dest, D);
+        break;
+    }
+    case LIROpcode::Copy:
+        if (F.getRegType(Inst.Dest) == LIRType::Int)
+            storeGPR(Inst.Dest, useGPR(Inst.A, RAX));
+        else
+            storeXMM(Inst.Dest, useXMM(Inst.A, XMM0));
+        break;
+    case LIROpcode::Neg:
+        if (F.getRegType(Inst.Dest) == LIRType::Int) {
+            GPR D = destGPR(Inst.Dest);
+            loadGPR(D, Inst.A);
+            Asm.neg(D);
+            storeGPR(Inst.Dest, D);
+        } else {
+            XMM D = destXMM(Inst.Dest);
+            loadXMM(D, Inst.A);
+            Asm.movImm(RAX, INT64_MIN);
+            Asm.movq(XMM1, RAX);
+            Asm.xorpd(D, XMM1);
+            storeXMM(Inst.Dest, D);
+        }
+        break;
+    case LIROpcode::IntToFloat: {
+        GPR Ra = useGPR(Inst.A, RAX);
+        XMM D = destXMM(Inst.Dest);
+        Asm.cvtsi2sd(D, Ra);
+        storeXMM(Inst.Dest, D);
+        break;
+    }
+    case LIROpcode::FloatToInt: {
+        XMM Xa = useXMM(Inst.A, XMM0);
+        GPR D = destGPR(Inst.Dest);
+        Asm.cvttsd2si(D, Xa);
+        storeGPR(Inst.Dest, D);
+        break;
+    }
+    case LIROpcode::Call:
+        emitCall(Inst);
+        break;
+
+    #define LIR_INT_BINARY(Id, Name) case LIROpcode::Id:
+    #include "JIT/LIROps.def"
+        emitIntBinary(Inst);
+        break;
+    #define LIR_FLOAT_BINARY(Id, Name) case LIROpcode::Id:
+    #include "JIT/LIROps.def"
+        emitFloatBinary(Inst);
+        break;
+    #define LIR_INT_COMPARE(Id, Name) case LIROpcode::Id:
+    #include "JIT/LIROps.def"
+        emitIntCompare(Inst);
+        return;
+    #define LIR_FLOAT_COMPARE(Id, Name) case LIROpcode::Id:
+    #include "JIT/LIROps.def"
+        emitFloatCompare(Inst);
+        return;
+
+    case LIROpcode::Br:
+        if (Inst.Targets[0] != Block + 1)
+            Asm.jmp(BlockLabels[Inst.Targets[0]]);
+        break;
+    case LIROpcode::CondBr:
+        emitCondBr(Inst, Block);
+        break;
+    case LIROpcode::Ret:
+        if (F.getReturnType() == LIRType::Int)
+            loadGPR(RAX, Inst.A);
+        else
+            loadXMM(XMM0, Inst.A);
+        emitEpilogue();
+        break;
+    }
+    CompareResult = NoVReg;
+}
+
+// emitThunk - Переходник int64_t(const LIRValue *Args): раскладывает
+// аргументы по регистрам, вызывает функцию и возвращает биты результата.
+void emitThunk(X86Assembler &Asm, const LIRFunction &F, X86Assembler::Label Entry) {
+    Asm.push(RBP);
+    Asm.mov(RBP, RSP);
+    Asm.mov(R11, RDI);
+    unsigned NumInts = 0, NumFloats = 0;
+    for (unsigned I = 0; I != F.Params.size(); ++I) {
+        Mem Arg{R11, 8 * static_cast<int32_t>(I)};
+        if (F.getRegType(F.Params[I]) == LIRType::Int)
+            Asm.mov(IntArgRegs[NumInts++], Arg);
+        else
+            Asm.movsd(FloatArgRegs[NumFloats++], Arg);
+    }
+    Asm.call(Entry);
+    if (F.getReturnType() == LIRType::Float)
+        Asm.movq(RAX, XMM0);
+    Asm.pop(RBP);
+    Asm.ret();
+}
+
+} // namespace
+
+//===----------------------------------------------------------------------===//
+// JITCompiler
+//===----------------------------------------------------------------------===//
+
+bool JITCompiler::isHostSupported() {
+#if defined(__x86_64__)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool JITCompiler::compile(const LIRModule &M, std::string &Error) {
+    auto Start = std::chrono::steady_clock::now();
+    if (!isHostSupported()) {
+        Error = "JIT requires an x86-64 host";
+        return false;
+    }
+    if (!M.verify(Error))
+        return false;
+
+    const auto &Functions = M.getFunctions();
+    for (const auto &F : Functions) {
+        std::vector<LIRType> ParamTypes;
+        for (VReg Param : F->Params)
+            ParamTypes.push_back(F->getRegType(Param));
+        if (!fitsCallingConvention(ParamTypes)) {
+            Error = F->getName() + ": too many parameters for the JIT";
+            return false;
+        }
+    }
+
+    X86Assembler Asm;
+    std::vector<X86Assembler::Label> FunctionLabels;
+    for (size_t I = 0; I != Functions.size(); ++I)
+        FunctionLabels.push_back(Asm.createLabel());
+
+    CompileStats = Stats();
+    for (const auto &F : Functions) {
+        RegisterAssignment Alloc = getAllocator().allocate(*F);
+        for (const ValueLocation &Loc : Alloc.Locations)
+            CompileStats.NumSpilledValues += Loc.isStack();
+        FunctionCodegen(Asm, *F, Alloc, FunctionLabels).emit();
+    }
+
+    std::vector<X86Assembler::Label> ThunkLabels;
+    for (const auto &F : Functions) {
+        ThunkLabels.push_back(Asm.createLabel());
+        Asm.bind(ThunkLabels.back());
+        emitThunk(Asm, *F, FunctionLabels[F->getIndex()]);
+    }
+
+    if (!Asm.finalize()) {
+        Error = "internal JIT error: unresolved label";
+        return false;
+    }
+    if (!Memory.allocate(Asm.size())) {
+        Error = "can not allocate executable memory";
+        return false;
+    }
+    std::memcpy(Memory.data(), Asm.getCode().data(), Asm.size());
+    if (!Memory.makeExecutable()) {
+        Memory.release();
+        Error = "can not make JIT memory executable";
+        return false;
+    }
+
+    Module = &M;
+    EntryOffsets.clear();
+    ThunkOffsets.clear();
+    for (size_t I = 0; I != Functions.size(); ++I) {
+        EntryOffsets.push_back(Asm.getLabelOffset(FunctionLabels[I]));
+        ThunkOffsets.push_back(Asm.getLabelOffset(ThunkLabels[I]));
+    }
+
+    CompileStats.NumFunctions = static_cast<unsigned>(Functions.size());
+    CompileStats.CodeSize = Asm.size();
+    CompileStats.CompileMicros = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - Start).count());
+    return true;
+}
+
+void *JITCompiler::getPointerToFunction(const LIRFunction *F) const {
+    if (!F || F->getIndex() >= EntryOffsets.size())
+        return nullptr;
+    return Memory.data() + EntryOffsets[F->getIndex()];
+}
+
+LIRValue JITCompiler::call(const LIRFunction *F, ArrayRef<LIRValue> Args) const {
+    using ThunkFn = int64_t (*)(const LIRValue *);
+    auto Thunk = reinterpret_cast<ThunkFn>(Memory.data() + ThunkOffsets[F->getIndex()]);
+    return makeInt(Thunk(Args.data()));
+}
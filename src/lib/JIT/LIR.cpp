@@ -0,0 +1,287 @@
+#include <cstring>
+#include <ostream>
+#include "JIT/LIR.h"
+
+const char *getOpcodeName(LIROpcode Op) {
+    switch (Op) {
+      #define LIR_OP(Id, Name) case LIROpcode::Id: return Name;
+      #include "JIT/LIROps.def"
+    }
+    return "<invalid>";
+}
+
+bool isTerminator(LIROpcode Op) {
+    switch (Op) {
+      #define LIR_TERMINATOR(Id, Name) case LIROpcode::Id: return true;
+      #include "JIT/LIROps.def"
+    default:
+        return false;
+    }
+}
+
+double LIRInst::getFloatImm() const {
+    double Value;
+    std::memcpy(&Value, &Imm, sizeof(Value));
+    return Value;
+}
+
+//===----------------------------------------------------------------------===//
+// LIRModule
+//===----------------------------------------------------------------------===//
+
+LIRFunction *LIRModule::createFunction(std::string Name, ArrayRef<LIRType> ParamTypes,
+                                       LIRType ReturnType) {
+    unsigned Index = static_cast<unsigned>(Functions.size());
+    Functions.push_back(std::make_unique<LIRFunction>(std::move(Name), ReturnType, Index));
+    LIRFunction *F = Functions.back().get();
+    for (LIRType Type : ParamTypes)
+        F->Params.push_back(F->createReg(Type));
+    F->Blocks.emplace_back();
+    return F;
+}
+
+LIRFunction *LIRModule::getFunction(std::string_view Name) const {
+    for (const auto &F : Functions)
+        if (F->getName() == Name)
+            return F.get();
+    return nullptr;
+}
+
+static bool verifyFunction(const LIRFunction &F, std::string &Error) {
+    auto fail = [&](size_t Block, const std::string &Message) {
+        Error = F.getName() + ": bb" + std::to_string(Block) + ": " + Message;
+        return false;
+    };
+    auto isReg = [&](VReg R, LIRType Type) {
+        return R < F.getNumRegs() && F.getRegType(R) == Type;
+    };
+
+    for (size_t B = 0; B != F.Blocks.size(); ++B) {
+        const std::vector<LIRInst> &Insts = F.Blocks[B].Insts;
+        if (Insts.empty() || !isTerminator(Insts.back().Op))
+            return fail(B, "block does not end with a terminator");
+
+        for (size_t I = 0; I != Insts.size(); ++I) {
+            const LIRInst &Inst = Insts[I];
+            std::string Name = getOpcodeName(Inst.Op);
+            if (isTerminator(Inst.Op) && I + 1 != Insts.size())
+                return fail(B, "terminator '" + Name + "' in the middle of a block");
+
+            bool Valid = true;
+            switch (Inst.Op) {
+            case LIROpcode::IConst:
+                Valid = isReg(Inst.Dest, LIRType::Int);
+                break;
+            case LIROpcode::FConst:
+                Valid = isReg(Inst.Dest, LIRType::Float);
+                break;
+            case LIROpcode::Copy:
+            case LIROpcode::Neg:
+                Valid = Inst.Dest < F.getNumRegs() &&
+                        isReg(Inst.A, F.getRegType(Inst.Dest));
+                break;
+            case LIROpcode::IntToFloat:
+                Valid = isReg(Inst.Dest, LIRType::Float) && isReg(Inst.A, LIRType::Int);
+                break;
+            case LIROpcode::FloatToInt:
+                Valid = isReg(Inst.Dest, LIRType::Int) && isReg(Inst.A, LIRType::Float);
+                break;
+            #define LIR_INT_BINARY(Id, N) case LIROpcode::Id:
+            #define LIR_INT_COMPARE(Id, N) case LIROpcode::Id:
+            #include "JIT/LIROps.def"
+                Valid = isReg(Inst.Dest, LIRType::Int) && isReg(Inst.A, LIRType::Int) &&
+                        isReg(Inst.B, LIRType::Int);
+                break;
+            #define LIR_FLOAT_BINARY(Id, N) case LIROpcode::Id:
+            #include "JIT/LIROps.def"
+                Valid = isReg(Inst.Dest, LIRType::Float) && isReg(Inst.A, LIRType::Float) &&
+                        isReg(Inst.B, LIRType::Float);
+                break;
+            #define LIR_FLOAT_COMPARE(Id, N) case LIROpcode::Id:
+            #include "JIT/LIROps.def"
+                Valid = isReg(Inst.Dest, LIRType::Int) && isReg(Inst.A, LIRType::Float) &&
+                        isReg(Inst.B, LIRType::Float);
+                break;
+            case LIROpcode::Call: {
+                const LIRFunction *Callee = Inst.Callee;
+                Valid = Callee && Callee->Params.size() == Inst.Args.size() &&
+                        isReg(Inst.Dest, Callee->getReturnType());
+                for (size_t A = 0; Valid && A != Inst.Args.size(); ++A)
+                    Valid = isReg(Inst.Args[A], Callee->getRegType(Callee->Params[A]));
+                break;
+            }
+            case LIROpcode::Br:
+                Valid = Inst.Targets[0] < F.Blocks.size();
+                break;
+            case LIROpcode::CondBr:
+                Valid = isReg(Inst.A, LIRType::Int) && Inst.Targets[0] < F.Blocks.size() &&
+                        Inst.Targets[1] < F.Blocks.size();
+                break;
+            case LIROpcode::Ret:
+                Valid = isReg(Inst.A, F.getReturnType());
+                break;
+            }
+            if (!Valid)
+                return fail(B, "invalid operands of '" + Name + "'");
+        }
+    }
+    return true;
+}
+
+bool LIRModule::verify(std::string &Error) const {
+    for (const auto &F : Functions)
+        if (!verifyFunction(*F, Error))
+            return false;
+    return true;
+}
+
+static void printReg(std::ostream &OS, const LIRFunction &F, VReg R) {
+    OS << (F.getRegType(R) == LIRType::Float ? "%f" : "%r") << R;
+}
+
+void LIRFunction::print(std::ostream &OS) const {
+    OS << "func " << Name << "(";
+    for (size_t I = 0; I != Params.size(); ++I) {
+        if (I)
+            OS << ", ";
+        printReg(OS, *this, Params[I]);
+    }
+    OS << ") -> " << (ReturnType == LIRType::Float ? "float" : "int") << " {\n";
+
+    for (size_t B = 0; B != Blocks.size(); ++B) {
+        OS << "bb" << B << ":\n";
+        for (const LIRInst &Inst : Blocks[B].Insts) {
+            OS << "  ";
+            if (Inst.Dest != NoVReg) {
+                printReg(OS, *this, Inst.Dest);
+                OS << " = ";
+            }
+            OS << getOpcodeName(Inst.Op);
+            switch (Inst.Op) {
+            case LIROpcode::IConst:
+                OS << ' ' << Inst.Imm;
+                break;
+            case LIROpcode::FConst:
+                OS << ' ' << Inst.getFloatImm();
+                break;
+            case LIROpcode::Call:
+                OS << ' ' << Inst.Callee->getName() << '(';
+                for (size_t A = 0; A != Inst.Args.size(); ++A) {
+                    if (A)
+                        OS << ", ";
+                    printReg(OS, *this, Inst.Args[A]);
+                }
+                OS << ')';
+                break;
+            case LIROpcode::Br:
+                OS << " bb" << Inst.Targets[0];
+                break;
+            case LIROpcode::CondBr:
+                OS << ' ';
+                printReg(OS, *this, Inst.A);
+                OS << ", bb" << Inst.Targets[0] << ", bb" << Inst.Targets[1];
+                break;
+            default:
+                if (Inst.A != NoVReg) {
+                    OS << ' ';
+                    printReg(OS, *this, Inst.A);
+                }
+                if (Inst.B != NoVReg) {
+                    OS << ", ";
+                    printReg(OS, *this, Inst.B);
+                }
+                break;
+            }
+            OS << '\n';
+        }
+    }
+    OS << "}\n";
+}
+
+void LIRModule::print(std::ostream &OS) const {
+    for (const auto &F : Functions)
+        F->print(OS);
+}
+
+//===----------------------------------------------------------------------===//
+// LIRBuilder
+//===----------------------------------------------------------------------===//
+
+LIRInst &LIRBuilder::append(LIROpcode Op) {
+    std::vector<LIRInst> &Insts = F.Blocks[Current].Insts;
+    Insts.emplace_back();
+    Insts.back().Op = Op;
+    return Insts.back();
+}
+
+BlockID LIRBuilder::createBlock() {
+    F.Blocks.emplace_back();
+    return static_cast<BlockID>(F.Blocks.size() - 1);
+}
+
+VReg LIRBuilder::emitBinary(LIROpcode Op, LIRType ResultType, VReg A, VReg B) {
+    VReg Dest = F.createReg(ResultType);
+    LIRInst &Inst = append(Op);
+    Inst.Dest = Dest;
+    Inst.A = A;
+    Inst.B = B;
+    return Dest;
+}
+
+VReg LIRBuilder::iconst(int64_t Value) {
+    VReg Dest = F.createReg(LIRType::Int);
+    LIRInst &Inst = append(LIROpcode::IConst);
+    Inst.Dest = Dest;
+    Inst.Imm = Value;
+    return Dest;
+}
+
+VReg LIRBuilder::fconst(double Value) {
+    VReg Dest = F.createReg(LIRType::Float);
+    LIRInst &Inst = append(LIROpcode::FConst);
+    Inst.Dest = Dest;
+    std::memcpy(&Inst.Imm, &Value, sizeof(Value));
+    return Dest;
+}
+
+void LIRBuilder::copy(VReg Dest, VReg Src) {
+    LIRInst &Inst = append(LIROpcode::Copy);
+    Inst.Dest = Dest;
+    Inst.A = Src;
+}
+
+VReg LIRBuilder::createNeg(VReg A) {
+    return emitBinary(LIROpcode::Neg, F.getRegType(A), A, NoVReg);
+}
+
+VReg LIRBuilder::createIntToFloat(VReg A) {
+    return emitBinary(LIROpcode::IntToFloat, LIRType::Float, A, NoVReg);
+}
+
+VReg LIRBuilder::createFloatToInt(VReg A) {
+    return emitBinary(LIROpcode::FloatToInt, LIRType::Int, A, NoVReg);
+}
+
+VReg LIRBuilder::createCall(LIRFunction *Callee, ArrayRef<VReg> Args) {
+    VReg Dest = F.createReg(Callee->getReturnType());
+    LIRInst &Inst = append(LIROpcode::Call);
+    Inst.Dest = Dest;
+    Inst.Callee = Callee;
+    Inst.Args = Args.vec();
+    return Dest;
+}
+
+void LIRBuilder::createBr(BlockID Target) {
+    append(LIROpcode::Br).Targets[0] = Target;
+}
+
+void LIRBuilder::createCondBr(VReg Cond, BlockID IfTrue, BlockID IfFalse) {
+    LIRInst &Inst = append(LIROpcode::CondBr);
+    Inst.A = Cond;
+    Inst.Targets[0] = IfTrue;
+    Inst.Targets[1] = IfFalse;
+}
+
+void LIRBuilder::createRet(VReg Value) {
+    append(LIROpcode::Ret).A = Value;
+}
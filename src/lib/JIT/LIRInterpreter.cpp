@@ -0,0 +1,126 @@
+#include <cassert>
+#include "JIT/LIRInterpreter.h"
+
+LIRValue LIRInterpreter::run(const LIRFunction &F, ArrayRef<LIRValue> Args) {
+    assert(Args.size() == F.Params.size() && "wrong number of arguments");
+
+    // Кадр адресуется индексом: вложенные вызовы могут переразместить Frames.
+    size_t Base = Frames.size();
+    Frames.resize(Base + F.getNumRegs(), makeInt(0));
+    for (size_t I = 0; I != Args.size(); ++I)
+        Frames[Base + F.Params[I]] = Args[I];
+
+    auto reg = [&](VReg R) -> LIRValue & { return Frames[Base + R]; };
+
+    BlockID Block = 0;
+    while (true) {
+        for (const LIRInst &Inst : F.Blocks[Block].Insts) {
+            ++NumInstsExecuted;
+            switch (Inst.Op) {
+            case LIROpcode::IConst:
+                reg(Inst.Dest).I = Inst.Imm;
+                break;
+            case LIROpcode::FConst:
+                reg(Inst.Dest).F = Inst.getFloatImm();
+                break;
+            case LIROpcode::Copy:
+                reg(Inst.Dest) = reg(Inst.A);
+                break;
+            case LIROpcode::Neg:
+                if (F.getRegType(Inst.Dest) == LIRType::Float)
+                    reg(Inst.Dest).F = -reg(Inst.A).F;
+                else
+                    reg(Inst.Dest).I = static_cast<int64_t>(0 - static_cast<uint64_t>(reg(Inst.A).I));
+                break;
+            case LIROpcode::IntToFloat:
+                reg(Inst.Dest).F = static_cast<double>(reg(Inst.A).I);
+                break;
+            case LIROpcode::FloatToInt:
+                reg(Inst.Dest).I = static_cast<int64_t>(reg(Inst.A).F);
+                break;
+
+            // Сложение и умножение — по модулю 2^64, как в машинном коде.
+            case LIROpcode::Add:
+                reg(Inst.Dest).I = static_cast<int64_t>(static_cast<uint64_t>(reg(Inst.A).I) +
+                                                        static_cast<uint64_t>(reg(Inst.B).I));
+                break;
+            case LIROpcode::Sub:
+                reg(Inst.Dest).I = static_cast<int64_t>(static_cast<uint64_t>(reg(Inst.A).I) -
+                                                        static_cast<uint64_t>(reg(Inst.B).I));
+                break;
+            case LIROpcode::Mul:
+                reg(Inst.Dest).I = static_cast<int64_t>(static_cast<uint64_t>(reg(Inst.A).I) *
+                                                        static_cast<uint64_t>(reg(Inst.B).I));
+                break;
+            case LIROpcode::Div:
+                reg(Inst.Dest).I = reg(Inst.A).I / reg(Inst.B).I;
+                break;
+            case LIROpcode::Rem:
+                reg(Inst.Dest).I = reg(Inst.A).I % reg(Inst.B).I;
+                break;
+            case LIROpcode::And:
+                reg(Inst.Dest).I = reg(Inst.A).I & reg(Inst.B).I;
+                break;
+            case LIROpcode::Or:
+                reg(Inst.Dest).I = reg(Inst.A).I | reg(Inst.B).I;
+                break;
+            case LIROpcode::Xor:
+                reg(Inst.Dest).I = reg(Inst.A).I ^ reg(Inst.B).I;
+                break;
+
+            case LIROpcode::FAdd:
+                reg(Inst.Dest).F = reg(Inst.A).F + reg(Inst.B).F;
+                break;
+            case LIROpcode::FSub:
+                reg(Inst.Dest).F = reg(Inst.A).F - reg(Inst.B).F;
+                break;
+            case LIROpcode::FMul:
+                reg(Inst.Dest).F = reg(Inst.A).F * reg(Inst.B).F;
+                break;
+            case LIROpcode::FDiv:
+                reg(Inst.Dest).F = reg(Inst.A).F / reg(Inst.B).F;
+                break;
+
+            #define COMPARE(Id, Field, Op)                                    \
+            case LIROpcode::Id:                                               \
+                reg(Inst.Dest).I = reg(Inst.A).Field Op reg(Inst.B).Field;    \
+                break;
+            COMPARE(CmpEq, I, ==)
+            COMPARE(CmpNe, I, !=)
+            COMPARE(CmpLt, I, <)
+            COMPARE(CmpLe, I, <=)
+            COMPARE(CmpGt, I, >)
+            COMPARE(CmpGe, I, >=)
+            COMPARE(FCmpEq, F, ==)
+            COMPARE(FCmpNe, F, !=)
+            COMPARE(FCmpLt, F, <)
+            COMPARE(FCmpLe, F, <=)
+            COMPARE(FCmpGt, F, >)
+            COMPARE(FCmpGe, F, >=)
+            #undef COMPARE
+
+            case LIROpcode::Call: {
+                std::vector<LIRValue> CallArgs;
+                CallArgs.reserve(Inst.Args.size());
+                for (VReg Arg : Inst.Args)
+                    CallArgs.push_back(reg(Arg));
+                LIRValue Result = run(*Inst.Callee, CallArgs);
+                reg(Inst.Dest) = Result;
+                break;
+            }
+
+            case LIROpcode::Br:
+                Block = Inst.Targets[0];
+                break;
+            case LIROpcode::CondBr:
+                Block = Inst.Targets[reg(Inst.A).I != 0 ? 0 : 1];
+                break;
+            case LIROpcode::Ret: {
+                LIRValue Result = reg(Inst.A);
+                Frames.resize(Base);
+                return Result;
+            }
+            }
+        }
+    }
+}
@@ -0,0 +1,269 @@
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "JIT/LIR.h"
+
+namespace {
+
+// splitLine - Слова строки; пробелы, запятые и скобки — разделители.
+std::vector<std::string_view> splitLine(std::string_view Line) {
+    std::vector<std::string_view> Words;
+    size_t Start = std::string_view::npos;
+    for (size_t I = 0; I <= Line.size(); ++I) {
+        bool Separator = I == Line.size() || Line[I] == ' ' || Line[I] == '\t' ||
+                         Line[I] == ',' || Line[I] == '(' || Line[I] == ')' ||
+                         Line[I] == '\r';
+        if (!Separator && Start == std::string_view::npos)
+            Start = I;
+        if (Separator && Start != std::string_view::npos) {
+            Words.push_back(Line.substr(Start, I - Start));
+            Start = std::string_view::npos;
+        }
+    }
+    return Words;
+}
+
+bool parseUnsigned(std::string_view Text, uint32_t &Value) {
+    if (Text.empty() || Text.size() > 9)
+        return false;
+    Value = 0;
+    for (char C : Text) {
+        if (C < '0' || C > '9')
+            return false;
+        Value = Value * 10 + static_cast<uint32_t>(C - '0');
+    }
+    return true;
+}
+
+bool parseType(std::string_view Text, LIRType &Type) {
+    if (Text == "int")
+        Type = LIRType::Int;
+    else if (Text == "float")
+        Type = LIRType::Float;
+    else
+        return false;
+    return true;
+}
+
+class LIRParser {
+    LIRModule &M;
+    std::string &Error;
+    unsigned LineNo = 0;
+
+    LIRFunction *F = nullptr;
+    // Known - Тип регистра уже задан в тексте.
+    std::vector<bool> Known;
+    BlockID Current = 0;
+
+public:
+    LIRParser(LIRModule &m, std::string &error) : M(m), Error(error) {}
+
+    bool fail(const std::string &Message) {
+        Error = "line " + std::to_string(LineNo) + ": " + Message;
+        return false;
+    }
+
+    bool parseHeader(const std::vector<std::string_view> &Words, bool Create);
+    bool parseReg(std::string_view Text, VReg &R);
+    bool parseBlock(std::string_view Text, BlockID &Block);
+    bool parseInst(const std::vector<std::string_view> &Words);
+    bool run(std::string_view Text, bool Headers);
+};
+
+// parseHeader - "func имя(%r0, %f1) -> int {".
+bool LIRParser::parseHeader(const std::vector<std::string_view> &Words, bool Create) {
+    size_t N = Words.size();
+    LIRType ReturnType;
+    if (N < 5 || Words[N - 1] != "{" || Words[N - 3] != "->" ||
+        !parseType(Words[N - 2], ReturnType))
+        return fail("malformed function header");
+
+    std::string Name(Words[1]);
+    if (!Create) {
+        F = M.getFunction(Name);
+        Known.assign(F->getNumRegs(), true);
+        Current = 0;
+        return true;
+    }
+
+    if (M.getFunction(Name))
+        return fail("redefinition of function '" + Name + "'");
+    std::vector<LIRType> ParamTypes;
+    for (size_t I = 2; I != N - 3; ++I) {
+        uint32_t Index;
+        if (Words[I].size() < 3 || Words[I][0] != '%' ||
+            (Words[I][1] != 'r' && Words[I][1] != 'f') ||
+            !parseUnsigned(Words[I].substr(2), Index) || Index != ParamTypes.size())
+            return fail("parameters must be %r0/%f0, %r1/%f1, ... in order");
+        ParamTypes.push_back(Words[I][1] == 'f' ? LIRType::Float : LIRType::Int);
+    }
+    M.createFunction(std::move(Name), ParamTypes, ReturnType);
+    return true;
+}
+
+bool LIRParser::parseReg(std::string_view Text, VReg &R) {
+    if (Text.size() < 3 || Text[0] != '%' || (Text[1] != 'r' && Text[1] != 'f') ||
+        !parseUnsigned(Text.substr(2), R))
+        return fail("expected a register, got '" + std::string(Text) + "'");
+    LIRType Type = Text[1] == 'f' ? LIRType::Float : LIRType::Int;
+    if (R >= F->getNumRegs()) {
+        F->RegTypes.resize(R + 1, Type);
+        Known.resize(R + 1, false);
+    }
+    if (Known[R] && F->RegTypes[R] != Type)
+        return fail("register " + std::to_string(R) + " is used with two types");
+    F->RegTypes[R] = Type;
+    Known[R] = true;
+    return true;
+}
+
+bool LIRParser::parseBlock(std::string_view Text, BlockID &Block) {
+    if (Text.size() < 3 || Text.substr(0, 2) != "bb" || !parseUnsigned(Text.substr(2), Block))
+        return fail("expected a block, got '" + std::string(Text) + "'");
+    if (Block >= F->Blocks.size())
+        F->Blocks.resize(Block + 1);
+    return true;
+}
+
+bool LIRParser::parseInst(const std::vector<std::string_view> &Words) {
+    LIRInst Inst;
+    size_t Pos = 0;
+    if (Words.size() >= 2 && Words[1] == "=") {
+        if (!parseReg(Words[0], Inst.Dest))
+            return false;
+        Pos = 2;
+    }
+    if (Pos >= Words.size())
+        return fail("expected an instruction");
+
+    bool Found = false;
+    #define LIR_OP(Id, Name)                                                  \
+    if (!Found && Words[Pos] == Name) {                                       \
+        Inst.Op = LIROpcode::Id;                                              \
+        Found = true;                                                         \
+    }
+    #include "JIT/LIROps.def"
+    if (!Found)
+        return fail("unknown instruction '" + std::string(Words[Pos]) + "'");
+
+    std::vector<std::string_view> Ops(Words.begin() + static_cast<long>(Pos) + 1, Words.end());
+    auto expect = [&](size_t Count) {
+        return Ops.size() == Count ||
+               fail(std::string("wrong number of operands for '") +
+                    getOpcodeName(Inst.Op) + "'");
+    };
+
+    switch (Inst.Op) {
+    case LIROpcode::IConst: {
+        if (!expect(1))
+            return false;
+        std::string Text(Ops[0]);
+        char *End;
+        Inst.Imm = std::strtoll(Text.c_str(), &End, 10);
+        if (*End != '\0')
+            return fail("invalid integer '" + Text + "'");
+        break;
+    }
+    case LIROpcode::FConst: {
+        if (!expect(1))
+            return false;
+        std::string Text(Ops[0]);
+        char *End;
+        LIRValue Value = makeFloat(std::strtod(Text.c_str(), &End));
+        if (*End != '\0')
+            return fail("invalid number '" + Text + "'");
+        Inst.Imm = Value.I;
+        break;
+    }
+    case LIROpcode::Call:
+        if (Ops.empty())
+            return fail("expected a callee");
+        Inst.Callee = M.getFunction(Ops[0]);
+        if (!Inst.Callee)
+            return fail("unknown function '" + std::string(Ops[0]) + "'");
+        for (size_t I = 1; I != Ops.size(); ++I) {
+            Inst.Args.push_back(NoVReg);
+            if (!parseReg(Ops[I], Inst.Args.back()))
+                return false;
+        }
+        break;
+    case LIROpcode::Br:
+        if (!expect(1) || !parseBlock(Ops[0], Inst.Targets[0]))
+            return false;
+        break;
+    case LIROpcode::CondBr:
+        if (!expect(3) || !parseReg(Ops[0], Inst.A) || !parseBlock(Ops[1], Inst.Targets[0]) ||
+            !parseBlock(Ops[2], Inst.Targets[1]))
+            return false;
+        break;
+    default:
+        if (Ops.empty() || Ops.size() > 2)
+            return expect(1);
+        if (!parseReg(Ops[0], Inst.A))
+            return false;
+        if (Ops.size() == 2 && !parseReg(Ops[1], Inst.B))
+            return false;
+        break;
+    }
+
+    F->Blocks[Current].Insts.push_back(std::move(Inst));
+    return true;
+}
+
+// run - Первый проход (Headers) создаёт функции, чтобы вызовы могли
+// ссылаться на функции ниже по тексту; второй читает тела.
+bool LIRParser::run(std::string_view Text, bool Headers) {
+    LineNo = 0;
+    F = nullptr;
+    size_t LineStart = 0;
+    while (LineStart < Text.size()) {
+        size_t LineEnd = Text.find('\n', LineStart);
+        if (LineEnd == std::string_view::npos)
+            LineEnd = Text.size();
+        std::string_view Line = Text.substr(LineStart, LineEnd - LineStart);
+        LineStart = LineEnd + 1;
+        ++LineNo;
+
+        size_t Comment = Line.find(';');
+        if (Comment != std::string_view::npos)
+            Line = Line.substr(0, Comment);
+        std::vector<std::string_view> Words = splitLine(Line);
+        if (Words.empty())
+            continue;
+
+        if (Words[0] == "func") {
+            if (F)
+                return fail("missing '}'");
+            if (!parseHeader(Words, Headers))
+                return false;
+            if (Headers)
+                F = M.getFunctions().back().get();
+            continue;
+        }
+        if (!F)
+            return fail("expected 'func'");
+        if (Words.size() == 1 && Words[0] == "}") {
+            F = nullptr;
+            continue;
+        }
+        if (Headers)
+            continue;
+        if (Words.size() == 1 && Words[0].back() == ':') {
+            if (!parseBlock(Words[0].substr(0, Words[0].size() - 1), Current))
+                return false;
+            continue;
+        }
+        if (!parseInst(Words))
+            return false;
+    }
+    if (F)
+        return fail("missing '}'");
+    return true;
+}
+
+} // namespace
+
+bool parseLIRModule(std::string_view Text, LIRModule &M, std::string &Error) {
+    LIRParser Parser(M, Error);
+    return Parser.run(Text, true) && Parser.run(Text, false);
+}
@@ -0,0 +1,247 @@
+#include <algorithm>
+#include "JIT/RegisterAllocator.h"
+
+namespace {
+
+// BitVector - Множество виртуальных регистров для анализа живости.
+class BitVector {
+    std::vector<uint64_t> Words;
+
+public:
+    explicit BitVector(size_t Size = 0) : Words((Size + 63) / 64, 0) {}
+
+    void set(size_t I) { Words[I / 64] |= uint64_t(1) << (I % 64); }
+    bool test(size_t I) const { return (Words[I / 64] >> (I % 64)) & 1; }
+
+    // unionWith - this |= Other; возвращает true, если множество выросло.
+    bool unionWith(const BitVector &Other) {
+        bool Changed = false;
+        for (size_t W = 0; W != Words.size(); ++W) {
+            uint64_t New = Words[W] | Other.Words[W];
+            Changed |= New != Words[W];
+            Words[W] = New;
+        }
+        return Changed;
+    }
+
+    // unionWithDifference - this |= A & ~B.
+    bool unionWithDifference(const BitVector &A, const BitVector &B) {
+        bool Changed = false;
+        for (size_t W = 0; W != Words.size(); ++W) {
+            uint64_t New = Words[W] | (A.Words[W] & ~B.Words[W]);
+            Changed |= New != Words[W];
+            Words[W] = New;
+        }
+        return Changed;
+    }
+
+    template <typename Fn>
+    void forEach(Fn F) const {
+        for (size_t W = 0; W != Words.size(); ++W)
+            for (uint64_t Bits = Words[W]; Bits; Bits &= Bits - 1)
+                F(static_cast<VReg>(W * 64 + __builtin_ctzll(Bits)));
+    }
+};
+
+template <typename Fn>
+void forEachUse(const LIRInst &Inst, Fn F) {
+    if (Inst.A != NoVReg)
+        F(Inst.A);
+    if (Inst.B != NoVReg)
+        F(Inst.B);
+    for (VReg Arg : Inst.Args)
+        F(Arg);
+}
+
+template <typename Fn>
+void forEachSuccessor(const LIRBlock &Block, Fn F) {
+    const LIRInst &Term = Block.Insts.back();
+    if (Term.Op == LIROpcode::Br)
+        F(Term.Targets[0]);
+    else if (Term.Op == LIROpcode::CondBr) {
+        F(Term.Targets[0]);
+        F(Term.Targets[1]);
+    }
+}
+
+} // namespace
+
+std::vector<LiveInterval> LinearScanAllocator::computeLiveIntervals(const LIRFunction &F) {
+    size_t NumRegs = F.getNumRegs();
+    size_t NumBlocks = F.Blocks.size();
+
+    // Use - читается в блоке до записи; Def - пишется в блоке.
+    std::vector<BitVector> Use(NumBlocks, BitVector(NumRegs));
+    std::vector<BitVector> Def(NumBlocks, BitVector(NumRegs));
+    for (size_t B = 0; B != NumBlocks; ++B) {
+        for (const LIRInst &Inst : F.Blocks[B].Insts) {
+            forEachUse(Inst, [&](VReg R) {
+                if (!Def[B].test(R))
+                    Use[B].set(R);
+            });
+            if (Inst.Dest != NoVReg)
+                Def[B].set(Inst.Dest);
+        }
+    }
+
+    std::vector<BitVector> LiveIn(NumBlocks, BitVector(NumRegs));
+    std::vector<BitVector> LiveOut(NumBlocks, BitVector(NumRegs));
+    bool Changed = true;
+    while (Changed) {
+        Changed = false;
+        for (size_t B = NumBlocks; B-- != 0;) {
+            forEachSuccessor(F.Blocks[B], [&](BlockID Succ) {
+                Changed |= LiveOut[B].unionWith(LiveIn[Succ]);
+            });
+            Changed |= LiveIn[B].unionWith(Use[B]);
+            Changed |= LiveIn[B].unionWithDifference(LiveOut[B], Def[B]);
+        }
+    }
+
+    std::vector<uint32_t> Start(NumRegs, UINT32_MAX);
+    std::vector<uint32_t> End(NumRegs, 0);
+    auto touch = [&](VReg R, uint32_t Pos) {
+        Start[R] = std::min(Start[R], Pos);
+        End[R] = std::max(End[R], Pos);
+    };
+
+    for (VReg Param : F.Params)
+        touch(Param, 0);
+
+    std::vector<uint32_t> CallPositions;
+    uint32_t N = 0;
+    for (size_t B = 0; B != NumBlocks; ++B) {
+        uint32_t BlockStart = 2 * N;
+        for (const LIRInst &Inst : F.Blocks[B].Insts) {
+            forEachUse(Inst, [&](VReg R) { touch(R, 2 * N); });
+            if (Inst.Dest != NoVReg)
+                touch(Inst.Dest, 2 * N + 1);
+            if (Inst.Op == LIROpcode::Call)
+                CallPositions.push_back(2 * N);
+            ++N;
+        }
+        uint32_t BlockEnd = 2 * N - 1;
+        LiveIn[B].forEach([&](VReg R) { touch(R, BlockStart); });
+        LiveOut[B].forEach([&](VReg R) { touch(R, BlockEnd); });
+    }
+
+    std::vector<LiveInterval> Intervals;
+    for (VReg R = 0; R != NumRegs; ++R) {
+        if (Start[R] == UINT32_MAX)
+            continue;
+        // Вызов в самой позиции Start (первая инструкция функции или блока,
+        // где значение живо на входе) тоже пересекает интервал, если
+        // значение нужно после него.
+        auto NextCall = std::lower_bound(CallPositions.begin(), CallPositions.end(), Start[R]);
+        bool CrossesCall = NextCall != CallPositions.end() && *NextCall + 1 < End[R];
+        Intervals.push_back({R, Start[R], End[R], CrossesCall});
+    }
+    std::stable_sort(Intervals.begin(), Intervals.end(),
+                     [](const LiveInterval &L, const LiveInterval &R) {
+                         return L.Start < R.Start;
+                     });
+    return Intervals;
+}
+
+LinearScanAllocator::LinearScanAllocator(RegisterClass IntRegs, RegisterClass FloatRegs)
+    : Classes{std::move(IntRegs), std::move(FloatRegs)} {}
+
+void LinearScanAllocator::allocateClass(const LIRFunction &F,
+                                        const std::vector<LiveInterval> &Intervals,
+                                        LIRType Type, RegisterAssignment &Result) const {
+    const RegisterClass &Class = Classes[static_cast<unsigned>(Type)];
+    auto isCalleeSaved = [&](uint8_t Reg) {
+        return std::find(Class.CalleeSaved.begin(), Class.CalleeSaved.end(), Reg) !=
+               Class.CalleeSaved.end();
+    };
+
+    struct Active {
+        uint32_t End;
+        VReg Reg;
+        uint8_t Phys;
+    };
+    std::vector<Active> ActiveList;
+    bool Free[256] = {};
+    for (uint8_t Reg : Class.CallerSaved)
+        Free[Reg] = true;
+    for (uint8_t Reg : Class.CalleeSaved)
+        Free[Reg] = true;
+
+    auto spill = [&](VReg R) {
+        Result.Locations[R].K = ValueLocation::Stack;
+        Result.Locations[R].Slot = Result.NumSpillSlots++;
+    };
+    auto assign = [&](const LiveInterval &LI, uint8_t Phys) {
+        Free[Phys] = false;
+        Result.Locations[LI.Reg].K = ValueLocation::Register;
+        Result.Locations[LI.Reg].PhysReg = Phys;
+        ActiveList.push_back({LI.End, LI.Reg, Phys});
+        if (isCalleeSaved(Phys) &&
+            std::find(Result.UsedCalleeSaved.begin(), Result.UsedCalleeSaved.end(), Phys) ==
+                Result.UsedCalleeSaved.end())
+            Result.UsedCalleeSaved.push_back(Phys);
+    };
+
+    std::vector<uint8_t> Candidates;
+    for (const LiveInterval &LI : Intervals) {
+        if (F.getRegType(LI.Reg) != Type)
+            continue;
+
+        // Освобождаем регистры интервалов, закончившихся до начала текущего.
+        ActiveList.erase(std::remove_if(ActiveList.begin(), ActiveList.end(),
+                                        [&](const Active &A) {
+                                            if (A.End >= LI.Start)
+                                                return false;
+                                            Free[A.Phys] = true;
+                                            return true;
+                                        }),
+                         ActiveList.end());
+
+        // Живое через вызов значение может занять только сохраняемый регистр.
+        // Остальным сначала отдаём несохраняемые, чтобы не платить за пролог.
+        Candidates.clear();
+        if (!LI.CrossesCall)
+            Candidates = Class.CallerSaved;
+        Candidates.insert(Candidates.end(), Class.CalleeSaved.begin(), Class.CalleeSaved.end());
+
+        auto FreeReg = std::find_if(Candidates.begin(), Candidates.end(),
+                                    [&](uint8_t Reg) { return Free[Reg]; });
+        if (FreeReg != Candidates.end()) {
+            assign(LI, *FreeReg);
+            continue;
+        }
+
+        // Свободных нет: отбираем регистр у интервала, живущего дольше всех.
+        auto Victim = ActiveList.end();
+        for (auto It = ActiveList.begin(); It != ActiveList.end(); ++It) {
+            if (std::find(Candidates.begin(), Candidates.end(), It->Phys) == Candidates.end())
+                continue;
+            if (Victim == ActiveList.end() || It->End > Victim->End)
+                Victim = It;
+        }
+        if (Victim == ActiveList.end() || Victim->End <= LI.End) {
+            spill(LI.Reg);
+            continue;
+        }
+        uint8_t Phys = Victim->Phys;
+        spill(Victim->Reg);
+        ActiveList.erase(Victim);
+        assign(LI, Phys);
+    }
+}
+
+RegisterAssignment LinearScanAllocator::allocate(const LIRFunction &F) const {
+    RegisterAssignment Result;
+    Result.Locations.resize(F.getNumRegs());
+
+    std::vector<LiveInterval> Intervals = computeLiveIntervals(F);
+    allocateClass(F, Intervals, LIRType::Int, Result);
+    allocateClass(F, Intervals, LIRType::Float, Result);
+
+    // Начало в позиции 0 без параметра означает чтение до первой записи.
+    for (const LiveInterval &LI : Intervals)
+        if (LI.Start == 0 &&
+            std::find(F.Params.begin(), F.Params.end(), LI.Reg) == F.Params.end())
+            Result.ZeroOnEntry.push_back(LI.Reg);
+    return Result;
+}
@@ -0,0 +1,206 @@
+#include <cassert>
+#include <cstring>
+#include "JIT/X86Assembler.h"
+
+using namespace x86;
+
+X86Assembler::Label X86Assembler::createLabel() {
+    LabelOffsets.push_back(-1);
+    return static_cast<Label>(LabelOffsets.size() - 1);
+}
+
+void X86Assembler::bind(Label L) {
+    assert(!isBound(L) && "label is bound twice");
+    LabelOffsets[L] = static_cast<int64_t>(Code.size());
+}
+
+bool X86Assembler::finalize() {
+    for (const Fixup &F : Fixups) {
+        if (!isBound(F.Target))
+            return false;
+        int64_t Rel = LabelOffsets[F.Target] - static_cast<int64_t>(F.Offset + 4);
+        int32_t Rel32 = static_cast<int32_t>(Rel);
+        std::memcpy(&Code[F.Offset], &Rel32, sizeof(Rel32));
+    }
+    Fixups.clear();
+    return true;
+}
+
+void X86Assembler::emit32(uint32_t Value) {
+    for (unsigned I = 0; I != 4; ++I)
+        emit8(static_cast<uint8_t>(Value >> (8 * I)));
+}
+
+void X86Assembler::emit64(uint64_t Value) {
+    emit32(static_cast<uint32_t>(Value));
+    emit32(static_cast<uint32_t>(Value >> 32));
+}
+
+// emitRex - REX нужен для 64-битного операнда, регистров r8-r15 и (Force)
+// байтовых регистров spl/bpl/sil/dil.
+void X86Assembler::emitRex(bool W, uint8_t Reg, uint8_t RM, bool Force) {
+    uint8_t Rex = 0x40 | (W << 3) | ((Reg >> 3) << 2) | (RM >> 3);
+    if (Rex != 0x40 || Force)
+        emit8(Rex);
+}
+
+void X86Assembler::emitModRMReg(uint8_t Reg, uint8_t RM) {
+    emit8(static_cast<uint8_t>(0xC0 | ((Reg & 7) << 3) | (RM & 7)));
+}
+
+void X86Assembler::emitModRMMem(uint8_t Reg, Mem M) {
+    assert((M.Base & 7) != RSP && "base register needs a SIB byte");
+    if (M.Disp >= -128 && M.Disp <= 127) {
+        emit8(static_cast<uint8_t>(0x40 | ((Reg & 7) << 3) | (M.Base & 7)));
+        emit8(static_cast<uint8_t>(M.Disp));
+    } else {
+        emit8(static_cast<uint8_t>(0x80 | ((Reg & 7) << 3) | (M.Base & 7)));
+        emit32(static_cast<uint32_t>(M.Disp));
+    }
+}
+
+void X86Assembler::emitRel32(Label Target) {
+    Fixups.push_back({Code.size(), Target});
+    emit32(0);
+}
+
+void X86Assembler::emitRR(uint8_t Prefix, bool W, uint8_t Op1, uint8_t Op2, uint8_t Reg,
+                          uint8_t RM) {
+    if (Prefix)
+        emit8(Prefix);
+    emitRex(W, Reg, RM);
+    if (Op1)
+        emit8(Op1);
+    emit8(Op2);
+    emitModRMReg(Reg, RM);
+}
+
+void X86Assembler::emitRM(uint8_t Prefix, bool W, uint8_t Op1, uint8_t Op2, uint8_t Reg,
+                          Mem M) {
+    if (Prefix)
+        emit8(Prefix);
+    emitRex(W, Reg, M.Base);
+    if (Op1)
+        emit8(Op1);
+    emit8(Op2);
+    emitModRMMem(Reg, M);
+}
+
+//===----------------------------------------------------------------------===//
+// Целочисленные инструкции
+//===----------------------------------------------------------------------===//
+
+void X86Assembler::mov(GPR Dst, GPR Src) {
+    if (Dst != Src)
+        emitRR(0, true, 0, 0x89, Src, Dst);
+}
+
+void X86Assembler::mov(GPR Dst, Mem Src) { emitRM(0, true, 0, 0x8B, Dst, Src); }
+
+void X86Assembler::mov(Mem Dst, GPR Src) { emitRM(0, true, 0, 0x89, Src, Dst); }
+
+void X86Assembler::movImm(GPR Dst, int64_t Imm) {
+    if (Imm == 0) {
+        emitRR(0, false, 0, 0x31, Dst, Dst); // xor r32, r32
+    } else if (Imm >= 0 && Imm <= UINT32_MAX) {
+        emitRex(false, 0, Dst);              // mov r32, imm32 (расширяется нулями)
+        emit8(static_cast<uint8_t>(0xB8 + (Dst & 7)));
+        emit32(static_cast<uint32_t>(Imm));
+    } else if (Imm >= INT32_MIN && Imm <= INT32_MAX) {
+        emitRR(0, true, 0, 0xC7, 0, Dst);    // mov r/m64, simm32
+        emit32(static_cast<uint32_t>(Imm));
+    } else {
+        emitRex(true, 0, Dst);               // movabs r64, imm64
+        emit8(static_cast<uint8_t>(0xB8 + (Dst & 7)));
+        emit64(static_cast<uint64_t>(Imm));
+    }
+}
+
+void X86Assembler::add(GPR Dst, GPR Src) { emitRR(0, true, 0, 0x01, Src, Dst); }
+void X86Assembler::sub(GPR Dst, GPR Src) { emitRR(0, true, 0, 0x29, Src, Dst); }
+void X86Assembler::and_(GPR Dst, GPR Src) { emitRR(0, true, 0, 0x21, Src, Dst); }
+void X86Assembler::or_(GPR Dst, GPR Src) { emitRR(0, true, 0, 0x09, Src, Dst); }
+void X86Assembler::xor_(GPR Dst, GPR Src) { emitRR(0, true, 0, 0x31, Src, Dst); }
+void X86Assembler::cmp(GPR A, GPR B) { emitRR(0, true, 0, 0x39, B, A); }
+void X86Assembler::test(GPR A, GPR B) { emitRR(0, true, 0, 0x85, B, A); }
+void X86Assembler::imul(GPR Dst, GPR Src) { emitRR(0, true, 0x0F, 0xAF, Dst, Src); }
+void X86Assembler::neg(GPR Dst) { emitRR(0, true, 0, 0xF7, 3, Dst); }
+void X86Assembler::idiv(GPR Divisor) { emitRR(0, true, 0, 0xF7, 7, Divisor); }
+
+void X86Assembler::cqo() {
+    emit8(0x48);
+    emit8(0x99);
+}
+
+void X86Assembler::setcc(Cond C, GPR Dst) {
+    emitRex(false, 0, Dst, Dst >= RSP);
+    emit8(0x0F);
+    emit8(static_cast<uint8_t>(0x90 + C));
+    emitModRMReg(0, Dst);
+    // movzx r32, r8
+    emitRex(false, Dst, Dst, Dst >= RSP);
+    emit8(0x0F);
+    emit8(0xB6);
+    emitModRMReg(Dst, Dst);
+}
+
+void X86Assembler::subImm(GPR Dst, int32_t Imm) {
+    emitRR(0, true, 0, 0x81, 5, Dst);
+    emit32(static_cast<uint32_t>(Imm));
+}
+
+//===----------------------------------------------------------------------===//
+// SSE2
+//===----------------------------------------------------------------------===//
+
+void X86Assembler::movsd(XMM Dst, XMM Src) {
+    if (Dst != Src)
+        emitRR(0xF2, false, 0x0F, 0x10, Dst, Src);
+}
+
+void X86Assembler::movsd(XMM Dst, Mem Src) { emitRM(0xF2, false, 0x0F, 0x10, Dst, Src); }
+void X86Assembler::movsd(Mem Dst, XMM Src) { emitRM(0xF2, false, 0x0F, 0x11, Src, Dst); }
+
+void X86Assembler::addsd(XMM Dst, XMM Src) { emitRR(0xF2, false, 0x0F, 0x58, Dst, Src); }
+void X86Assembler::mulsd(XMM Dst, XMM Src) { emitRR(0xF2, false, 0x0F, 0x59, Dst, Src); }
+void X86Assembler::subsd(XMM Dst, XMM Src) { emitRR(0xF2, false, 0x0F, 0x5C, Dst, Src); }
+void X86Assembler::divsd(XMM Dst, XMM Src) { emitRR(0xF2, false, 0x0F, 0x5E, Dst, Src); }
+void X86Assembler::xorpd(XMM Dst, XMM Src) { emitRR(0x66, false, 0x0F, 0x57, Dst, Src); }
+void X86Assembler::ucomisd(XMM A, XMM B) { emitRR(0x66, false, 0x0F, 0x2E, A, B); }
+
+void X86Assembler::cvtsi2sd(XMM Dst, GPR Src) { emitRR(0xF2, true, 0x0F, 0x2A, Dst, Src); }
+void X86Assembler::cvttsd2si(GPR Dst, XMM Src) { emitRR(0xF2, true, 0x0F, 0x2C, Dst, Src); }
+void X86Assembler::movq(XMM Dst, GPR Src) { emitRR(0x66, true, 0x0F, 0x6E, Dst, Src); }
+void X86Assembler::movq(GPR Dst, XMM Src) { emitRR(0x66, true, 0x0F, 0x7E, Src, Dst); }
+
+//===----------------------------------------------------------------------===//
+// Управление
+//===----------------------------------------------------------------------===//
+
+void X86Assembler::push(GPR Reg) {
+    emitRex(false, 0, Reg);
+    emit8(static_cast<uint8_t>(0x50 + (Reg & 7)));
+}
+
+void X86Assembler::pop(GPR Reg) {
+    emitRex(false, 0, Reg);
+    emit8(static_cast<uint8_t>(0x58 + (Reg & 7)));
+}
+
+void X86Assembler::jmp(Label Target) {
+    emit8(0xE9);
+    emitRel32(Target);
+}
+
+void X86Assembler::jcc(Cond C, Label Target) {
+    emit8(0x0F);
+    emit8(static_cast<uint8_t>(0x80 + C));
+    emitRel32(Target);
+}
+
+void X86Assembler::call(Label Target) {
+    emit8(0xE8);
+    emitRel32(Target);
+}
+
+void X86Assembler::ret() { emit8(0xC3); }
@@ -0,0 +1,207 @@
+#include <cstdint>
+#include "MIR/Dominators.h"
+#include "MIR/Passes.h"
+
+namespace {
+
+MIRInst *makeInt(MIRFunction &F, int64_t V) {
+    MIRInst *C = F.createInst(MIROpcode::IConst, MIRType::Int, {});
+    C->setIntValue(V);
+    return C;
+}
+
+MIRInst *makeFloat(MIRFunction &F, double V) {
+    MIRInst *C = F.createInst(MIROpcode::FConst, MIRType::Float, {});
+    C->setFloatValue(V);
+    return C;
+}
+
+MIRInst *makeBool(MIRFunction &F, bool V) {
+    MIRInst *C = F.createInst(MIROpcode::BConst, MIRType::Bool, {});
+    C->setIntValue(V);
+    return C;
+}
+
+bool isIntConst(const MIRInst *V, int64_t Value) {
+    return V->getOpcode() == MIROpcode::IConst && V->getIntValue() == Value;
+}
+
+// Арифметика MIR — по модулю 2^64; считаем в беззнаковых, чтобы
+// переполнение при свёртке не было UB компилятора.
+int64_t wrap(uint64_t V) { return static_cast<int64_t>(V); }
+
+// fold - Свёрнутое значение I: новая константа (ещё не в блоке) или уже
+// существующий операнд для тождеств вида x + 0. nullptr — свернуть нельзя.
+MIRInst *fold(MIRFunction &F, MIRInst *I) {
+    MIROpcode Op = I->getOpcode();
+    unsigned NumOps = I->getNumOperands();
+    if (I->isPhi() || NumOps == 0 || NumOps > 2 || Op == MIROpcode::Call ||
+        I->isTerminator())
+        return nullptr;
+
+    MIRInst *A = I->getOperand(0);
+    if (NumOps == 1) {
+        switch (Op) {
+        case MIROpcode::Neg:
+            if (A->getOpcode() == MIROpcode::IConst)
+                return makeInt(F, wrap(0 - static_cast<uint64_t>(A->getIntValue())));
+            break;
+        case MIROpcode::FNeg:
+            if (A->getOpcode() == MIROpcode::FConst)
+                return makeFloat(F, -A->getFloatValue());
+            break;
+        case MIROpcode::Not:
+            if (A->getOpcode() == MIROpcode::BConst)
+                return makeBool(F, !A->getBoolValue());
+            break;
+        default:
+            break;
+        }
+        return nullptr;
+    }
+
+    MIRInst *B = I->getOperand(1);
+    bool IntConsts = A->getOpcode() == MIROpcode::IConst && B->getOpcode() == MIROpcode::IConst;
+    bool FloatConsts = A->getOpcode() == MIROpcode::FConst && B->getOpcode() == MIROpcode::FConst;
+    bool BoolConsts = A->getOpcode() == MIROpcode::BConst && B->getOpcode() == MIROpcode::BConst;
+
+    if (IntConsts) {
+        int64_t L = A->getIntValue(), R = B->getIntValue();
+        uint64_t UL = static_cast<uint64_t>(L), UR = static_cast<uint64_t>(R);
+        switch (Op) {
+        case MIROpcode::Add: return makeInt(F, wrap(UL + UR));
+        case MIROpcode::Sub: return makeInt(F, wrap(UL - UR));
+        case MIROpcode::Mul: return makeInt(F, wrap(UL * UR));
+        case MIROpcode::Div:
+        case MIROpcode::Rem:
+            // Неопределённое деление оставляем как есть — пусть упадёт
+            // во время выполнения, а не при компиляции.
+            if (R == 0 || (L == INT64_MIN && R == -1))
+                return nullptr;
+            return makeInt(F, Op == MIROpcode::Div ? L / R : L % R);
+        case MIROpcode::CmpEq: return makeBool(F, L == R);
+        case MIROpcode::CmpNe: return makeBool(F, L != R);
+        case MIROpcode::CmpLt: return makeBool(F, L < R);
+        case MIROpcode::CmpLe: return makeBool(F, L <= R);
+        case MIROpcode::CmpGt: return makeBool(F, L > R);
+        case MIROpcode::CmpGe: return makeBool(F, L >= R);
+        default:
+            return nullptr;
+        }
+    }
+
+    if (FloatConsts) {
+        double L = A->getFloatValue(), R = B->getFloatValue();
+        switch (Op) {
+        case MIROpcode::FAdd: return makeFloat(F, L + R);
+        case MIROpcode::FSub: return makeFloat(F, L - R);
+        case MIROpcode::FMul: return makeFloat(F, L * R);
+        case MIROpcode::FDiv: return makeFloat(F, L / R);
+        case MIROpcode::FCmpEq: return makeBool(F, L == R);
+        case MIROpcode::FCmpNe: return makeBool(F, L != R);
+        case MIROpcode::FCmpLt: return makeBool(F, L < R);
+        case MIROpcode::FCmpLe: return makeBool(F, L <= R);
+        case MIROpcode::FCmpGt: return makeBool(F, L > R);
+        case MIROpcode::FCmpGe: return makeBool(F, L >= R);
+        default:
+            return nullptr;
+        }
+    }
+
+    if (BoolConsts) {
+        if (Op == MIROpcode::And)
+            return makeBool(F, A->getBoolValue() && B->getBoolValue());
+        if (Op == MIROpcode::Or)
+            return makeBool(F, A->getBoolValue() || B->getBoolValue());
+        return nullptr;
+    }
+
+    // Тождества с одним константным операндом. Для чисел с плавающей
+    // точкой их нет: x + 0.0 != x при x == -0.0.
+    switch (Op) {
+    case MIROpcode::Add:
+        if (isIntConst(B, 0)) return A;
+        if (isIntConst(A, 0)) return B;
+        break;
+    case MIROpcode::Sub:
+        if (isIntConst(B, 0)) return A;
+        break;
+    case MIROpcode::Mul:
+        if (isIntConst(B, 1)) return A;
+        if (isIntConst(A, 1)) return B;
+        if (isIntConst(A, 0) || isIntConst(B, 0)) return makeInt(F, 0);
+        break;
+    case MIROpcode::And:
+    case MIROpcode::Or: {
+        // false && x == false, true && x == x; для || — наоборот.
+        bool Absorbing = Op == MIROpcode::Or;
+        for (unsigned K = 0; K != 2; ++K) {
+            MIRInst *C = I->getOperand(K);
+            if (C->getOpcode() != MIROpcode::BConst)
+                continue;
+            if (C->getBoolValue() == Absorbing)
+                return makeBool(F, Absorbing);
+            return I->getOperand(1 - K);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+    return nullptr;
+}
+
+} // namespace
+
+unsigned runConstantFolding(MIRFunction &F) {
+    std::vector<MIRInst *> Replacement(F.getNumValues(), nullptr);
+    unsigned NumChanges = 0;
+
+    // В обратном post-order определения встречаются раньше использований
+    // (кроме операндов phi по обратным дугам), поэтому цепочки констант
+    // сворачиваются за один проход.
+    DominatorTree DT(F);
+    for (MIRBlock *B : DT.getReversePostOrder()) {
+        for (size_t Pos = 0; Pos != B->Insts.size(); ++Pos) {
+            MIRInst *I = B->Insts[Pos];
+            for (unsigned Op = 0; Op != I->getNumOperands(); ++Op)
+                if (I->getOperand(Op)->getID() < Replacement.size())
+                    I->setOperand(Op, resolveReplacement(Replacement, I->getOperand(Op)));
+
+            MIRInst *New = fold(F, I);
+            if (!New)
+                continue;
+            if (!New->getParent()) {
+                New->setParent(B);
+                B->Insts[Pos] = New;
+            } else {
+                B->Insts.erase(B->Insts.begin() + Pos--);
+            }
+            Replacement.resize(F.getNumValues(), nullptr);
+            Replacement[I->getID()] = New;
+            ++NumChanges;
+        }
+
+        // condbr по константе становится br; невыбранный преемник теряет
+        // дугу, и phi в нём — соответствующий операнд.
+        MIRInst *T = B->getTerminator();
+        if (!T || T->getOpcode() != MIROpcode::CondBr ||
+            T->getOperand(0)->getOpcode() != MIROpcode::BConst)
+            continue;
+        bool Cond = T->getOperand(0)->getBoolValue();
+        MIRBlock *Taken = T->getSuccessor(Cond ? 0 : 1);
+        MIRBlock *NotTaken = T->getSuccessor(Cond ? 1 : 0);
+        MIRInst *Br = F.createInst(MIROpcode::Br, MIRType::Void, {});
+        Br->setSuccessor(0, Taken);
+        Br->setParent(B);
+        B->Insts.back() = Br;
+        NotTaken->removePredecessor(NotTaken->getPredIndex(B));
+        ++NumChanges;
+    }
+
+    if (NumChanges) {
+        Replacement.resize(F.getNumValues(), nullptr);
+        F.replaceAllUses(Replacement);
+    }
+    return NumChanges;
+}
@@ -0,0 +1,54 @@
+#include <algorithm>
+#include "MIR/Passes.h"
+
+unsigned runCopyPropagation(MIRFunction &F) {
+    std::vector<MIRInst *> Replacement(F.getNumValues(), nullptr);
+    unsigned NumChanges = 0;
+
+    for (const auto &B : F.Blocks)
+        for (MIRInst *I : B->Insts)
+            if (I->getOpcode() == MIROpcode::Copy) {
+                Replacement[I->getID()] = I->getOperand(0);
+                ++NumChanges;
+            }
+
+    // Тривиальная phi — все операнды одно и то же значение (или сама phi).
+    // Её замена может сделать тривиальной другую phi того же цикла,
+    // поэтому повторяем до неподвижной точки.
+    for (bool Changed = true; Changed;) {
+        Changed = false;
+        for (const auto &B : F.Blocks) {
+            for (unsigned P = 0, E = B->getNumPhis(); P != E; ++P) {
+                MIRInst *Phi = B->Insts[P];
+                if (Replacement[Phi->getID()])
+                    continue;
+                MIRInst *Same = nullptr;
+                bool Trivial = true;
+                for (MIRInst *Op : Phi->getOperands()) {
+                    MIRInst *V = resolveReplacement(Replacement, Op);
+                    if (V == Phi || V == Same)
+                        continue;
+                    if (Same) {
+                        Trivial = false;
+                        break;
+                    }
+                    Same = V;
+                }
+                if (!Trivial || !Same)
+                    continue;
+                Replacement[Phi->getID()] = Same;
+                Changed = true;
+                ++NumChanges;
+            }
+        }
+    }
+
+    if (!NumChanges)
+        return 0;
+    F.replaceAllUses(Replacement);
+    for (const auto &B : F.Blocks)
+        B->Insts.erase(std::remove_if(B->Insts.begin(), B->Insts.end(),
+                                      [&](MIRInst *I) { return Replacement[I->getID()]; }),
+                       B->Insts.end());
+    return NumChanges;
+}
@@ -0,0 +1,46 @@
+#include <algorithm>
+#include "MIR/Dominators.h"
+#include "MIR/Passes.h"
+
+unsigned runDeadCodeElimination(MIRFunction &F) {
+    unsigned NumRemoved = 0;
+
+    // Недостижимые блоки удаляются целиком вместе с дугами из них.
+    DominatorTree DT(F);
+    if (DT.getReversePostOrder().size() != F.Blocks.size()) {
+        std::vector<bool> Dead(F.Blocks.size(), false);
+        for (const auto &B : F.Blocks)
+            if (!DT.isReachable(B.get())) {
+                Dead[B->getID()] = true;
+                NumRemoved += static_cast<unsigned>(B->Insts.size());
+            }
+        F.eraseBlocks(Dead);
+    }
+
+    // Mark-sweep: живы побочные инструкции и всё, от чего они зависят.
+    std::vector<bool> Live(F.getNumValues(), false);
+    std::vector<MIRInst *> Worklist;
+    for (const auto &B : F.Blocks)
+        for (MIRInst *I : B->Insts)
+            if (hasSideEffects(I->getOpcode())) {
+                Live[I->getID()] = true;
+                Worklist.push_back(I);
+            }
+    while (!Worklist.empty()) {
+        MIRInst *I = Worklist.back();
+        Worklist.pop_back();
+        for (MIRInst *Op : I->getOperands())
+            if (!Live[Op->getID()]) {
+                Live[Op->getID()] = true;
+                Worklist.push_back(Op);
+            }
+    }
+
+    for (const auto &B : F.Blocks) {
+        auto NewEnd = std::remove_if(B->Insts.begin(), B->Insts.end(),
+                                     [&](MIRInst *I) { return !Live[I->getID()]; });
+        NumRemoved += static_cast<unsigned>(B->Insts.end() - NewEnd);
+        B->Insts.erase(NewEnd, B->Insts.end());
+    }
+    return NumRemoved;
+}
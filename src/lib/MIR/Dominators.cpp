@@ -0,0 +1,80 @@
+#include <utility>
+#include "MIR/Dominators.h"
+
+DominatorTree::DominatorTree(const MIRFunction &F)
+    : RPONumber(F.Blocks.size(), ~0u) {
+    // Итеративный DFS: пара (блок, следующий преемник для обхода).
+    std::vector<MIRBlock *> PostOrder;
+    std::vector<bool> Visited(F.Blocks.size(), false);
+    std::vector<std::pair<MIRBlock *, unsigned>> Stack;
+    Stack.push_back({F.getEntryBlock(), 0});
+    Visited[0] = true;
+    while (!Stack.empty()) {
+        auto &[B, Next] = Stack.back();
+        if (Next == B->getNumSuccessors()) {
+            PostOrder.push_back(B);
+            Stack.pop_back();
+            continue;
+        }
+        MIRBlock *Succ = B->getSuccessor(Next++);
+        if (!Visited[Succ->getID()]) {
+            Visited[Succ->getID()] = true;
+            Stack.push_back({Succ, 0});
+        }
+    }
+
+    RPO.assign(PostOrder.rbegin(), PostOrder.rend());
+    for (unsigned I = 0; I != RPO.size(); ++I)
+        RPONumber[RPO[I]->getID()] = I;
+
+    auto intersect = [&](unsigned A, unsigned B) {
+        while (A != B) {
+            while (A > B)
+                A = IDom[A];
+            while (B > A)
+                B = IDom[B];
+        }
+        return A;
+    };
+
+    IDom.assign(RPO.size(), ~0u);
+    IDom[0] = 0;
+    bool Changed = true;
+    while (Changed) {
+        Changed = false;
+        for (unsigned I = 1; I != RPO.size(); ++I) {
+            unsigned NewIDom = ~0u;
+            for (MIRBlock *Pred : RPO[I]->Preds) {
+                unsigned P = RPONumber[Pred->getID()];
+                if (P == ~0u || IDom[P] == ~0u)
+                    continue;
+                NewIDom = NewIDom == ~0u ? P : intersect(P, NewIDom);
+            }
+            if (NewIDom != IDom[I]) {
+                IDom[I] = NewIDom;
+                Changed = true;
+            }
+        }
+    }
+}
+
+MIRBlock *DominatorTree::getIDom(const MIRBlock *B) const {
+    unsigned N = RPONumber[B->getID()];
+    if (N == ~0u || N == 0)
+        return nullptr;
+    return RPO[IDom[N]];
+}
+
+bool DominatorTree::dominates(const MIRBlock *A, const MIRBlock *B) const {
+    unsigned NB = RPONumber[B->getID()];
+    if (NB == ~0u)
+        return true;
+    unsigned NA = RPONumber[A->getID()];
+    if (NA == ~0u)
+        return false;
+    // Доминатор всегда раньше в RPO, поэтому подъём останавливается, как
+    // только номер стал меньше NA.
+    while (NB > NA)
+        NB = IDom[NB];
+    return NB == NA;
+}
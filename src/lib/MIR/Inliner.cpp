@@ -0,0 +1,189 @@
+#include <algorithm>
+#include "MIR/Passes.h"
+
+namespace {
+
+bool callsItself(const MIRFunction &F) {
+    for (const auto &B : F.Blocks)
+        for (MIRInst *I : B->Insts)
+            if (I->getOpcode() == MIROpcode::Call && I->getCallee() == &F)
+                return true;
+    return false;
+}
+
+bool shouldInline(const MIRFunction &Caller, const MIRFunction &Callee) {
+    return &Callee != &Caller && Callee.getNumInsts() <= InlineThreshold &&
+           !callsItself(Callee);
+}
+
+MIRInst *makeZero(MIRFunction &F, MIRType Ty) {
+    if (Ty == MIRType::Ref || Ty == MIRType::Addr)
+        return F.createInst(MIROpcode::Null, Ty, {});
+    MIROpcode Op = Ty == MIRType::Float ? MIROpcode::FConst
+                   : Ty == MIRType::Bool ? MIROpcode::BConst
+                                         : MIROpcode::IConst;
+    MIRInst *C = F.createInst(Op, Ty, {});
+    if (Ty == MIRType::Float)
+        C->setFloatValue(0.0);
+    else
+        C->setIntValue(0);
+    return C;
+}
+
+// inlineCall - Заменяет Call копией тела вызываемой функции.
+//
+// Блок вызова делится: инструкции после вызова уходят в новый блок Tail,
+// на место вызова встаёт переход во вход копии, а каждый ret копии
+// становится переходом в Tail. alloca копии переносятся во вход
+// вызывающей функции. Результат вызова записывается в Replacement;
+// использования заменяются после всех встраиваний.
+void inlineCall(MIRFunction &Caller, MIRInst *Call, std::vector<MIRInst *> &Replacement) {
+    const MIRFunction &Callee = *Call->getCallee();
+    MIRBlock *B = Call->getParent();
+
+    std::vector<MIRInst *> Args;
+    for (MIRInst *Op : Call->getOperands())
+        Args.push_back(resolveReplacement(Replacement, Op));
+
+    MIRBlock *Tail = Caller.createBlock();
+    auto It = std::find(B->Insts.begin(), B->Insts.end(), Call);
+    Tail->Insts.assign(It + 1, B->Insts.end());
+    B->Insts.erase(It, B->Insts.end());
+    for (MIRInst *I : Tail->Insts)
+        I->setParent(Tail);
+    // Дуги из B теперь выходят из Tail. Если у condbr оба преемника — один
+    // блок, все его дуги из B заменятся при первом же проходе.
+    for (unsigned S = 0; S != Tail->getNumSuccessors(); ++S)
+        for (MIRBlock *&P : Tail->getSuccessor(S)->Preds)
+            if (P == B)
+                P = Tail;
+
+    // Копируем в два шага: сначала инструкции и блоки, затем операнды, —
+    // phi могут ссылаться на значения из блоков, скопированных позже.
+    std::vector<MIRBlock *> BlockMap;
+    for (size_t I = 0; I != Callee.Blocks.size(); ++I)
+        BlockMap.push_back(Caller.createBlock());
+    std::vector<MIRInst *> ValueMap(Callee.getNumValues(), nullptr);
+    std::vector<MIRInst *> Clones;
+    std::vector<std::pair<MIRBlock *, MIRInst *>> Returns;
+
+    for (const auto &CB : Callee.Blocks) {
+        MIRBlock *NB = BlockMap[CB->getID()];
+        for (MIRBlock *P : CB->Preds)
+            NB->Preds.push_back(BlockMap[P->getID()]);
+        for (MIRInst *I : CB->Insts) {
+            if (I->getOpcode() == MIROpcode::Param) {
+                ValueMap[I->getID()] = Args[I->getIntValue()];
+                continue;
+            }
+            if (I->getOpcode() == MIROpcode::Ret) {
+                MIRInst *Br = Caller.createInst(MIROpcode::Br, MIRType::Void, {});
+                Br->setSuccessor(0, Tail);
+                Br->setParent(NB);
+                NB->Insts.push_back(Br);
+                Returns.push_back({NB, I->getNumOperands() ? I->getOperand(0) : nullptr});
+                continue;
+            }
+            MIRInst *Clone = Caller.createInst(I->getOpcode(), I->getType(), I->getOperands());
+            for (unsigned S = 0; S != I->getNumSuccessors(); ++S)
+                Clone->setSuccessor(S, BlockMap[I->getSuccessor(S)->getID()]);
+            if (I->getOpcode() == MIROpcode::Call)
+                Clone->setCallee(I->getCallee());
+            else if (I->getOpcode() == MIROpcode::FConst)
+                Clone->setFloatValue(I->getFloatValue());
+            else if (I->getOpcode() == MIROpcode::AllocRef)
+                Clone->setClass(I->getClass());
+            else if (I->isConstant() || I->getOpcode() == MIROpcode::LoadField ||
+                     I->getOpcode() == MIROpcode::StoreField)
+                Clone->setIntValue(I->getIntValue());
+            if (I->getOpcode() == MIROpcode::Alloca) {
+                MIRBlock *CallerEntry = Caller.getEntryBlock();
+                Clone->setParent(CallerEntry);
+                CallerEntry->Insts.insert(
+                    CallerEntry->Insts.begin() + CallerEntry->getNumPhis(), Clone);
+            } else {
+                Clone->setParent(NB);
+                NB->Insts.push_back(Clone);
+            }
+            ValueMap[I->getID()] = Clone;
+            Clones.push_back(Clone);
+        }
+    }
+    for (MIRInst *Clone : Clones)
+        for (unsigned Op = 0; Op != Clone->getNumOperands(); ++Op)
+            Clone->setOperand(Op, ValueMap[Clone->getOperand(Op)->getID()]);
+
+    MIRBlock *Entry = BlockMap.front();
+    MIRInst *Br = Caller.createInst(MIROpcode::Br, MIRType::Void, {});
+    Br->setSuccessor(0, Entry);
+    Br->setParent(B);
+    B->Insts.push_back(Br);
+    Entry->Preds.push_back(B);
+
+    for (const auto &Ret : Returns)
+        Tail->Preds.push_back(Ret.first);
+
+    Replacement.resize(Caller.getNumValues(), nullptr);
+    if (Call->getType() == MIRType::Void)
+        return;
+    MIRInst *Result;
+    if (Returns.empty()) {
+        // Вызываемая функция не возвращается: Tail недостижим, но значение
+        // вызова должно быть чем-то определено.
+        Result = makeZero(Caller, Call->getType());
+        Result->setParent(Tail);
+        Tail->Insts.insert(Tail->Insts.begin(), Result);
+    } else if (Returns.size() == 1) {
+        Result = ValueMap[Returns.front().second->getID()];
+    } else {
+        std::vector<MIRInst *> Incoming;
+        for (const auto &Ret : Returns)
+            Incoming.push_back(ValueMap[Ret.second->getID()]);
+        Result = Caller.createInst(MIROpcode::Phi, Call->getType(), Incoming);
+        Result->setParent(Tail);
+        Tail->Insts.insert(Tail->Insts.begin(), Result);
+    }
+    Replacement.resize(Caller.getNumValues(), nullptr);
+    Replacement[Call->getID()] = Result;
+}
+
+// postOrder - Функции в порядке, где вызываемые идут раньше вызывающих
+// (кроме рёбер, замыкающих рекурсию).
+void postOrder(MIRFunction *F, std::vector<bool> &Visited, std::vector<MIRFunction *> &Order) {
+    Visited[F->getIndex()] = true;
+    for (const auto &B : F->Blocks)
+        for (MIRInst *I : B->Insts)
+            if (I->getOpcode() == MIROpcode::Call && !Visited[I->getCallee()->getIndex()])
+                postOrder(I->getCallee(), Visited, Order);
+    Order.push_back(F);
+}
+
+} // namespace
+
+unsigned runInliner(MIRModule &M) {
+    std::vector<bool> Visited(M.getFunctions().size(), false);
+    std::vector<MIRFunction *> Order;
+    for (const auto &F : M.getFunctions())
+        if (!Visited[F->getIndex()])
+            postOrder(F.get(), Visited, Order);
+
+    // Снизу вверх: к моменту обработки функции вызываемые ею уже содержат
+    // встроенный код, и встраивается окончательная версия.
+    unsigned NumInlined = 0;
+    std::vector<MIRInst *> Calls, Replacement;
+    for (MIRFunction *F : Order) {
+        Calls.clear();
+        for (const auto &B : F->Blocks)
+            for (MIRInst *I : B->Insts)
+                if (I->getOpcode() == MIROpcode::Call && shouldInline(*F, *I->getCallee()))
+                    Calls.push_back(I);
+        if (Calls.empty())
+            continue;
+        Replacement.assign(F->getNumValues(), nullptr);
+        for (MIRInst *Call : Calls)
+            inlineCall(*F, Call, Replacement);
+        F->replaceAllUses(Replacement);
+        NumInlined += static_cast<unsigned>(Calls.size());
+    }
+    return NumInlined;
+}
@@ -0,0 +1,106 @@
+#include <algorithm>
+#include "MIR/Dominators.h"
+#include "MIR/Passes.h"
+
+namespace {
+
+// canHoist - Инструкцию можно выполнить заранее, даже если тело цикла не
+// выполнится ни разу: у неё нет побочных эффектов и она не может упасть.
+// Чтения памяти не выносятся: анализа записей в цикле нет.
+bool canHoist(const MIRInst *I) {
+    if (accessesMemory(I->getOpcode()))
+        return false;
+    switch (I->getOpcode()) {
+    case MIROpcode::Phi:
+    case MIROpcode::Param:
+    case MIROpcode::Call:
+        return false;
+    case MIROpcode::Div:
+    case MIROpcode::Rem: {
+        const MIRInst *Divisor = I->getOperand(1);
+        return Divisor->getOpcode() == MIROpcode::IConst && Divisor->getIntValue() != 0 &&
+               Divisor->getIntValue() != -1;
+    }
+    default:
+        return !I->isTerminator();
+    }
+}
+
+} // namespace
+
+unsigned runLoopInvariantCodeMotion(MIRFunction &F) {
+    DominatorTree DT(F);
+    const std::vector<MIRBlock *> &RPO = DT.getReversePostOrder();
+
+    // Обратная дуга ведёт в блок, доминирующий над её началом; цель —
+    // заголовок естественного цикла, начало — латч.
+    std::vector<std::vector<MIRBlock *>> Latches(F.Blocks.size());
+    for (MIRBlock *B : RPO)
+        for (unsigned S = 0; S != B->getNumSuccessors(); ++S)
+            if (DT.dominates(B->getSuccessor(S), B))
+                Latches[B->getSuccessor(S)->getID()].push_back(B);
+
+    unsigned NumHoisted = 0;
+    std::vector<bool> InLoop(F.Blocks.size());
+    std::vector<MIRBlock *> Body, Worklist;
+
+    // Вложенный заголовок стоит в RPO позже внешнего: идём с конца, чтобы
+    // вынесенное из внутреннего цикла могло подняться и из внешнего.
+    for (size_t Idx = RPO.size(); Idx-- != 0;) {
+        MIRBlock *Header = RPO[Idx];
+        if (Latches[Header->getID()].empty())
+            continue;
+
+        // Тело — блоки, из которых латч достижим без прохода через заголовок.
+        std::fill(InLoop.begin(), InLoop.end(), false);
+        InLoop[Header->getID()] = true;
+        Body.assign(1, Header);
+        Worklist = Latches[Header->getID()];
+        while (!Worklist.empty()) {
+            MIRBlock *B = Worklist.back();
+            Worklist.pop_back();
+            if (InLoop[B->getID()])
+                continue;
+            InLoop[B->getID()] = true;
+            Body.push_back(B);
+            for (MIRBlock *P : B->Preds)
+                if (DT.isReachable(P))
+                    Worklist.push_back(P);
+        }
+
+        // Предзаголовок — единственный вход в цикл снаружи, ведущий только в
+        // заголовок. MIRGen всегда его создаёт; без него цикл пропускаем.
+        MIRBlock *Preheader = nullptr;
+        unsigned NumOutside = 0;
+        for (MIRBlock *P : Header->Preds)
+            if (!InLoop[P->getID()]) {
+                Preheader = P;
+                ++NumOutside;
+            }
+        if (NumOutside != 1 || Preheader->getNumSuccessors() != 1)
+            continue;
+
+        // В порядке RPO операнд выносится раньше своих пользователей.
+        std::sort(Body.begin(), Body.end(), [&](MIRBlock *A, MIRBlock *B) {
+            return DT.getRPONumber(A) < DT.getRPONumber(B);
+        });
+        for (MIRBlock *B : Body) {
+            for (size_t Pos = 0; Pos != B->Insts.size(); ++Pos) {
+                MIRInst *I = B->Insts[Pos];
+                if (!canHoist(I))
+                    continue;
+                bool Invariant = std::all_of(I->getOperands().begin(), I->getOperands().end(),
+                                             [&](MIRInst *Op) {
+                                                 return !InLoop[Op->getParent()->getID()];
+                                             });
+                if (!Invariant)
+                    continue;
+                B->Insts.erase(B->Insts.begin() + Pos--);
+                Preheader->Insts.insert(Preheader->Insts.end() - 1, I);
+                I->setParent(Preheader);
+                ++NumHoisted;
+            }
+        }
+    }
+    return NumHoisted;
+}
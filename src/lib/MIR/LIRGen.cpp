@@ -0,0 +1,259 @@
+#include <utility>
+#include "MIR/Dominators.h"
+#include "MIR/LIRGen.h"
+
+namespace {
+
+// mapType - Void бывает только типом результата: такая функция в LIR
+// возвращает Int 0.
+bool mapType(MIRType Ty, LIRType &Result) {
+    switch (Ty) {
+    case MIRType::Int:
+    case MIRType::Bool:
+    case MIRType::Void:
+        Result = LIRType::Int;
+        return true;
+    case MIRType::Float:
+        Result = LIRType::Float;
+        return true;
+    default:
+        return false;
+    }
+}
+
+// FunctionLowering - Переводит тело одной функции. Блоки обходятся в
+// обратном post-order, поэтому определение значения (кроме phi) всегда
+// переведено раньше его использований.
+class FunctionLowering {
+    const MIRFunction &MF;
+    LIRFunction &LF;
+    // Functions - Функции LIR по номеру функции MIR.
+    const std::vector<LIRFunction *> &Functions;
+    std::string &Error;
+    LIRBuilder B;
+    DominatorTree DT;
+
+    // Regs - Регистр значения по ID инструкции MIR.
+    std::vector<VReg> Regs;
+    // Blocks - Блок LIR по ID блока MIR.
+    std::vector<BlockID> Blocks;
+
+    bool fail(const std::string &Message) {
+        Error = MF.getName() + ": " + Message;
+        return false;
+    }
+
+    VReg reg(const MIRInst *V) const { return Regs[V->getID()]; }
+    void define(const MIRInst *I, VReg R) { Regs[I->getID()] = R; }
+
+    bool lowerInst(const MIRInst *I);
+
+    // lowerEdge - Блок LIR, в который ведёт дуга Succ блока From, вместе с
+    // копиями в phi преемника.
+    BlockID lowerEdge(const MIRBlock *From, unsigned Succ);
+    void emitPhiCopies(const MIRBlock *From, unsigned Succ);
+
+public:
+    FunctionLowering(const MIRFunction &mf, LIRFunction &lf,
+                     const std::vector<LIRFunction *> &functions, std::string &error)
+        : MF(mf), LF(lf), Functions(functions), Error(error), B(lf), DT(mf),
+          Regs(mf.getNumValues(), NoVReg), Blocks(mf.Blocks.size(), 0) {}
+
+    bool run();
+};
+
+bool FunctionLowering::run() {
+    // Блоки LIR идут в том же обратном post-order: вход остаётся блоком 0,
+    // а преемник чаще всего стоит сразу за блоком.
+    const std::vector<MIRBlock *> &RPO = DT.getReversePostOrder();
+    for (size_t I = 1; I != RPO.size(); ++I)
+        Blocks[RPO[I]->getID()] = B.createBlock();
+
+    // Регистры phi заводятся заранее: в них пишут предшественники, которые
+    // могут стоять раньше блока с phi.
+    for (MIRBlock *Block : RPO) {
+        for (MIRInst *I : Block->Insts) {
+            if (!I->isPhi())
+                break;
+            LIRType Ty;
+            if (!mapType(I->getType(), Ty))
+                return fail(std::string("phi of type '") + getTypeName(I->getType()) +
+                            "' is not supported by LIR");
+            define(I, B.createVar(Ty));
+        }
+    }
+
+    for (MIRBlock *Block : RPO) {
+        B.setInsertPoint(Blocks[Block->getID()]);
+        for (MIRInst *I : Block->Insts)
+            if (!I->isPhi() && !lowerInst(I))
+                return false;
+    }
+    return true;
+}
+
+bool FunctionLowering::lowerInst(const MIRInst *I) {
+    auto operand = [&](unsigned N) { return reg(I->getOperand(N)); };
+
+    switch (I->getOpcode()) {
+    case MIROpcode::Param:
+        define(I, B.getParam(static_cast<unsigned>(I->getIntValue())));
+        return true;
+    case MIROpcode::IConst:
+        define(I, B.iconst(I->getIntValue()));
+        return true;
+    case MIROpcode::BConst:
+        define(I, B.iconst(I->getBoolValue()));
+        return true;
+    case MIROpcode::FConst:
+        define(I, B.fconst(I->getFloatValue()));
+        return true;
+    case MIROpcode::Copy: {
+        VReg Dest = B.createVar(LF.getRegType(operand(0)));
+        B.copy(Dest, operand(0));
+        define(I, Dest);
+        return true;
+    }
+    case MIROpcode::Phi:
+        // Регистр заведён в run(), значения пишут дуги предшественников.
+        return true;
+    case MIROpcode::Neg:
+    case MIROpcode::FNeg:
+        define(I, B.createNeg(operand(0)));
+        return true;
+    case MIROpcode::Not:
+        define(I, B.createXor(operand(0), B.iconst(1)));
+        return true;
+
+    // Арифметика, логика и сравнения MIR называются в LIR так же.
+    #define MIR_INT_BINARY(Id, Name)                                          \
+    case MIROpcode::Id:                                                       \
+        define(I, B.create##Id(operand(0), operand(1)));                      \
+        return true;
+    #define MIR_FLOAT_BINARY(Id, Name) MIR_INT_BINARY(Id, Name)
+    #define MIR_BOOL_BINARY(Id, Name) MIR_INT_BINARY(Id, Name)
+    #define MIR_INT_COMPARE(Id, Name) MIR_INT_BINARY(Id, Name)
+    #define MIR_FLOAT_COMPARE(Id, Name) MIR_INT_BINARY(Id, Name)
+    #include "MIR/MIROps.def"
+
+    case MIROpcode::Call: {
+        std::vector<VReg> Args;
+        for (MIRInst *Arg : I->getOperands())
+            Args.push_back(reg(Arg));
+        define(I, B.createCall(Functions[I->getCallee()->getIndex()], Args));
+        return true;
+    }
+
+    #define MIR_MEMORY_OP(Id, Name) case MIROpcode::Id:
+    #include "MIR/MIROps.def"
+    case MIROpcode::Null:
+        return fail(std::string("'") + getOpcodeName(I->getOpcode()) +
+                    "' is not supported by LIR");
+
+    case MIROpcode::Br:
+        B.createBr(lowerEdge(I->getParent(), 0));
+        return true;
+    case MIROpcode::CondBr: {
+        BlockID Current = B.getInsertBlock();
+        BlockID IfTrue = lowerEdge(I->getParent(), 0);
+        BlockID IfFalse = lowerEdge(I->getParent(), 1);
+        B.setInsertPoint(Current);
+        B.createCondBr(operand(0), IfTrue, IfFalse);
+        return true;
+    }
+    case MIROpcode::Ret:
+        B.createRet(I->getNumOperands() ? operand(0) : B.iconst(0));
+        return true;
+    }
+    return fail("unknown MIR opcode");
+}
+
+BlockID FunctionLowering::lowerEdge(const MIRBlock *From, unsigned Succ) {
+    const MIRBlock *To = From->getSuccessor(Succ);
+    if (!To->getNumPhis())
+        return Blocks[To->getID()];
+    if (From->getNumSuccessors() == 1) {
+        emitPhiCopies(From, Succ);
+        return Blocks[To->getID()];
+    }
+
+    // Дуга condbr: копии в отдельном блоке, чтобы путь во второй преемник
+    // видел прежние значения регистров phi.
+    BlockID Edge = B.createBlock();
+    B.setInsertPoint(Edge);
+    emitPhiCopies(From, Succ);
+    B.createBr(Blocks[To->getID()]);
+    return Edge;
+}
+
+void FunctionLowering::emitPhiCopies(const MIRBlock *From, unsigned Succ) {
+    // Номер дуги в Preds: condbr с обеими дугами в один блок занимает в
+    // Preds два места подряд по порядку преемников.
+    const MIRBlock *To = From->getSuccessor(Succ);
+    unsigned Skip = Succ == 1 && From->getSuccessor(0) == To;
+    unsigned PredIndex = 0;
+    for (;; ++PredIndex) {
+        if (To->Preds[PredIndex] != From)
+            continue;
+        if (!Skip)
+            break;
+        --Skip;
+    }
+
+    std::vector<std::pair<VReg, VReg>> Copies;
+    for (MIRInst *Phi : To->Insts) {
+        if (!Phi->isPhi())
+            break;
+        Copies.emplace_back(reg(Phi), reg(Phi->getOperand(PredIndex)));
+    }
+
+    // Копии на дуге выполняются одновременно. Если phi читает другую phi
+    // того же блока (обмен значений в цикле), источники сначала снимаются
+    // во временные регистры.
+    bool ReadsOtherPhi = false;
+    for (size_t I = 0; I != Copies.size(); ++I)
+        for (size_t J = 0; J != Copies.size(); ++J)
+            ReadsOtherPhi |= I != J && Copies[I].second == Copies[J].first;
+    if (ReadsOtherPhi) {
+        for (auto &Copy : Copies) {
+            VReg Temp = B.createVar(LF.getRegType(Copy.second));
+            B.copy(Temp, Copy.second);
+            Copy.second = Temp;
+        }
+    }
+    for (const auto &Copy : Copies)
+        if (Copy.first != Copy.second)
+            B.copy(Copy.first, Copy.second);
+}
+
+} // namespace
+
+bool lowerToLIR(const MIRModule &M, LIRModule &Out, std::string &Error) {
+    // Сначала объявляем все функции, чтобы вызовы могли ссылаться на
+    // функции ниже по списку.
+    std::vector<LIRFunction *> Functions;
+    for (const auto &F : M.getFunctions()) {
+        std::vector<LIRType> ParamTypes;
+        for (MIRType Ty : F->getParamTypes()) {
+            LIRType ParamType;
+            if (Ty == MIRType::Void || !mapType(Ty, ParamType)) {
+                Error = F->getName() + ": parameter of type '" + getTypeName(Ty) +
+                        "' is not supported by LIR";
+                return false;
+            }
+            ParamTypes.push_back(ParamType);
+        }
+        LIRType ReturnType;
+        if (!mapType(F->getReturnType(), ReturnType)) {
+            Error = F->getName() + ": return type '" + getTypeName(F->getReturnType()) +
+                    "' is not supported by LIR";
+            return false;
+        }
+        Functions.push_back(Out.createFunction(F->getName(), ParamTypes, ReturnType));
+    }
+
+    for (const auto &F : M.getFunctions())
+        if (!FunctionLowering(*F, *Functions[F->getIndex()], Functions, Error).run())
+            return false;
+    return Out.verify(Error);
+}
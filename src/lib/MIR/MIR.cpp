@@ -0,0 +1,401 @@
+#include <algorithm>
+#include <cassert>
+#include <ostream>
+#include "MIR/MIR.h"
+#include "Runtime/HeapObject.h"
+
+const char *getOpcodeName(MIROpcode Op) {
+    switch (Op) {
+      #define MIR_OP(Id, Name) case MIROpcode::Id: return Name;
+      #include "MIR/MIROps.def"
+    }
+    return "<invalid>";
+}
+
+bool isTerminator(MIROpcode Op) {
+    switch (Op) {
+      #define MIR_TERMINATOR(Id, Name) case MIROpcode::Id: return true;
+      #include "MIR/MIROps.def"
+    default:
+        return false;
+    }
+}
+
+bool hasSideEffects(MIROpcode Op) {
+    switch (Op) {
+    case MIROpcode::Call:
+    case MIROpcode::Retain:
+    case MIROpcode::Release:
+    case MIROpcode::StoreField:
+    case MIROpcode::Store:
+        return true;
+    default:
+        return isTerminator(Op);
+    }
+}
+
+bool accessesMemory(MIROpcode Op) {
+    switch (Op) {
+      #define MIR_MEMORY_OP(Id, Name) case MIROpcode::Id: return true;
+      #include "MIR/MIROps.def"
+    default:
+        return false;
+    }
+}
+
+const char *getTypeName(MIRType Type) {
+    switch (Type) {
+    case MIRType::Void: return "void";
+    case MIRType::Int: return "int";
+    case MIRType::Float: return "float";
+    case MIRType::Bool: return "bool";
+    case MIRType::Ref: return "ref";
+    case MIRType::Addr: return "addr";
+    }
+    return "<invalid>";
+}
+
+//===----------------------------------------------------------------------===//
+// MIRBlock
+//===----------------------------------------------------------------------===//
+
+unsigned MIRBlock::getNumPhis() const {
+    unsigned N = 0;
+    while (N != Insts.size() && Insts[N]->isPhi())
+        ++N;
+    return N;
+}
+
+unsigned MIRBlock::getPredIndex(const MIRBlock *Pred) const {
+    for (unsigned I = 0; I != Preds.size(); ++I)
+        if (Preds[I] == Pred)
+            return I;
+    return ~0u;
+}
+
+void MIRBlock::removePredecessor(unsigned Index) {
+    assert(Index < Preds.size() && "Invalid predecessor index!");
+    Preds.erase(Preds.begin() + Index);
+    for (unsigned I = 0, E = getNumPhis(); I != E; ++I) {
+        MIRInst *Phi = Insts[I];
+        for (unsigned Op = Index; Op + 1 < Phi->getNumOperands(); ++Op)
+            Phi->setOperand(Op, Phi->getOperand(Op + 1));
+        // Массив операндов в арене не сжимается, уменьшаем только счётчик.
+        Phi->NumOperands--;
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// MIRFunction
+//===----------------------------------------------------------------------===//
+
+MIRBlock *MIRFunction::createBlock() {
+    Blocks.push_back(std::unique_ptr<MIRBlock>(new MIRBlock(static_cast<uint32_t>(Blocks.size()))));
+    return Blocks.back().get();
+}
+
+MIRInst *MIRFunction::createInst(MIROpcode Op, MIRType Ty, ArrayRef<MIRInst *> Operands) {
+    MIRInst **Storage = nullptr;
+    if (!Operands.empty()) {
+        Storage = Arena.allocate<MIRInst *>(Operands.size());
+        std::copy(Operands.begin(), Operands.end(), Storage);
+    }
+    void *Mem = Arena.allocate(sizeof(MIRInst), alignof(MIRInst));
+    return new (Mem) MIRInst(Op, Ty, NumValues++, Storage,
+                             static_cast<unsigned>(Operands.size()));
+}
+
+void MIRFunction::setOperands(MIRInst *I, ArrayRef<MIRInst *> Operands) {
+    if (Operands.size() > I->NumOperands)
+        I->Operands = Arena.allocate<MIRInst *>(Operands.size());
+    std::copy(Operands.begin(), Operands.end(), I->Operands);
+    I->NumOperands = static_cast<uint16_t>(Operands.size());
+}
+
+unsigned MIRFunction::getNumInsts() const {
+    unsigned N = 0;
+    for (const auto &B : Blocks)
+        N += static_cast<unsigned>(B->Insts.size());
+    return N;
+}
+
+MIRInst *resolveReplacement(std::vector<MIRInst *> &Replacement, MIRInst *V) {
+    MIRInst *Result = V;
+    while (Replacement[Result->getID()])
+        Result = Replacement[Result->getID()];
+    // Сжимаем путь, чтобы повторные запросы были O(1).
+    while (V != Result) {
+        MIRInst *Next = Replacement[V->getID()];
+        Replacement[V->getID()] = Result;
+        V = Next;
+    }
+    return Result;
+}
+
+void MIRFunction::replaceAllUses(std::vector<MIRInst *> &Replacement) {
+    for (const auto &B : Blocks)
+        for (MIRInst *I : B->Insts)
+            for (unsigned Op = 0; Op != I->getNumOperands(); ++Op)
+                if (Replacement[I->getOperand(Op)->getID()])
+                    I->setOperand(Op, resolveReplacement(Replacement, I->getOperand(Op)));
+}
+
+void MIRFunction::eraseBlocks(const std::vector<bool> &Dead) {
+    for (const auto &B : Blocks) {
+        if (Dead[B->getID()])
+            continue;
+        for (unsigned I = static_cast<unsigned>(B->Preds.size()); I-- != 0;)
+            if (Dead[B->Preds[I]->getID()])
+                B->removePredecessor(I);
+    }
+    Blocks.erase(std::remove_if(Blocks.begin(), Blocks.end(),
+                                [&](const std::unique_ptr<MIRBlock> &B) {
+                                    return Dead[B->getID()];
+                                }),
+                 Blocks.end());
+    for (size_t I = 0; I != Blocks.size(); ++I)
+        Blocks[I]->ID = static_cast<uint32_t>(I);
+}
+
+//===----------------------------------------------------------------------===//
+// MIRModule
+//===----------------------------------------------------------------------===//
+
+MIRFunction *MIRModule::createFunction(std::string Name, ArrayRef<MIRType> ParamTypes,
+                                       MIRType ReturnType) {
+    unsigned Index = static_cast<unsigned>(Functions.size());
+    Functions.push_back(std::make_unique<MIRFunction>(std::move(Name), ParamTypes.vec(),
+                                                      ReturnType, Index));
+    MIRFunction *F = Functions.back().get();
+    F->createBlock();
+    return F;
+}
+
+MIRFunction *MIRModule::getFunction(std::string_view Name) const {
+    for (const auto &F : Functions)
+        if (F->getName() == Name)
+            return F.get();
+    return nullptr;
+}
+
+unsigned MIRModule::getNumInsts() const {
+    unsigned N = 0;
+    for (const auto &F : Functions)
+        N += F->getNumInsts();
+    return N;
+}
+
+bool MIRModule::verify(std::string &Error) const {
+    for (const auto &F : Functions)
+        if (!verifyFunction(*F, Error))
+            return false;
+    return true;
+}
+
+void MIRModule::print(std::ostream &OS) const {
+    for (size_t I = 0; I != Functions.size(); ++I) {
+        if (I)
+            OS << '\n';
+        Functions[I]->print(OS);
+    }
+}
+
+//===----------------------------------------------------------------------===//
+// Печать
+//===----------------------------------------------------------------------===//
+
+void MIRFunction::print(std::ostream &OS) const {
+    // Значения нумеруются заново в порядке печати, чтобы дамп не зависел от
+    // того, сколько инструкций создали и удалили проходы.
+    std::vector<unsigned> Numbers(NumValues, ~0u);
+    unsigned Next = 0;
+    for (const auto &B : Blocks)
+        for (MIRInst *I : B->Insts)
+            if (I->getType() != MIRType::Void)
+                Numbers[I->getID()] = Next++;
+
+    auto printValue = [&](MIRInst *V) {
+        if (Numbers[V->getID()] == ~0u)
+            OS << "%<deleted>";
+        else
+            OS << '%' << Numbers[V->getID()];
+    };
+
+    OS << "func @" << Name << "(";
+    for (size_t I = 0; I != ParamTypes.size(); ++I)
+        OS << (I ? ", " : "") << getTypeName(ParamTypes[I]);
+    OS << ") -> " << getTypeName(ReturnType) << " {\n";
+
+    for (const auto &B : Blocks) {
+        OS << "bb" << B->getID() << ':';
+        if (!B->Preds.empty()) {
+            OS << "  ; preds:";
+            for (MIRBlock *Pred : B->Preds)
+                OS << " bb" << Pred->getID();
+        }
+        OS << '\n';
+
+        for (MIRInst *I : B->Insts) {
+            OS << "  ";
+            if (I->getType() != MIRType::Void) {
+                printValue(I);
+                OS << " = ";
+            }
+            OS << getOpcodeName(I->getOpcode());
+            switch (I->getOpcode()) {
+            case MIROpcode::Param:
+            case MIROpcode::IConst:
+                OS << ' ' << I->getIntValue();
+                break;
+            case MIROpcode::FConst:
+                OS << ' ' << I->getFloatValue();
+                break;
+            case MIROpcode::BConst:
+                OS << (I->getBoolValue() ? " true" : " false");
+                break;
+            case MIROpcode::Phi:
+                for (unsigned Op = 0; Op != I->getNumOperands(); ++Op) {
+                    OS << (Op ? ", [" : " [");
+                    printValue(I->getOperand(Op));
+                    if (Op < B->Preds.size())
+                        OS << ", bb" << B->Preds[Op]->getID();
+                    OS << ']';
+                }
+                break;
+            case MIROpcode::AllocRef:
+                OS << " @" << I->getClass()->Name;
+                break;
+            case MIROpcode::LoadField:
+            case MIROpcode::StoreField:
+                for (unsigned Op = 0; Op != I->getNumOperands(); ++Op) {
+                    OS << (Op ? ", " : " ");
+                    printValue(I->getOperand(Op));
+                    if (Op == 0)
+                        OS << " + " << I->getIntValue();
+                }
+                break;
+            case MIROpcode::Call:
+                OS << " @" << I->getCallee()->getName() << '(';
+                for (unsigned Op = 0; Op != I->getNumOperands(); ++Op) {
+                    if (Op)
+                        OS << ", ";
+                    printValue(I->getOperand(Op));
+                }
+                OS << ')';
+                break;
+            default:
+                for (unsigned Op = 0; Op != I->getNumOperands(); ++Op) {
+                    OS << (Op ? ", " : " ");
+                    printValue(I->getOperand(Op));
+                }
+                for (unsigned S = 0; S != I->getNumSuccessors(); ++S)
+                    OS << (S || I->getNumOperands() ? ", bb" : " bb")
+                       << I->getSuccessor(S)->getID();
+                break;
+            }
+            if (I->getType() != MIRType::Void && !I->isConstant() && !I->isTerminator())
+                OS << " : " << getTypeName(I->getType());
+            OS << '\n';
+        }
+    }
+    OS << "}\n";
+}
+
+//===----------------------------------------------------------------------===//
+// MIRBuilder
+//===----------------------------------------------------------------------===//
+
+MIRInst *MIRBuilder::append(MIROpcode Op, MIRType Ty, ArrayRef<MIRInst *> Operands) {
+    assert(Current && !isTerminated() && "Appending to a terminated block!");
+    MIRInst *I = F.createInst(Op, Ty, Operands);
+    I->setParent(Current);
+    Current->Insts.push_back(I);
+    return I;
+}
+
+MIRInst *MIRBuilder::createParam(unsigned Index) {
+    MIRInst *I = append(MIROpcode::Param, F.getParamTypes()[Index], {});
+    I->setIntValue(Index);
+    return I;
+}
+
+MIRInst *MIRBuilder::iconst(int64_t Value) {
+    MIRInst *I = append(MIROpcode::IConst, MIRType::Int, {});
+    I->setIntValue(Value);
+    return I;
+}
+
+MIRInst *MIRBuilder::fconst(double Value) {
+    MIRInst *I = append(MIROpcode::FConst, MIRType::Float, {});
+    I->setFloatValue(Value);
+    return I;
+}
+
+MIRInst *MIRBuilder::bconst(bool Value) {
+    MIRInst *I = append(MIROpcode::BConst, MIRType::Bool, {});
+    I->setIntValue(Value);
+    return I;
+}
+
+MIRInst *MIRBuilder::createCopy(MIRInst *V) {
+    return append(MIROpcode::Copy, V->getType(), {V});
+}
+
+MIRInst *MIRBuilder::createPhi(MIRType Ty, MIRBlock *B) {
+    MIRInst *Phi = F.createInst(MIROpcode::Phi, Ty, {});
+    Phi->setParent(B);
+    B->Insts.insert(B->Insts.begin() + B->getNumPhis(), Phi);
+    return Phi;
+}
+
+MIRInst *MIRBuilder::createAlloca() {
+    MIRBlock *Entry = F.getEntryBlock();
+    MIRInst *Slot = F.createInst(MIROpcode::Alloca, MIRType::Addr, {});
+    Slot->setParent(Entry);
+    Entry->Insts.insert(Entry->Insts.begin() + Entry->getNumPhis(), Slot);
+    return Slot;
+}
+
+MIRInst *MIRBuilder::createCall(MIRFunction *Callee, ArrayRef<MIRInst *> Args) {
+    MIRInst *I = append(MIROpcode::Call, Callee->getReturnType(), Args);
+    I->setCallee(Callee);
+    return I;
+}
+
+MIRInst *MIRBuilder::createAllocRef(const ClassMetadata *Class) {
+    MIRInst *I = append(MIROpcode::AllocRef, MIRType::Ref, {});
+    I->setClass(Class);
+    return I;
+}
+
+MIRInst *MIRBuilder::createLoadField(MIRType Ty, MIRInst *Object, uint32_t Offset) {
+    MIRInst *I = append(MIROpcode::LoadField, Ty, {Object});
+    I->setIntValue(Offset);
+    return I;
+}
+
+void MIRBuilder::createStoreField(MIRInst *Object, uint32_t Offset, MIRInst *Value) {
+    MIRInst *I = append(MIROpcode::StoreField, MIRType::Void, {Object, Value});
+    I->setIntValue(Offset);
+}
+
+void MIRBuilder::createBr(MIRBlock *Target) {
+    MIRInst *I = append(MIROpcode::Br, MIRType::Void, {});
+    I->setSuccessor(0, Target);
+    Target->Preds.push_back(Current);
+}
+
+void MIRBuilder::createCondBr(MIRInst *Cond, MIRBlock *IfTrue, MIRBlock *IfFalse) {
+    MIRInst *I = append(MIROpcode::CondBr, MIRType::Void, {Cond});
+    I->setSuccessor(0, IfTrue);
+    I->setSuccessor(1, IfFalse);
+    IfTrue->Preds.push_back(Current);
+    IfFalse->Preds.push_back(Current);
+}
+
+void MIRBuilder::createRet(MIRInst *Value) {
+    if (Value)
+        append(MIROpcode::Ret, MIRType::Void, {Value});
+    else
+        append(MIROpcode::Ret, MIRType::Void, {});
+}
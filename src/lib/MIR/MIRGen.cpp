@@ -0,0 +1,666 @@
+#include <algorithm>
+#include <unordered_map>
+#include <utility>
+#include "AST/ASTVisitor.h"
+#include "AST/Types.h"
+#include "MIR/MIRGen.h"
+
+namespace {
+
+bool mapType(TypeBase *T, MIRType &Result) {
+    if (!T)
+        return false;
+    switch (T->getKind()) {
+    case TypeKind::Int:
+        Result = MIRType::Int;
+        return true;
+    case TypeKind::Double:
+        Result = MIRType::Float;
+        return true;
+    case TypeKind::Bool:
+        Result = MIRType::Bool;
+        return true;
+    case TypeKind::Tuple:
+        Result = MIRType::Void;
+        return static_cast<TupleType *>(T)->isVoid();
+    default:
+        return false;
+    }
+}
+
+// LoweredFunction - Объявление функции, видимое в местах вызова.
+struct LoweredFunction {
+    MIRFunction *F;
+    // InOutTypes - Тип значения за адресом для inout-параметров, Void для
+    // остальных.
+    std::vector<MIRType> InOutTypes;
+};
+
+// FunctionLowering - Строит тело одной функции.
+//
+// visit() возвращает значение выражения; у операторов и выражений без
+// значения — nullptr. Ошибка запоминается в Failed, и обход сворачивается.
+//
+// inout-параметр приходит адресом (addr): чтение — load, присваивание —
+// store. Локальная переменная, переданная как &x, на время вызова
+// кладётся в свой alloca (один на переменную, во входном блоке) и
+// перечитывается после него; inout-параметр передаётся дальше тем же
+// адресом.
+class FunctionLowering : public ASTVisitor<FunctionLowering, MIRInst *> {
+    const std::unordered_map<Identifier, LoweredFunction> &Functions;
+    MIRFunction &F;
+    MIRBuilder B;
+    std::string &Error;
+    bool Failed = false;
+
+    // Состояние построения SSA, по ID блока.
+    std::vector<std::unordered_map<const ValueDecl *, MIRInst *>> CurrentDef;
+    std::vector<bool> Sealed;
+    std::vector<std::vector<std::pair<const ValueDecl *, MIRInst *>>> IncompletePhis;
+    std::unordered_map<const ValueDecl *, MIRType> VarTypes;
+    // InOutAddrs - Адреса inout-параметров; их значения не в SSA.
+    std::unordered_map<const ValueDecl *, MIRInst *> InOutAddrs;
+    // SpillSlots - alloca локальной переменной, уже передававшейся как &x.
+    std::unordered_map<const ValueDecl *, MIRInst *> SpillSlots;
+
+    // Scopes - Видимые локальные имена; ScopeStarts — начало каждой области.
+    std::vector<std::pair<Identifier, const ValueDecl *>> Scopes;
+    std::vector<size_t> ScopeStarts;
+
+    struct LoopTargets {
+        MIRBlock *Continue;
+        MIRBlock *Break;
+    };
+    std::vector<LoopTargets> Loops;
+
+public:
+    FunctionLowering(const std::unordered_map<Identifier, LoweredFunction> &functions,
+                     MIRFunction &f, std::string &error)
+        : Functions(functions), F(f), B(f), Error(error) {}
+
+    bool run(FuncDecl *D);
+
+    MIRInst *visitNode(Node *N) {
+        return fail(std::string(Node::getKindName(N->getKind())) +
+                    " is not supported by MIR lowering");
+    }
+
+    MIRInst *visitVarDecl(VarDecl *D);
+    MIRInst *visitBraceStmt(BraceStmt *S);
+    MIRInst *visitReturnStmt(ReturnStmt *S);
+    MIRInst *visitIfStmt(IfStmt *S);
+    MIRInst *visitWhileStmt(WhileStmt *S);
+    MIRInst *visitBreakStmt(BreakStmt *S);
+    MIRInst *visitContinueStmt(ContinueStmt *S);
+
+    MIRInst *visitIntegerLiteralExpr(IntegerLiteralExpr *E) { return B.iconst(E->getValue()); }
+    MIRInst *visitFloatLiteralExpr(FloatLiteralExpr *E) { return B.fconst(E->getValue()); }
+    MIRInst *visitBooleanLiteralExpr(BooleanLiteralExpr *E) { return B.bconst(E->getValue()); }
+    MIRInst *visitDeclRefExpr(DeclRefExpr *E);
+    MIRInst *visitUnaryExpr(UnaryExpr *E);
+    MIRInst *visitBinaryExpr(BinaryExpr *E);
+    MIRInst *visitAssignExpr(AssignExpr *E);
+    MIRInst *visitCallExpr(CallExpr *E);
+    MIRInst *visitTupleExpr(TupleExpr *E);
+
+private:
+    MIRInst *fail(const std::string &Message) {
+        if (!Failed)
+            Error = F.getName() + ": " + Message;
+        Failed = true;
+        return nullptr;
+    }
+
+    // lowerValue - Выражение, у которого обязано быть значение.
+    MIRInst *lowerValue(Expr *E) {
+        MIRInst *V = visit(E);
+        if (!Failed && (!V || V->getType() == MIRType::Void))
+            return fail(std::string(Node::getKindName(E->getKind())) + " has no value");
+        return V;
+    }
+
+    MIRBlock *createBlock() {
+        MIRBlock *Block = B.createBlock();
+        growBlockState();
+        return Block;
+    }
+    void growBlockState() {
+        CurrentDef.resize(F.Blocks.size());
+        Sealed.resize(F.Blocks.size(), false);
+        IncompletePhis.resize(F.Blocks.size());
+    }
+
+    // ensureInsertable - После return/break/continue код до конца области
+    // недостижим; он попадает в новый блок без предшественников.
+    void ensureInsertable() {
+        if (!B.isTerminated())
+            return;
+        MIRBlock *Dead = createBlock();
+        seal(Dead);
+        B.setInsertPoint(Dead);
+    }
+
+    void pushScope() { ScopeStarts.push_back(Scopes.size()); }
+    void popScope() {
+        Scopes.resize(ScopeStarts.back());
+        ScopeStarts.pop_back();
+    }
+    const ValueDecl *lookup(Identifier Name) const {
+        for (size_t I = Scopes.size(); I-- != 0;)
+            if (Scopes[I].first == Name)
+                return Scopes[I].second;
+        return nullptr;
+    }
+
+    MIRInst *zeroValue(MIRType Ty, MIRBlock *Block);
+
+    void writeVariable(const ValueDecl *Var, MIRBlock *Block, MIRInst *Value) {
+        CurrentDef[Block->getID()][Var] = Value;
+    }
+    MIRInst *readVariable(const ValueDecl *Var, MIRBlock *Block);
+    MIRInst *readVariableRecursive(const ValueDecl *Var, MIRBlock *Block);
+    void addPhiOperands(const ValueDecl *Var, MIRInst *Phi);
+    void seal(MIRBlock *Block);
+
+    MIRInst *lowerShortCircuit(BinaryExpr *E, bool IsAnd);
+    const ValueDecl *lookupRef(DeclRefExpr *E) const {
+        return E->getDecl() ? E->getDecl() : lookup(E->getName());
+    }
+};
+
+MIRInst *FunctionLowering::zeroValue(MIRType Ty, MIRBlock *Block) {
+    MIRInst *Zero;
+    if (Ty == MIRType::Float) {
+        Zero = F.createInst(MIROpcode::FConst, Ty, {});
+        Zero->setFloatValue(0);
+    } else {
+        Zero = F.createInst(Ty == MIRType::Bool ? MIROpcode::BConst : MIROpcode::IConst, Ty, {});
+        Zero->setIntValue(0);
+    }
+    Zero->setParent(Block);
+    Block->Insts.insert(Block->Insts.begin() + Block->getNumPhis(), Zero);
+    return Zero;
+}
+
+MIRInst *FunctionLowering::readVariable(const ValueDecl *Var, MIRBlock *Block) {
+    auto &Defs = CurrentDef[Block->getID()];
+    auto It = Defs.find(Var);
+    if (It != Defs.end())
+        return It->second;
+    return readVariableRecursive(Var, Block);
+}
+
+MIRInst *FunctionLowering::readVariableRecursive(const ValueDecl *Var, MIRBlock *Block) {
+    MIRType Ty = VarTypes.at(Var);
+    MIRInst *Value;
+    if (!Sealed[Block->getID()]) {
+        // Не все предшественники известны: операнды добавит seal().
+        Value = B.createPhi(Ty, Block);
+        IncompletePhis[Block->getID()].push_back({Var, Value});
+    } else if (Block->Preds.empty()) {
+        // Только в недостижимом коде: обычное чтение всегда видит
+        // определение из объявления.
+        Value = zeroValue(Ty, Block);
+    } else if (Block->Preds.size() == 1) {
+        Value = readVariable(Var, Block->Preds[0]);
+    } else {
+        // Phi записывается до чтения операндов, чтобы разорвать циклы.
+        Value = B.createPhi(Ty, Block);
+        writeVariable(Var, Block, Value);
+        addPhiOperands(Var, Value);
+    }
+    writeVariable(Var, Block, Value);
+    return Value;
+}
+
+void FunctionLowering::addPhiOperands(const ValueDecl *Var, MIRInst *Phi) {
+    MIRBlock *Block = Phi->getParent();
+    std::vector<MIRInst *> Operands;
+    for (MIRBlock *Pred : Block->Preds)
+        Operands.push_back(readVariable(Var, Pred));
+    F.setOperands(Phi, Operands);
+}
+
+void FunctionLowering::seal(MIRBlock *Block) {
+    // addPhiOperands может создать новые неполные phi только в других,
+    // ещё не запечатанных блоках, поэтому список копируется.
+    auto Pending = std::move(IncompletePhis[Block->getID()]);
+    IncompletePhis[Block->getID()].clear();
+    Sealed[Block->getID()] = true;
+    for (auto &[Var, Phi] : Pending)
+        addPhiOperands(Var, Phi);
+}
+
+bool FunctionLowering::run(FuncDecl *D) {
+    growBlockState();
+    seal(F.getEntryBlock());
+    B.setInsertPoint(F.getEntryBlock());
+
+    pushScope();
+    ArrayRef<ParamDecl *> Params = D->getParams();
+    const std::vector<MIRType> &InOutTypes = Functions.at(D->getName()).InOutTypes;
+    for (unsigned I = 0; I != Params.size(); ++I) {
+        if (InOutTypes[I] != MIRType::Void) {
+            VarTypes[Params[I]] = InOutTypes[I];
+            InOutAddrs[Params[I]] = B.createParam(I);
+        } else {
+            VarTypes[Params[I]] = F.getParamTypes()[I];
+            writeVariable(Params[I], F.getEntryBlock(), B.createParam(I));
+        }
+        Scopes.push_back({Params[I]->getName(), Params[I]});
+    }
+
+    if (D->getBody())
+        visit(D->getBody());
+    popScope();
+    if (Failed)
+        return false;
+
+    if (!B.isTerminated()) {
+        MIRBlock *Last = B.getInsertBlock();
+        if (F.getReturnType() == MIRType::Void)
+            B.createRet(nullptr);
+        else if (Last->Preds.empty() && Last != F.getEntryBlock())
+            B.createRet(zeroValue(F.getReturnType(), Last));
+        else {
+            fail("missing return");
+            return false;
+        }
+    }
+    return true;
+}
+
+MIRInst *FunctionLowering::visitVarDecl(VarDecl *D) {
+    MIRType Ty;
+    bool HasType = D->getType() != nullptr;
+    if (HasType && !mapType(D->getType(), Ty))
+        return fail("variable '" + std::string(D->getName().str()) + "' has unsupported type");
+
+    MIRInst *Value;
+    if (D->getInit()) {
+        MIRInst *Init = lowerValue(D->getInit());
+        if (Failed)
+            return nullptr;
+        if (HasType && Init->getType() != Ty)
+            return fail("initializer of '" + std::string(D->getName().str()) +
+                        "' has a wrong type");
+        Ty = Init->getType();
+        // Привязка имени — копия; её убирает copyprop.
+        Value = B.createCopy(Init);
+    } else {
+        if (!HasType)
+            return fail("variable '" + std::string(D->getName().str()) + "' has no type");
+        Value = zeroValue(Ty, B.getInsertBlock());
+    }
+
+    VarTypes[D] = Ty;
+    writeVariable(D, B.getInsertBlock(), Value);
+    Scopes.push_back({D->getName(), D});
+    return nullptr;
+}
+
+MIRInst *FunctionLowering::visitBraceStmt(BraceStmt *S) {
+    pushScope();
+    for (Node *Element : S->getElements()) {
+        ensureInsertable();
+        visit(Element);
+        if (Failed)
+            break;
+    }
+    popScope();
+    return nullptr;
+}
+
+MIRInst *FunctionLowering::visitReturnStmt(ReturnStmt *S) {
+    if (!S->hasResult()) {
+        if (F.getReturnType() != MIRType::Void)
+            return fail("missing return value");
+        B.createRet(nullptr);
+        return nullptr;
+    }
+    MIRInst *Result = lowerValue(S->getResult());
+    if (Failed)
+        return nullptr;
+    if (Result->getType() != F.getReturnType())
+        return fail("return value has a wrong type");
+    B.createRet(Result);
+    return nullptr;
+}
+
+MIRInst *FunctionLowering::visitIfStmt(IfStmt *S) {
+    MIRInst *Cond = lowerValue(S->getCond());
+    if (Failed)
+        return nullptr;
+    if (Cond->getType() != MIRType::Bool)
+        return fail("condition is not Bool");
+
+    MIRBlock *Then = createBlock();
+    MIRBlock *Merge = createBlock();
+    MIRBlock *Else = S->getElse() ? createBlock() : Merge;
+    B.createCondBr(Cond, Then, Else);
+    seal(Then);
+
+    B.setInsertPoint(Then);
+    visit(S->getThen());
+    if (Failed)
+        return nullptr;
+    if (!B.isTerminated())
+        B.createBr(Merge);
+
+    if (S->getElse()) {
+        seal(Else);
+        B.setInsertPoint(Else);
+        visit(S->getElse());
+        if (Failed)
+            return nullptr;
+        if (!B.isTerminated())
+            B.createBr(Merge);
+    }
+
+    seal(Merge);
+    B.setInsertPoint(Merge);
+    return nullptr;
+}
+
+MIRInst *FunctionLowering::visitWhileStmt(WhileStmt *S) {
+    // Отдельный заголовок: блок перед ним заканчивается br только на
+    // заголовок и служит LICM предзаголовком.
+    MIRBlock *Header = createBlock();
+    B.createBr(Header);
+    B.setInsertPoint(Header);
+
+    MIRInst *Cond = lowerValue(S->getCond());
+    if (Failed)
+        return nullptr;
+    if (Cond->getType() != MIRType::Bool)
+        return fail("condition is not Bool");
+
+    MIRBlock *Body = createBlock();
+    MIRBlock *Exit = createBlock();
+    B.createCondBr(Cond, Body, Exit);
+    seal(Body);
+
+    Loops.push_back({Header, Exit});
+    B.setInsertPoint(Body);
+    visit(S->getBody());
+    Loops.pop_back();
+    if (Failed)
+        return nullptr;
+    if (!B.isTerminated())
+        B.createBr(Header);
+
+    seal(Header);
+    seal(Exit);
+    B.setInsertPoint(Exit);
+    return nullptr;
+}
+
+MIRInst *FunctionLowering::visitBreakStmt(BreakStmt *) {
+    if (Loops.empty())
+        return fail("'break' outside of a loop");
+    B.createBr(Loops.back().Break);
+    return nullptr;
+}
+
+MIRInst *FunctionLowering::visitContinueStmt(ContinueStmt *) {
+    if (Loops.empty())
+        return fail("'continue' outside of a loop");
+    B.createBr(Loops.back().Continue);
+    return nullptr;
+}
+
+MIRInst *FunctionLowering::visitDeclRefExpr(DeclRefExpr *E) {
+    const ValueDecl *D = lookupRef(E);
+    if (!D || !VarTypes.count(D))
+        return fail("use of unknown variable '" + std::string(E->getName().str()) + "'");
+    auto Addr = InOutAddrs.find(D);
+    if (Addr != InOutAddrs.end())
+        return B.createLoad(VarTypes[D], Addr->second);
+    return readVariable(D, B.getInsertBlock());
+}
+
+MIRInst *FunctionLowering::visitUnaryExpr(UnaryExpr *E) {
+    MIRInst *Operand = lowerValue(E->getOperand());
+    if (Failed)
+        return nullptr;
+    std::string_view Op = E->getOperator().str();
+    MIRType Ty = Operand->getType();
+    if (Op == "+" && (Ty == MIRType::Int || Ty == MIRType::Float))
+        return Operand;
+    if (Op == "-" && Ty == MIRType::Int)
+        return B.createNeg(Operand);
+    if (Op == "-" && Ty == MIRType::Float)
+        return B.createFNeg(Operand);
+    if (Op == "!" && Ty == MIRType::Bool)
+        return B.createNot(Operand);
+    return fail("invalid operand of unary '" + std::string(Op) + "'");
+}
+
+MIRInst *FunctionLowering::lowerShortCircuit(BinaryExpr *E, bool IsAnd) {
+    MIRInst *LHS = lowerValue(E->getLHS());
+    if (Failed)
+        return nullptr;
+    if (LHS->getType() != MIRType::Bool)
+        return fail("operand of '" + std::string(E->getOperator().str()) + "' is not Bool");
+
+    // a && b: если a ложно, результат false без вычисления b; a || b — true.
+    MIRInst *Short = B.bconst(!IsAnd);
+    MIRBlock *LHSEnd = B.getInsertBlock();
+    MIRBlock *RHSBlock = createBlock();
+    MIRBlock *Merge = createBlock();
+    if (IsAnd)
+        B.createCondBr(LHS, RHSBlock, Merge);
+    else
+        B.createCondBr(LHS, Merge, RHSBlock);
+    seal(RHSBlock);
+
+    B.setInsertPoint(RHSBlock);
+    MIRInst *RHS = lowerValue(E->getRHS());
+    if (Failed)
+        return nullptr;
+    if (RHS->getType() != MIRType::Bool)
+        return fail("operand of '" + std::string(E->getOperator().str()) + "' is not Bool");
+    B.createBr(Merge);
+    seal(Merge);
+
+    B.setInsertPoint(Merge);
+    MIRInst *Phi = B.createPhi(MIRType::Bool, Merge);
+    std::vector<MIRInst *> Operands;
+    for (MIRBlock *Pred : Merge->Preds)
+        Operands.push_back(Pred == LHSEnd ? Short : RHS);
+    F.setOperands(Phi, Operands);
+    return Phi;
+}
+
+MIRInst *FunctionLowering::visitBinaryExpr(BinaryExpr *E) {
+    std::string_view Op = E->getOperator().str();
+    if (Op == "&&" || Op == "||")
+        return lowerShortCircuit(E, Op == "&&");
+
+    MIRInst *LHS = lowerValue(E->getLHS());
+    MIRInst *RHS = Failed ? nullptr : lowerValue(E->getRHS());
+    if (Failed)
+        return nullptr;
+    MIRType Ty = LHS->getType();
+    if (Ty != RHS->getType())
+        return fail("operands of '" + std::string(Op) + "' have different types");
+
+    if (Ty == MIRType::Int) {
+        if (Op == "+") return B.createAdd(LHS, RHS);
+        if (Op == "-") return B.createSub(LHS, RHS);
+        if (Op == "*") return B.createMul(LHS, RHS);
+        if (Op == "/") return B.createDiv(LHS, RHS);
+        if (Op == "%") return B.createRem(LHS, RHS);
+        if (Op == "==") return B.createCmpEq(LHS, RHS);
+        if (Op == "!=") return B.createCmpNe(LHS, RHS);
+        if (Op == "<") return B.createCmpLt(LHS, RHS);
+        if (Op == "<=") return B.createCmpLe(LHS, RHS);
+        if (Op == ">") return B.createCmpGt(LHS, RHS);
+        if (Op == ">=") return B.createCmpGe(LHS, RHS);
+    } else if (Ty == MIRType::Float) {
+        if (Op == "+") return B.createFAdd(LHS, RHS);
+        if (Op == "-") return B.createFSub(LHS, RHS);
+        if (Op == "*") return B.createFMul(LHS, RHS);
+        if (Op == "/") return B.createFDiv(LHS, RHS);
+        if (Op == "==") return B.createFCmpEq(LHS, RHS);
+        if (Op == "!=") return B.createFCmpNe(LHS, RHS);
+        if (Op == "<") return B.createFCmpLt(LHS, RHS);
+        if (Op == "<=") return B.createFCmpLe(LHS, RHS);
+        if (Op == ">") return B.createFCmpGt(LHS, RHS);
+        if (Op == ">=") return B.createFCmpGe(LHS, RHS);
+    } else if (Ty == MIRType::Bool) {
+        // a != b — это (a && !b) || (!a && b); a == b — его отрицание.
+        if (Op == "==" || Op == "!=") {
+            MIRInst *OnlyLHS = B.createAnd(LHS, B.createNot(RHS));
+            MIRInst *OnlyRHS = B.createAnd(B.createNot(LHS), RHS);
+            MIRInst *Differ = B.createOr(OnlyLHS, OnlyRHS);
+            return Op == "!=" ? Differ : B.createNot(Differ);
+        }
+    }
+    return fail("invalid operands of binary '" + std::string(Op) + "'");
+}
+
+MIRInst *FunctionLowering::visitAssignExpr(AssignExpr *E) {
+    auto *Dest = dyn_cast<DeclRefExpr>(E->getDest());
+    if (!Dest)
+        return fail("assignment target must be a variable");
+    const ValueDecl *D = lookupRef(Dest);
+    if (!D || !VarTypes.count(D))
+        return fail("use of unknown variable '" + std::string(Dest->getName().str()) + "'");
+    auto Addr = InOutAddrs.find(D);
+    if (Addr == InOutAddrs.end() && (!isa<VarDecl>(D) || cast<VarDecl>(D)->isLet()))
+        return fail("cannot assign to '" + std::string(Dest->getName().str()) + "'");
+
+    MIRInst *Source = lowerValue(E->getSource());
+    if (Failed)
+        return nullptr;
+    if (Source->getType() != VarTypes[D])
+        return fail("assigned value has a wrong type");
+    if (Addr != InOutAddrs.end())
+        B.createStore(Addr->second, Source);
+    else
+        writeVariable(D, B.getInsertBlock(), B.createCopy(Source));
+    return nullptr;
+}
+
+MIRInst *FunctionLowering::visitCallExpr(CallExpr *E) {
+    auto *Ref = dyn_cast<DeclRefExpr>(E->getCallee());
+    auto It = Ref ? Functions.find(Ref->getName()) : Functions.end();
+    if (It == Functions.end())
+        return fail("call of an unknown function");
+    MIRFunction *Callee = It->second.F;
+    const std::vector<MIRType> &InOutTypes = It->second.InOutTypes;
+    if (Callee->getParamTypes().size() != E->getArgs().size())
+        return fail("wrong number of arguments in call to '" + Callee->getName() + "'");
+
+    std::vector<MIRInst *> Args;
+    // Spilled - Локальные переменные, отданные по адресу; после вызова
+    // их значение перечитывается.
+    std::vector<std::pair<const ValueDecl *, MIRInst *>> Spilled;
+    std::vector<const ValueDecl *> InOutArgs;
+    for (unsigned I = 0; I != E->getArgs().size(); ++I) {
+        std::string ArgName =
+            "argument " + std::to_string(I) + " of '" + Callee->getName() + "'";
+        auto *InOut = dyn_cast<InOutExpr>(E->getArgs()[I]);
+        if (InOutTypes[I] == MIRType::Void) {
+            if (InOut)
+                return fail(ArgName + " is not inout");
+            MIRInst *Arg = lowerValue(E->getArgs()[I]);
+            if (Failed)
+                return nullptr;
+            if (Arg->getType() != Callee->getParamTypes()[I])
+                return fail(ArgName + " has a wrong type");
+            Args.push_back(Arg);
+            continue;
+        }
+
+        auto *Var = InOut ? dyn_cast<DeclRefExpr>(InOut->getSubExpr()) : nullptr;
+        if (!Var)
+            return fail(ArgName + " must be '&variable'");
+        const ValueDecl *D = lookupRef(Var);
+        if (!D || !VarTypes.count(D))
+            return fail("use of unknown variable '" + std::string(Var->getName().str()) + "'");
+        if (VarTypes[D] != InOutTypes[I])
+            return fail(ArgName + " has a wrong type");
+        // Два адреса одной переменной в одном вызове — перекрывающийся
+        // доступ, его запрещает и Swift.
+        if (std::find(InOutArgs.begin(), InOutArgs.end(), D) != InOutArgs.end())
+            return fail("overlapping inout accesses to '" + std::string(Var->getName().str()) +
+                        "'");
+        InOutArgs.push_back(D);
+
+        auto Addr = InOutAddrs.find(D);
+        if (Addr != InOutAddrs.end()) {
+            Args.push_back(Addr->second);
+            continue;
+        }
+        if (!isa<VarDecl>(D) || cast<VarDecl>(D)->isLet())
+            return fail("cannot pass immutable '" + std::string(Var->getName().str()) +
+                        "' as inout");
+        MIRInst *&Slot = SpillSlots[D];
+        if (!Slot)
+            Slot = B.createAlloca();
+        B.createStore(Slot, readVariable(D, B.getInsertBlock()));
+        Spilled.push_back({D, Slot});
+        Args.push_back(Slot);
+    }
+
+    MIRInst *Result = B.createCall(Callee, Args);
+    for (auto &[D, Slot] : Spilled)
+        writeVariable(D, B.getInsertBlock(), B.createLoad(VarTypes[D], Slot));
+    return Result;
+}
+
+MIRInst *FunctionLowering::visitTupleExpr(TupleExpr *E) {
+    // Скобки вокруг одного выражения; настоящих кортежей в MIR нет.
+    if (E->getElements().size() != 1)
+        return fail("tuples are not supported by MIR lowering");
+    return visit(E->getElements()[0]);
+}
+
+} // namespace
+
+bool lowerToMIR(ArrayRef<FuncDecl *> Funcs, MIRModule &M, std::string &Error) {
+    // Сначала объявляем все функции, чтобы вызовы могли ссылаться на
+    // функции ниже по списку.
+    std::unordered_map<Identifier, LoweredFunction> Functions;
+    for (FuncDecl *D : Funcs) {
+        std::string Name(D->getName().str());
+        if (Functions.count(D->getName())) {
+            Error = "redefinition of function '" + Name + "'";
+            return false;
+        }
+
+        std::vector<MIRType> ParamTypes, InOutTypes;
+        for (ParamDecl *P : D->getParams()) {
+            TypeBase *PT = P->getType();
+            if (auto *IOT = PT ? dyn_cast<InOutType>(PT) : nullptr)
+                PT = IOT->getObjectType();
+            MIRType Ty;
+            if (!mapType(PT, Ty) || Ty == MIRType::Void) {
+                Error = Name + ": parameter '" + std::string(P->getName().str()) +
+                        "' has unsupported type";
+                return false;
+            }
+            ParamTypes.push_back(P->isInOut() ? MIRType::Addr : Ty);
+            InOutTypes.push_back(P->isInOut() ? Ty : MIRType::Void);
+        }
+        MIRType ReturnType = MIRType::Void;
+        if (D->getType()) {
+            auto *FT = dyn_cast<FunctionType>(D->getType());
+            if (!FT || !mapType(FT->getResult(), ReturnType)) {
+                Error = Name + ": unsupported return type";
+                return false;
+            }
+        }
+        Functions[D->getName()] = {M.createFunction(Name, ParamTypes, ReturnType),
+                                   std::move(InOutTypes)};
+    }
+
+    for (FuncDecl *D : Funcs) {
+        FunctionLowering Lowering(Functions, *Functions[D->getName()].F, Error);
+        if (!Lowering.run(D))
+            return false;
+    }
+    return true;
+}
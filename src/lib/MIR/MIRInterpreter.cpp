@@ -0,0 +1,187 @@
+#include <cassert>
+#include <cstring>
+#include "MIR/MIRInterpreter.h"
+#include "Runtime/Runtime.h"
+
+namespace {
+
+int64_t wrap(uint64_t V) { return static_cast<int64_t>(V); }
+
+// Поля объекта хранятся в раскладке Runtime: Bool — один байт.
+MIRValue loadField(const void *Field, MIRType Ty) {
+    MIRValue V = makeMIRInt(0);
+    if (Ty == MIRType::Bool)
+        V.I = *static_cast<const uint8_t *>(Field);
+    else
+        std::memcpy(&V, Field, sizeof(V));
+    return V;
+}
+
+void storeField(void *Field, MIRType Ty, MIRValue V) {
+    if (Ty == MIRType::Bool)
+        *static_cast<uint8_t *>(Field) = V.I != 0;
+    else
+        std::memcpy(Field, &V, sizeof(V));
+}
+
+char *fieldAddress(MIRValue Object, const MIRInst *I) {
+    assert(Object.P && "field access through a null reference");
+    return static_cast<char *>(Object.P) + I->getIntValue();
+}
+
+} // namespace
+
+MIRValue MIRInterpreter::run(const MIRFunction &F, ArrayRef<MIRValue> Args) {
+    assert(Args.size() == F.getParamTypes().size() && "wrong number of arguments");
+
+    // Кадр адресуется индексом: вложенные вызовы могут переразместить Frames.
+    size_t Base = Frames.size();
+    size_t SlotBase = Slots.size();
+    Frames.resize(Base + F.getNumValues(), makeMIRInt(0));
+    auto val = [&](const MIRInst *V) -> MIRValue & { return Frames[Base + V->getID()]; };
+
+    std::vector<MIRValue> PhiValues;
+    const MIRBlock *Prev = nullptr;
+    const MIRBlock *B = F.getEntryBlock();
+    while (true) {
+        // Все phi блока читают значения одновременно: phi может быть
+        // операндом другой phi того же блока.
+        unsigned NumPhis = B->getNumPhis();
+        if (NumPhis) {
+            unsigned Pred = B->getPredIndex(Prev);
+            PhiValues.clear();
+            for (unsigned P = 0; P != NumPhis; ++P)
+                PhiValues.push_back(val(B->Insts[P]->getOperand(Pred)));
+            for (unsigned P = 0; P != NumPhis; ++P)
+                val(B->Insts[P]) = PhiValues[P];
+            NumInstsExecuted += NumPhis;
+        }
+
+        const MIRBlock *Next = nullptr;
+        for (size_t Pos = NumPhis; Pos != B->Insts.size() && !Next; ++Pos) {
+            const MIRInst *I = B->Insts[Pos];
+            ++NumInstsExecuted;
+            auto a = [&]() -> MIRValue & { return val(I->getOperand(0)); };
+            auto b = [&]() -> MIRValue & { return val(I->getOperand(1)); };
+            switch (I->getOpcode()) {
+            case MIROpcode::Param:
+                val(I) = Args[I->getIntValue()];
+                break;
+            case MIROpcode::IConst:
+            case MIROpcode::BConst:
+                val(I).I = I->getIntValue();
+                break;
+            case MIROpcode::FConst:
+                val(I).F = I->getFloatValue();
+                break;
+            case MIROpcode::Copy:
+                val(I) = a();
+                break;
+            case MIROpcode::Phi:
+                assert(false && "phi after non-phi instruction");
+                break;
+            case MIROpcode::Neg:
+                val(I).I = wrap(0 - static_cast<uint64_t>(a().I));
+                break;
+            case MIROpcode::FNeg:
+                val(I).F = -a().F;
+                break;
+            case MIROpcode::Not:
+                val(I).I = !a().I;
+                break;
+            case MIROpcode::Call: {
+                std::vector<MIRValue> CallArgs;
+                for (MIRInst *Op : I->getOperands())
+                    CallArgs.push_back(val(Op));
+                MIRValue Result = run(*I->getCallee(), CallArgs);
+                val(I) = Result;
+                break;
+            }
+
+            case MIROpcode::Null:
+                val(I).P = nullptr;
+                break;
+            case MIROpcode::AllocRef:
+                assert(RT && "object allocation without a runtime");
+                val(I).P = RT->allocObject(*I->getClass());
+                break;
+            case MIROpcode::Retain:
+                assert(RT && "retain without a runtime");
+                RT->retain(static_cast<HeapObject *>(a().P));
+                break;
+            case MIROpcode::Release:
+                assert(RT && "release without a runtime");
+                RT->release(static_cast<HeapObject *>(a().P));
+                break;
+            case MIROpcode::LoadField:
+                val(I) = loadField(fieldAddress(a(), I), I->getType());
+                break;
+            case MIROpcode::StoreField:
+                storeField(fieldAddress(a(), I), I->getOperand(1)->getType(), b());
+                break;
+            case MIROpcode::Alloca:
+                Slots.push_back(makeMIRInt(0));
+                val(I).P = &Slots.back();
+                break;
+            case MIROpcode::Load:
+                val(I) = *static_cast<MIRValue *>(a().P);
+                break;
+            case MIROpcode::Store:
+                *static_cast<MIRValue *>(a().P) = b();
+                break;
+
+            // Сложение и умножение — по модулю 2^64, как в машинном коде.
+            case MIROpcode::Add:
+                val(I).I = wrap(static_cast<uint64_t>(a().I) + static_cast<uint64_t>(b().I));
+                break;
+            case MIROpcode::Sub:
+                val(I).I = wrap(static_cast<uint64_t>(a().I) - static_cast<uint64_t>(b().I));
+                break;
+            case MIROpcode::Mul:
+                val(I).I = wrap(static_cast<uint64_t>(a().I) * static_cast<uint64_t>(b().I));
+                break;
+            case MIROpcode::Div:
+                val(I).I = a().I / b().I;
+                break;
+            case MIROpcode::Rem:
+                val(I).I = a().I % b().I;
+                break;
+            case MIROpcode::FAdd: val(I).F = a().F + b().F; break;
+            case MIROpcode::FSub: val(I).F = a().F - b().F; break;
+            case MIROpcode::FMul: val(I).F = a().F * b().F; break;
+            case MIROpcode::FDiv: val(I).F = a().F / b().F; break;
+            case MIROpcode::And: val(I).I = a().I && b().I; break;
+            case MIROpcode::Or: val(I).I = a().I || b().I; break;
+
+            case MIROpcode::CmpEq: val(I).I = a().I == b().I; break;
+            case MIROpcode::CmpNe: val(I).I = a().I != b().I; break;
+            case MIROpcode::CmpLt: val(I).I = a().I < b().I; break;
+            case MIROpcode::CmpLe: val(I).I = a().I <= b().I; break;
+            case MIROpcode::CmpGt: val(I).I = a().I > b().I; break;
+            case MIROpcode::CmpGe: val(I).I = a().I >= b().I; break;
+            case MIROpcode::FCmpEq: val(I).I = a().F == b().F; break;
+            case MIROpcode::FCmpNe: val(I).I = a().F != b().F; break;
+            case MIROpcode::FCmpLt: val(I).I = a().F < b().F; break;
+            case MIROpcode::FCmpLe: val(I).I = a().F <= b().F; break;
+            case MIROpcode::FCmpGt: val(I).I = a().F > b().F; break;
+            case MIROpcode::FCmpGe: val(I).I = a().F >= b().F; break;
+
+            case MIROpcode::Br:
+                Next = I->getSuccessor(0);
+                break;
+            case MIROpcode::CondBr:
+                Next = I->getSuccessor(a().I ? 0 : 1);
+                break;
+            case MIROpcode::Ret: {
+                MIRValue Result = I->getNumOperands() ? a() : makeMIRInt(0);
+                Frames.resize(Base);
+                Slots.resize(SlotBase);
+                return Result;
+            }
+            }
+        }
+        assert(Next && "block without terminator");
+        Prev = B;
+        B = Next;
+    }
+}
@@ -0,0 +1,162 @@
+#include <chrono>
+#include <ostream>
+#include "MIR/PassManager.h"
+#include "MIR/Passes.h"
+
+const char *getPassName(MIRPassID ID) {
+    switch (ID) {
+      #define MIR_PASS(Id, Name) case MIRPassID::Id: return Name;
+      #include "MIR/MIRPasses.def"
+    }
+    return "<invalid>";
+}
+
+bool isFunctionPass(MIRPassID ID) {
+    switch (ID) {
+      #define MIR_FUNCTION_PASS(Id, Name) case MIRPassID::Id: return true;
+      #include "MIR/MIRPasses.def"
+    default:
+        return false;
+    }
+}
+
+namespace {
+
+unsigned runFunctionPass(MIRPassID ID, MIRFunction &F) {
+    switch (ID) {
+      #define MIR_FUNCTION_PASS(Id, Name) case MIRPassID::Id: return run##Id(F);
+      #include "MIR/MIRPasses.def"
+    default:
+        return 0;
+    }
+}
+
+unsigned runModulePass(MIRPassID ID, MIRModule &M) {
+    switch (ID) {
+      #define MIR_MODULE_PASS(Id, Name) case MIRPassID::Id: return run##Id(M);
+      #include "MIR/MIRPasses.def"
+    default:
+        return 0;
+    }
+}
+
+uint64_t nanosSince(std::chrono::steady_clock::time_point Start) {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                     std::chrono::steady_clock::now() - Start)
+                                     .count());
+}
+
+} // namespace
+
+bool MIRPassManager::addPass(std::string_view Name) {
+    #define MIR_PASS(Id, PassName)                                            \
+    if (Name == PassName) {                                                   \
+        addPass(MIRPassID::Id);                                               \
+        return true;                                                          \
+    }
+    #include "MIR/MIRPasses.def"
+    return false;
+}
+
+void MIRPassManager::addDefaultPipeline() {
+    for (MIRPassID ID : {MIRPassID::ConstantFolding, MIRPassID::CopyPropagation,
+                         MIRPassID::DeadCodeElimination, MIRPassID::Inliner,
+                         MIRPassID::ConstantFolding, MIRPassID::CopyPropagation,
+                         MIRPassID::RetainReleaseElimination,
+                         MIRPassID::LoopInvariantCodeMotion,
+                         MIRPassID::DeadCodeElimination})
+        addPass(ID);
+}
+
+bool MIRPassManager::runFunctionGroup(MIRModule &M, size_t Begin, size_t End,
+                                      std::string &Error) {
+    const auto &Functions = M.getFunctions();
+    // Errors - По строке на функцию: задачи пишут каждая в свою.
+    std::vector<std::string> Errors(Functions.size());
+
+    auto runGroup = [&](MIRFunction &F) {
+        // Статистика копится локально и сливается под мьютексом один раз.
+        std::vector<PassStats> Local(End - Begin);
+        for (size_t P = Begin; P != End; ++P) {
+            PassStats &S = Local[P - Begin];
+            unsigned Before = F.getNumInsts();
+            auto Start = std::chrono::steady_clock::now();
+            S.NumChanges = runFunctionPass(Pipeline[P], F);
+            S.Nanos = nanosSince(Start);
+            S.NumRuns = 1;
+            S.InstsRemoved = int64_t(Before) - int64_t(F.getNumInsts());
+            if (VerifyEach && !verifyFunction(F, Errors[F.getIndex()])) {
+                Errors[F.getIndex()] = std::string("after ") + getPassName(Pipeline[P]) + ": " +
+                                       Errors[F.getIndex()];
+                break;
+            }
+        }
+        std::lock_guard<std::mutex> Lock(StatsMutex);
+        for (size_t P = Begin; P != End; ++P) {
+            PassStats &S = Stats[P];
+            const PassStats &L = Local[P - Begin];
+            S.NumRuns += L.NumRuns;
+            S.NumChanges += L.NumChanges;
+            S.InstsRemoved += L.InstsRemoved;
+            S.Nanos += L.Nanos;
+        }
+    };
+
+    if (Pool && Functions.size() > 1) {
+        for (const auto &F : Functions)
+            Pool->async([&runGroup, Fn = F.get()] { runGroup(*Fn); });
+        Pool->wait();
+    } else {
+        for (const auto &F : Functions)
+            runGroup(*F);
+    }
+
+    for (std::string &E : Errors)
+        if (!E.empty()) {
+            Error = std::move(E);
+            return false;
+        }
+    return true;
+}
+
+bool MIRPassManager::run(MIRModule &M, std::string &Error) {
+    Stats.assign(Pipeline.size(), PassStats());
+    for (size_t P = 0; P != Pipeline.size(); ++P)
+        Stats[P].Name = getPassName(Pipeline[P]);
+
+    size_t P = 0;
+    while (P != Pipeline.size()) {
+        if (isFunctionPass(Pipeline[P])) {
+            size_t End = P;
+            while (End != Pipeline.size() && isFunctionPass(Pipeline[End]))
+                ++End;
+            if (!runFunctionGroup(M, P, End, Error))
+                return false;
+            P = End;
+            continue;
+        }
+
+        PassStats &S = Stats[P];
+        unsigned Before = M.getNumInsts();
+        auto Start = std::chrono::steady_clock::now();
+        S.NumChanges = runModulePass(Pipeline[P], M);
+        S.Nanos = nanosSince(Start);
+        S.NumRuns = 1;
+        S.InstsRemoved = int64_t(Before) - int64_t(M.getNumInsts());
+        if (VerifyEach && !M.verify(Error)) {
+            Error = std::string("after ") + S.Name + ": " + Error;
+            return false;
+        }
+        ++P;
+    }
+    return true;
+}
+
+void MIRPassManager::printStats(std::ostream &OS) const {
+    OS << "*** MIR Pass Stats:\n";
+    for (const PassStats &S : Stats) {
+        OS << "  " << S.Name << ": " << S.NumRuns << " runs, " << S.NumChanges
+           << " changes, " << S.InstsRemoved << " insts removed, "
+           << double(S.Nanos) / 1e6 << " ms\n";
+    }
+}
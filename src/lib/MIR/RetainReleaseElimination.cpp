@@ -0,0 +1,76 @@
+#include <algorithm>
+#include "MIR/Passes.h"
+
+namespace {
+
+// getRoot - Значение без копий: retain %a и release %b, где %b = copy %a,
+// относятся к одному объекту.
+const MIRInst *getRoot(const MIRInst *V) {
+    while (V->getOpcode() == MIROpcode::Copy)
+        V = V->getOperand(0);
+    return V;
+}
+
+// mayDecrement - Инструкция может уменьшить счётчик какого-то объекта.
+// Вызов может отпустить любой объект, release другого значения — тот же
+// объект под другим именем.
+bool mayDecrement(const MIRInst *I) {
+    return I->getOpcode() == MIROpcode::Call || I->getOpcode() == MIROpcode::Release;
+}
+
+} // namespace
+
+// runRetainReleaseElimination - Удаляет пары retain %x ... release %x на
+// прямом участке кода, если между ними никто не может уменьшить счётчик.
+//
+// Пара лишь временно поднимает счётчик на единицу. Объект жив до retain
+// (иначе retain некорректен), а между ними его счётчик не падает, поэтому
+// без пары он так же жив на всём отрезке, и после release счётчик тот же.
+// Загрузки и записи полей счётчиков не трогают и пару не разрывают.
+//
+// Прямой участок продолжается через br в блок с единственным
+// предшественником: так выглядит тело, встроенное на место вызова.
+unsigned runRetainReleaseElimination(MIRFunction &F) {
+    unsigned NumRemoved = 0;
+    std::vector<bool> Dead(F.getNumValues(), false);
+    for (const auto &B : F.Blocks) {
+        for (size_t Pos = 0; Pos != B->Insts.size(); ++Pos) {
+            MIRInst *Retain = B->Insts[Pos];
+            if (Retain->getOpcode() != MIROpcode::Retain || Dead[Retain->getID()])
+                continue;
+            const MIRInst *Object = getRoot(Retain->getOperand(0));
+            const MIRBlock *Cur = B.get();
+            size_t Next = Pos + 1;
+            while (Next != Cur->Insts.size()) {
+                MIRInst *I = Cur->Insts[Next++];
+                if (I->getOpcode() == MIROpcode::Br) {
+                    // Блоки недостижимого цикла могут вернуть обход в B.
+                    const MIRBlock *Succ = I->getSuccessor(0);
+                    if (Succ->Preds.size() != 1 || Succ == B.get())
+                        break;
+                    Cur = Succ;
+                    Next = 0;
+                    continue;
+                }
+                if (Dead[I->getID()])
+                    continue;
+                if (I->getOpcode() == MIROpcode::Release && getRoot(I->getOperand(0)) == Object) {
+                    Dead[Retain->getID()] = Dead[I->getID()] = true;
+                    NumRemoved += 2;
+                    break;
+                }
+                if (mayDecrement(I))
+                    break;
+            }
+        }
+    }
+    if (!NumRemoved)
+        return 0;
+
+    for (const auto &B : F.Blocks) {
+        auto NewEnd = std::remove_if(B->Insts.begin(), B->Insts.end(),
+                                     [&](MIRInst *I) { return Dead[I->getID()]; });
+        B->Insts.erase(NewEnd, B->Insts.end());
+    }
+    return NumRemoved;
+}
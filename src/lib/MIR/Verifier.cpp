@@ -0,0 +1,265 @@
+#include <algorithm>
+#include "MIR/Dominators.h"
+#include "MIR/MIR.h"
+
+namespace {
+
+// isStorable - Тип значения, которое можно положить в поле или ячейку.
+bool isStorable(MIRType Ty) {
+    return Ty != MIRType::Void && Ty != MIRType::Addr;
+}
+
+class Verifier {
+    const MIRFunction &F;
+    std::string &Error;
+    // Defs - Инструкция по ID, если она стоит в одном из блоков функции.
+    std::vector<const MIRInst *> Defs;
+    // Positions - Индекс инструкции в её блоке, по ID.
+    std::vector<unsigned> Positions;
+
+public:
+    Verifier(const MIRFunction &f, std::string &error) : F(f), Error(error) {}
+
+    bool fail(const MIRBlock *B, const std::string &Message) {
+        Error = F.getName() + ": bb" + std::to_string(B->getID()) + ": " + Message;
+        return false;
+    }
+
+    bool verifyCFG();
+    bool verifyInst(const MIRBlock *B, const MIRInst *I, unsigned Pos);
+    bool verifyDominance();
+    bool run();
+};
+
+bool Verifier::verifyCFG() {
+    if (F.Blocks.empty()) {
+        Error = F.getName() + ": function has no blocks";
+        return false;
+    }
+    if (!F.getEntryBlock()->Preds.empty())
+        return fail(F.getEntryBlock(), "entry block has predecessors");
+
+    // Preds каждого блока должны совпадать, как мультимножество, с дугами
+    // из терминаторов.
+    std::vector<std::vector<const MIRBlock *>> Expected(F.Blocks.size());
+    for (size_t B = 0; B != F.Blocks.size(); ++B) {
+        const MIRBlock *Block = F.Blocks[B].get();
+        if (Block->getID() != B)
+            return fail(Block, "block numbering is out of date");
+        const MIRInst *T = Block->getTerminator();
+        if (!T)
+            return fail(Block, "block does not end with a terminator");
+        for (unsigned S = 0; S != T->getNumSuccessors(); ++S) {
+            const MIRBlock *Succ = T->getSuccessor(S);
+            if (!Succ || Succ->getID() >= F.Blocks.size() ||
+                F.Blocks[Succ->getID()].get() != Succ)
+                return fail(Block, "branch to a block outside the function");
+            Expected[Succ->getID()].push_back(Block);
+        }
+    }
+    for (size_t B = 0; B != F.Blocks.size(); ++B) {
+        std::vector<const MIRBlock *> Actual(F.Blocks[B]->Preds.begin(),
+                                             F.Blocks[B]->Preds.end());
+        std::sort(Actual.begin(), Actual.end());
+        std::sort(Expected[B].begin(), Expected[B].end());
+        if (Actual != Expected[B])
+            return fail(F.Blocks[B].get(), "predecessor list does not match branches");
+    }
+    return true;
+}
+
+bool Verifier::verifyInst(const MIRBlock *B, const MIRInst *I, unsigned Pos) {
+    std::string Name = getOpcodeName(I->getOpcode());
+    auto bad = [&](const std::string &Message) { return fail(B, "'" + Name + "' " + Message); };
+    auto operandsAre = [&](MIRType Ty, unsigned N) {
+        if (I->getNumOperands() != N)
+            return false;
+        for (MIRInst *Op : I->getOperands())
+            if (Op->getType() != Ty)
+                return false;
+        return true;
+    };
+
+    if (I->getParent() != B)
+        return bad("has a wrong parent block");
+    if (I->isTerminator() && Pos + 1 != B->Insts.size())
+        return bad("in the middle of a block");
+    if (I->isPhi() && Pos != 0 && !B->Insts[Pos - 1]->isPhi())
+        return bad("after a non-phi instruction");
+
+    bool Valid = true;
+    switch (I->getOpcode()) {
+    case MIROpcode::Param:
+        Valid = I->getNumOperands() == 0 && I->getIntValue() >= 0 &&
+                static_cast<size_t>(I->getIntValue()) < F.getParamTypes().size() &&
+                I->getType() == F.getParamTypes()[I->getIntValue()];
+        break;
+    case MIROpcode::IConst:
+        Valid = I->getType() == MIRType::Int && I->getNumOperands() == 0;
+        break;
+    case MIROpcode::FConst:
+        Valid = I->getType() == MIRType::Float && I->getNumOperands() == 0;
+        break;
+    case MIROpcode::BConst:
+        Valid = I->getType() == MIRType::Bool && I->getNumOperands() == 0;
+        break;
+    case MIROpcode::Copy:
+        Valid = I->getType() != MIRType::Void && operandsAre(I->getType(), 1);
+        break;
+    case MIROpcode::Phi:
+        if (I->getNumOperands() != B->Preds.size())
+            return bad("has " + std::to_string(I->getNumOperands()) + " operands for " +
+                       std::to_string(B->Preds.size()) + " predecessors");
+        Valid = I->getType() != MIRType::Void &&
+                operandsAre(I->getType(), I->getNumOperands());
+        break;
+    case MIROpcode::Neg:
+        Valid = I->getType() == MIRType::Int && operandsAre(MIRType::Int, 1);
+        break;
+    case MIROpcode::FNeg:
+        Valid = I->getType() == MIRType::Float && operandsAre(MIRType::Float, 1);
+        break;
+    case MIROpcode::Not:
+        Valid = I->getType() == MIRType::Bool && operandsAre(MIRType::Bool, 1);
+        break;
+    #define MIR_INT_BINARY(Id, N) case MIROpcode::Id:
+    #include "MIR/MIROps.def"
+        Valid = I->getType() == MIRType::Int && operandsAre(MIRType::Int, 2);
+        break;
+    #define MIR_FLOAT_BINARY(Id, N) case MIROpcode::Id:
+    #include "MIR/MIROps.def"
+        Valid = I->getType() == MIRType::Float && operandsAre(MIRType::Float, 2);
+        break;
+    #define MIR_BOOL_BINARY(Id, N) case MIROpcode::Id:
+    #include "MIR/MIROps.def"
+        Valid = I->getType() == MIRType::Bool && operandsAre(MIRType::Bool, 2);
+        break;
+    #define MIR_INT_COMPARE(Id, N) case MIROpcode::Id:
+    #include "MIR/MIROps.def"
+        Valid = I->getType() == MIRType::Bool && operandsAre(MIRType::Int, 2);
+        break;
+    #define MIR_FLOAT_COMPARE(Id, N) case MIROpcode::Id:
+    #include "MIR/MIROps.def"
+        Valid = I->getType() == MIRType::Bool && operandsAre(MIRType::Float, 2);
+        break;
+    case MIROpcode::Call: {
+        const MIRFunction *Callee = I->getCallee();
+        Valid = Callee && Callee->getParamTypes().size() == I->getNumOperands() &&
+                I->getType() == Callee->getReturnType();
+        for (unsigned A = 0; Valid && A != I->getNumOperands(); ++A)
+            Valid = I->getOperand(A)->getType() == Callee->getParamTypes()[A];
+        break;
+    }
+    case MIROpcode::Null:
+        Valid = (I->getType() == MIRType::Ref || I->getType() == MIRType::Addr) &&
+                I->getNumOperands() == 0;
+        break;
+    case MIROpcode::AllocRef:
+        Valid = I->getType() == MIRType::Ref && I->getNumOperands() == 0 && I->getClass();
+        break;
+    case MIROpcode::Retain:
+    case MIROpcode::Release:
+        Valid = I->getType() == MIRType::Void && operandsAre(MIRType::Ref, 1);
+        break;
+    case MIROpcode::LoadField:
+        Valid = isStorable(I->getType()) && operandsAre(MIRType::Ref, 1) &&
+                I->getIntValue() >= 0;
+        break;
+    case MIROpcode::StoreField:
+        Valid = I->getType() == MIRType::Void && I->getNumOperands() == 2 &&
+                I->getOperand(0)->getType() == MIRType::Ref &&
+                isStorable(I->getOperand(1)->getType()) && I->getIntValue() >= 0;
+        break;
+    case MIROpcode::Alloca:
+        // Слот вне входного блока выделялся бы заново на каждом проходе.
+        if (B != F.getEntryBlock())
+            return bad("outside the entry block");
+        Valid = I->getType() == MIRType::Addr && I->getNumOperands() == 0;
+        break;
+    case MIROpcode::Load:
+        Valid = isStorable(I->getType()) && operandsAre(MIRType::Addr, 1);
+        break;
+    case MIROpcode::Store:
+        Valid = I->getType() == MIRType::Void && I->getNumOperands() == 2 &&
+                I->getOperand(0)->getType() == MIRType::Addr &&
+                isStorable(I->getOperand(1)->getType());
+        break;
+    case MIROpcode::Br:
+        Valid = I->getNumOperands() == 0;
+        break;
+    case MIROpcode::CondBr:
+        Valid = operandsAre(MIRType::Bool, 1);
+        break;
+    case MIROpcode::Ret:
+        Valid = F.getReturnType() == MIRType::Void ? I->getNumOperands() == 0
+                                                   : operandsAre(F.getReturnType(), 1);
+        break;
+    }
+    if (!Valid)
+        return bad("has invalid operands or type");
+
+    for (MIRInst *Op : I->getOperands())
+        if (Op->getID() >= Defs.size() || Defs[Op->getID()] != Op)
+            return bad("uses a value that is not in the function");
+    return true;
+}
+
+bool Verifier::verifyDominance() {
+    DominatorTree DT(F);
+    auto dominatesUse = [&](const MIRInst *Def, const MIRBlock *UseBlock, unsigned UsePos) {
+        const MIRBlock *DefBlock = Def->getParent();
+        if (DefBlock != UseBlock)
+            return DT.dominates(DefBlock, UseBlock);
+        return Positions[Def->getID()] < UsePos;
+    };
+
+    for (const auto &B : F.Blocks) {
+        if (!DT.isReachable(B.get()))
+            continue;
+        for (unsigned Pos = 0; Pos != B->Insts.size(); ++Pos) {
+            const MIRInst *I = B->Insts[Pos];
+            for (unsigned Op = 0; Op != I->getNumOperands(); ++Op) {
+                const MIRInst *Def = I->getOperand(Op);
+                // Операнд phi используется в конце соответствующего
+                // предшественника.
+                bool Dominates =
+                    I->isPhi() ? dominatesUse(Def, B->Preds[Op],
+                                              static_cast<unsigned>(B->Preds[Op]->Insts.size()))
+                               : dominatesUse(Def, B.get(), Pos);
+                if (!Dominates)
+                    return fail(B.get(), std::string("'") + getOpcodeName(I->getOpcode()) +
+                                             "' uses a value that does not dominate it");
+            }
+        }
+    }
+    return true;
+}
+
+bool Verifier::run() {
+    if (!verifyCFG())
+        return false;
+
+    Defs.assign(F.getNumValues(), nullptr);
+    Positions.assign(F.getNumValues(), 0);
+    for (const auto &B : F.Blocks) {
+        for (unsigned Pos = 0; Pos != B->Insts.size(); ++Pos) {
+            const MIRInst *I = B->Insts[Pos];
+            if (I->getID() >= Defs.size() || Defs[I->getID()])
+                return fail(B.get(), "instruction is inserted twice or has a foreign ID");
+            Defs[I->getID()] = I;
+            Positions[I->getID()] = Pos;
+        }
+    }
+
+    for (const auto &B : F.Blocks)
+        for (unsigned Pos = 0; Pos != B->Insts.size(); ++Pos)
+            if (!verifyInst(B.get(), B->Insts[Pos], Pos))
+                return false;
+    return verifyDominance();
+}
+
+} // namespace
+
+bool verifyFunction(const MIRFunction &F, std::string &Error) {
+    return Verifier(F, Error).run();
+}
@@ -1,4 +1,5 @@
 #include <cassert>
+#include <cctype>
 #include <stdio.h>
 #include "Parse/Lexer.h"
 
@@ -6,6 +7,12 @@ Lexer::Lexer(std::string_view input) {
     initialize(input);
 };
 
+Lexer::Lexer(std::string_view input, const Token &Resume) {
+    initialize(input);
+    NextToken = Resume;
+    IsContinuation = true;
+};
+
 void Lexer::initialize(std::string_view input) {
     BufferStart = input.data();
     BufferEnd = input.data() + input.size();
@@ -103,7 +110,7 @@ Restart:
             }
             break;
         case '#':
-            if (TriviaStart == BufferStart && *CurPtr == '!') {
+            if (TriviaStart == BufferStart && !IsContinuation && *CurPtr == '!') {
                 --CurPtr;  // Возвращаемся на '#'
                 skipHashbang();
                 goto Restart;
@@ -0,0 +1,220 @@
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include "Parse/StreamingLexer.h"
+
+// isTriviaByte - true для байтов, которые Lexer::lexTrivia молча пропускает:
+// пробелы и символы, не начинающие ни один токен. Должно совпадать со
+// списком case в lexTrivia.
+static bool isTriviaByte(char C) {
+    switch (C) {
+    case '/': case '#': case '<': case '>': case 0:
+    case (char)-1: case (char)-2:
+    case '@': case '{': case '[': case '(': case '}': case ']': case ')':
+    case ',': case ';': case ':': case '\\': case '$':
+    case '"': case '\'': case '`':
+    case '_':
+    case '%': case '!': case '?': case '=':
+    case '-': case '+': case '*':
+    case '&': case '|': case '^': case '~': case '.':
+        return false;
+    default:
+        if ((C >= '0' && C <= '9') || (C >= 'a' && C <= 'z') ||
+            (C >= 'A' && C <= 'Z'))
+            return false;
+        return true;
+    }
+}
+
+StreamingLexer::StreamingLexer(ReadFn read, size_t chunkSize)
+    : Read(std::move(read)), ChunkSize(std::max<size_t>(chunkSize, 1)) {
+    Window.resize(1, '\0');
+}
+
+StreamingLexer::ReadFn StreamingLexer::readFromFD(int FD) {
+    return [FD](char *Buffer, size_t Size) -> size_t {
+        while (true) {
+            ssize_t N = ::read(FD, Buffer, Size);
+            if (N < 0 && errno == EINTR)
+                continue;
+            return N > 0 ? static_cast<size_t>(N) : 0;
+        }
+    };
+}
+
+Token StreamingLexer::lex() {
+    if (!EmittedStart) {
+        EmittedStart = true;
+        return Prev;
+    }
+    if (Finished)
+        return Prev;
+
+    while (true) {
+        if (!WindowLexer)
+            refill();
+
+        const char *WindowEnd = Window.data() + WindowSize;
+        const char *After = WindowLexer->getBufferPtr();
+        Token Result = WindowLexer->lex();
+
+        if (Result.isEOF()) {
+            // NUL посреди окна — настоящий конец файла, как и в
+            // буферизованном режиме. EOF на границе окна означает лишь, что
+            // окно кончилось.
+            if (StreamEnded || Result.getText().data() < WindowEnd) {
+                Finished = true;
+                Prev = Result;
+                return Result;
+            }
+        } else if (StreamEnded || After + 1 < WindowEnd) {
+            // Lexer заглядывает максимум на один байт за конец токена
+            // (проверка "123." перед цифрой), поэтому токен, за которым в
+            // окне есть ещё хотя бы байт, уже не изменится.
+            ResumeOffset = static_cast<size_t>(After - Window.data());
+            Prev = Result;
+            return Result;
+        }
+
+        WindowLexer.reset();
+    }
+}
+
+void StreamingLexer::refill() {
+    // Текст Prev может указывать в окно, которое сейчас сдвинется.
+    if (Prev.getText().data()) {
+        std::string Text(Prev.getText());
+        PrevText.swap(Text);
+        Prev.setToken(Prev.getKind(), PrevText);
+    }
+
+    dropPrefix(ResumeOffset);
+    ResumeOffset = 0;
+
+    while (true) {
+        readAtLeast(WindowSize + ChunkSize);
+        bool NeedMore = false;
+        size_t Skipped = skipTrivia(NeedMore);
+        dropPrefix(Skipped);
+        if (!NeedMore || StreamEnded)
+            break;
+    }
+
+    WindowLexer.emplace(std::string_view(Window.data(), WindowSize), Prev);
+    // Первый lex() возвращает Prev, который уже выдан.
+    WindowLexer->lex();
+}
+
+void StreamingLexer::readAtLeast(size_t Target) {
+    if (Window.size() < Target + 1)
+        Window.resize(Target + 1);
+    while (!StreamEnded && WindowSize < Target) {
+        size_t N = Read(Window.data() + WindowSize, Target - WindowSize);
+        if (N == 0)
+            StreamEnded = true;
+        WindowSize += N;
+    }
+    Window[WindowSize] = '\0';
+}
+
+void StreamingLexer::dropPrefix(size_t Count) {
+    if (!Count)
+        return;
+    assert(Count <= WindowSize && "Dropping past the end of the window");
+    if (Count < WindowSize)
+        std::memmove(Window.data(), Window.data() + Count, WindowSize - Count);
+    WindowSize -= Count;
+    Window[WindowSize] = '\0';
+    AtStreamStart = false;
+}
+
+size_t StreamingLexer::skipTrivia(bool &NeedMore) {
+    const char *Start = Window.data();
+    const char *End = Start + WindowSize;
+    const char *Ptr = Start;
+    NeedMore = false;
+
+    while (true) {
+        switch (State) {
+        case TriviaState::LineComment:
+            // Как advanceToEndOfLine: '\n', '\r' и NUL остаются на месте.
+            while (Ptr < End && *Ptr != '\n' && *Ptr != '\r' && *Ptr != '\0')
+                ++Ptr;
+            if (Ptr == End) {
+                NeedMore = true;
+                return static_cast<size_t>(Ptr - Start);
+            }
+            State = TriviaState::Normal;
+            break;
+
+        case TriviaState::BlockComment:
+            // Как skipToEndOfSlashStarComment, но с состоянием между окнами.
+            while (Ptr < End && State == TriviaState::BlockComment) {
+                char C = *Ptr++;
+                if (CommentPending == '*' && C == '/') {
+                    CommentPending = 0;
+                    if (--CommentDepth == 0)
+                        State = TriviaState::Normal;
+                    continue;
+                }
+                if (CommentPending == '/' && C == '*') {
+                    CommentPending = 0;
+                    ++CommentDepth;
+                    continue;
+                }
+                CommentPending = 0;
+                if (C == '*' || C == '/')
+                    CommentPending = C;
+                else if (C == '\0')
+                    State = TriviaState::Normal; // незавершённый комментарий
+            }
+            if (State == TriviaState::BlockComment) {
+                NeedMore = true;
+                return static_cast<size_t>(Ptr - Start);
+            }
+            break;
+
+        case TriviaState::Normal:
+            while (Ptr < End) {
+                char C = *Ptr;
+                if (C == '/' || (C == '#' && AtStreamStart && Ptr == Start)) {
+                    if (Ptr + 1 == End && !StreamEnded) {
+                        // Нужен следующий байт, чтобы понять, комментарий ли это.
+                        NeedMore = true;
+                        return static_cast<size_t>(Ptr - Start);
+                    }
+                    if (C == '#') {
+                        if (Ptr[1] != '!')
+                            return static_cast<size_t>(Ptr - Start);
+                        Ptr += 2;
+                        State = TriviaState::LineComment;
+                        break;
+                    }
+                    if (Ptr[1] == '/') {
+                        Ptr += 2;
+                        State = TriviaState::LineComment;
+                        break;
+                    }
+                    if (Ptr[1] == '*') {
+                        Ptr += 2;
+                        State = TriviaState::BlockComment;
+                        CommentDepth = 1;
+                        CommentPending = 0;
+                        break;
+                    }
+                    return static_cast<size_t>(Ptr - Start);
+                }
+                if (!isTriviaByte(C))
+                    return static_cast<size_t>(Ptr - Start);
+                ++Ptr;
+            }
+            if (State == TriviaState::Normal) {
+                NeedMore = true;
+                return static_cast<size_t>(Ptr - Start);
+            }
+            break;
+        }
+    }
+}
@@ -0,0 +1,154 @@
+#include <algorithm>
+#include "AST/Decl.h"
+#include "AST/Types.h"
+#include "Runtime/Layout.h"
+
+namespace {
+
+TypeLayout makeScalar(uint32_t Size, bool IsRef = false) {
+    TypeLayout L;
+    L.Size = L.Alignment = Size;
+    if (IsRef)
+        L.RefOffsets.push_back(0);
+    return L;
+}
+
+uint32_t alignTo(uint32_t Value, uint32_t Alignment) {
+    return (Value + Alignment - 1) / Alignment * Alignment;
+}
+
+} // namespace
+
+const FieldLayout *NominalLayout::getField(Identifier FieldName) const {
+    for (const FieldLayout &Field : Fields)
+        if (Field.Name == FieldName)
+            return &Field;
+    return nullptr;
+}
+
+LayoutContext::LayoutContext()
+    : IntLayout(makeScalar(8)), DoubleLayout(makeScalar(8)), BoolLayout(makeScalar(1)),
+      RefLayout(makeScalar(sizeof(HeapObject *), /*IsRef=*/true)) {}
+
+void LayoutContext::addStruct(const StructDecl *D) {
+    Structs[D->getName()] = D;
+}
+
+void LayoutContext::addClass(Identifier Name, ArrayRef<Decl *> Members) {
+    Classes[Name] = Members;
+}
+
+const TypeLayout *LayoutContext::getLayout(TypeBase *T, std::string &Error) {
+    switch (T->getKind()) {
+    case TypeKind::Int:
+        return &IntLayout;
+    case TypeKind::Double:
+        return &DoubleLayout;
+    case TypeKind::Bool:
+        return &BoolLayout;
+    case TypeKind::Struct: {
+        const NominalLayout *L = getNominalLayout(cast<StructType>(T)->getName(), Error);
+        return L ? &L->Value : nullptr;
+    }
+    case TypeKind::Class: {
+        // Поля объекта для ссылки не нужны: класс может хранить ссылку
+        // на себя, и считать его раскладку здесь нельзя.
+        Identifier Name = cast<ClassType>(T)->getName();
+        if (!Classes.count(Name)) {
+            Error = "unknown class '" + std::string(Name.str()) + "'";
+            return nullptr;
+        }
+        return &RefLayout;
+    }
+    default:
+        Error = "type has no runtime layout";
+        return nullptr;
+    }
+}
+
+const NominalLayout *LayoutContext::getNominalLayout(Identifier Name, std::string &Error) {
+    auto It = Layouts.find(Name);
+    if (It != Layouts.end())
+        return It->second.get();
+
+    auto S = Structs.find(Name);
+    if (S != Structs.end())
+        return computeLayout(Name, /*IsClass=*/false, S->second->getMembers(), Error);
+    auto C = Classes.find(Name);
+    if (C != Classes.end())
+        return computeLayout(Name, /*IsClass=*/true, C->second, Error);
+    Error = "unknown type '" + std::string(Name.str()) + "'";
+    return nullptr;
+}
+
+const ClassMetadata *LayoutContext::getClassMetadata(Identifier Name, std::string &Error) {
+    const NominalLayout *L = getNominalLayout(Name, Error);
+    if (!L)
+        return nullptr;
+    if (!L->IsClass) {
+        Error = "'" + std::string(Name.str()) + "' is not a class";
+        return nullptr;
+    }
+    return L->Metadata.get();
+}
+
+NominalLayout *LayoutContext::computeLayout(Identifier Name, bool IsClass,
+                                            ArrayRef<Decl *> Members, std::string &Error) {
+    if (std::find(InProgress.begin(), InProgress.end(), Name) != InProgress.end()) {
+        Error = "struct '" + std::string(Name.str()) + "' contains itself and has infinite size";
+        return nullptr;
+    }
+    InProgress.push_back(Name);
+
+    auto Result = std::make_unique<NominalLayout>();
+    Result->Name = Name;
+    Result->IsClass = IsClass;
+
+    // Поля — в порядке объявления, каждое на своём выравнивании.
+    uint32_t Offset = IsClass ? HeapObjectHeaderSize : 0;
+    uint32_t Alignment = IsClass ? alignof(HeapObject) : 1;
+    std::vector<uint32_t> RefOffsets;
+    for (Decl *Member : Members) {
+        auto *Var = dyn_cast<VarDecl>(Member);
+        if (!Var)
+            continue;
+        if (!Var->getType()) {
+            Error = "stored property '" + std::string(Var->getName().str()) + "' of '" +
+                    std::string(Name.str()) + "' has no type";
+            InProgress.pop_back();
+            return nullptr;
+        }
+        const TypeLayout *FieldType = getLayout(Var->getType(), Error);
+        if (!FieldType) {
+            Error = std::string(Name.str()) + "." + std::string(Var->getName().str()) + ": " +
+                    Error;
+            InProgress.pop_back();
+            return nullptr;
+        }
+        Offset = alignTo(Offset, FieldType->Alignment);
+        Alignment = std::max(Alignment, FieldType->Alignment);
+        Result->Fields.push_back({Var->getName(), Var->getType(), Offset, FieldType});
+        for (uint32_t Ref : FieldType->RefOffsets)
+            RefOffsets.push_back(Offset + Ref);
+        Offset += FieldType->Size;
+    }
+    InProgress.pop_back();
+
+    if (IsClass) {
+        Result->Value = RefLayout;
+        auto Metadata = std::make_unique<ClassMetadata>();
+        Metadata->Name = std::string(Name.str());
+        Metadata->InstanceSize = alignTo(Offset, Alignment);
+        Metadata->InstanceAlignment = Alignment;
+        Metadata->RefOffsets = std::move(RefOffsets);
+        Result->Metadata = std::move(Metadata);
+    } else {
+        Result->Value.Size = Offset;
+        Result->Value.Alignment = Alignment;
+        Result->Value.RefOffsets = std::move(RefOffsets);
+    }
+
+    NominalLayout *L = Result.get();
+    Layouts[Name] = std::move(Result);
+    return L;
+}
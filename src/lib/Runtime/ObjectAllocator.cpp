@@ -0,0 +1,70 @@
+#include <cassert>
+#include <cstdlib>
+#include <new>
+#include <ostream>
+#include "Runtime/ObjectAllocator.h"
+
+ObjectAllocator::~ObjectAllocator() {
+    for (void *Slab : Slabs)
+        std::free(Slab);
+}
+
+void *ObjectAllocator::allocateFromSlab(size_t BlockSize) {
+    if (static_cast<size_t>(End - CurPtr) < BlockSize) {
+        // Остаток старого слэба не раздаётся: он меньше самого крупного
+        // класса и в сумме не превышает процента от слэбов.
+        void *Slab = std::aligned_alloc(SizeClassGranule, SlabSize);
+        if (!Slab)
+            throw std::bad_alloc();
+        Slabs.push_back(Slab);
+        ++AllocStats.NumSlabs;
+        CurPtr = static_cast<char *>(Slab);
+        End = CurPtr + SlabSize;
+    }
+    void *Result = CurPtr;
+    CurPtr += BlockSize;
+    return Result;
+}
+
+void *ObjectAllocator::allocate(size_t Size) {
+    assert(Size && "zero-sized allocation");
+    ++AllocStats.NumAllocs;
+    if (Size > MaxPooledSize) {
+        ++AllocStats.NumLarge;
+        size_t Rounded = (Size + SizeClassGranule - 1) / SizeClassGranule * SizeClassGranule;
+        void *Result = std::aligned_alloc(SizeClassGranule, Rounded);
+        if (!Result)
+            throw std::bad_alloc();
+        return Result;
+    }
+
+    size_t Class = getSizeClass(Size);
+    if (FreeBlock *Block = FreeLists[Class]) {
+        FreeLists[Class] = Block->Next;
+        ++AllocStats.NumReused;
+        return Block;
+    }
+    return allocateFromSlab((Class + 1) * SizeClassGranule);
+}
+
+void ObjectAllocator::deallocate(void *Ptr, size_t Size) {
+    if (!Ptr)
+        return;
+    ++AllocStats.NumFrees;
+    if (Size > MaxPooledSize) {
+        std::free(Ptr);
+        return;
+    }
+    size_t Class = getSizeClass(Size);
+    auto *Block = static_cast<FreeBlock *>(Ptr);
+    Block->Next = FreeLists[Class];
+    FreeLists[Class] = Block;
+}
+
+void ObjectAllocator::printStats(std::ostream &OS) const {
+    OS << "*** Object Allocator Stats:\n";
+    OS << "  " << AllocStats.NumAllocs << " allocations, " << AllocStats.NumReused
+       << " reused from free lists, " << AllocStats.NumLarge << " large\n";
+    OS << "  " << AllocStats.NumFrees << " frees, " << AllocStats.NumSlabs << " slabs of "
+       << SlabSize / 1024 << " KiB\n";
+}
@@ -0,0 +1,84 @@
+#include <cassert>
+#include <cstring>
+#include <ostream>
+#include "Runtime/Runtime.h"
+
+namespace {
+
+HeapObject *&refAt(void *Base, uint32_t Offset) {
+    return *reinterpret_cast<HeapObject **>(static_cast<char *>(Base) + Offset);
+}
+
+} // namespace
+
+HeapObject *Runtime::allocObject(const ClassMetadata &Metadata) {
+    assert(Metadata.InstanceSize >= HeapObjectHeaderSize && "instance without a header");
+    assert(Metadata.InstanceAlignment <= ObjectAllocator::SizeClassGranule &&
+           "instance alignment is not supported by the allocator");
+    void *Memory = Allocator.allocate(Metadata.InstanceSize);
+    std::memset(Memory, 0, Metadata.InstanceSize);
+    auto *Object = static_cast<HeapObject *>(Memory);
+    Object->Metadata = &Metadata;
+    Object->RefCount = 1;
+    ++RuntimeStats.NumAllocs;
+    return Object;
+}
+
+void Runtime::release(HeapObject *Object) {
+    if (!Object)
+        return;
+    ++RuntimeStats.NumReleases;
+    assert(Object->RefCount && "releasing a dead object");
+    if (--Object->RefCount)
+        return;
+
+    // Уничтожение объекта отпускает его поля, и те могут уйти следом; если
+    // release вызван изнутри такого уничтожения (из deinit), объект ждёт
+    // своей очереди во внешнем цикле. Пустая очередь этого не показывает:
+    // уничтожаемый объект из неё уже вынут.
+    DestroyWorklist.push_back(Object);
+    if (Destroying)
+        return;
+    Destroying = true;
+    while (!DestroyWorklist.empty()) {
+        HeapObject *Dead = DestroyWorklist.back();
+        DestroyWorklist.pop_back();
+        destroy(Dead);
+    }
+    Destroying = false;
+}
+
+void Runtime::destroy(HeapObject *Object) {
+    const ClassMetadata &Metadata = *Object->Metadata;
+    if (Metadata.Deinit)
+        Metadata.Deinit(Object);
+    for (uint32_t Offset : Metadata.RefOffsets) {
+        HeapObject *Field = refAt(Object, Offset);
+        if (!Field)
+            continue;
+        ++RuntimeStats.NumReleases;
+        if (!--Field->RefCount)
+            DestroyWorklist.push_back(Field);
+    }
+    Allocator.deallocate(Object, Metadata.InstanceSize);
+    ++RuntimeStats.NumDeallocs;
+}
+
+void Runtime::copyValue(void *Dest, const void *Src, const TypeLayout &L) {
+    std::memcpy(Dest, Src, L.Size);
+    for (uint32_t Offset : L.RefOffsets)
+        retain(refAt(Dest, Offset));
+}
+
+void Runtime::destroyValue(void *Value, const TypeLayout &L) {
+    for (uint32_t Offset : L.RefOffsets)
+        release(refAt(Value, Offset));
+}
+
+void Runtime::printStats(std::ostream &OS) const {
+    OS << "*** Runtime Stats:\n";
+    OS << "  " << RuntimeStats.NumAllocs << " objects allocated, " << RuntimeStats.NumDeallocs
+       << " freed, " << getNumLiveObjects() << " live\n";
+    OS << "  " << RuntimeStats.NumRetains << " retains, " << RuntimeStats.NumReleases
+       << " releases\n";
+}
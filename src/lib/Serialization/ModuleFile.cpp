@@ -0,0 +1,220 @@
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Basic/Hashing.h"
+#include "Serialization/ModuleFile.h"
+
+using namespace module_format;
+
+ModuleFile::ModuleFile(const char *data, size_t size, ASTContext &ctx)
+    : Data(data), Size(size), Ctx(ctx),
+      Hdr(reinterpret_cast<const Header *>(data)) {}
+
+ModuleFile::~ModuleFile() {
+    ::munmap(const_cast<char *>(Data), Size);
+}
+
+std::unique_ptr<ModuleFile> ModuleFile::open(const std::string &Path, ASTContext &Ctx,
+                                             std::string &Error) {
+    int FD = ::open(Path.c_str(), O_RDONLY);
+    if (FD < 0) {
+        Error = "can not open module file: " + Path;
+        return nullptr;
+    }
+
+    struct stat St;
+    if (::fstat(FD, &St) < 0 || St.st_size < static_cast<off_t>(sizeof(Header))) {
+        ::close(FD);
+        Error = "module file is truncated: " + Path;
+        return nullptr;
+    }
+
+    size_t Size = static_cast<size_t>(St.st_size);
+    void *Mem = ::mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, FD, 0);
+    ::close(FD);
+    if (Mem == MAP_FAILED) {
+        Error = "can not map module file: " + Path;
+        return nullptr;
+    }
+
+    std::unique_ptr<ModuleFile> File(new ModuleFile(static_cast<const char *>(Mem), Size, Ctx));
+    if (!File->validateHeader(Error))
+        return nullptr;
+
+    File->Identifiers.resize(File->Hdr->NumIdentifiers);
+    File->Types.resize(File->Hdr->NumTypes, nullptr);
+    return File;
+}
+
+bool ModuleFile::validateHeader(std::string &Error) const {
+    if (std::memcmp(Hdr->Magic, Magic, sizeof(Magic)) != 0) {
+        Error = "not a SwiftMini module file";
+        return false;
+    }
+    if (Hdr->Version != Version) {
+        Error = "unsupported module format version " + std::to_string(Hdr->Version);
+        return false;
+    }
+    if (Hdr->FileSize != Size) {
+        Error = "module file size does not match its header";
+        return false;
+    }
+
+    // Таблицы должны целиком лежать в файле; сами записи проверяются при
+    // чтении.
+    auto fits = [this](uint32_t Offset, uint64_t Count, uint64_t EltSize) {
+        return Offset % 4 == 0 && Offset + Count * EltSize <= Size;
+    };
+    if (!fits(Hdr->IdentifierOffsets, Hdr->NumIdentifiers, sizeof(uint32_t)) ||
+        !fits(Hdr->TypeOffsets, Hdr->NumTypes, sizeof(uint32_t)) ||
+        !fits(Hdr->DeclRecords, Hdr->NumDecls, sizeof(DeclRecord)) ||
+        !fits(Hdr->DeclHashTable, Hdr->NumBuckets, sizeof(uint32_t)) ||
+        Hdr->NumBuckets == 0 || (Hdr->NumBuckets & (Hdr->NumBuckets - 1)) != 0 ||
+        Hdr->ModuleName >= Hdr->NumIdentifiers) {
+        Error = "module file is corrupted";
+        return false;
+    }
+    return true;
+}
+
+uint32_t ModuleFile::readU32(uint32_t Offset) const {
+    uint32_t Value;
+    std::memcpy(&Value, Data + Offset, sizeof(Value));
+    return Value;
+}
+
+std::string_view ModuleFile::getIdentifierText(IdentifierID ID) const {
+    if (ID >= Hdr->NumIdentifiers)
+        return {};
+    uint32_t Offset = readU32(Hdr->IdentifierOffsets + ID * sizeof(uint32_t));
+    if (uint64_t(Offset) + sizeof(uint32_t) > Size)
+        return {};
+    uint32_t Length = readU32(Offset);
+    if (uint64_t(Offset) + sizeof(uint32_t) + Length > Size)
+        return {};
+    return {Data + Offset + sizeof(uint32_t), Length};
+}
+
+Identifier ModuleFile::getIdentifier(IdentifierID ID) {
+    if (ID >= Identifiers.size())
+        return Identifier();
+    Identifier &Cached = Identifiers[ID];
+    if (Cached.empty())
+        Cached = Ctx.getIdentifier(getIdentifierText(ID));
+    return Cached;
+}
+
+TypeBase *ModuleFile::getType(TypeID ID) {
+    if (ID >= Types.size())
+        return nullptr;
+    if (TypeBase *Cached = Types[ID])
+        return Cached;
+
+    uint32_t Offset = readU32(Hdr->TypeOffsets + ID * sizeof(uint32_t));
+    if (Offset % 4 != 0 || uint64_t(Offset) + sizeof(TypeRecord) > Size)
+        return nullptr;
+    TypeRecord Record;
+    std::memcpy(&Record, Data + Offset, sizeof(Record));
+    uint32_t OperandsOffset = Offset + sizeof(TypeRecord);
+    if (uint64_t(OperandsOffset) + uint64_t(Record.NumOperands) * sizeof(uint32_t) > Size)
+        return nullptr;
+    auto operand = [&](uint32_t I) {
+        return readU32(OperandsOffset + I * sizeof(uint32_t));
+    };
+
+    // Операнды всегда имеют меньший номер, чем сам тип (так пишет
+    // ModuleWriter), это же защищает от циклов в повреждённом файле.
+    auto operandType = [&](uint32_t I) -> TypeBase * {
+        TypeID OpID = operand(I);
+        return OpID < ID ? getType(OpID) : nullptr;
+    };
+
+    TypeBase *Result = nullptr;
+    switch (static_cast<TypeKind>(Record.Kind)) {
+      #define BUILTIN_TYPE(Id, Name)                                          \
+      case TypeKind::Id:                                                      \
+        Result = Ctx.get##Id##Type();                                         \
+        break;
+      #define NOMINAL_TYPE(Id, Parent)                                        \
+      case TypeKind::Id:                                                      \
+        if (Record.NumOperands == 1) {                                        \
+            Identifier Name = getIdentifier(operand(0));                      \
+            if (!Name.empty())                                                \
+                Result = Ctx.get##Id##Type(Name);                             \
+        }                                                                     \
+        break;
+      #include "AST/TypeNodes.def"
+
+    case TypeKind::Function: {
+        if (Record.NumOperands == 0)
+            break;
+        TypeBase *ResultType = operandType(0);
+        std::vector<TypeBase *> Params;
+        for (uint32_t I = 1; I < Record.NumOperands; ++I)
+            Params.push_back(operandType(I));
+        bool Valid = ResultType != nullptr;
+        for (TypeBase *Param : Params)
+            Valid &= Param != nullptr;
+        if (Valid)
+            Result = Ctx.getFunctionType(Params, ResultType);
+        break;
+    }
+    case TypeKind::Tuple: {
+        std::vector<TypeBase *> Elements;
+        bool Valid = true;
+        for (uint32_t I = 0; I < Record.NumOperands; ++I) {
+            Elements.push_back(operandType(I));
+            Valid &= Elements.back() != nullptr;
+        }
+        if (Valid)
+            Result = Ctx.getTupleType(Elements);
+        break;
+    }
+    case TypeKind::InOut:
+        if (Record.NumOperands == 1) {
+            TypeBase *Object = operandType(0);
+            if (Object && !isa<InOutType>(Object))
+                Result = Ctx.getInOutType(Object);
+        }
+        break;
+    }
+
+    if (Result) {
+        Types[ID] = Result;
+        ++NumLoadedTypes;
+    }
+    return Result;
+}
+
+Identifier ModuleFile::getModuleName() { return getIdentifier(Hdr->ModuleName); }
+
+ModuleFile::Decl ModuleFile::getDecl(unsigned Index) {
+    if (Index >= Hdr->NumDecls)
+        return {DeclKind::Let, Identifier(), nullptr};
+    DeclRecord Record;
+    std::memcpy(&Record, Data + Hdr->DeclRecords + Index * sizeof(DeclRecord),
+                sizeof(Record));
+    return {static_cast<DeclKind>(Record.Kind), getIdentifier(Record.Name),
+            getType(Record.Type)};
+}
+
+std::optional<ModuleFile::Decl> ModuleFile::lookup(std::string_view Name) {
+    uint32_t Mask = Hdr->NumBuckets - 1;
+    uint32_t Index = static_cast<uint32_t>(hashBytes(Name)) & Mask;
+    for (uint32_t Probe = 0; Probe != Hdr->NumBuckets; ++Probe) {
+        uint32_t Entry = readU32(Hdr->DeclHashTable + Index * sizeof(uint32_t));
+        if (Entry == 0 || Entry > Hdr->NumDecls)
+            return std::nullopt;
+
+        // Сравниваем текст прямо в отображённом файле, не интернируя чужие имена.
+        DeclRecord Record;
+        std::memcpy(&Record, Data + Hdr->DeclRecords + (Entry - 1) * sizeof(DeclRecord),
+                    sizeof(Record));
+        if (getIdentifierText(Record.Name) == Name)
+            return getDecl(Entry - 1);
+        Index = (Index + 1) & Mask;
+    }
+    return std::nullopt;
+}
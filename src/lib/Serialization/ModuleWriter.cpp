@@ -0,0 +1,183 @@
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <unordered_map>
+#include "Basic/Hashing.h"
+#include "Serialization/ModuleWriter.h"
+
+using namespace module_format;
+
+namespace {
+
+// Serializer - Назначает номера именам и типам и раскладывает файл.
+class Serializer {
+    std::string Out;
+
+    std::unordered_map<const char *, IdentifierID> IdentifierIDs;
+    std::vector<Identifier> IdentifierList;
+
+    std::unordered_map<TypeBase *, TypeID> TypeIDs;
+    std::vector<TypeBase *> TypeList;
+
+public:
+    IdentifierID addIdentifier(Identifier Id) {
+        auto Result = IdentifierIDs.insert(
+            {Id.get(), static_cast<IdentifierID>(IdentifierList.size())});
+        if (Result.second)
+            IdentifierList.push_back(Id);
+        return Result.first->second;
+    }
+
+    // addType - Номер типа; операнды получают номера раньше самого типа.
+    TypeID addType(TypeBase *T) {
+        auto It = TypeIDs.find(T);
+        if (It != TypeIDs.end())
+            return It->second;
+
+        if (auto *Nominal = dyn_cast<NominalType>(T))
+            addIdentifier(Nominal->getName());
+        else if (auto *Fn = dyn_cast<FunctionType>(T)) {
+            addType(Fn->getResult());
+            for (TypeBase *Param : Fn->getParams())
+                addType(Param);
+        } else if (auto *Tuple = dyn_cast<TupleType>(T)) {
+            for (TypeBase *Elt : Tuple->getElements())
+                addType(Elt);
+        } else if (auto *InOut = dyn_cast<InOutType>(T))
+            addType(InOut->getObjectType());
+
+        TypeID ID = static_cast<TypeID>(TypeList.size());
+        TypeIDs[T] = ID;
+        TypeList.push_back(T);
+        return ID;
+    }
+
+    uint32_t offset() const { return static_cast<uint32_t>(Out.size()); }
+
+    void align() { Out.append((4 - Out.size() % 4) % 4, '\0'); }
+
+    void appendU32(uint32_t Value) { appendRaw(&Value, sizeof(Value)); }
+
+    void appendRaw(const void *Bytes, size_t Size) {
+        Out.append(static_cast<const char *>(Bytes), Size);
+    }
+
+    void patchU32(uint32_t Offset, uint32_t Value) {
+        std::memcpy(&Out[Offset], &Value, sizeof(Value));
+    }
+
+    std::string take() { return std::move(Out); }
+
+    // writeIdentifiers - Данные имён и таблица смещений.
+    std::pair<uint32_t, uint32_t> writeIdentifiers() {
+        std::vector<uint32_t> Offsets;
+        for (Identifier Id : IdentifierList) {
+            Offsets.push_back(offset());
+            std::string_view Text = Id.str();
+            appendU32(static_cast<uint32_t>(Text.size()));
+            appendRaw(Text.data(), Text.size());
+            Out += '\0';
+            align();
+        }
+        uint32_t Table = offset();
+        for (uint32_t Offset : Offsets)
+            appendU32(Offset);
+        return {static_cast<uint32_t>(IdentifierList.size()), Table};
+    }
+
+    std::pair<uint32_t, uint32_t> writeTypes() {
+        std::vector<uint32_t> Offsets;
+        for (TypeBase *T : TypeList) {
+            Offsets.push_back(offset());
+            std::vector<uint32_t> Operands;
+            if (auto *Nominal = dyn_cast<NominalType>(T))
+                Operands.push_back(IdentifierIDs.at(Nominal->getName().get()));
+            else if (auto *Fn = dyn_cast<FunctionType>(T)) {
+                Operands.push_back(TypeIDs.at(Fn->getResult()));
+                for (TypeBase *Param : Fn->getParams())
+                    Operands.push_back(TypeIDs.at(Param));
+            } else if (auto *Tuple = dyn_cast<TupleType>(T)) {
+                for (TypeBase *Elt : Tuple->getElements())
+                    Operands.push_back(TypeIDs.at(Elt));
+            } else if (auto *InOut = dyn_cast<InOutType>(T))
+                Operands.push_back(TypeIDs.at(InOut->getObjectType()));
+
+            TypeRecord Record{};
+            Record.Kind = static_cast<uint8_t>(T->getKind());
+            Record.NumOperands = static_cast<uint32_t>(Operands.size());
+            appendRaw(&Record, sizeof(Record));
+            for (uint32_t Op : Operands)
+                appendU32(Op);
+        }
+        uint32_t Table = offset();
+        for (uint32_t Offset : Offsets)
+            appendU32(Offset);
+        return {static_cast<uint32_t>(TypeList.size()), Table};
+    }
+};
+
+} // namespace
+
+std::string ModuleWriter::serialize() const {
+    Serializer S;
+
+    IdentifierID NameID = S.addIdentifier(ModuleName);
+    std::vector<DeclRecord> Records;
+    for (const PendingDecl &D : Decls) {
+        DeclRecord Record{};
+        Record.Name = S.addIdentifier(D.Name);
+        Record.Type = S.addType(D.Type);
+        Record.Kind = static_cast<uint8_t>(D.Kind);
+        Records.push_back(Record);
+    }
+
+    Header Hdr{};
+    std::memcpy(Hdr.Magic, Magic, sizeof(Magic));
+    Hdr.Version = Version;
+    Hdr.ModuleName = NameID;
+    S.appendRaw(&Hdr, sizeof(Hdr));
+
+    auto [NumIdentifiers, IdentifierTable] = S.writeIdentifiers();
+    auto [NumTypes, TypeTable] = S.writeTypes();
+
+    uint32_t DeclTable = S.offset();
+    for (const DeclRecord &Record : Records)
+        S.appendRaw(&Record, sizeof(Record));
+
+    // Хеш-таблица имён с линейным пробированием, заполнение не выше 1/2.
+    uint32_t NumBuckets = 1;
+    while (NumBuckets < Records.size() * 2)
+        NumBuckets *= 2;
+    std::vector<uint32_t> Buckets(NumBuckets, 0);
+    for (size_t I = 0; I != Decls.size(); ++I) {
+        size_t Index = hashBytes(Decls[I].Name.str()) & (NumBuckets - 1);
+        while (Buckets[Index])
+            Index = (Index + 1) & (NumBuckets - 1);
+        Buckets[Index] = static_cast<uint32_t>(I + 1);
+    }
+    uint32_t HashTable = S.offset();
+    for (uint32_t Bucket : Buckets)
+        S.appendU32(Bucket);
+
+    uint32_t FileSize = S.offset();
+    S.patchU32(offsetof(Header, FileSize), FileSize);
+    S.patchU32(offsetof(Header, NumIdentifiers), NumIdentifiers);
+    S.patchU32(offsetof(Header, IdentifierOffsets), IdentifierTable);
+    S.patchU32(offsetof(Header, NumTypes), NumTypes);
+    S.patchU32(offsetof(Header, TypeOffsets), TypeTable);
+    S.patchU32(offsetof(Header, NumDecls), static_cast<uint32_t>(Records.size()));
+    S.patchU32(offsetof(Header, DeclRecords), DeclTable);
+    S.patchU32(offsetof(Header, NumBuckets), NumBuckets);
+    S.patchU32(offsetof(Header, DeclHashTable), HashTable);
+    return S.take();
+}
+
+bool ModuleWriter::writeToFile(const std::string &Path) const {
+    std::string Image = serialize();
+    std::ofstream File(Path, std::ios::binary | std::ios::trunc);
+    if (!File.is_open())
+        return false;
+    File.write(Image.data(), static_cast<std::streamsize>(Image.size()));
+    return static_cast<bool>(File);
+}
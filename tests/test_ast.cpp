@@ -0,0 +1,227 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "AST/ASTContext.h"
+#include "AST/ASTVisitor.h"
+#include "AST/ASTWalker.h"
+#include "AST/FlatAST.h"
+
+class ASTTest : public ::testing::Test {
+protected:
+    ASTContext Ctx;
+
+    Identifier id(const char *Name) { return Ctx.getIdentifier(Name); }
+
+    Expr *ref(const char *Name) { return new (Ctx) DeclRefExpr(id(Name)); }
+    Expr *lit(int64_t Value) { return new (Ctx) IntegerLiteralExpr(Value); }
+    Expr *binary(const char *Op, Expr *LHS, Expr *RHS) {
+        return new (Ctx) BinaryExpr(id(Op), LHS, RHS);
+    }
+    BraceStmt *brace(std::vector<Node *> Elements) {
+        return new (Ctx) BraceStmt(Ctx.allocateCopy<Node *>(Elements));
+    }
+
+    // makeSum - func sum(n: Int) {
+    //   var s = 0
+    //   var i = 0
+    //   while i < n { s = s + i; i = i + 1 }
+    //   return s
+    // }
+    FuncDecl *makeSum() {
+        ParamDecl *N = new (Ctx) ParamDecl(id("n"), Ctx.getIntType());
+        auto *S = new (Ctx) VarDecl(id("s"), false, nullptr, lit(0));
+        auto *I = new (Ctx) VarDecl(id("i"), false, nullptr, lit(0));
+        auto *Loop = new (Ctx) WhileStmt(
+            binary("<", ref("i"), ref("n")),
+            brace({new (Ctx) AssignExpr(ref("s"), binary("+", ref("s"), ref("i"))),
+                   new (Ctx) AssignExpr(ref("i"), binary("+", ref("i"), lit(1)))}));
+        BraceStmt *Body = brace({S, I, Loop, new (Ctx) ReturnStmt(ref("s"))});
+        return new (Ctx) FuncDecl(id("sum"), Ctx.allocateCopy<ParamDecl *>({N}), Body);
+    }
+};
+
+namespace {
+
+// KindCounter - Переопределяет только часть методов; остальные узлы
+// поднимаются по иерархии до visitDecl/visitStmt/visitNode.
+class KindCounter : public ASTVisitor<KindCounter, const char *> {
+public:
+    const char *visitVarDecl(VarDecl *) { return "var"; }
+    const char *visitValueDecl(ValueDecl *) { return "value"; }
+    const char *visitLiteralExpr(LiteralExpr *) { return "literal"; }
+    const char *visitStmt(Stmt *) { return "stmt"; }
+};
+
+class Evaluator : public ASTVisitor<Evaluator, int64_t, int64_t> {
+public:
+    int64_t visitIntegerLiteralExpr(IntegerLiteralExpr *E, int64_t) { return E->getValue(); }
+    int64_t visitDeclRefExpr(DeclRefExpr *, int64_t X) { return X; }
+    int64_t visitBinaryExpr(BinaryExpr *E, int64_t X) {
+        int64_t L = visit(E->getLHS(), X), R = visit(E->getRHS(), X);
+        return E->getOperator().str() == "+" ? L + R : L * R;
+    }
+};
+
+class TraceWalker : public ASTWalker<TraceWalker> {
+public:
+    std::vector<std::string> Trace;
+    bool SkipLoops = false;
+
+    bool walkToDeclPre(Decl *D) {
+        Trace.push_back(std::string("+") + Node::getKindName(D->getKind()));
+        return true;
+    }
+    void walkToDeclPost(Decl *D) {
+        Trace.push_back(std::string("-") + Node::getKindName(D->getKind()));
+    }
+    bool walkToStmtPre(Stmt *S) {
+        Trace.push_back(std::string("+") + Node::getKindName(S->getKind()));
+        return !(SkipLoops && isa<WhileStmt>(S));
+    }
+};
+
+class ExprCounter : public ASTVisitor<ExprCounter> {
+public:
+    unsigned Refs = 0, Literals = 0, Other = 0;
+
+    void visitDeclRefExpr(DeclRefExpr *) { ++Refs; }
+    void visitLiteralExpr(LiteralExpr *) { ++Literals; }
+    void visitNode(Node *) { ++Other; }
+};
+
+} // namespace
+
+TEST_F(ASTTest, CastingFollowsNodeRanges) {
+    FuncDecl *F = makeSum();
+    Node *N = F;
+    EXPECT_TRUE(isa<Decl>(N));
+    EXPECT_TRUE(isa<ValueDecl>(N));
+    EXPECT_FALSE(isa<Stmt>(N));
+    EXPECT_EQ(dyn_cast<VarDecl>(N), nullptr);
+    EXPECT_EQ(cast<FuncDecl>(N)->getParams().size(), 1u);
+
+    Node *Lit = lit(3);
+    EXPECT_TRUE(isa<Expr>(Lit));
+    EXPECT_TRUE(isa<LiteralExpr>(Lit));
+    EXPECT_FALSE(isa<LiteralExpr>(ref("x")));
+    EXPECT_TRUE(isa<Stmt>(F->getBody()));
+}
+
+TEST_F(ASTTest, VisitorFallsBackToParent) {
+    KindCounter V;
+    EXPECT_STREQ(V.visit(new (Ctx) VarDecl(id("x"), true)), "var");
+    EXPECT_STREQ(V.visit(new (Ctx) ParamDecl(id("p"), nullptr)), "value");
+    EXPECT_STREQ(V.visit(new (Ctx) BooleanLiteralExpr(true)), "literal");
+    EXPECT_STREQ(V.visit(new (Ctx) BreakStmt()), "stmt");
+    // visitNode по умолчанию возвращает RetTy().
+    EXPECT_EQ(V.visit(ref("x")), nullptr);
+}
+
+TEST_F(ASTTest, VisitorPassesExtraArguments) {
+    // (x + 2) * x
+    Expr *E = binary("*", binary("+", ref("x"), lit(2)), ref("x"));
+    EXPECT_EQ(Evaluator().visit(E, 5), 35);
+    EXPECT_EQ(Evaluator().visit(E, 1), 3);
+}
+
+TEST_F(ASTTest, WalkerVisitsInSourceOrder) {
+    TraceWalker W;
+    W.walk(makeSum());
+    std::vector<std::string> Expected = {
+        "+FuncDecl", "+ParamDecl", "-ParamDecl", "+BraceStmt", "+VarDecl", "-VarDecl",
+        "+VarDecl", "-VarDecl", "+WhileStmt", "+BraceStmt", "+ReturnStmt", "-FuncDecl"};
+    EXPECT_EQ(W.Trace, Expected);
+}
+
+TEST_F(ASTTest, WalkerSkipsChildrenWhenPreReturnsFalse) {
+    TraceWalker W;
+    W.SkipLoops = true;
+    W.walk(makeSum());
+    std::vector<std::string> Expected = {
+        "+FuncDecl", "+ParamDecl", "-ParamDecl", "+BraceStmt", "+VarDecl", "-VarDecl",
+        "+VarDecl", "-VarDecl", "+WhileStmt", "+ReturnStmt", "-FuncDecl"};
+    EXPECT_EQ(W.Trace, Expected);
+}
+
+TEST_F(ASTTest, FlatBodyIsPostOrder) {
+    FuncDecl *F = makeSum();
+    FlatBody Flat = FlatBody::build(F);
+    ASSERT_EQ(Flat.size(), 24u);
+
+    const FlatNode &Root = Flat[Flat.getRootIndex()];
+    EXPECT_EQ(Root.N, F);
+    EXPECT_EQ(Root.SubtreeSize, Flat.size());
+    EXPECT_EQ(Root.Parent, FlatBody::NoParent);
+    EXPECT_EQ(Flat[0].Kind, NodeKind::ParamDecl);
+
+    // Каждый ребёнок стоит раньше родителя и внутри его отрезка.
+    for (uint32_t I = 0; I != Flat.size(); ++I) {
+        if (I == Flat.getRootIndex())
+            continue;
+        uint32_t P = Flat[I].Parent;
+        ASSERT_GT(P, I);
+        EXPECT_GE(I, P + 1 - Flat[P].SubtreeSize);
+    }
+
+    std::vector<uint32_t> Children = Flat.getChildren(Flat.getRootIndex());
+    ASSERT_EQ(Children.size(), 2u);
+    EXPECT_EQ(Flat[Children[0]].N, F->getParams()[0]);
+    EXPECT_EQ(Flat[Children[1]].N, F->getBody());
+
+    std::vector<uint32_t> Body = Flat.getChildren(Children[1]);
+    ASSERT_EQ(Body.size(), 4u);
+    EXPECT_EQ(Flat[Body[0]].Kind, NodeKind::VarDecl);
+    EXPECT_EQ(Flat[Body[2]].Kind, NodeKind::WhileStmt);
+    EXPECT_EQ(Flat[Body[3]].Kind, NodeKind::ReturnStmt);
+    EXPECT_TRUE(Flat.getChildren(0).empty());
+}
+
+TEST_F(ASTTest, FlatBodyDrivesVisitor) {
+    FlatBody Flat = FlatBody::build(makeSum());
+    ExprCounter Counter;
+    Flat.visitPostOrder(Counter);
+    EXPECT_EQ(Counter.Refs, 8u);
+    EXPECT_EQ(Counter.Literals, 3u);
+    EXPECT_EQ(Counter.Refs + Counter.Literals + Counter.Other, Flat.size());
+    EXPECT_TRUE(FlatBody::build(nullptr).empty());
+
+    // Имена, операторы и значения литералов видны без обращения к узлам.
+    unsigned RefsToS = 0, Pluses = 0;
+    int64_t LiteralSum = 0;
+    for (const FlatNode &Entry : Flat) {
+        if (Entry.Kind == NodeKind::DeclRefExpr)
+            RefsToS += Entry.getName() == id("s");
+        else if (Entry.Kind == NodeKind::BinaryExpr)
+            Pluses += Entry.getName() == id("+");
+        else if (Entry.Kind == NodeKind::IntegerLiteralExpr)
+            LiteralSum += Entry.IntValue;
+    }
+    EXPECT_EQ(RefsToS, 3u);
+    EXPECT_EQ(Pluses, 2u);
+    EXPECT_EQ(LiteralSum, 1);
+    EXPECT_EQ(Flat[Flat.getRootIndex()].getName(), id("sum"));
+}
+
+TEST_F(ASTTest, Dump) {
+    auto *Call = new (Ctx) CallExpr(ref("print"), Ctx.allocateCopy<Expr *>({
+        new (Ctx) StringLiteralExpr("hi"),
+        new (Ctx) MemberRefExpr(ref("p"), id("x"))}));
+    Call->setType(Ctx.getVoidType());
+    auto *Let = new (Ctx) VarDecl(id("k"), true, Ctx.getIntType(), lit(1));
+
+    std::ostringstream OS;
+    brace({Let, new (Ctx) IfStmt(new (Ctx) BooleanLiteralExpr(true), brace({Call}))})->dump(OS);
+    EXPECT_EQ(OS.str(),
+              "(BraceStmt\n"
+              "  (VarDecl let k : Int\n"
+              "    (IntegerLiteralExpr 1))\n"
+              "  (IfStmt\n"
+              "    (BooleanLiteralExpr true)\n"
+              "    (BraceStmt\n"
+              "      (CallExpr : ()\n"
+              "        (DeclRefExpr print)\n"
+              "        (StringLiteralExpr \"hi\")\n"
+              "        (MemberRefExpr .x\n"
+              "          (DeclRefExpr p))))))\n");
+}
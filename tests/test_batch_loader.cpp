@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+#include "Driver/BatchLoader.h"
+#include "Parse/Lexer.h"
+
+// Каждый тест гоняется на обоих путях: io_uring (если ядро его даёт) и
+// пуле потоков.
+class BatchLoaderTest : public ::testing::TestWithParam<bool> {
+protected:
+    std::string Dir;
+    std::vector<std::string> Created;
+
+    void SetUp() override {
+        char Template[] = "/tmp/swiftmini-load-XXXXXX";
+        ASSERT_NE(mkdtemp(Template), nullptr);
+        Dir = Template;
+    }
+
+    void TearDown() override {
+        for (const std::string &Path : Created)
+            std::remove(Path.c_str());
+        rmdir(Dir.c_str());
+    }
+
+    std::string writeSource(const std::string &Name, const std::string &Text) {
+        std::string Path = Dir + "/" + Name;
+        std::ofstream(Path, std::ios::binary) << Text;
+        Created.push_back(Path);
+        return Path;
+    }
+
+    BatchLoader::Options options(unsigned QueueDepth) {
+        BatchLoader::Options Opts;
+        Opts.QueueDepth = QueueDepth;
+        Opts.NumThreads = 2;
+        Opts.ForceThreadPool = GetParam();
+        return Opts;
+    }
+};
+
+TEST_P(BatchLoaderTest, LoadsEveryFileWithSentinel) {
+    std::vector<std::string> Paths, Texts;
+    for (unsigned I = 0; I != 50; ++I) {
+        std::string N = std::to_string(I);
+        Texts.push_back("func f" + N + "() { return " + N + " }");
+        Paths.push_back(writeSource("f" + N + ".swiftMini", Texts.back()));
+    }
+    // Пустой файл и файл в мегабайт тоже получают сентинел.
+    Texts.push_back("");
+    Paths.push_back(writeSource("empty.swiftMini", ""));
+    Texts.push_back(std::string(1 << 20, 'x'));
+    Paths.push_back(writeSource("big.swiftMini", Texts.back()));
+
+    // Глубина меньше числа файлов: окно переиспользуется.
+    BatchLoader Loader(options(8));
+    if (GetParam()) {
+        EXPECT_EQ(Loader.getBackend(), BatchLoader::Backend::ThreadPool);
+    }
+    std::vector<unsigned> Seen(Paths.size(), 0);
+    Loader.load(Paths, [&](LoadedFile &File) {
+        ASSERT_LT(File.Index, Paths.size());
+        ++Seen[File.Index];
+        EXPECT_EQ(File.Errno, 0);
+        EXPECT_EQ(File.Path, Paths[File.Index]);
+        EXPECT_EQ(File.getContents(), Texts[File.Index]);
+        EXPECT_EQ(File.Data[File.Size], '\0');
+    });
+    for (unsigned Count : Seen)
+        EXPECT_EQ(Count, 1u);
+
+    const BatchLoader::Stats &S = Loader.getStats();
+    EXPECT_EQ(S.NumFiles, Paths.size());
+    EXPECT_EQ(S.NumFailed, 0u);
+    EXPECT_GT(S.NumSyscalls, 0u);
+    size_t Bytes = 0;
+    for (const std::string &Text : Texts)
+        Bytes += Text.size();
+    EXPECT_EQ(S.NumBytes, Bytes);
+}
+
+TEST_P(BatchLoaderTest, ReportsMissingFiles) {
+    std::vector<std::string> Paths = {writeSource("a.swiftMini", "let a = 1"),
+                                      Dir + "/missing.swiftMini",
+                                      writeSource("b.swiftMini", "let b = 2")};
+    BatchLoader Loader(options(4));
+    std::vector<int> Errors(Paths.size(), -1);
+    Loader.load(Paths, [&](LoadedFile &File) { Errors[File.Index] = File.Errno; });
+    EXPECT_EQ(Errors[0], 0);
+    EXPECT_EQ(Errors[1], ENOENT);
+    EXPECT_EQ(Errors[2], 0);
+    EXPECT_EQ(Loader.getStats().NumFailed, 1u);
+
+    // Тот же загрузчик можно использовать повторно.
+    unsigned Calls = 0;
+    Loader.load({Paths[0]}, [&](LoadedFile &) { ++Calls; });
+    EXPECT_EQ(Calls, 1u);
+    Loader.load({}, [&](LoadedFile &) { ++Calls; });
+    EXPECT_EQ(Calls, 1u);
+}
+
+TEST_P(BatchLoaderTest, BuffersGoStraightToLexer) {
+    std::vector<std::string> Paths = {writeSource("a.swiftMini", "let x = 42 + y"),
+                                      writeSource("b.swiftMini", "func f() {}")};
+    BatchLoader Loader(options(2));
+    std::vector<unsigned> Tokens(Paths.size());
+    std::unique_ptr<char[]> Kept;
+    Loader.load(Paths, [&](LoadedFile &File) {
+        Lexer L(File.getContents());
+        while (!L.lex().isEOF())
+            ++Tokens[File.Index];
+        if (File.Index == 0)
+            Kept = std::move(File.Data);
+    });
+    // Вместе с START_OF_FILE.
+    EXPECT_EQ(Tokens[0], 7u);
+    EXPECT_EQ(Tokens[1], 7u);
+    ASSERT_NE(Kept, nullptr);
+    EXPECT_STREQ(Kept.get(), "let x = 42 + y");
+}
+
+// Размер канала заранее неизвестен: читаем до EOF, а не до st_size == 0.
+TEST_P(BatchLoaderTest, ReadsPipesUntilEOF) {
+    std::string Fifo = Dir + "/pipe.swiftMini";
+    ASSERT_EQ(mkfifo(Fifo.c_str(), 0600), 0);
+    Created.push_back(Fifo);
+    // Больше начального буфера, чтобы он вырос хотя бы раз.
+    std::string Text;
+    while (Text.size() < 300 * 1024)
+        Text += "let x = " + std::to_string(Text.size()) + "\n";
+    std::thread Writer([&] {
+        std::ofstream Out(Fifo, std::ios::binary);
+        for (size_t I = 0; I < Text.size(); I += 4096)
+            Out << Text.substr(I, 4096) << std::flush;
+    });
+
+    std::vector<std::string> Paths = {Fifo, writeSource("a.swiftMini", "let a = 1"),
+                                      "/proc/self/stat"};
+    BatchLoader Loader(options(4));
+    std::vector<std::string> Contents(Paths.size());
+    Loader.load(Paths, [&](LoadedFile &File) {
+        EXPECT_EQ(File.Errno, 0) << File.Path;
+        EXPECT_EQ(File.Data[File.Size], '\0');
+        Contents[File.Index] = std::string(File.getContents());
+    });
+    Writer.join();
+    EXPECT_EQ(Contents[0], Text);
+    EXPECT_EQ(Contents[1], "let a = 1");
+    EXPECT_FALSE(Contents[2].empty());
+}
+
+INSTANTIATE_TEST_SUITE_P(Backends, BatchLoaderTest, ::testing::Values(false, true),
+                         [](const ::testing::TestParamInfo<bool> &Info) {
+                             return Info.param ? "ThreadPool" : "Default";
+                         });
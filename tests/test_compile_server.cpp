@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+#include "Driver/CompileServer.h"
+
+class CompileServerTest : public ::testing::Test {
+protected:
+    CompileServer Server;
+    std::string Path;
+
+    void SetUp() override {
+        char Template[] = "/tmp/swiftmini-server-XXXXXX";
+        int FD = mkstemp(Template);
+        ASSERT_GE(FD, 0);
+        close(FD);
+        Path = Template;
+        writeSource("let x = 42");
+    }
+
+    void TearDown() override { std::remove(Path.c_str()); }
+
+    void writeSource(const std::string &Text) {
+        std::ofstream(Path, std::ios::binary) << Text;
+    }
+};
+
+TEST_F(CompileServerTest, OpenLexesOnce) {
+    EXPECT_EQ(Server.handleRequest("open " + Path), "ok 5 tokens");
+    EXPECT_EQ(Server.handleRequest("open " + Path), "ok 5 tokens (cached)");
+    EXPECT_EQ(Server.getStats().NumLexes, 1u);
+}
+
+TEST_F(CompileServerTest, TokensComeFromCache) {
+    Server.handleRequest("open " + Path);
+    std::string Tokens = Server.handleRequest("tokens " + Path);
+    EXPECT_EQ(Tokens,
+              "ok 5\n"
+              "<kw_let> 0 3 let\n"
+              "<identifier> 4 1 x\n"
+              "<equal> 6 1 =\n"
+              "<integer_literal> 8 2 42\n"
+              "<EOF> 10 0 \n");
+    EXPECT_EQ(Server.getStats().NumLexes, 1u);
+}
+
+TEST_F(CompileServerTest, ChangeRelexesOnlyOnNewContent) {
+    Server.handleRequest("open " + Path);
+    EXPECT_EQ(Server.handleRequest("change " + Path + "\nlet x = 42"),
+              "ok 5 tokens (unchanged)");
+    EXPECT_EQ(Server.getStats().NumLexes, 1u);
+
+    EXPECT_EQ(Server.handleRequest("change " + Path + "\nvar y"), "ok 3 tokens");
+    EXPECT_EQ(Server.getStats().NumLexes, 2u);
+
+    // Без тела файл перечитывается с диска.
+    writeSource("func f");
+    EXPECT_EQ(Server.handleRequest("change " + Path), "ok 3 tokens");
+    EXPECT_EQ(Server.getStats().NumLexes, 3u);
+}
+
+TEST_F(CompileServerTest, IdentifiersAreFreedWithTheirFile) {
+    Server.handleRequest("change a.swiftMini\nlet foo = bar");
+    Server.handleRequest("change b.swiftMini\nvar foo = baz");
+    EXPECT_EQ(Server.getNumIdentifiers(), 4u);
+
+    // Новая версия не тащит за собой имена старой.
+    for (int I = 0; I != 100; ++I)
+        Server.handleRequest("change a.swiftMini\nlet v" + std::to_string(I));
+    EXPECT_EQ(Server.getNumIdentifiers(), 3u);
+
+    Server.handleRequest("close a.swiftMini");
+    Server.handleRequest("close b.swiftMini");
+    EXPECT_EQ(Server.getNumIdentifiers(), 0u);
+    EXPECT_EQ(Server.getIdentifierMemory(), 0u);
+    EXPECT_NE(Server.handleRequest("stats").find("identifier-bytes 0\n"),
+              std::string::npos);
+}
+
+TEST_F(CompileServerTest, Errors) {
+    EXPECT_EQ(Server.handleRequest("tokens " + Path), "error: file is not open: " + Path);
+    EXPECT_EQ(Server.handleRequest("open /nonexistent/file"),
+              "error: can not open file: /nonexistent/file");
+    EXPECT_EQ(Server.handleRequest("frobnicate"), "error: unknown request: frobnicate");
+}
+
+TEST_F(CompileServerTest, FramedSession) {
+    int ToServer[2], FromServer[2];
+    ASSERT_EQ(pipe(ToServer), 0);
+    ASSERT_EQ(pipe(FromServer), 0);
+
+    ASSERT_TRUE(writeFrame(ToServer[1], "change m.swiftMini\nlet a"));
+    ASSERT_TRUE(writeFrame(ToServer[1], "close m.swiftMini"));
+    ASSERT_TRUE(writeFrame(ToServer[1], "shutdown"));
+    ASSERT_TRUE(writeFrame(ToServer[1], "stats"));
+    close(ToServer[1]);
+
+    Server.serve(ToServer[0], FromServer[1]);
+    close(FromServer[1]);
+    EXPECT_TRUE(Server.isShutdownRequested());
+
+    FrameReader Reader(FromServer[0]);
+    std::string Response;
+    ASSERT_TRUE(Reader.read(Response));
+    EXPECT_EQ(Response, "ok 3 tokens");
+    ASSERT_TRUE(Reader.read(Response));
+    EXPECT_EQ(Response, "ok");
+    ASSERT_TRUE(Reader.read(Response));
+    EXPECT_EQ(Response, "ok");
+    // После shutdown запросы не обрабатываются.
+    EXPECT_FALSE(Reader.read(Response));
+
+    close(ToServer[0]);
+    close(FromServer[0]);
+}
+
+TEST_F(CompileServerTest, ClientHangupEndsOnlyItsConnection) {
+    // Ответ ушедшему клиенту — EPIPE, а не SIGPIPE, убивающий процесс.
+    int Pair[2];
+    ASSERT_EQ(socketpair(AF_UNIX, SOCK_STREAM, 0, Pair), 0);
+    close(Pair[1]);
+    EXPECT_FALSE(writeFrame(Pair[0], "ok"));
+    close(Pair[0]);
+
+    std::string Socket = Path + ".sock";
+    std::thread ServerThread([&] { EXPECT_TRUE(Server.serveUnixSocket(Socket)); });
+    auto connectToServer = [&] {
+        sockaddr_un Addr{};
+        Addr.sun_family = AF_UNIX;
+        std::memcpy(Addr.sun_path, Socket.c_str(), Socket.size() + 1);
+        int FD = socket(AF_UNIX, SOCK_STREAM, 0);
+        for (int Attempt = 0; Attempt != 1000; ++Attempt) {
+            if (connect(FD, reinterpret_cast<sockaddr *>(&Addr), sizeof(Addr)) == 0)
+                return FD;
+            usleep(1000);
+        }
+        close(FD);
+        return -1;
+    };
+
+    // Первый клиент просит токены и уходит, не читая ответ.
+    int First = connectToServer();
+    ASSERT_GE(First, 0);
+    ASSERT_TRUE(writeFrame(First, "change a.swiftMini\nlet a"));
+    close(First);
+
+    int Second = connectToServer();
+    ASSERT_GE(Second, 0);
+    ASSERT_TRUE(writeFrame(Second, "shutdown"));
+    FrameReader Reader(Second);
+    std::string Response;
+    EXPECT_TRUE(Reader.read(Response));
+    EXPECT_EQ(Response, "ok");
+    close(Second);
+    ServerThread.join();
+}
@@ -0,0 +1,166 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "Driver/DependencyGraph.h"
+
+class DependencyGraphTest : public ::testing::Test {
+protected:
+    std::string Dir;
+    std::vector<std::string> Created;
+
+    void SetUp() override {
+        char Template[] = "/tmp/swiftmini-deps-XXXXXX";
+        ASSERT_NE(mkdtemp(Template), nullptr);
+        Dir = Template;
+    }
+
+    void TearDown() override {
+        for (const std::string &Path : Created)
+            std::remove(Path.c_str());
+        rmdir(Dir.c_str());
+    }
+
+    std::string writeSource(const std::string &Name, const std::string &Text) {
+        std::string Path = Dir + "/" + Name;
+        std::ofstream(Path, std::ios::binary) << Text;
+        Created.push_back(Path);
+        return Path;
+    }
+
+    // build - Планирует сборку относительно Graph и делает её новой базой.
+    std::vector<RebuildDecision> build(DependencyGraph &Graph,
+                                       const std::vector<std::string> &Inputs) {
+        DependencyGraph NewGraph;
+        std::vector<RebuildDecision> Decisions;
+        std::string Error;
+        EXPECT_TRUE(planIncrementalBuild(Graph, Inputs, NewGraph, Decisions, Error)) << Error;
+        Graph = std::move(NewGraph);
+        return Decisions;
+    }
+};
+
+TEST(DependencyScanTest, ExtractsImportsDeclsAndUses) {
+    FileDependencies Deps = DependencyGraph::scanFile(
+        "app.swift",
+        "import Geometry\n"
+        "struct Point { var x: Int }\n"
+        "func area(r: Radius) -> Double { let tmp = r }\n");
+
+    EXPECT_EQ(Deps.Imports, std::vector<std::string>{"Geometry"});
+    ASSERT_EQ(Deps.Provides.size(), 2u);
+    EXPECT_TRUE(Deps.Provides.count("Point"));
+    EXPECT_TRUE(Deps.Provides.count("area"));
+    // Локальные объявления не входят в интерфейс файла.
+    EXPECT_FALSE(Deps.Provides.count("tmp"));
+    EXPECT_FALSE(Deps.Provides.count("x"));
+
+    std::vector<std::string> Expected = {"Double", "Geometry", "Int", "Point",
+                                         "Radius", "area", "r", "tmp", "x"};
+    EXPECT_EQ(Deps.Uses, Expected);
+    EXPECT_EQ(DependencyGraph::getModuleName("dir/app.swift"), "app");
+
+    std::vector<Token> Tokens;
+    DependencyGraph::scanFile("m.swift", "let k = 1", Tokens);
+    ASSERT_EQ(Tokens.size(), 4u);
+    EXPECT_TRUE(Tokens[0].is(tok::kw_let));
+    EXPECT_TRUE(Tokens[3].is(tok::integer_literal));
+}
+
+TEST(DependencyScanTest, FunctionBodyIsNotPartOfInterface) {
+    auto hashOf = [](const std::string &Source) {
+        return DependencyGraph::scanFile("m.swift", Source).Provides.at("f");
+    };
+    uint64_t Original = hashOf("func f(a: Int) -> Int { return a }");
+    EXPECT_EQ(hashOf("func f(a: Int) -> Int { return 0 }"), Original);
+    EXPECT_NE(hashOf("func f(a: Double) -> Int { return a }"), Original);
+}
+
+TEST_F(DependencyGraphTest, SaveAndLoadRoundTrip) {
+    DependencyGraph Graph;
+    Graph.addFile(DependencyGraph::scanFile(Dir + "/lib.swift",
+                                            "import Base\nfunc g(x: Int) {}\nlet k = 1"));
+    std::string DepsPath = Dir + "/graph.deps";
+    Created.push_back(DepsPath);
+    ASSERT_TRUE(Graph.save(DepsPath));
+
+    DependencyGraph Loaded;
+    std::string Error;
+    ASSERT_TRUE(Loaded.load(DepsPath, Error)) << Error;
+    ASSERT_EQ(Loaded.size(), 1u);
+    const FileDependencies *Original = Graph.getFile(Dir + "/lib.swift");
+    const FileDependencies *Copy = Loaded.getModule("lib");
+    ASSERT_NE(Copy, nullptr);
+    EXPECT_EQ(Copy->ContentHash, Original->ContentHash);
+    EXPECT_EQ(Copy->Imports, Original->Imports);
+    EXPECT_EQ(Copy->Provides, Original->Provides);
+    EXPECT_EQ(Copy->Uses, Original->Uses);
+}
+
+TEST_F(DependencyGraphTest, LoadRejectsMalformedFile) {
+    std::string DepsPath = writeSource("bad.deps", "swiftmini-deps 1\nhash zz\n");
+    DependencyGraph Graph;
+    std::string Error;
+    EXPECT_FALSE(Graph.load(DepsPath, Error));
+    EXPECT_NE(Error.find("malformed"), std::string::npos);
+
+    std::string Missing = Dir + "/missing.deps";
+    EXPECT_FALSE(Graph.load(Missing, Error));
+}
+
+TEST_F(DependencyGraphTest, RebuildsOnlyAffectedFiles) {
+    std::string Lib = writeSource("Lib.swift",
+                                  "func used(a: Int) -> Int { return a }\n"
+                                  "func unused() { }\n");
+    std::string UsesLib = writeSource("app.swift", "import Lib\nlet v = used(a: 1)\n");
+    std::string Other = writeSource("other.swift", "let w = 2\n");
+    std::vector<std::string> Inputs = {Lib, UsesLib, Other};
+
+    DependencyGraph Graph;
+    for (const RebuildDecision &D : build(Graph, Inputs)) {
+        EXPECT_TRUE(D.NeedsRebuild);
+        EXPECT_EQ(D.Reason, "new file");
+    }
+
+    // Без изменений ничего не пересобирается.
+    for (const RebuildDecision &D : build(Graph, Inputs))
+        EXPECT_FALSE(D.NeedsRebuild) << D.Path;
+
+    // Тело функции — не интерфейс: зависимые файлы не трогаем.
+    writeSource("Lib.swift", "func used(a: Int) -> Int { return 0 }\nfunc unused() { }\n");
+    std::vector<RebuildDecision> Decisions = build(Graph, Inputs);
+    EXPECT_EQ(Decisions[0].Reason, "content changed");
+    EXPECT_FALSE(Decisions[1].NeedsRebuild);
+    EXPECT_FALSE(Decisions[2].NeedsRebuild);
+
+    // Сигнатура неиспользуемой функции тоже не задевает app.swift.
+    writeSource("Lib.swift", "func used(a: Int) -> Int { return 0 }\nfunc unused(b: Int) { }\n");
+    Decisions = build(Graph, Inputs);
+    EXPECT_TRUE(Decisions[0].NeedsRebuild);
+    EXPECT_FALSE(Decisions[1].NeedsRebuild);
+
+    // Изменение используемого объявления пересобирает импортирующий файл.
+    writeSource("Lib.swift", "func used(a: Double) -> Int { return 0 }\nfunc unused(b: Int) { }\n");
+    Decisions = build(Graph, Inputs);
+    EXPECT_TRUE(Decisions[0].NeedsRebuild);
+    EXPECT_TRUE(Decisions[1].NeedsRebuild);
+    EXPECT_EQ(Decisions[1].Reason, "uses changed declaration 'used' from 'Lib'");
+    // Пересборка лексит содержимое, прочитанное при планировании.
+    EXPECT_EQ(Decisions[1].NumTokens, 11u);
+    EXPECT_FALSE(Decisions[2].NeedsRebuild);
+    EXPECT_EQ(Decisions[2].NumTokens, 0u);
+}
+
+TEST_F(DependencyGraphTest, RebuildsWhenImportedModuleDisappears) {
+    std::string Lib = writeSource("Lib.swift", "let k = 1\n");
+    std::string App = writeSource("app.swift", "import Lib\nlet v = k\n");
+
+    DependencyGraph Graph;
+    build(Graph, {Lib, App});
+    std::vector<RebuildDecision> Decisions = build(Graph, {App});
+    ASSERT_EQ(Decisions.size(), 1u);
+    EXPECT_TRUE(Decisions[0].NeedsRebuild);
+    EXPECT_EQ(Decisions[0].Reason, "module 'Lib' disappeared");
+}
@@ -0,0 +1,352 @@
+#include <gtest/gtest.h>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include "JIT/JITCompiler.h"
+#include "JIT/LIR.h"
+#include "JIT/LIRInterpreter.h"
+#include "JIT/RegisterAllocator.h"
+
+namespace {
+
+// buildSumLoop - sum(n): var s = 0; var i = 0; while i < n { s += i; i += 1 }.
+LIRFunction *buildSumLoop(LIRModule &M) {
+    LIRFunction *F = M.createFunction("sum", {LIRType::Int}, LIRType::Int);
+    LIRBuilder B(*F);
+    BlockID Header = B.createBlock(), Body = B.createBlock(), Exit = B.createBlock();
+    VReg S = B.createVar(LIRType::Int), I = B.createVar(LIRType::Int);
+    B.copy(S, B.iconst(0));
+    B.copy(I, B.iconst(0));
+    B.createBr(Header);
+
+    B.setInsertPoint(Header);
+    B.createCondBr(B.createCmpLt(I, B.getParam(0)), Body, Exit);
+
+    B.setInsertPoint(Body);
+    B.copy(S, B.createAdd(S, I));
+    B.copy(I, B.createAdd(I, B.iconst(1)));
+    B.createBr(Header);
+
+    B.setInsertPoint(Exit);
+    B.createRet(S);
+    return F;
+}
+
+// buildFib - fib(n) = n < 2 ? n : fib(n - 1) + fib(n - 2).
+LIRFunction *buildFib(LIRModule &M) {
+    LIRFunction *F = M.createFunction("fib", {LIRType::Int}, LIRType::Int);
+    LIRBuilder B(*F);
+    BlockID Small = B.createBlock(), Rec = B.createBlock();
+    VReg N = B.getParam(0);
+    B.createCondBr(B.createCmpLt(N, B.iconst(2)), Small, Rec);
+    B.setInsertPoint(Small);
+    B.createRet(N);
+    B.setInsertPoint(Rec);
+    VReg A = B.createCall(F, {B.createSub(N, B.iconst(1))});
+    VReg C = B.createCall(F, {B.createSub(N, B.iconst(2))});
+    B.createRet(B.createAdd(A, C));
+    return F;
+}
+
+// buildHarmonic - Сумма 1/k для k = 1..n в double.
+LIRFunction *buildHarmonic(LIRModule &M) {
+    LIRFunction *F = M.createFunction("harmonic", {LIRType::Int}, LIRType::Float);
+    LIRBuilder B(*F);
+    BlockID Header = B.createBlock(), Body = B.createBlock(), Exit = B.createBlock();
+    VReg Sum = B.createVar(LIRType::Float), K = B.createVar(LIRType::Int);
+    B.copy(Sum, B.fconst(0.0));
+    B.copy(K, B.iconst(1));
+    B.createBr(Header);
+    B.setInsertPoint(Header);
+    B.createCondBr(B.createCmpLe(K, B.getParam(0)), Body, Exit);
+    B.setInsertPoint(Body);
+    B.copy(Sum, B.createFAdd(Sum, B.createFDiv(B.fconst(1.0), B.createIntToFloat(K))));
+    B.copy(K, B.createAdd(K, B.iconst(1)));
+    B.createBr(Header);
+    B.setInsertPoint(Exit);
+    B.createRet(Sum);
+    return F;
+}
+
+class JITTest : public ::testing::Test {
+protected:
+    LIRModule M;
+    JITCompiler JIT;
+    LIRInterpreter Interp;
+
+    void SetUp() override {
+        if (!JITCompiler::isHostSupported())
+            GTEST_SKIP() << "JIT needs an x86-64 host";
+    }
+
+    void compile() {
+        std::string Error;
+        ASSERT_TRUE(JIT.compile(M, Error)) << Error;
+    }
+};
+
+} // namespace
+
+TEST_F(JITTest, LoopMatchesInterpreter) {
+    LIRFunction *Sum = buildSumLoop(M);
+    compile();
+    auto Fn = JIT.getFunction<int64_t (*)(int64_t)>("sum");
+    ASSERT_NE(Fn, nullptr);
+    for (int64_t N : {0, 1, 2, 10, 1000, 123457}) {
+        EXPECT_EQ(Fn(N), N * (N - 1) / 2);
+        EXPECT_EQ(Fn(N), Interp.run(*Sum, {makeInt(N)}).I);
+    }
+}
+
+TEST_F(JITTest, RecursiveCalls) {
+    LIRFunction *Fib = buildFib(M);
+    compile();
+    auto Fn = JIT.getFunction<int64_t (*)(int64_t)>("fib");
+    EXPECT_EQ(Fn(0), 0);
+    EXPECT_EQ(Fn(1), 1);
+    EXPECT_EQ(Fn(20), 6765);
+    EXPECT_EQ(JIT.call(Fib, {makeInt(15)}).I, Interp.run(*Fib, {makeInt(15)}).I);
+}
+
+TEST_F(JITTest, FloatArithmetic) {
+    LIRFunction *H = buildHarmonic(M);
+    compile();
+    auto Fn = JIT.getFunction<double (*)(int64_t)>("harmonic");
+    EXPECT_DOUBLE_EQ(Fn(4), 1.0 + 0.5 + 1.0 / 3 + 0.25);
+    EXPECT_EQ(Fn(1000), Interp.run(*H, {makeInt(1000)}).F);
+    EXPECT_EQ(JIT.call(H, {makeInt(1000)}).F, Fn(1000));
+}
+
+// Все бинарные операции и сравнения на наборе значений, включая
+// отрицательные и граничные, сверяются с интерпретатором.
+TEST_F(JITTest, IntOperationsMatchInterpreter) {
+    std::vector<LIROpcode> Ops = {
+        #define LIR_INT_BINARY(Id, Name) LIROpcode::Id,
+        #define LIR_INT_COMPARE(Id, Name) LIROpcode::Id,
+        #include "JIT/LIROps.def"
+    };
+    for (LIROpcode Op : Ops) {
+        LIRFunction *F = M.createFunction(getOpcodeName(Op), {LIRType::Int, LIRType::Int},
+                                          LIRType::Int);
+        LIRInst Inst;
+        Inst.Op = Op;
+        Inst.A = F->Params[0];
+        Inst.B = F->Params[1];
+        Inst.Dest = F->createReg(LIRType::Int);
+        F->Blocks[0].Insts.push_back(Inst);
+        LIRBuilder(*F).createRet(Inst.Dest);
+    }
+    compile();
+
+    const int64_t Values[] = {0, 1, -1, 7, -7, 3, 1000003, -99,
+                              std::numeric_limits<int64_t>::max()};
+    for (const auto &F : M.getFunctions()) {
+        bool IsDivision = F->getName() == "div" || F->getName() == "rem";
+        for (int64_t A : Values)
+            for (int64_t B : Values) {
+                if (IsDivision && B == 0)
+                    continue;
+                LIRValue Args[] = {makeInt(A), makeInt(B)};
+                EXPECT_EQ(JIT.call(F.get(), {Args, 2}).I, Interp.run(*F, {Args, 2}).I)
+                    << F->getName() << "(" << A << ", " << B << ")";
+            }
+    }
+}
+
+TEST_F(JITTest, FloatComparisonsHandleNaN) {
+    std::vector<LIROpcode> Ops = {
+        #define LIR_FLOAT_COMPARE(Id, Name) LIROpcode::Id,
+        #include "JIT/LIROps.def"
+    };
+    for (LIROpcode Op : Ops) {
+        LIRFunction *F = M.createFunction(getOpcodeName(Op), {LIRType::Float, LIRType::Float},
+                                          LIRType::Int);
+        LIRBuilder B(*F);
+        BlockID Yes = B.createBlock(), No = B.createBlock();
+        LIRInst Inst;
+        Inst.Op = Op;
+        Inst.A = F->Params[0];
+        Inst.B = F->Params[1];
+        Inst.Dest = F->createReg(LIRType::Int);
+        F->Blocks[0].Insts.push_back(Inst);
+        // Ветвление по результату проверяет и слияние сравнения с переходом.
+        B.createCondBr(Inst.Dest, Yes, No);
+        B.setInsertPoint(Yes);
+        B.createRet(B.createAdd(Inst.Dest, B.iconst(10)));
+        B.setInsertPoint(No);
+        B.createRet(Inst.Dest);
+    }
+    compile();
+
+    const double NaN = std::nan("");
+    const double Values[] = {0.0, -0.0, 1.5, -2.0, NaN};
+    for (const auto &F : M.getFunctions())
+        for (double A : Values)
+            for (double B : Values) {
+                LIRValue Args[] = {makeFloat(A), makeFloat(B)};
+                EXPECT_EQ(JIT.call(F.get(), {Args, 2}).I, Interp.run(*F, {Args, 2}).I)
+                    << F->getName() << "(" << A << ", " << B << ")";
+            }
+}
+
+// Значений больше, чем регистров: часть уходит в память.
+TEST_F(JITTest, HighRegisterPressureSpills) {
+    LIRFunction *F = M.createFunction("pressure", {LIRType::Int, LIRType::Float},
+                                      LIRType::Float);
+    LIRBuilder B(*F);
+    std::vector<VReg> Ints, Floats;
+    for (int I = 0; I != 24; ++I) {
+        Ints.push_back(B.createMul(B.getParam(0), B.iconst(I + 1)));
+        Floats.push_back(B.createFMul(B.getParam(1), B.fconst(I + 0.5)));
+    }
+    VReg IntSum = B.iconst(0);
+    VReg FloatSum = B.fconst(0);
+    for (int I = 0; I != 24; ++I) {
+        IntSum = B.createSub(Ints[I], IntSum);
+        FloatSum = B.createFSub(Floats[I], FloatSum);
+    }
+    B.createRet(B.createFAdd(FloatSum, B.createIntToFloat(IntSum)));
+    compile();
+
+    EXPECT_GT(JIT.getStats().NumSpilledValues, 0u);
+    auto Fn = JIT.getFunction<double (*)(int64_t, double)>("pressure");
+    LIRValue Args[] = {makeInt(3), makeFloat(0.25)};
+    EXPECT_EQ(Fn(3, 0.25), Interp.run(*F, {Args, 2}).F);
+}
+
+// Значения, живые через вызов, не портятся вызываемой функцией, которая
+// сама занимает все несохраняемые регистры.
+TEST_F(JITTest, ValuesSurviveCalls) {
+    LIRFunction *Clobber = M.createFunction("clobber", {LIRType::Int}, LIRType::Int);
+    {
+        LIRBuilder B(*Clobber);
+        std::vector<VReg> Vals;
+        for (int I = 0; I != 12; ++I)
+            Vals.push_back(B.createAdd(B.getParam(0), B.iconst(I)));
+        VReg Sum = B.iconst(0);
+        for (VReg V : Vals)
+            Sum = B.createAdd(Sum, V);
+        B.createRet(Sum);
+    }
+
+    LIRFunction *F = M.createFunction("caller", {LIRType::Int, LIRType::Float}, LIRType::Float);
+    LIRBuilder B(*F);
+    std::vector<VReg> Live;
+    for (int I = 0; I != 8; ++I)
+        Live.push_back(B.createMul(B.getParam(0), B.iconst(I + 2)));
+    VReg X = B.createFMul(B.getParam(1), B.fconst(3.0));
+    VReg R = B.createCall(Clobber, {B.getParam(0)});
+    VReg Sum = R;
+    for (VReg V : Live)
+        Sum = B.createAdd(Sum, V);
+    B.createRet(B.createFAdd(X, B.createIntToFloat(Sum)));
+    compile();
+
+    LIRValue Args[] = {makeInt(5), makeFloat(1.25)};
+    EXPECT_EQ(JIT.call(F, {Args, 2}).F, Interp.run(*F, {Args, 2}).F);
+
+    RegisterAssignment Alloc =
+        LinearScanAllocator({{6, 7, 8, 9, 10}, {3, 12, 13, 14, 15}}, {{8, 9}, {}}).allocate(*F);
+    for (VReg V : Live) {
+        ASSERT_TRUE(Alloc.Locations[V].isRegister() || Alloc.Locations[V].isStack());
+        if (Alloc.Locations[V].isRegister()) {
+            uint8_t Reg = Alloc.Locations[V].PhysReg;
+            EXPECT_TRUE(Reg == 3 || Reg >= 12) << "value in a caller-saved register";
+        }
+    }
+    // Для double сохраняемых регистров нет.
+    EXPECT_TRUE(Alloc.Locations[X].isStack());
+}
+
+// Вызов — первая инструкция функции: параметр, нужный после него, живёт
+// через вызов с самой первой позиции.
+TEST_F(JITTest, ParamSurvivesLeadingCall) {
+    LIRFunction *G = M.createFunction("g", {LIRType::Int}, LIRType::Int);
+    {
+        LIRBuilder B(*G);
+        B.createRet(B.createMul(B.getParam(0), B.iconst(2)));
+    }
+    LIRFunction *F = M.createFunction("main", {LIRType::Int}, LIRType::Int);
+    LIRBuilder B(*F);
+    VReg R = B.createCall(G, {B.getParam(0)});
+    B.createRet(B.createAdd(R, B.getParam(0)));
+    compile();
+    EXPECT_EQ(JIT.getFunction<int64_t (*)(int64_t)>("main")(5), 15);
+
+    for (const LiveInterval &LI : LinearScanAllocator::computeLiveIntervals(*F))
+        if (LI.Reg == F->Params[0]) {
+            EXPECT_TRUE(LI.CrossesCall);
+        }
+}
+
+TEST_F(JITTest, RegistersReadBeforeWriteAreZero) {
+    LIRFunction *F = M.createFunction("zero", {}, LIRType::Int);
+    LIRBuilder B(*F);
+    VReg Uninit = B.createVar(LIRType::Int);
+    B.createRet(B.createAdd(Uninit, B.iconst(42)));
+    compile();
+    EXPECT_EQ(JIT.getFunction<int64_t (*)()>("zero")(), 42);
+}
+
+TEST(LiveIntervalsTest, LoopVariableSpansLoop) {
+    LIRModule M;
+    LIRFunction *F = buildSumLoop(M);
+    std::vector<LiveInterval> Intervals = LinearScanAllocator::computeLiveIntervals(*F);
+    // Счётчик (регистр 2 — после параметра и s) жив до конца тела цикла,
+    // откуда идёт обратный переход.
+    uint32_t NumInsts = 0;
+    for (const LIRBlock &Block : F->Blocks)
+        NumInsts += static_cast<uint32_t>(Block.Insts.size());
+    for (const LiveInterval &LI : Intervals)
+        if (LI.Reg == 2) {
+            uint32_t BodyEnd = 2 * (NumInsts - 1) - 1;
+            EXPECT_EQ(LI.End, BodyEnd);
+        }
+}
+
+TEST(LIRTest, VerifierRejectsTypeErrors) {
+    LIRModule M;
+    LIRFunction *F = M.createFunction("bad", {LIRType::Int}, LIRType::Int);
+    LIRBuilder B(*F);
+    VReg X = B.fconst(1.0);
+    B.createRet(B.createAdd(B.getParam(0), X));
+    std::string Error;
+    EXPECT_FALSE(M.verify(Error));
+    EXPECT_NE(Error.find("invalid operands of 'add'"), std::string::npos) << Error;
+
+    LIRModule M2;
+    M2.createFunction("empty", {}, LIRType::Int);
+    EXPECT_FALSE(M2.verify(Error));
+    EXPECT_NE(Error.find("terminator"), std::string::npos);
+}
+
+TEST(LIRTest, PrintAndParseRoundTrip) {
+    LIRModule M;
+    buildSumLoop(M);
+    buildFib(M);
+    buildHarmonic(M);
+    std::ostringstream Printed;
+    M.print(Printed);
+
+    LIRModule Parsed;
+    std::string Error;
+    ASSERT_TRUE(parseLIRModule(Printed.str(), Parsed, Error)) << Error;
+    ASSERT_TRUE(Parsed.verify(Error)) << Error;
+    std::ostringstream Reprinted;
+    Parsed.print(Reprinted);
+    EXPECT_EQ(Printed.str(), Reprinted.str());
+
+    LIRInterpreter Interp;
+    EXPECT_EQ(Interp.run(*Parsed.getFunction("fib"), {makeInt(10)}).I, 55);
+}
+
+TEST(LIRTest, ParseErrors) {
+    LIRModule M;
+    std::string Error;
+    EXPECT_FALSE(parseLIRModule("func f() -> int {\nbb0:\n  %r0 = frob %r1\n}\n", M, Error));
+    EXPECT_EQ(Error, "line 3: unknown instruction 'frob'");
+
+    LIRModule M2;
+    EXPECT_FALSE(parseLIRModule("func f() -> int {\nbb0:\n  %r0 = call g()\n  ret %r0\n}\n", M2, Error));
+    EXPECT_EQ(Error, "line 3: unknown function 'g'");
+}
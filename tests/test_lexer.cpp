@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <vector>
 #include "Parse/Lexer.h"
 
 class LexerTest : public ::testing::Test {
@@ -410,4 +411,119 @@ TEST_F(LexerTest, LexBufferEndHandling) {
     // case 0: if (CurPtr == BufferEnd) goto Restart;
     Token tok3 = lexer.lex();
     EXPECT_EQ(tok3.getKind(), tok::eof);
-}
\ No newline at end of file
+}
+
+TEST_F(LexerTest, LexReservedWords) {
+    // Все ключевые слова из Tokens.def зарезервированы, а не только
+    // if/let/var/else/func/return, как было раньше.
+    std::string input = "import struct class typealias new _ in is as Self self "
+                        "super nil true false __FILE__ __LINE__ __COLUMN__ "
+                        "__FUNCTION__ __DSO_HANDLE__ dynamicType where";
+    std::vector<tok> expected = {
+        tok::kw_import, tok::kw_struct, tok::kw_class, tok::kw_typealias,
+        tok::kw_new, tok::kw__, tok::kw_in, tok::kw_is, tok::kw_as,
+        tok::kw_Self, tok::kw_self, tok::kw_super, tok::kw_nil, tok::kw_true,
+        tok::kw_false, tok::kw___FILE__, tok::kw___LINE__, tok::kw___COLUMN__,
+        tok::kw___FUNCTION__, tok::kw___DSO_HANDLE__, tok::kw_dynamicType,
+        tok::kw_where};
+    Lexer lexer(input);
+
+    EXPECT_EQ(lexer.lex().getKind(), tok::START_OF_FILE);
+    for (tok kind : expected) {
+        Token t = lexer.lex();
+        EXPECT_EQ(t.getKind(), kind) << t.getText();
+    }
+    EXPECT_EQ(lexer.lex().getKind(), tok::eof);
+}
+
+TEST_F(LexerTest, LexNearKeywordsAsIdentifiers) {
+    // Регистр, префиксы и продолжения ключевых слов остаются идентификаторами.
+    std::string input = "New _a in2 self_ __FILE SELF news";
+    Lexer lexer(input);
+
+    EXPECT_EQ(lexer.lex().getKind(), tok::START_OF_FILE);
+    for (int i = 0; i != 7; ++i) {
+        Token t = lexer.lex();
+        EXPECT_EQ(t.getKind(), tok::identifier) << t.getText();
+    }
+    EXPECT_EQ(lexer.lex().getKind(), tok::eof);
+}
+
+TEST(TokenInfoTest, TableMatchesTokensDef) {
+    static_assert(sizeof(tok) == 1, "tok must stay one byte");
+    EXPECT_EQ(Token::getTokenName(tok::kw_func), "<kw_func>");
+    EXPECT_EQ(Token::getTokenName(tok::l_paren), "<l_paren>");
+    EXPECT_EQ(Token::getTokenName(tok::eof), "<EOF>");
+    EXPECT_EQ(Token::getTokenName(tok::START_OF_FILE), "<START_OF_FILE>");
+    EXPECT_EQ(getTokenInfo(tok::kw_while).Spelling, "while");
+    EXPECT_EQ(getTokenInfo(tok::arrow).Spelling, "->");
+    EXPECT_TRUE(getTokenInfo(tok::identifier).Spelling.empty());
+
+    // Каждое ключевое слово из таблицы распознаётся лексером по написанию.
+    for (unsigned I = 0; I != NumTokenKinds; ++I) {
+        const TokenInfo &Info = TokenInfos[I];
+        if (!(Info.Categories & TC_Keyword))
+            continue;
+        const char *Start = Info.Spelling.data();
+        EXPECT_EQ(Token::kindOfIdentifier(Start, Start + Info.Spelling.size()),
+                  static_cast<tok>(I));
+    }
+
+    // Слова с той же длиной, первой и последней буквой — не ключевые.
+    for (std::string_view Text : {"lat", "fine", "rn", "ifs", "Sef", "__LINE_", "_x", "x"})
+        EXPECT_EQ(Token::kindOfIdentifier(Text.data(), Text.data() + Text.size()),
+                  tok::identifier)
+            << Text;
+    static_assert(Keywords.lookup("typealias") == tok::kw_typealias);
+}
+
+TEST(TokenInfoTest, CategoryPredicates) {
+    Token Func(tok::kw_func, "func");
+    EXPECT_TRUE(Func.isKeyword());
+    EXPECT_TRUE(Func.isDeclKeyword());
+    EXPECT_FALSE(Func.isStmtKeyword());
+    EXPECT_FALSE(Func.isPunctuation());
+
+    Token Return(tok::kw_return, "return");
+    EXPECT_TRUE(Return.isStmtKeyword());
+    EXPECT_TRUE(Token(tok::kw_true, "true").isKeyword());
+    EXPECT_FALSE(Token(tok::kw_true, "true").isDeclKeyword());
+
+    EXPECT_TRUE(Token(tok::string_literal, "\"a\"").isLiteral());
+    EXPECT_TRUE(Token(tok::integer_literal, "1").isIdentifierOrLiteral());
+    EXPECT_FALSE(Token(tok::identifier, "x").isLiteral());
+
+    Token Plus(tok::plus, "+");
+    EXPECT_TRUE(Plus.isPunctuation());
+    EXPECT_TRUE(Plus.isOperator());
+    EXPECT_FALSE(Plus.isAnyOperator());
+    EXPECT_TRUE(Token(tok::oper_binary, "<>").isAnyOperator());
+    EXPECT_FALSE(Token(tok::comma, ",").isOperator());
+}
+
+TEST(TokenInfoTest, Precedence) {
+    Token Plus(tok::plus, "+"), Star(tok::star, "*"), Equal(tok::equal, "=");
+    EXPECT_GT(Star.getPrecedence(), Plus.getPrecedence());
+    EXPECT_GT(Plus.getPrecedence(), Equal.getPrecedence());
+    EXPECT_EQ(Plus.getAssociativity(), Associativity::Left);
+    EXPECT_EQ(Equal.getAssociativity(), Associativity::Right);
+    EXPECT_EQ(Token(tok::tilde, "~").getPrecedence(), 0u);
+    EXPECT_EQ(Token(tok::tilde, "~").getAssociativity(), Associativity::None);
+}
+
+TEST(TokenInfoTest, TokenSets) {
+    static constexpr TokenSet DeclStart = TokenSet::withCategory(TC_DeclKeyword);
+    static constexpr TokenSet Closers = {tok::r_paren, tok::r_brace, tok::r_square};
+    static_assert(DeclStart.contains(tok::kw_var) && !DeclStart.contains(tok::kw_if), "");
+
+    EXPECT_TRUE(Token(tok::kw_struct, "struct").isAny(DeclStart));
+    EXPECT_FALSE(Token(tok::identifier, "x").isAny(DeclStart));
+    EXPECT_TRUE(Closers.contains(tok::r_brace));
+    EXPECT_FALSE(Closers.contains(tok::l_brace));
+
+    TokenSet Both = DeclStart | Closers;
+    EXPECT_TRUE(Both.contains(tok::kw_let));
+    EXPECT_TRUE(Both.contains(tok::r_square));
+    EXPECT_FALSE(Both.contains(tok::START_OF_FILE));
+    EXPECT_FALSE(TokenSet().contains(tok::unknown));
+}
@@ -0,0 +1,569 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "AST/ASTContext.h"
+#include "AST/Decl.h"
+#include "AST/Expr.h"
+#include "AST/Stmt.h"
+#include "Basic/ThreadPool.h"
+#include "JIT/JITCompiler.h"
+#include "JIT/LIRInterpreter.h"
+#include "MIR/Dominators.h"
+#include "MIR/LIRGen.h"
+#include "MIR/MIRGen.h"
+#include "MIR/MIRInterpreter.h"
+#include "MIR/PassManager.h"
+#include "MIR/Passes.h"
+#include "Runtime/Runtime.h"
+
+class MIRTest : public ::testing::Test {
+protected:
+    ASTContext Ctx;
+    MIRModule M;
+    std::string Error;
+
+    Identifier id(const char *Name) { return Ctx.getIdentifier(Name); }
+
+    Expr *ref(const char *Name) { return new (Ctx) DeclRefExpr(id(Name)); }
+    Expr *lit(int64_t Value) { return new (Ctx) IntegerLiteralExpr(Value); }
+    Expr *binary(const char *Op, Expr *LHS, Expr *RHS) {
+        return new (Ctx) BinaryExpr(id(Op), LHS, RHS);
+    }
+    Expr *assign(const char *Name, Expr *Value) {
+        return new (Ctx) AssignExpr(ref(Name), Value);
+    }
+    Expr *call(const char *Name, std::vector<Expr *> Args) {
+        return new (Ctx) CallExpr(ref(Name), Ctx.allocateCopy<Expr *>(Args));
+    }
+    VarDecl *var(const char *Name, Expr *Init) {
+        return new (Ctx) VarDecl(id(Name), false, nullptr, Init);
+    }
+    Stmt *ret(Expr *Value) { return new (Ctx) ReturnStmt(Value); }
+    BraceStmt *brace(std::vector<Node *> Elements) {
+        return new (Ctx) BraceStmt(Ctx.allocateCopy<Node *>(Elements));
+    }
+
+    // func(Name, {"a", "b"}, Body) - Функция от Int-параметров, возвращающая Int.
+    FuncDecl *func(std::string_view Name, std::vector<const char *> ParamNames, BraceStmt *Body) {
+        std::vector<ParamDecl *> Params;
+        std::vector<TypeBase *> ParamTypes;
+        for (const char *P : ParamNames) {
+            Params.push_back(new (Ctx) ParamDecl(id(P), Ctx.getIntType()));
+            ParamTypes.push_back(Ctx.getIntType());
+        }
+        return new (Ctx) FuncDecl(Ctx.getIdentifier(Name), Ctx.allocateCopy<ParamDecl *>(Params),
+                                  Body, Ctx.getFunctionType(ParamTypes, Ctx.getIntType()));
+    }
+
+    // loopSum(n, k) - s = 0; i = 0; while i < n { s = s + k * k; i = i + 1 }; return s
+    FuncDecl *loopSum() {
+        return func("loopSum", {"n", "k"},
+                    brace({var("s", lit(0)), var("i", lit(0)),
+                           new (Ctx) WhileStmt(
+                               binary("<", ref("i"), ref("n")),
+                               brace({assign("s", binary("+", ref("s"),
+                                                         binary("*", ref("k"), ref("k")))),
+                                      assign("i", binary("+", ref("i"), lit(1)))})),
+                           ret(ref("s"))}));
+    }
+
+    void lower(std::vector<FuncDecl *> Funcs) {
+        ASSERT_TRUE(lowerToMIR(Funcs, M, Error)) << Error;
+        ASSERT_TRUE(M.verify(Error)) << Error;
+    }
+
+    int64_t exec(const char *Name, std::vector<int64_t> Args) {
+        std::vector<MIRValue> Values;
+        for (int64_t A : Args)
+            Values.push_back(makeMIRInt(A));
+        MIRInterpreter Interp;
+        return Interp.run(*M.getFunction(Name), Values).I;
+    }
+
+    unsigned countOps(const MIRFunction &F, MIROpcode Op) {
+        unsigned N = 0;
+        for (const auto &B : F.Blocks)
+            for (MIRInst *I : B->Insts)
+                N += I->getOpcode() == Op;
+        return N;
+    }
+
+    std::string print(const MIRFunction &F) {
+        std::ostringstream OS;
+        F.print(OS);
+        return OS.str();
+    }
+};
+
+TEST_F(MIRTest, BuilderAndPrinter) {
+    MIRFunction *F = M.createFunction("max", {MIRType::Int, MIRType::Int}, MIRType::Int);
+    MIRBuilder B(*F);
+    B.setInsertPoint(F->getEntryBlock());
+    MIRInst *A = B.createParam(0);
+    MIRInst *C = B.createParam(1);
+    MIRBlock *Then = B.createBlock(), *Merge = B.createBlock();
+    B.createCondBr(B.createCmpGt(A, C), Then, Merge);
+    B.setInsertPoint(Then);
+    B.createBr(Merge);
+    MIRInst *Phi = B.createPhi(MIRType::Int, Merge);
+    F->setOperands(Phi, {C, A});
+    B.setInsertPoint(Merge);
+    B.createRet(Phi);
+
+    ASSERT_TRUE(M.verify(Error)) << Error;
+    EXPECT_EQ(print(*F), "func @max(int, int) -> int {\n"
+                         "bb0:\n"
+                         "  %0 = param 0 : int\n"
+                         "  %1 = param 1 : int\n"
+                         "  %2 = cmp.gt %0, %1 : bool\n"
+                         "  condbr %2, bb1, bb2\n"
+                         "bb1:  ; preds: bb0\n"
+                         "  br bb2\n"
+                         "bb2:  ; preds: bb0 bb1\n"
+                         "  %3 = phi [%1, bb0], [%0, bb1] : int\n"
+                         "  ret %3\n"
+                         "}\n");
+    EXPECT_EQ(exec("max", {3, 7}), 7);
+    EXPECT_EQ(exec("max", {9, 7}), 9);
+}
+
+TEST_F(MIRTest, VerifierRejectsBrokenSSA) {
+    MIRFunction *F = M.createFunction("f", {MIRType::Int}, MIRType::Int);
+    MIRBuilder B(*F);
+    B.setInsertPoint(F->getEntryBlock());
+    MIRInst *P = B.createParam(0);
+    MIRBlock *Left = B.createBlock(), *Right = B.createBlock(), *Merge = B.createBlock();
+    B.createCondBr(B.createCmpEq(P, B.iconst(0)), Left, Right);
+    B.setInsertPoint(Left);
+    MIRInst *One = B.iconst(1);
+    B.createBr(Merge);
+    B.setInsertPoint(Right);
+    B.createBr(Merge);
+    B.setInsertPoint(Merge);
+    // One определено только на одной из веток.
+    B.createRet(One);
+    EXPECT_FALSE(M.verify(Error));
+    EXPECT_NE(Error.find("dominate"), std::string::npos) << Error;
+}
+
+TEST_F(MIRTest, LowersLoopsToSSA) {
+    lower({loopSum()});
+    const MIRFunction &F = *M.getFunction("loopSum");
+    // Заголовок цикла запечатывается после тела, поэтому phi получают все
+    // четыре прочитанные в цикле переменные; у n и k они тривиальны.
+    EXPECT_EQ(countOps(F, MIROpcode::Phi), 4u);
+    EXPECT_EQ(exec("loopSum", {10, 3}), 90);
+    EXPECT_EQ(exec("loopSum", {0, 3}), 0);
+
+    runCopyPropagation(*M.getFunction("loopSum"));
+    EXPECT_EQ(countOps(F, MIROpcode::Phi), 2u);
+    EXPECT_EQ(exec("loopSum", {10, 3}), 90);
+}
+
+TEST_F(MIRTest, ReportsLoweringErrors) {
+    FuncDecl *D = func("f", {"a"}, brace({assign("a", lit(1))}));
+    EXPECT_FALSE(lowerToMIR({D}, M, Error));
+    EXPECT_NE(Error.find("cannot assign to 'a'"), std::string::npos) << Error;
+}
+
+TEST_F(MIRTest, FoldsConstantsAndBranches) {
+    // if 2 * 3 + 4 == 10 { return a } else { return 0 - a }
+    auto *If = new (Ctx) IfStmt(
+        binary("==", binary("+", binary("*", lit(2), lit(3)), lit(4)), lit(10)),
+        brace({ret(ref("a"))}), brace({ret(binary("-", lit(0), ref("a")))}));
+    lower({func("f", {"a"}, brace({If}))});
+    MIRFunction &F = *M.getFunction("f");
+
+    EXPECT_GT(runConstantFolding(F), 0u);
+    EXPECT_EQ(countOps(F, MIROpcode::CondBr), 0u);
+    EXPECT_GT(runDeadCodeElimination(F), 0u);
+    ASSERT_TRUE(verifyFunction(F, Error)) << Error;
+    EXPECT_EQ(F.Blocks.size(), 2u);
+    EXPECT_EQ(countOps(F, MIROpcode::Mul), 0u);
+    EXPECT_EQ(exec("f", {5}), 5);
+}
+
+TEST_F(MIRTest, DoesNotFoldTrappingDivision) {
+    lower({func("f", {}, brace({ret(binary("/", lit(1), lit(0)))}))});
+    MIRFunction &F = *M.getFunction("f");
+    runConstantFolding(F);
+    EXPECT_EQ(countOps(F, MIROpcode::Div), 1u);
+}
+
+TEST_F(MIRTest, CopyPropagationRemovesCopiesAndTrivialPhis) {
+    // Переменная k не меняется в цикле: её phi тривиальна.
+    lower({func("f", {"n"},
+                brace({var("k", lit(7)), var("i", lit(0)),
+                       new (Ctx) WhileStmt(binary("<", ref("i"), ref("n")),
+                                           brace({assign("i", binary("+", ref("i"), ref("k")))})),
+                       ret(ref("k"))}))});
+    MIRFunction &F = *M.getFunction("f");
+    EXPECT_GT(countOps(F, MIROpcode::Copy), 0u);
+    EXPECT_GT(runCopyPropagation(F), 0u);
+    ASSERT_TRUE(verifyFunction(F, Error)) << Error;
+    EXPECT_EQ(countOps(F, MIROpcode::Copy), 0u);
+    EXPECT_EQ(countOps(F, MIROpcode::Phi), 1u);
+    EXPECT_EQ(exec("f", {20}), 7);
+}
+
+TEST_F(MIRTest, HoistsLoopInvariants) {
+    lower({loopSum()});
+    MIRFunction &F = *M.getFunction("loopSum");
+    MIRInterpreter Before;
+    Before.run(F, {makeMIRInt(100), makeMIRInt(3)});
+
+    runCopyPropagation(F);
+    // Выносятся k * k и константа 1 из i + 1.
+    EXPECT_EQ(runLoopInvariantCodeMotion(F), 2u);
+    ASSERT_TRUE(verifyFunction(F, Error)) << Error;
+
+    // k * k теперь в предзаголовке — блоке, который доминирует над циклом.
+    DominatorTree DT(F);
+    MIRInst *Mul = nullptr;
+    for (const auto &B : F.Blocks)
+        for (MIRInst *I : B->Insts)
+            if (I->getOpcode() == MIROpcode::Mul)
+                Mul = I;
+    ASSERT_NE(Mul, nullptr);
+    for (const auto &B : F.Blocks)
+        for (MIRInst *I : B->Insts)
+            if (I->isPhi()) {
+                EXPECT_TRUE(DT.dominates(Mul->getParent(), I->getParent()));
+            }
+
+    MIRInterpreter After;
+    EXPECT_EQ(After.run(F, {makeMIRInt(100), makeMIRInt(3)}).I, 900);
+    EXPECT_LT(After.getNumInstsExecuted(), Before.getNumInstsExecuted());
+}
+
+TEST_F(MIRTest, InlinesSmallNonRecursiveCalls) {
+    FuncDecl *Square = func("square", {"x"}, brace({ret(binary("*", ref("x"), ref("x")))}));
+    FuncDecl *Abs = func("abs", {"x"},
+                         brace({new (Ctx) IfStmt(binary("<", ref("x"), lit(0)),
+                                                 brace({ret(binary("-", lit(0), ref("x")))})),
+                                ret(ref("x"))}));
+    // fact не встраивается: рекурсия.
+    FuncDecl *Fact = func(
+        "fact", {"n"},
+        brace({new (Ctx) IfStmt(binary("<=", ref("n"), lit(1)), brace({ret(lit(1))})),
+               ret(binary("*", ref("n"), call("fact", {binary("-", ref("n"), lit(1))})))}));
+    FuncDecl *Main = func(
+        "main", {"a"},
+        brace({ret(binary("+", binary("+", call("square", {ref("a")}), call("square", {lit(3)})),
+                          binary("+", call("abs", {ref("a")}), call("fact", {lit(5)}))))}));
+    lower({Square, Abs, Fact, Main});
+
+    EXPECT_EQ(exec("main", {-4}), 16 + 9 + 4 + 120);
+    EXPECT_EQ(runInliner(M), 3u);
+    ASSERT_TRUE(M.verify(Error)) << Error;
+
+    const MIRFunction &F = *M.getFunction("main");
+    EXPECT_EQ(countOps(F, MIROpcode::Call), 1u);
+    EXPECT_EQ(countOps(*M.getFunction("fact"), MIROpcode::Call), 1u);
+    EXPECT_EQ(exec("main", {-4}), 16 + 9 + 4 + 120);
+    EXPECT_EQ(exec("main", {6}), 36 + 9 + 6 + 120);
+}
+
+TEST_F(MIRTest, PassesInOutArgumentsByAddress) {
+    // bump(x: inout Int, by: Int) -> Int { x = x + by; return x }
+    std::vector<ParamDecl *> BumpParams = {new (Ctx) ParamDecl(id("x"), Ctx.getInOutType(Ctx.getIntType()),
+                                                   /*isInOut=*/true),
+                               new (Ctx) ParamDecl(id("by"), Ctx.getIntType())};
+    std::vector<TypeBase *> BumpTypes = {Ctx.getInOutType(Ctx.getIntType()), Ctx.getIntType()};
+    auto *Bump = new (Ctx) FuncDecl(
+        id("bump"), Ctx.allocateCopy<ParamDecl *>(BumpParams),
+        brace({assign("x", binary("+", ref("x"), ref("by"))), ret(ref("x"))}),
+        Ctx.getFunctionType(BumpTypes, Ctx.getIntType()));
+    // twice(x: inout Int) -> Int { bump(&x, 1); return bump(&x, 1) }
+    std::vector<ParamDecl *> TwiceParams = {new (Ctx) ParamDecl(id("x"), Ctx.getIntType(), true)};
+    auto inout = [&](const char *Name) { return new (Ctx) InOutExpr(ref(Name)); };
+    auto *Twice = new (Ctx) FuncDecl(
+        id("twice"), Ctx.allocateCopy<ParamDecl *>(TwiceParams),
+        brace({call("bump", {inout("x"), lit(1)}), ret(call("bump", {inout("x"), lit(1)}))}),
+        Ctx.getFunctionType({}, Ctx.getIntType()));
+    // main(a) { var v = a; var w = bump(&v, 2); w = w + twice(&v); return v * 100 + w }
+    FuncDecl *Main = func(
+        "main", {"a"},
+        brace({var("v", ref("a")), var("w", call("bump", {inout("v"), lit(2)})),
+               assign("w", binary("+", ref("w"), call("twice", {inout("v")}))),
+               ret(binary("+", binary("*", ref("v"), lit(100)), ref("w")))}));
+    // sumTo(n) { var v = 0; var i = 0; while i < n { bump(&v, i); i = i + 1 }; return v }
+    FuncDecl *SumTo = func(
+        "sumTo", {"n"},
+        brace({var("v", lit(0)), var("i", lit(0)),
+               new (Ctx) WhileStmt(binary("<", ref("i"), ref("n")),
+                                   brace({call("bump", {inout("v"), ref("i")}),
+                                          assign("i", binary("+", ref("i"), lit(1)))})),
+               ret(ref("v"))}));
+    lower({Bump, Twice, Main, SumTo});
+
+    EXPECT_EQ(M.getFunction("bump")->getParamTypes()[0], MIRType::Addr);
+    EXPECT_EQ(countOps(*M.getFunction("bump"), MIROpcode::Store), 1u);
+    // twice передаёт свой адрес дальше, без копии.
+    EXPECT_EQ(countOps(*M.getFunction("twice"), MIROpcode::Alloca), 0u);
+    // Один слот на переменную, сколько бы раз её ни передавали по адресу.
+    EXPECT_EQ(countOps(*M.getFunction("main"), MIROpcode::Alloca), 1u);
+    EXPECT_EQ(exec("main", {1}), 508);
+    // Слот для вызова в теле цикла выделяется во входном блоке, один раз.
+    MIRFunction *Loop = M.getFunction("sumTo");
+    EXPECT_EQ(countOps(*Loop, MIROpcode::Alloca), 1u);
+    EXPECT_EQ(Loop->getEntryBlock()->Insts.front()->getOpcode(), MIROpcode::Alloca);
+    EXPECT_EQ(exec("sumTo", {1000}), 1000 * 999 / 2);
+
+    MIRPassManager PM;
+    PM.addDefaultPipeline();
+    PM.setVerifyEach(true);
+    ASSERT_TRUE(PM.run(M, Error)) << Error;
+    EXPECT_EQ(countOps(*M.getFunction("main"), MIROpcode::Call), 0u);
+    EXPECT_EQ(exec("main", {1}), 508);
+    EXPECT_EQ(exec("main", {-7}), (-7 + 4) * 100 + (-7 + 2) + (-7 + 4));
+    EXPECT_EQ(exec("sumTo", {1000}), 1000 * 999 / 2);
+
+    MIRModule Bad;
+    FuncDecl *ByValue = func("f", {"a"}, brace({var("v", lit(0)),
+                                              ret(call("bump", {ref("v"), lit(1)}))}));
+    std::vector<FuncDecl *> BadFuncs = {Bump, ByValue};
+    EXPECT_FALSE(lowerToMIR(BadFuncs, Bad, Error));
+    EXPECT_EQ(Error, "f: argument 0 of 'bump' must be '&variable'");
+}
+
+TEST_F(MIRTest, EliminatesCancellingRetainRelease) {
+    ClassMetadata Box;
+    Box.Name = "Box";
+    Box.InstanceSize = HeapObjectHeaderSize + 8;
+    const uint32_t Value = HeapObjectHeaderSize;
+
+    // peek(o) = o.value; touch(o): две пары retain/release, вторая — вокруг
+    // вызова, который может отпустить объект.
+    MIRFunction *Peek = M.createFunction("peek", {MIRType::Ref}, MIRType::Int);
+    MIRBuilder PB(*Peek);
+    PB.setInsertPoint(Peek->getEntryBlock());
+    PB.createRet(PB.createLoadField(MIRType::Int, PB.createParam(0), Value));
+
+    MIRFunction *Touch = M.createFunction("touch", {MIRType::Ref}, MIRType::Int);
+    MIRBuilder B(*Touch);
+    B.setInsertPoint(Touch->getEntryBlock());
+    MIRInst *Object = B.createParam(0);
+    B.createRetain(Object);
+    MIRInst *Field = B.createLoadField(MIRType::Int, Object, Value);
+    B.createStoreField(Object, Value, B.createAdd(Field, B.iconst(1)));
+    B.createRelease(B.createCopy(Object));
+    B.createRetain(Object);
+    MIRInst *Result = B.createCall(Peek, {Object});
+    B.createRelease(Object);
+    B.createRet(Result);
+    ASSERT_TRUE(M.verify(Error)) << Error;
+    EXPECT_NE(print(*Touch).find("store_field %0 + 16"), std::string::npos) << print(*Touch);
+
+    auto runTouch = [&](Runtime &RT) {
+        HeapObject *O = RT.allocObject(Box);
+        *reinterpret_cast<int64_t *>(O->getField(Value)) = 41;
+        MIRInterpreter Interp(&RT);
+        int64_t R = Interp.run(*Touch, {makeMIRPointer(O)}).I;
+        EXPECT_EQ(O->RefCount, 1u);
+        RT.release(O);
+        return R;
+    };
+    Runtime Before;
+    EXPECT_EQ(runTouch(Before), 42);
+    EXPECT_EQ(Before.getStats().NumRetains, 2u);
+
+    EXPECT_EQ(runRetainReleaseElimination(*Touch), 2u);
+    ASSERT_TRUE(M.verify(Error)) << Error;
+    EXPECT_EQ(countOps(*Touch, MIROpcode::Retain), 1u);
+    Runtime After;
+    EXPECT_EQ(runTouch(After), 42);
+    EXPECT_EQ(After.getStats().NumRetains, 1u);
+    EXPECT_EQ(After.getNumLiveObjects(), 0u);
+
+    // После встраивания peek вызова нет, и вторая пара тоже снимается.
+    MIRPassManager PM;
+    PM.addDefaultPipeline();
+    PM.setVerifyEach(true);
+    ASSERT_TRUE(PM.run(M, Error)) << Error;
+    EXPECT_EQ(countOps(*Touch, MIROpcode::Retain), 0u);
+    EXPECT_EQ(countOps(*Touch, MIROpcode::Release), 0u);
+    Runtime Optimised;
+    EXPECT_EQ(runTouch(Optimised), 42);
+    EXPECT_EQ(Optimised.getStats().NumRetains, 0u);
+    EXPECT_EQ(Optimised.getStats().NumReleases, 1u);
+}
+
+TEST_F(MIRTest, PassManagerRunsDefaultPipeline) {
+    FuncDecl *Square = func("square", {"x"}, brace({ret(binary("*", ref("x"), ref("x")))}));
+    FuncDecl *Main = func("main", {"a"},
+                          brace({ret(binary("+", call("square", {ref("a")}),
+                                            call("square", {lit(3)})))}));
+    lower({Square, Main, loopSum()});
+
+    MIRPassManager PM;
+    PM.addDefaultPipeline();
+    PM.setVerifyEach(true);
+    ASSERT_TRUE(PM.run(M, Error)) << Error;
+
+    // square(3) встроен и свёрнут в константу.
+    const MIRFunction &F = *M.getFunction("main");
+    EXPECT_EQ(countOps(F, MIROpcode::Call), 0u);
+    EXPECT_EQ(countOps(F, MIROpcode::Mul), 1u);
+    EXPECT_EQ(exec("main", {5}), 34);
+    EXPECT_EQ(exec("loopSum", {4, 5}), 100);
+
+    ASSERT_EQ(PM.getStats().size(), PM.getPipeline().size());
+    EXPECT_STREQ(PM.getStats()[3].Name, "inline");
+    EXPECT_EQ(PM.getStats()[3].NumChanges, 2u);
+    EXPECT_EQ(PM.getStats()[0].NumRuns, 3u);
+}
+
+TEST_F(MIRTest, PassManagerParsesPassNames) {
+    MIRPassManager PM;
+    EXPECT_TRUE(PM.addPass("licm"));
+    EXPECT_TRUE(PM.addPass("inline"));
+    EXPECT_FALSE(PM.addPass("gvn"));
+    ASSERT_EQ(PM.getPipeline().size(), 2u);
+    EXPECT_EQ(PM.getPipeline()[0], MIRPassID::LoopInvariantCodeMotion);
+    EXPECT_FALSE(isFunctionPass(PM.getPipeline()[1]));
+}
+
+TEST_F(MIRTest, ParallelPipelineMatchesSerial) {
+    // Одинаковые модули оптимизируются последовательно и на пуле потоков;
+    // результат не должен зависеть от способа запуска.
+    auto build = [&](MIRModule &Out) {
+        std::vector<FuncDecl *> Funcs;
+        for (unsigned I = 0; I != 16; ++I) {
+            std::string Name = "f" + std::to_string(I);
+            Funcs.push_back(func(Name, {"n", "k"},
+                                 brace({var("s", lit(I)), var("i", lit(0)),
+                                        new (Ctx) WhileStmt(
+                                            binary("<", ref("i"), ref("n")),
+                                            brace({assign("s", binary("+", ref("s"),
+                                                                      binary("*", ref("k"),
+                                                                             lit(I + 1)))),
+                                                   assign("i", binary("+", ref("i"), lit(1)))})),
+                                        ret(ref("s"))})));
+        }
+        ASSERT_TRUE(lowerToMIR(Funcs, Out, Error)) << Error;
+    };
+    MIRModule Serial, Parallel;
+    build(Serial);
+    build(Parallel);
+
+    MIRPassManager SerialPM;
+    SerialPM.addDefaultPipeline();
+    ASSERT_TRUE(SerialPM.run(Serial, Error)) << Error;
+
+    ThreadPool Pool(4);
+    MIRPassManager ParallelPM;
+    ParallelPM.addDefaultPipeline();
+    ParallelPM.setThreadPool(&Pool);
+    ParallelPM.setVerifyEach(true);
+    ASSERT_TRUE(ParallelPM.run(Parallel, Error)) << Error;
+
+    std::ostringstream A, B;
+    Serial.print(A);
+    Parallel.print(B);
+    EXPECT_EQ(A.str(), B.str());
+    for (size_t I = 0; I != SerialPM.getStats().size(); ++I)
+        EXPECT_EQ(SerialPM.getStats()[I].NumChanges, ParallelPM.getStats()[I].NumChanges);
+}
+
+TEST_F(MIRTest, LowersToLIRForTheJIT) {
+    FuncDecl *Square = func("square", {"x"}, brace({ret(binary("*", ref("x"), ref("x")))}));
+    FuncDecl *Fact = func(
+        "fact", {"n"},
+        brace({new (Ctx) IfStmt(binary("<=", ref("n"), lit(1)), brace({ret(lit(1))})),
+               ret(binary("*", ref("n"), call("fact", {binary("-", ref("n"), lit(1))})))}));
+    // swap(n) - a и b меняются местами n раз; после копий phi цикла читают
+    // друг друга, и копии на дуге должны идти параллельно.
+    FuncDecl *Swap = func(
+        "swap", {"n"},
+        brace({var("a", lit(1)), var("b", lit(2)), var("i", lit(0)),
+               new (Ctx) WhileStmt(binary("<", ref("i"), ref("n")),
+                                   brace({var("t", ref("a")), assign("a", ref("b")),
+                                          assign("b", ref("t")),
+                                          assign("i", binary("+", ref("i"), lit(1)))})),
+               ret(binary("+", binary("*", ref("a"), lit(10)), ref("b")))}));
+    FuncDecl *Main = func("main", {"a"},
+                          brace({ret(binary("+", call("square", {ref("a")}),
+                                            call("fact", {lit(5)})))}));
+    lower({Square, Fact, Swap, Main, loopSum()});
+
+    MIRPassManager PM;
+    PM.addDefaultPipeline();
+    ASSERT_TRUE(PM.run(M, Error)) << Error;
+
+    LIRModule L;
+    ASSERT_TRUE(lowerToLIR(M, L, Error)) << Error;
+    ASSERT_EQ(L.getFunctions().size(), M.getFunctions().size());
+
+    struct Case {
+        const char *Name;
+        std::vector<int64_t> Args;
+    };
+    std::vector<Case> Cases = {{"main", {7}},   {"fact", {10}},      {"swap", {0}},
+                               {"swap", {5}},   {"swap", {6}},       {"loopSum", {10, 3}},
+                               {"loopSum", {0, 3}}};
+    LIRInterpreter Interp;
+    for (const Case &C : Cases) {
+        std::vector<LIRValue> Args;
+        for (int64_t A : C.Args)
+            Args.push_back(makeInt(A));
+        EXPECT_EQ(Interp.run(*L.getFunction(C.Name), Args).I, exec(C.Name, C.Args)) << C.Name;
+    }
+    EXPECT_EQ(exec("swap", {5}), 21);
+
+    if (!JITCompiler::isHostSupported())
+        return;
+    JITCompiler JIT;
+    ASSERT_TRUE(JIT.compile(L, Error)) << Error;
+    for (const Case &C : Cases) {
+        std::vector<LIRValue> Args;
+        for (int64_t A : C.Args)
+            Args.push_back(makeInt(A));
+        EXPECT_EQ(JIT.call(L.getFunction(C.Name), Args).I, exec(C.Name, C.Args)) << C.Name;
+    }
+}
+
+TEST_F(MIRTest, LowersFloatsBoolsAndSharedEdgesToLIR) {
+    // pick(c, x, y) - condbr с обеими дугами в один блок: phi различает их
+    // по порядку дуг. Результат — (!c ? x : y) * 2.0 - 0.5.
+    MIRFunction *F = M.createFunction("pick", {MIRType::Bool, MIRType::Float, MIRType::Float},
+                                      MIRType::Float);
+    MIRBuilder B(*F);
+    B.setInsertPoint(F->getEntryBlock());
+    MIRInst *C = B.createParam(0), *X = B.createParam(1), *Y = B.createParam(2);
+    MIRBlock *Merge = B.createBlock();
+    B.createCondBr(B.createNot(C), Merge, Merge);
+    MIRInst *Phi = B.createPhi(MIRType::Float, Merge);
+    F->setOperands(Phi, {X, Y});
+    B.setInsertPoint(Merge);
+    B.createRet(B.createFSub(B.createFMul(Phi, B.fconst(2.0)), B.fconst(0.5)));
+    ASSERT_TRUE(M.verify(Error)) << Error;
+
+    LIRModule L;
+    ASSERT_TRUE(lowerToLIR(M, L, Error)) << Error;
+    LIRInterpreter Interp;
+    const LIRFunction &Pick = *L.getFunction("pick");
+    EXPECT_EQ(Interp.run(Pick, {makeInt(0), makeFloat(3.0), makeFloat(5.0)}).F, 5.5);
+    EXPECT_EQ(Interp.run(Pick, {makeInt(1), makeFloat(3.0), makeFloat(5.0)}).F, 9.5);
+}
+
+TEST_F(MIRTest, LIRLoweringRejectsMemory) {
+    MIRFunction *F = M.createFunction("slot", {}, MIRType::Int);
+    MIRBuilder B(*F);
+    B.setInsertPoint(F->getEntryBlock());
+    MIRInst *Slot = B.createAlloca();
+    B.createStore(Slot, B.iconst(1));
+    B.createRet(B.createLoad(MIRType::Int, Slot));
+    ASSERT_TRUE(M.verify(Error)) << Error;
+
+    LIRModule L;
+    EXPECT_FALSE(lowerToLIR(M, L, Error));
+    EXPECT_EQ(Error, "slot: 'alloca' is not supported by LIR");
+
+    MIRModule ByAddress;
+    ByAddress.createFunction("bump", {MIRType::Addr}, MIRType::Void);
+    LIRModule L2;
+    EXPECT_FALSE(lowerToLIR(ByAddress, L2, Error));
+    EXPECT_EQ(Error, "bump: parameter of type 'addr' is not supported by LIR");
+}
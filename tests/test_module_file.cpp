@@ -0,0 +1,130 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <unistd.h>
+#include "Serialization/ModuleFile.h"
+#include "Serialization/ModuleWriter.h"
+
+using module_format::DeclKind;
+
+class ModuleFileTest : public ::testing::Test {
+protected:
+    std::string Path;
+
+    void SetUp() override {
+        char Template[] = "/tmp/swiftmini-module-XXXXXX";
+        int FD = mkstemp(Template);
+        ASSERT_GE(FD, 0);
+        close(FD);
+        Path = Template;
+    }
+
+    void TearDown() override { std::remove(Path.c_str()); }
+
+    // writeGeometryModule - Модуль с несколькими объявлениями разных видов.
+    void writeGeometryModule() {
+        ASTContext Ctx;
+        TypeBase *Point = Ctx.getStructType(Ctx.getIdentifier("Point"));
+        TypeBase *Dbl = Ctx.getDoubleType();
+
+        ModuleWriter Writer(Ctx.getIdentifier("Geometry"));
+        Writer.addDecl(DeclKind::Struct, Ctx.getIdentifier("Point"), Point);
+        Writer.addDecl(DeclKind::Func, Ctx.getIdentifier("distance"),
+                       Ctx.getFunctionType({Point, Point}, Dbl));
+        Writer.addDecl(DeclKind::Func, Ctx.getIdentifier("scale"),
+                       Ctx.getFunctionType({Ctx.getInOutType(Point), Dbl},
+                                           Ctx.getVoidType()));
+        Writer.addDecl(DeclKind::Let, Ctx.getIdentifier("origin"),
+                       Ctx.getTupleType({Dbl, Dbl}));
+        Writer.addDecl(DeclKind::Var, Ctx.getIdentifier("counter"), Ctx.getIntType());
+        ASSERT_TRUE(Writer.writeToFile(Path));
+    }
+};
+
+TEST_F(ModuleFileTest, RoundTrip) {
+    writeGeometryModule();
+
+    // Читаем в новый контекст: типы должны уникализироваться заново в нём.
+    ASTContext Ctx;
+    std::string Error;
+    std::unique_ptr<ModuleFile> File = ModuleFile::open(Path, Ctx, Error);
+    ASSERT_NE(File, nullptr) << Error;
+    EXPECT_EQ(File->getModuleName().str(), "Geometry");
+    EXPECT_EQ(File->getNumDecls(), 5u);
+
+    auto Distance = File->lookup("distance");
+    ASSERT_TRUE(Distance.has_value());
+    EXPECT_EQ(Distance->Kind, DeclKind::Func);
+    EXPECT_EQ(Distance->Name, Ctx.getIdentifier("distance"));
+    EXPECT_EQ(Distance->Type->getString(), "(Point, Point) -> Double");
+
+    TypeBase *Point = Ctx.getStructType(Ctx.getIdentifier("Point"));
+    EXPECT_EQ(Distance->Type,
+              Ctx.getFunctionType({Point, Point}, Ctx.getDoubleType()));
+
+    auto Scale = File->lookup("scale");
+    ASSERT_TRUE(Scale.has_value());
+    EXPECT_EQ(Scale->Type->getString(), "(inout Point, Double) -> ()");
+
+    auto Origin = File->lookup("origin");
+    ASSERT_TRUE(Origin.has_value());
+    EXPECT_EQ(Origin->Kind, DeclKind::Let);
+    EXPECT_EQ(Origin->Type->getString(), "(Double, Double)");
+
+    EXPECT_FALSE(File->lookup("missing").has_value());
+}
+
+TEST_F(ModuleFileTest, TypesAreLoadedLazily) {
+    writeGeometryModule();
+
+    ASTContext Ctx;
+    std::string Error;
+    std::unique_ptr<ModuleFile> File = ModuleFile::open(Path, Ctx, Error);
+    ASSERT_NE(File, nullptr) << Error;
+    EXPECT_EQ(File->getNumLoadedTypes(), 0u);
+
+    ASSERT_TRUE(File->lookup("counter").has_value());
+    EXPECT_EQ(File->getNumLoadedTypes(), 1u);
+
+    // Point, Double и тип функции; кортеж и inout не тронуты.
+    ASSERT_TRUE(File->lookup("distance").has_value());
+    EXPECT_EQ(File->getNumLoadedTypes(), 4u);
+}
+
+TEST_F(ModuleFileTest, ManyDecls) {
+    {
+        ASTContext Ctx;
+        ModuleWriter Writer(Ctx.getIdentifier("Big"));
+        for (int i = 0; i < 5000; ++i)
+            Writer.addDecl(DeclKind::Struct, Ctx.getIdentifier("T" + std::to_string(i)),
+                           Ctx.getStructType(Ctx.getIdentifier("T" + std::to_string(i))));
+        ASSERT_TRUE(Writer.writeToFile(Path));
+    }
+
+    ASTContext Ctx;
+    std::string Error;
+    std::unique_ptr<ModuleFile> File = ModuleFile::open(Path, Ctx, Error);
+    ASSERT_NE(File, nullptr) << Error;
+    for (int i = 0; i < 5000; i += 97) {
+        auto D = File->lookup("T" + std::to_string(i));
+        ASSERT_TRUE(D.has_value());
+        EXPECT_EQ(D->Type->getString(), "T" + std::to_string(i));
+    }
+    EXPECT_EQ(File->getNumLoadedTypes(), 52u);
+}
+
+TEST_F(ModuleFileTest, RejectsBadFiles) {
+    ASTContext Ctx;
+    std::string Error;
+    EXPECT_EQ(ModuleFile::open("/nonexistent/module", Ctx, Error), nullptr);
+
+    std::ofstream(Path, std::ios::binary) << std::string(64, 'x');
+    EXPECT_EQ(ModuleFile::open(Path, Ctx, Error), nullptr);
+    EXPECT_EQ(Error, "not a SwiftMini module file");
+
+    writeGeometryModule();
+    std::ofstream(Path, std::ios::binary | std::ios::app) << "trailing";
+    EXPECT_EQ(ModuleFile::open(Path, Ctx, Error), nullptr);
+    EXPECT_EQ(Error, "module file size does not match its header");
+}
@@ -0,0 +1,207 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "AST/ASTContext.h"
+#include "AST/Decl.h"
+#include "Runtime/Layout.h"
+#include "Runtime/Runtime.h"
+
+class RuntimeTest : public ::testing::Test {
+protected:
+    ASTContext Ctx;
+    LayoutContext Layouts;
+    std::string Error;
+
+    Identifier id(const char *Name) { return Ctx.getIdentifier(Name); }
+
+    Decl *field(const char *Name, TypeBase *Ty) {
+        return new (Ctx) VarDecl(id(Name), false, Ty);
+    }
+
+    StructDecl *structDecl(const char *Name, std::vector<Decl *> Members) {
+        return new (Ctx) StructDecl(id(Name), Ctx.allocateCopy<Decl *>(Members));
+    }
+
+    HeapObject *&refField(HeapObject *Object, uint32_t Offset) {
+        return *reinterpret_cast<HeapObject **>(Object->getField(Offset));
+    }
+};
+
+TEST_F(RuntimeTest, StructsAreLaidOutInline) {
+    // struct Point { var x: Int; var ok: Bool; var y: Double }
+    Layouts.addStruct(structDecl("Point", {field("x", Ctx.getIntType()),
+                                           field("ok", Ctx.getBoolType()),
+                                           field("y", Ctx.getDoubleType())}));
+    // struct Segment { var a: Point; var b: Point; var tag: Bool }
+    Layouts.addStruct(structDecl("Segment", {field("a", Ctx.getStructType(id("Point"))),
+                                             field("b", Ctx.getStructType(id("Point"))),
+                                             field("tag", Ctx.getBoolType())}));
+
+    const NominalLayout *Point = Layouts.getNominalLayout(id("Point"), Error);
+    ASSERT_NE(Point, nullptr) << Error;
+    EXPECT_FALSE(Point->IsClass);
+    EXPECT_EQ(Point->getField(id("ok"))->Offset, 8u);
+    EXPECT_EQ(Point->getField(id("y"))->Offset, 16u);
+    EXPECT_EQ(Point->Value.Size, 24u);
+    EXPECT_EQ(Point->Value.Alignment, 8u);
+    EXPECT_TRUE(Point->Value.isTrivial());
+
+    // Вложенные структуры лежат на месте, без ссылок и выделений.
+    const TypeLayout *Segment = Layouts.getLayout(Ctx.getStructType(id("Segment")), Error);
+    ASSERT_NE(Segment, nullptr) << Error;
+    EXPECT_EQ(Segment->Size, 49u);
+    EXPECT_EQ(Segment->getStride(), 56u);
+    EXPECT_TRUE(Segment->isTrivial());
+    EXPECT_EQ(Layouts.getNominalLayout(id("Segment"), Error)->getField(id("b"))->Offset, 24u);
+}
+
+TEST_F(RuntimeTest, ClassesAreReferences) {
+    // class Node { var value: Int; var next: Node }
+    std::vector<Decl *> NodeMembers = {field("value", Ctx.getIntType()),
+                                       field("next", Ctx.getClassType(id("Node")))};
+    Layouts.addClass(id("Node"), Ctx.allocateCopy<Decl *>(NodeMembers));
+    // struct Pair { var flag: Bool; var node: Node }
+    Layouts.addStruct(structDecl("Pair", {field("flag", Ctx.getBoolType()),
+                                          field("node", Ctx.getClassType(id("Node")))}));
+
+    const ClassMetadata *Node = Layouts.getClassMetadata(id("Node"), Error);
+    ASSERT_NE(Node, nullptr) << Error;
+    EXPECT_EQ(Node->InstanceSize, HeapObjectHeaderSize + 16);
+    ASSERT_EQ(Node->RefOffsets.size(), 1u);
+    EXPECT_EQ(Node->RefOffsets[0], HeapObjectHeaderSize + 8);
+
+    const TypeLayout *Pair = Layouts.getLayout(Ctx.getStructType(id("Pair")), Error);
+    ASSERT_NE(Pair, nullptr) << Error;
+    EXPECT_EQ(Pair->Size, 16u);
+    ASSERT_EQ(Pair->RefOffsets.size(), 1u);
+    EXPECT_EQ(Pair->RefOffsets[0], 8u);
+
+    EXPECT_EQ(Layouts.getClassMetadata(id("Pair"), Error), nullptr);
+    EXPECT_EQ(Error, "'Pair' is not a class");
+}
+
+TEST_F(RuntimeTest, ReportsInvalidLayouts) {
+    Layouts.addStruct(structDecl("Loop", {field("self", Ctx.getStructType(id("Loop")))}));
+    EXPECT_EQ(Layouts.getNominalLayout(id("Loop"), Error), nullptr);
+    EXPECT_NE(Error.find("infinite size"), std::string::npos) << Error;
+
+    Layouts.addStruct(structDecl("Bad", {field("s", Ctx.getStringType())}));
+    EXPECT_EQ(Layouts.getNominalLayout(id("Bad"), Error), nullptr);
+    EXPECT_EQ(Error, "Bad.s: type has no runtime layout");
+
+    EXPECT_EQ(Layouts.getLayout(Ctx.getClassType(id("Missing")), Error), nullptr);
+    EXPECT_EQ(Error, "unknown class 'Missing'");
+}
+
+TEST_F(RuntimeTest, ReleaseDestroysObjectGraph) {
+    std::vector<Decl *> Members = {field("value", Ctx.getIntType()),
+                                   field("next", Ctx.getClassType(id("Node")))};
+    Layouts.addClass(id("Node"), Ctx.allocateCopy<Decl *>(Members));
+    const ClassMetadata *Meta = Layouts.getClassMetadata(id("Node"), Error);
+    ASSERT_NE(Meta, nullptr) << Error;
+    ClassMetadata Node = *Meta;
+    static unsigned NumDeinits;
+    NumDeinits = 0;
+    Node.Deinit = [](HeapObject *) { ++NumDeinits; };
+    uint32_t Next = Node.RefOffsets[0];
+
+    Runtime RT;
+    // Длинный список: освобождение не должно уходить в рекурсию.
+    const unsigned Length = 100000;
+    HeapObject *Head = nullptr;
+    for (unsigned I = 0; I != Length; ++I) {
+        HeapObject *N = RT.allocObject(Node);
+        EXPECT_EQ(N->RefCount, 1u);
+        refField(N, Next) = Head;
+        Head = N;
+    }
+    EXPECT_EQ(RT.getNumLiveObjects(), Length);
+
+    RT.retain(Head);
+    RT.release(Head);
+    EXPECT_EQ(NumDeinits, 0u);
+    RT.release(Head);
+    EXPECT_EQ(NumDeinits, Length);
+    EXPECT_EQ(RT.getNumLiveObjects(), 0u);
+    EXPECT_EQ(RT.getStats().NumRetains, 1u);
+    EXPECT_EQ(RT.getStats().NumReleases, Length + 1);
+}
+
+TEST_F(RuntimeTest, ReleaseFromDeinitDoesNotRecurse) {
+    std::vector<Decl *> Members = {field("next", Ctx.getClassType(id("Owner")))};
+    Layouts.addClass(id("Owner"), Ctx.allocateCopy<Decl *>(Members));
+    const ClassMetadata *Meta = Layouts.getClassMetadata(id("Owner"), Error);
+    ASSERT_NE(Meta, nullptr) << Error;
+    // Ссылку на следующий объект отпускает сам deinit, а не рантайм.
+    ClassMetadata Owner = *Meta;
+    static uint32_t Next;
+    Next = Owner.RefOffsets[0];
+    Owner.RefOffsets.clear();
+    static Runtime *RT;
+    static unsigned Depth, MaxDepth;
+    Depth = MaxDepth = 0;
+    Owner.Deinit = [](HeapObject *Object) {
+        MaxDepth = std::max(MaxDepth, ++Depth);
+        RT->release(*reinterpret_cast<HeapObject **>(Object->getField(Next)));
+        --Depth;
+    };
+
+    Runtime Rt;
+    RT = &Rt;
+    HeapObject *Head = nullptr;
+    for (unsigned I = 0; I != 1000; ++I) {
+        HeapObject *N = Rt.allocObject(Owner);
+        refField(N, Next) = Head;
+        Head = N;
+    }
+    Rt.release(Head);
+    EXPECT_EQ(Rt.getNumLiveObjects(), 0u);
+    EXPECT_EQ(MaxDepth, 1u);
+}
+
+TEST_F(RuntimeTest, CopyingStructsRetainsOnlyReferences) {
+    std::vector<Decl *> NoMembers;
+    Layouts.addClass(id("Box"), Ctx.allocateCopy<Decl *>(NoMembers));
+    Layouts.addStruct(structDecl("Pair", {field("count", Ctx.getIntType()),
+                                          field("box", Ctx.getClassType(id("Box")))}));
+    const TypeLayout *Pair = Layouts.getLayout(Ctx.getStructType(id("Pair")), Error);
+    ASSERT_NE(Pair, nullptr) << Error;
+
+    Runtime RT;
+    struct { int64_t Count; HeapObject *Box; } A, B;
+    A.Count = 7;
+    A.Box = RT.allocObject(*Layouts.getClassMetadata(id("Box"), Error));
+    RT.copyValue(&B, &A, *Pair);
+    EXPECT_EQ(B.Count, 7);
+    EXPECT_EQ(B.Box, A.Box);
+    EXPECT_EQ(A.Box->RefCount, 2u);
+
+    RT.destroyValue(&A, *Pair);
+    EXPECT_EQ(RT.getNumLiveObjects(), 1u);
+    RT.destroyValue(&B, *Pair);
+    EXPECT_EQ(RT.getNumLiveObjects(), 0u);
+}
+
+TEST_F(RuntimeTest, AllocatorReusesFreedBlocks) {
+    ObjectAllocator Allocator;
+    void *A = Allocator.allocate(40);
+    void *B = Allocator.allocate(48);
+    EXPECT_NE(A, B);
+    Allocator.deallocate(A, 40);
+    // 40 и 48 байт — один класс размера.
+    EXPECT_EQ(Allocator.allocate(33), A);
+    // Блок другого класса размера не переиспользуется.
+    Allocator.deallocate(B, 48);
+    EXPECT_NE(Allocator.allocate(64), B);
+
+    void *Large = Allocator.allocate(ObjectAllocator::MaxPooledSize + 1);
+    Allocator.deallocate(Large, ObjectAllocator::MaxPooledSize + 1);
+
+    const ObjectAllocator::Stats &S = Allocator.getStats();
+    EXPECT_EQ(S.NumAllocs, 5u);
+    EXPECT_EQ(S.NumFrees, 3u);
+    EXPECT_EQ(S.NumReused, 1u);
+    EXPECT_EQ(S.NumLarge, 1u);
+    EXPECT_EQ(S.NumSlabs, 1u);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include "Parse/Lexer.h"
+#include "Parse/StreamingLexer.h"
+
+namespace {
+
+struct LexedToken {
+    tok Kind;
+    std::string Text;
+
+    bool operator==(const LexedToken &RHS) const {
+        return Kind == RHS.Kind && Text == RHS.Text;
+    }
+};
+
+std::vector<LexedToken> lexBuffered(const std::string &Input) {
+    std::vector<LexedToken> Result;
+    Lexer L(Input);
+    while (true) {
+        Token T = L.lex();
+        Result.push_back({T.getKind(), std::string(T.getText())});
+        if (T.isEOF())
+            break;
+    }
+    return Result;
+}
+
+// stringReader - ReadFn, отдающий строку кусками не больше MaxRead байт,
+// как это делает pipe.
+StreamingLexer::ReadFn stringReader(const std::string &Input, size_t MaxRead) {
+    auto Pos = std::make_shared<size_t>(0);
+    return [&Input, Pos, MaxRead](char *Buffer, size_t Size) -> size_t {
+        size_t N = std::min({Size, MaxRead, Input.size() - *Pos});
+        std::memcpy(Buffer, Input.data() + *Pos, N);
+        *Pos += N;
+        return N;
+    };
+}
+
+std::vector<LexedToken> lexStreaming(const std::string &Input, size_t ChunkSize,
+                                     size_t MaxRead = SIZE_MAX) {
+    std::vector<LexedToken> Result;
+    StreamingLexer L(stringReader(Input, MaxRead), ChunkSize);
+    while (true) {
+        Token T = L.lex();
+        Result.push_back({T.getKind(), std::string(T.getText())});
+        if (T.isEOF())
+            break;
+    }
+    return Result;
+}
+
+void expectSameTokens(const std::string &Input) {
+    std::vector<LexedToken> Expected = lexBuffered(Input);
+    for (size_t Chunk : {1, 2, 3, 4, 5, 7, 16, 64, 4096}) {
+        EXPECT_EQ(lexStreaming(Input, Chunk), Expected)
+            << "chunk size " << Chunk << " input: " << Input;
+        EXPECT_EQ(lexStreaming(Input, Chunk, 1), Expected)
+            << "chunk size " << Chunk << " (1-byte reads) input: " << Input;
+    }
+}
+
+} // namespace
+
+TEST(StreamingLexerTest, MatchesBufferedLexer) {
+    const char *Inputs[] = {
+        "",
+        "let x = 42",
+        "\nlet \n\n\nx = 42\n",
+        "\rlet \r\nx = 42\r",
+        "let // comment\nx = 42",
+        "let // comment x = 42",
+        "let /* multi\nline comment */ x = 42",
+        "#!/usr/bin/swift\nlet x = 42",
+        "#!",
+        "#",
+        "let # x",
+        "@ { [ ( } ] ) , ; : \\ $",
+        "let ® x © = 42 ™",
+        "identifier_with_digits123 another",
+        "0xFF 0b1010 123.45 12. 1_000 0",
+        "\"string\" 'c' \"esc\\\"aped\" \"unterminated\nnext",
+        "/* outer /* inner */ still comment */ done",
+        "/*/ not closed yet */ x",
+        "/* never closed",
+        "// only a comment",
+        "a/b/*c*/d",
+        "func f() -> Int { return 1 }",
+        "< > < x",
+    };
+    for (const char *Input : Inputs)
+        expectSameTokens(Input);
+}
+
+TEST(StreamingLexerTest, EmbeddedNul) {
+    expectSameTokens(std::string("let x\0 = 42", 11));
+    expectSameTokens(std::string("let x = 42\0", 11));
+    expectSameTokens(std::string("/* a \0 */ x", 11));
+    expectSameTokens(std::string("// a \0\nx", 8));
+}
+
+TEST(StreamingLexerTest, RandomInputs) {
+    const std::string Alphabet = "ab_019.x \n\r\t/*\"'\\#!{}()=:;,@$<>-+";
+    std::mt19937 Rng(20240901);
+    for (int Iter = 0; Iter < 300; ++Iter) {
+        std::string Input;
+        size_t Length = Rng() % 80;
+        for (size_t I = 0; I < Length; ++I)
+            Input += Alphabet[Rng() % Alphabet.size()];
+        expectSameTokens(Input);
+    }
+}
+
+TEST(StreamingLexerTest, MemoryStaysBoundedForHugeComments) {
+    std::string Input = "let a /* ";
+    Input.append(4 * 1024 * 1024, 'x');
+    Input += " /* nested */ ";
+    Input.append(4 * 1024 * 1024, '\n');
+    Input += "*/ b // ";
+    Input.append(1024 * 1024, 'y');
+    Input += "\nc";
+
+    const size_t Chunk = 4096;
+    StreamingLexer L(stringReader(Input, SIZE_MAX), Chunk);
+    std::vector<std::string> Texts;
+    while (true) {
+        Token T = L.lex();
+        Texts.push_back(std::string(T.getText()));
+        if (T.isEOF())
+            break;
+    }
+    EXPECT_EQ(Texts, (std::vector<std::string>{"", "let", "a", "b", "c", ""}));
+    EXPECT_LT(L.getWindowCapacity(), 4 * Chunk);
+}
+
+TEST(StreamingLexerTest, LongTokenGrowsWindow) {
+    std::string Name(10000, 'n');
+    std::string Input = "let " + Name + " = 1";
+    std::vector<LexedToken> Tokens = lexStreaming(Input, 16);
+    ASSERT_EQ(Tokens.size(), 6u);
+    EXPECT_EQ(Tokens[2].Text, Name);
+    EXPECT_EQ(Tokens, lexBuffered(Input));
+}
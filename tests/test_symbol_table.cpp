@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+#include <string>
+#include <vector>
+#include "Sema/SymbolTable.h"
+
+class SymbolTableTest : public ::testing::Test {
+protected:
+    IdentifierTable Idents;
+    ScopedSymbolTable<int> Table;
+};
+
+TEST_F(SymbolTableTest, IdentifiersAreUniqued) {
+    Identifier A = Idents.get("foo");
+    Identifier B = Idents.get(std::string("fo") + "o");
+    EXPECT_EQ(A, B);
+    EXPECT_EQ(A.str(), "foo");
+    EXPECT_NE(A, Idents.get("bar"));
+    EXPECT_TRUE(Idents.get("").empty());
+    EXPECT_EQ(Idents.size(), 2u);
+}
+
+TEST_F(SymbolTableTest, LookupGlobal) {
+    Identifier X = Idents.get("x");
+    EXPECT_EQ(Table.lookup(X), nullptr);
+    EXPECT_TRUE(Table.insert(X, 1));
+    ASSERT_NE(Table.lookup(X), nullptr);
+    EXPECT_EQ(*Table.lookup(X), 1);
+}
+
+TEST_F(SymbolTableTest, RedeclarationInSameScope) {
+    Identifier X = Idents.get("x");
+    EXPECT_TRUE(Table.insert(X, 1));
+    EXPECT_FALSE(Table.insert(X, 2));
+    EXPECT_EQ(*Table.lookup(X), 1);
+}
+
+TEST_F(SymbolTableTest, ShadowingIsUndoneOnPop) {
+    Identifier X = Idents.get("x");
+    Identifier Y = Idents.get("y");
+    Table.insert(X, 1);
+
+    Table.pushScope();
+    EXPECT_FALSE(Table.isDeclaredInCurrentScope(X));
+    EXPECT_TRUE(Table.insert(X, 2));
+    EXPECT_TRUE(Table.insert(Y, 3));
+    EXPECT_EQ(*Table.lookup(X), 2);
+    EXPECT_EQ(*Table.lookup(Y), 3);
+
+    Table.pushScope();
+    EXPECT_TRUE(Table.insert(X, 4));
+    EXPECT_EQ(*Table.lookup(X), 4);
+    Table.popScope();
+
+    EXPECT_EQ(*Table.lookup(X), 2);
+    Table.popScope();
+
+    EXPECT_EQ(*Table.lookup(X), 1);
+    EXPECT_EQ(Table.lookup(Y), nullptr);
+    EXPECT_EQ(Table.getNumEntries(), 1u);
+    EXPECT_EQ(Table.getUndoLogSize(), 1u);
+}
+
+TEST_F(SymbolTableTest, ScopeGuard) {
+    Identifier X = Idents.get("x");
+    {
+        ScopedSymbolTable<int>::Scope S(Table);
+        Table.insert(X, 7);
+        EXPECT_EQ(Table.getDepth(), 1u);
+    }
+    EXPECT_EQ(Table.getDepth(), 0u);
+    EXPECT_EQ(Table.lookup(X), nullptr);
+}
+
+TEST_F(SymbolTableTest, GrowthPreservesShadowing) {
+    std::vector<Identifier> Names;
+    for (int i = 0; i < 1000; ++i)
+        Names.push_back(Idents.get("v" + std::to_string(i)));
+
+    for (int i = 0; i < 500; ++i)
+        Table.insert(Names[i], i);
+
+    // Вложенная область затеняет половину глобальных имён и добавляет новые,
+    // таблица при этом несколько раз растёт.
+    Table.pushScope();
+    for (int i = 250; i < 1000; ++i)
+        Table.insert(Names[i], -i);
+    EXPECT_EQ(Table.getNumEntries(), 1000u);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(*Table.lookup(Names[i]), i < 250 ? i : -i);
+    Table.popScope();
+
+    EXPECT_EQ(Table.getNumEntries(), 500u);
+    for (int i = 0; i < 500; ++i)
+        EXPECT_EQ(*Table.lookup(Names[i]), i);
+    for (int i = 500; i < 1000; ++i)
+        EXPECT_EQ(Table.lookup(Names[i]), nullptr);
+}
+
+TEST_F(SymbolTableTest, DeepNesting) {
+    Identifier X = Idents.get("x");
+    const int Depth = 10000;
+    for (int i = 0; i < Depth; ++i) {
+        Table.pushScope();
+        Table.insert(X, i);
+    }
+    EXPECT_EQ(*Table.lookup(X), Depth - 1);
+    for (int i = Depth - 1; i >= 0; --i) {
+        EXPECT_EQ(*Table.lookup(X), i);
+        Table.popScope();
+    }
+    EXPECT_EQ(Table.lookup(X), nullptr);
+    EXPECT_EQ(Table.getNumEntries(), 0u);
+}
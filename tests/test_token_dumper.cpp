@@ -0,0 +1,161 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <functional>
+#include <string>
+#include <vector>
+#include "Basic/BufferedWriter.h"
+#include "Driver/TokenDumper.h"
+#include "Parse/Lexer.h"
+
+namespace {
+
+// capture - Всё, что Fn записал через BufferedWriter в файл.
+std::string capture(const std::function<void(BufferedWriter &)> &Fn,
+                    size_t BufferSize = BufferedWriter::DefaultBufferSize) {
+    std::FILE *F = std::tmpfile();
+    {
+        BufferedWriter OS(fileno(F), BufferSize);
+        Fn(OS);
+    }
+    std::string Out;
+    std::rewind(F);
+    char Chunk[4096];
+    size_t N;
+    while ((N = std::fread(Chunk, 1, sizeof(Chunk), F)) != 0)
+        Out.append(Chunk, N);
+    std::fclose(F);
+    return Out;
+}
+
+std::string dump(TokenDumpFormat Format, std::string_view Path, std::string_view Source) {
+    return capture([&](BufferedWriter &OS) { TokenDumper(OS, Format).dumpFile(Path, Source); });
+}
+
+} // namespace
+
+TEST(BufferedWriterTest, WritesEverythingThroughSmallBuffer) {
+    std::string Expected;
+    std::string Out = capture(
+        [&](BufferedWriter &OS) {
+            for (unsigned I = 0; I != 100; ++I) {
+                std::string Chunk(I % 13, static_cast<char>('a' + I % 26));
+                OS.write(Chunk);
+                OS.write(',');
+                OS.writeDecimal(I * 1000003ull);
+                Expected += Chunk + "," + std::to_string(I * 1000003ull);
+            }
+            OS.writeDecimal(0);
+            OS.writeDecimal(UINT64_MAX);
+            Expected += "0" + std::to_string(UINT64_MAX);
+            EXPECT_TRUE(OS.flush());
+        },
+        /*BufferSize=*/8);
+    EXPECT_EQ(Out, Expected);
+}
+
+TEST(BufferedWriterTest, BatchesSyscalls) {
+    std::FILE *F = std::tmpfile();
+    BufferedWriter OS(fileno(F));
+    for (unsigned I = 0; I != 100000; ++I)
+        OS.write("<identifier> 'x'\n");
+    ASSERT_TRUE(OS.flush());
+    EXPECT_EQ(OS.getBytesWritten(), 1700000u);
+    EXPECT_LE(OS.getNumSyscalls(), 2u);
+
+    // Запись в закрытый дескриптор запоминается как ошибка.
+    OS.setFD(-1);
+    OS.write("lost");
+    EXPECT_FALSE(OS.flush());
+    std::fclose(F);
+}
+
+TEST(BufferedWriterTest, EncodesIntegers) {
+    std::string Out = capture([](BufferedWriter &OS) {
+        OS.writeULEB128(0);
+        OS.writeULEB128(127);
+        OS.writeULEB128(128);
+        OS.writeULEB128(624485);
+        OS.writeLE32(0x01020304);
+    });
+    EXPECT_EQ(Out, std::string("\x00\x7f\x80\x01\xe5\x8e\x26\x04\x03\x02\x01", 11));
+}
+
+TEST(TokenDumperTest, TextHasPositionsAndSeparators) {
+    std::string Out = dump(TokenDumpFormat::Text, "a.swift", "let x = 42\n  foo(\"t\tq\")\n");
+    EXPECT_EQ(Out, "a.swift:1:1: <kw_let> 'let'\n"
+                   "a.swift:1:5: <identifier> 'x'\n"
+                   "a.swift:1:7: <equal> '='\n"
+                   "a.swift:1:9: <integer_literal> '42'\n"
+                   "a.swift:2:3: <identifier> 'foo'\n"
+                   "a.swift:2:6: <l_paren> '('\n"
+                   "a.swift:2:7: <string_literal> '\"t\\tq\"'\n"
+                   "a.swift:2:12: <r_paren> ')'\n"
+                   "a.swift:3:1: <EOF> ''\n");
+}
+
+TEST(TokenDumperTest, JSONLinesEscapeText) {
+    std::string Out = dump(TokenDumpFormat::JSONLines, "dir/\"q\".swift", "\n\"a\tb\"");
+    EXPECT_EQ(Out,
+              "{\"file\":\"dir/\\\"q\\\".swift\",\"line\":2,\"col\":1,\"offset\":1,"
+              "\"kind\":\"string_literal\",\"text\":\"\\\"a\\tb\\\"\"}\n"
+              "{\"file\":\"dir/\\\"q\\\".swift\",\"line\":2,\"col\":6,\"offset\":6,"
+              "\"kind\":\"eof\",\"text\":\"\"}\n");
+}
+
+TEST(TokenDumperTest, BinaryStreamRoundTrips) {
+    std::vector<std::string> Paths = {"one.swift", "two.swift"};
+    std::vector<std::string> Sources = {"func f(a: Int) {\n  return a\n}\n",
+                                        "// comment\n\n  var y = 2.5"};
+    std::string Stream = capture([&](BufferedWriter &OS) {
+        TokenDumper Dumper(OS, TokenDumpFormat::Binary);
+        for (size_t I = 0; I != Paths.size(); ++I)
+            Dumper.dumpFile(Paths[I], Sources[I]);
+        EXPECT_EQ(Dumper.getNumTokens(), 12u + 5u);
+    });
+
+    // Позиции — те же, что в текстовом дампе.
+    std::string Text;
+    for (size_t I = 0; I != Paths.size(); ++I)
+        Text += dump(TokenDumpFormat::Text, Paths[I], Sources[I]);
+
+    std::string Decoded, Error;
+    std::string_view Source;
+    std::string_view Path;
+    bool Ok = readTokenStream(
+        Stream,
+        [&](std::string_view P, uint64_t Size) {
+            size_t I = P == Paths[0] ? 0 : 1;
+            Path = Paths[I];
+            Source = Sources[I];
+            EXPECT_EQ(Size, Source.size());
+        },
+        [&](const TokenRecord &R) {
+            std::string_view TokText = Source.substr(R.Offset, R.Length);
+            Decoded += std::string(Path) + ":" + std::to_string(R.Line) + ":" +
+                       std::to_string(R.Column) + ": " +
+                       std::string(Token::getTokenName(R.Kind)) + " '" +
+                       std::string(TokText) + "'\n";
+        },
+        Error);
+    ASSERT_TRUE(Ok) << Error;
+    EXPECT_EQ(Decoded, Text);
+}
+
+TEST(TokenDumperTest, RejectsCorruptedStreams) {
+    std::string Stream = dump(TokenDumpFormat::Binary, "a.swift", "let x = 1");
+    std::string Error;
+    auto ignoreFile = [](std::string_view, uint64_t) {};
+    auto ignoreToken = [](const TokenRecord &) {};
+
+    EXPECT_FALSE(readTokenStream("JUNK", ignoreFile, ignoreToken, Error));
+    EXPECT_EQ(Error, "not a token stream");
+    EXPECT_FALSE(readTokenStream(Stream.substr(0, Stream.size() - 2), ignoreFile, ignoreToken,
+                                 Error));
+    EXPECT_EQ(Error, "truncated token record");
+    EXPECT_TRUE(readTokenStream(Stream, ignoreFile, ignoreToken, Error)) << Error;
+
+    TokenDumpFormat Format;
+    EXPECT_TRUE(parseTokenDumpFormat("json", Format));
+    EXPECT_EQ(Format, TokenDumpFormat::JSONLines);
+    EXPECT_FALSE(parseTokenDumpFormat("xml", Format));
+}
@@ -0,0 +1,99 @@
+#include <gtest/gtest.h>
+#include <sstream>
+#include <unordered_map>
+#include "AST/ASTContext.h"
+
+class TypesTest : public ::testing::Test {
+protected:
+    ASTContext Ctx;
+};
+
+TEST_F(TypesTest, BuiltinTypes) {
+    EXPECT_EQ(Ctx.getIntType()->getString(), "Int");
+    EXPECT_EQ(Ctx.getDoubleType()->getString(), "Double");
+    EXPECT_NE(Ctx.getIntType(), Ctx.getDoubleType());
+    EXPECT_TRUE(isa<BuiltinType>(Ctx.getBoolType()));
+    EXPECT_FALSE(isa<NominalType>(Ctx.getStringType()));
+}
+
+TEST_F(TypesTest, NominalTypesAreUniquedByKindAndName) {
+    Identifier Point = Ctx.getIdentifier("Point");
+    StructType *S1 = Ctx.getStructType(Point);
+    StructType *S2 = Ctx.getStructType(Ctx.getIdentifier("Point"));
+    EXPECT_EQ(S1, S2);
+    EXPECT_EQ(S1->getName(), Point);
+
+    ClassType *C = Ctx.getClassType(Point);
+    EXPECT_NE(static_cast<TypeBase *>(S1), static_cast<TypeBase *>(C));
+    EXPECT_TRUE(isa<NominalType>(C));
+    EXPECT_TRUE(isa<ClassType>(C));
+    EXPECT_FALSE(isa<StructType>(C));
+}
+
+TEST_F(TypesTest, StructuralTypesAreUniqued) {
+    TypeBase *Int = Ctx.getIntType();
+    TypeBase *Dbl = Ctx.getDoubleType();
+
+    TupleType *T1 = Ctx.getTupleType({Int, Dbl});
+    TupleType *T2 = Ctx.getTupleType({Int, Dbl});
+    TupleType *T3 = Ctx.getTupleType({Dbl, Int});
+    EXPECT_EQ(T1, T2);
+    EXPECT_NE(T1, T3);
+    EXPECT_EQ(T1->getString(), "(Int, Double)");
+
+    EXPECT_TRUE(Ctx.getVoidType()->isVoid());
+    EXPECT_EQ(Ctx.getVoidType(), Ctx.getTupleType({}));
+
+    InOutType *IO = Ctx.getInOutType(Int);
+    EXPECT_EQ(IO, Ctx.getInOutType(Int));
+    EXPECT_EQ(IO->getObjectType(), Int);
+
+    FunctionType *F1 = Ctx.getFunctionType({IO, Dbl}, Ctx.getBoolType());
+    FunctionType *F2 = Ctx.getFunctionType({Ctx.getInOutType(Int), Dbl}, Ctx.getBoolType());
+    EXPECT_EQ(F1, F2);
+    EXPECT_NE(F1, Ctx.getFunctionType({Int, Dbl}, Ctx.getBoolType()));
+    EXPECT_EQ(F1->getParams().size(), 2u);
+    EXPECT_EQ(F1->getResult(), Ctx.getBoolType());
+    EXPECT_EQ(F1->getString(), "(inout Int, Double) -> Bool");
+
+    // Функция без параметров и кортеж из одного элемента — разные типы.
+    FunctionType *Thunk = Ctx.getFunctionType({}, Int);
+    EXPECT_EQ(Thunk->getString(), "() -> Int");
+    EXPECT_NE(static_cast<TypeBase *>(Thunk),
+              static_cast<TypeBase *>(Ctx.getTupleType({Int})));
+}
+
+TEST_F(TypesTest, ManyTypesSurviveTableGrowth) {
+    std::vector<TypeBase *> Structs;
+    for (int i = 0; i < 2000; ++i)
+        Structs.push_back(Ctx.getStructType(Ctx.getIdentifier("S" + std::to_string(i))));
+
+    std::unordered_map<TypeBase *, int> Index;
+    for (int i = 0; i < 2000; ++i)
+        Index[Ctx.getFunctionType({Structs[i]}, Structs[(i + 1) % 2000])] = i;
+
+    for (int i = 0; i < 2000; ++i) {
+        EXPECT_EQ(Ctx.getStructType(Ctx.getIdentifier("S" + std::to_string(i))), Structs[i]);
+        EXPECT_EQ(Index[Ctx.getFunctionType({Structs[i]}, Structs[(i + 1) % 2000])], i);
+    }
+    EXPECT_EQ(Index.size(), 2000u);
+}
+
+TEST_F(TypesTest, Stats) {
+    TypeBase *Int = Ctx.getIntType();
+    Ctx.getTupleType({Int, Int});
+    Ctx.getTupleType({Int, Int});
+    Ctx.getStructType(Ctx.getIdentifier("A"));
+
+    const ASTContext::TypeStats &S = Ctx.getTypeStats();
+    EXPECT_EQ(S.NumLookups, 3u);
+    EXPECT_EQ(S.NumHits, 1u);
+    EXPECT_EQ(S.NumTypesByKind[static_cast<unsigned>(TypeKind::Tuple)], 1u);
+    EXPECT_EQ(S.NumTypesByKind[static_cast<unsigned>(TypeKind::Struct)], 1u);
+    // 4 встроенных типа + кортеж + структура.
+    EXPECT_EQ(S.NumUniqueTypes, 6u);
+
+    std::ostringstream OS;
+    Ctx.printStats(OS);
+    EXPECT_NE(OS.str().find("6 unique types"), std::string::npos);
+}